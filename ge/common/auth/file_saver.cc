@@ -17,6 +17,7 @@
 #include "common/auth/file_saver.h"
 
 #include <securec.h>
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <vector>
@@ -28,6 +29,7 @@
 
 namespace {
 const int kFileOpSuccess = 0;
+const int32_t kInvalidFd = -1;
 }  //  namespace
 
 namespace ge {
@@ -340,4 +342,81 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status FileSaver::SaveToFile(co
   }
   return ret;
 }
+
+OmFileStreamSaver::~OmFileStreamSaver() {
+  // not finished, the file is incomplete
+  if (fd_ != kInvalidFd) {
+    (void)mmClose(fd_);
+    fd_ = kInvalidFd;
+    if (remove(file_path_.c_str()) != 0) {
+      GELOGW("Remove incomplete file %s failed, %s", file_path_.c_str(), strerror(errno));
+    } else {
+      GELOGI("Incomplete file %s removed.", file_path_.c_str());
+    }
+  }
+}
+
+Status OmFileStreamSaver::Open(const std::string &file_path, uint32_t partition_num) {
+  GE_CHK_BOOL_RET_STATUS(partition_num != 0, PARAM_INVALID, "Partition num of %s is 0.", file_path.c_str());
+  GE_CHK_BOOL_RET_STATUS(fd_ == kInvalidFd, FAILED, "Stream saver is already opened.");
+  partition_table_.assign(sizeof(ModelPartitionTable) + sizeof(ModelPartitionMemInfo) * partition_num, 0);
+  reinterpret_cast<ModelPartitionTable *>(partition_table_.data())->num = partition_num;
+  written_num_ = 0;
+  model_data_len_ = 0;
+
+  int32_t fd = kInvalidFd;
+  GE_CHK_STATUS_RET(FileSaver::OpenFile(fd, file_path), "Open file %s failed.", file_path.c_str());
+  fd_ = fd;
+  file_path_ = file_path;
+  // placeholder of file header and partition table
+  std::vector<char> placeholder(sizeof(ModelFileHeader) + partition_table_.size(), 0);
+  GE_CHK_STATUS_RET(FileSaver::WriteData(placeholder.data(), static_cast<uint32_t>(placeholder.size()), fd_),
+                    "Write placeholder of file header failed.");
+  return SUCCESS;
+}
+
+Status OmFileStreamSaver::WritePartition(ModelPartitionType type, const void *data, size_t size) {
+  GE_CHK_BOOL_RET_STATUS(fd_ != kInvalidFd, FAILED, "Stream saver is not opened.");
+  auto partition_table = reinterpret_cast<ModelPartitionTable *>(partition_table_.data());
+  GE_CHK_BOOL_RET_STATUS(written_num_ < partition_table->num, FAILED, "Too many partitions, partition num is %u.",
+                         partition_table->num);
+  GE_CHK_BOOL_RET_STATUS((data != nullptr) && (size > 0) && (size <= UINT32_MAX), PARAM_INVALID,
+                         "Invalid partition, type = %d, size = %zu.", static_cast<int>(type), size);
+  auto partition_size = static_cast<uint32_t>(size);
+  GE_CHK_BOOL_RET_STATUS(CheckUint32AddOverflow(model_data_len_, partition_size) == SUCCESS, FAILED,
+                         "UINT32 %u and %u addition can result in overflow!", model_data_len_, partition_size);
+  GE_CHK_STATUS_RET(FileSaver::WriteData(data, partition_size, fd_), "Write partition of type %d failed.",
+                    static_cast<int>(type));
+  partition_table->partition[written_num_] = {type, model_data_len_, partition_size};
+  model_data_len_ += partition_size;
+  ++written_num_;
+  GELOGD("Partition written, type:%d, size:%u", static_cast<int>(type), partition_size);
+  return SUCCESS;
+}
+
+Status OmFileStreamSaver::Finish(ModelFileHeader &file_header) {
+  GE_CHK_BOOL_RET_STATUS(fd_ != kInvalidFd, FAILED, "Stream saver is not opened.");
+  auto partition_table = reinterpret_cast<ModelPartitionTable *>(partition_table_.data());
+  GE_CHK_BOOL_RET_STATUS(written_num_ == partition_table->num, FAILED, "Partition num %u mismatches written num %u.",
+                         partition_table->num, written_num_);
+  auto table_size = static_cast<uint32_t>(partition_table_.size());
+  GE_CHK_BOOL_RET_STATUS(CheckUint32AddOverflow(table_size, model_data_len_) == SUCCESS, FAILED,
+                         "UINT32 %u and %u addition can result in overflow!", table_size, model_data_len_);
+  file_header.is_encrypt = ModelEncryptType::UNENCRYPTED;
+  file_header.length = table_size + model_data_len_;
+
+  GE_CHK_BOOL_RET_STATUS(mmLseek(fd_, 0, SEEK_SET) == 0, FAILED, "Seek to file header failed, %s", strerror(errno));
+  GE_CHK_STATUS_RET(FileSaver::WriteData(&file_header, sizeof(ModelFileHeader), fd_), "Write file header failed.");
+  GE_CHK_STATUS_RET(FileSaver::WriteData(partition_table_.data(), table_size, fd_), "Write partition table failed.");
+  auto fd = fd_;
+  fd_ = kInvalidFd;
+  if (mmClose(fd) != EN_OK) {
+    GELOGE(FAILED, "Close file failed.");
+    (void)remove(file_path_.c_str());
+    return FAILED;
+  }
+  GELOGD("Model saved by stream, partition num:%u, model_total_len:%zu", written_num_,
+         file_header.length + sizeof(ModelFileHeader));
+  return SUCCESS;
+}
 }  //  namespace ge
@@ -86,6 +86,8 @@ class FileSaver {
   static Status SaveToFile(const string &file_path, const void *data, int len);
 
  protected:
+  friend class OmFileStreamSaver;
+
   ///
   /// @ingroup domi_common
   /// @brief Check validity of the file path
@@ -116,5 +118,33 @@ class FileSaver {
                                        vector<ModelPartitionTable *> &model_partition_tables,
                                        const vector<vector<ModelPartition>> &all_partition_datas);
 };
+
+///
+/// @ingroup domi_common
+/// @brief save model of one partition table partition by partition, so that data of a partition can be released
+///        once it is written. Room of file header and partition table is reserved on Open and filled on Finish.
+///
+class OmFileStreamSaver {
+ public:
+  OmFileStreamSaver() = default;
+  ~OmFileStreamSaver();
+
+  OmFileStreamSaver(const OmFileStreamSaver &) = delete;
+  OmFileStreamSaver &operator=(const OmFileStreamSaver &) = delete;
+
+  Status Open(const std::string &file_path, uint32_t partition_num);
+
+  Status WritePartition(ModelPartitionType type, const void *data, size_t size);
+
+  Status Finish(ModelFileHeader &file_header);
+
+ private:
+  // the file is removed if the saver is destroyed before Finish succeeds
+  std::string file_path_;
+  int32_t fd_ = -1;
+  uint32_t written_num_ = 0;
+  uint32_t model_data_len_ = 0;
+  std::vector<char> partition_table_;
+};
 }  // namespace ge
 #endif  // GE_COMMON_AUTH_FILE_SAVER_H_
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "common/dump/dump_writer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "common/debug/memory_dumper.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
+#include "runtime/mem.h"
+
+namespace {
+const char *const kEnvThreadNum = "DUMP_WRITER_THREAD_NUM";
+const char *const kEnvMaxPendingSize = "DUMP_WRITER_MAX_PENDING_MB";
+const char *const kEnvDropOnFull = "DUMP_WRITER_DROP_ON_FULL";
+const char *const kEnvSync = "DUMP_WRITER_SYNC";
+const int kIntBase = 10;
+const int64_t kDefaultThreadNum = 1;
+const int64_t kMaxThreadNum = 16;
+const int64_t kDefaultMaxPendingSize = 256;  // MB
+const size_t kMegaBytes = 1024UL * 1024UL;
+const size_t kMaxWriteLen = 1024UL * kMegaBytes;
+
+int64_t GetEnvValue(const char *name, int64_t default_value) {
+  const char *value = std::getenv(name);
+  if (value == nullptr) {
+    return default_value;
+  }
+  auto parsed_value = std::strtol(value, nullptr, kIntBase);
+  return parsed_value > 0 ? parsed_value : default_value;
+}
+}  // namespace
+
+namespace ge {
+DumpWriter &DumpWriter::GetInstance() {
+  static DumpWriter instance;
+  return instance;
+}
+
+DumpWriter::DumpWriter()
+    : thread_num_(static_cast<size_t>(std::min(GetEnvValue(kEnvThreadNum, kDefaultThreadNum), kMaxThreadNum))),
+      max_pending_bytes_(static_cast<size_t>(GetEnvValue(kEnvMaxPendingSize, kDefaultMaxPendingSize)) * kMegaBytes),
+      drop_on_full_(GetEnvValue(kEnvDropOnFull, 0) > 0),
+      sync_(GetEnvValue(kEnvSync, 0) > 0) {}
+
+DumpWriter::~DumpWriter() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  // workers exit after all submitted dumps are written
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+Status DumpWriter::CopyDevMem(const void *addr, int64_t size, Buffer &buffer) {
+  buffer.clear();
+  if (size == 0) {
+    GELOGI("Size of dev mem is 0, nothing to copy.");
+    return SUCCESS;
+  }
+  GE_CHECK_NOTNULL(addr);
+  GE_CHK_BOOL_RET_STATUS(size > 0, PARAM_INVALID, "Invalid size of dev mem: %ld", size);
+  buffer.resize(static_cast<size_t>(size));
+  GE_CHK_RT_RET(rtMemcpy(buffer.data(), buffer.size(), addr, buffer.size(), RT_MEMCPY_DEVICE_TO_HOST));
+  return SUCCESS;
+}
+
+void DumpWriter::StartWorkers() {
+  GELOGI("Start dump writer, thread num = %zu, max pending size = %zu, drop on full = %d", thread_num_,
+         max_pending_bytes_, static_cast<int>(drop_on_full_));
+  for (size_t i = 0; i < thread_num_; ++i) {
+    workers_.emplace_back([this]() { WorkerRun(); });
+  }
+}
+
+Status DumpWriter::Submit(const std::string &file_path, std::vector<Buffer> &&buffers, uint64_t &seq) {
+  DumpTask task;
+  task.file_path = file_path;
+  task.buffers = std::move(buffers);
+  for (const auto &buffer : task.buffers) {
+    task.size += buffer.size();
+  }
+
+  std::unique_lock<std::mutex> lk(mu_);
+  if (sync_) {
+    task.seq = next_seq_++;
+    seq = task.seq;
+    lk.unlock();
+    GE_CHK_STATUS_RET(WriteFile(task), "Failed to write dump [%lu] to %s", seq, file_path.c_str());
+    GELOGI("Dump [%lu] written to %s, size = %zu", seq, file_path.c_str(), task.size);
+    return SUCCESS;
+  }
+  if (workers_.empty()) {
+    StartWorkers();
+  }
+  // a dump bigger than the bound is accepted when nothing is pending
+  auto has_room = [this, &task]() {
+    return (pending_bytes_ == 0) || (pending_bytes_ + task.size <= max_pending_bytes_);
+  };
+  if (!has_room()) {
+    if (drop_on_full_) {
+      GELOGW("Dump writer is full, pending size = %zu, dump of %s dropped", pending_bytes_, file_path.c_str());
+      seq = 0;
+      return SUCCESS;
+    }
+    cv_.wait(lk, has_room);
+  }
+  task.seq = next_seq_++;
+  seq = task.seq;
+  pending_bytes_ += task.size;
+  tasks_.emplace_back(std::move(task));
+  lk.unlock();
+  cv_.notify_all();
+  GELOGI("Dump [%lu] of %s submitted.", seq, file_path.c_str());
+  return SUCCESS;
+}
+
+Status DumpWriter::Flush() {
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this]() { return tasks_.empty() && (writing_num_ == 0); });
+  auto ret = write_status_;
+  write_status_ = SUCCESS;
+  return ret;
+}
+
+void DumpWriter::WorkerRun() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    cv_.wait(lk, [this]() { return stopped_ || !tasks_.empty(); });
+    if (tasks_.empty()) {
+      return;
+    }
+    DumpTask task = std::move(tasks_.front());
+    tasks_.pop_front();
+    ++writing_num_;
+    lk.unlock();
+
+    auto ret = WriteFile(task);
+    if (ret == SUCCESS) {
+      GELOGI("Dump [%lu] written to %s, size = %zu", task.seq, task.file_path.c_str(), task.size);
+    } else {
+      GELOGE(ret, "Failed to write dump [%lu] to %s", task.seq, task.file_path.c_str());
+    }
+    task.buffers.clear();
+
+    lk.lock();
+    --writing_num_;
+    pending_bytes_ -= task.size;
+    if ((ret != SUCCESS) && (write_status_ == SUCCESS)) {
+      write_status_ = ret;
+    }
+    cv_.notify_all();
+  }
+}
+
+Status DumpWriter::WriteFile(const DumpTask &task) {
+  MemoryDumper dumper;
+  GE_CHK_STATUS_RET(dumper.Open(task.file_path.c_str()), "Failed to open dump file %s", task.file_path.c_str());
+  for (const auto &buffer : task.buffers) {
+    for (size_t offset = 0; offset < buffer.size(); offset += kMaxWriteLen) {
+      auto len = std::min(buffer.size() - offset, kMaxWriteLen);
+      auto data = const_cast<uint8_t *>(buffer.data() + offset);
+      GE_CHK_STATUS_RET(dumper.Dump(data, static_cast<uint32_t>(len)), "Failed to write dump file %s",
+                        task.file_path.c_str());
+    }
+  }
+  dumper.Close();
+  return SUCCESS;
+}
+}  // namespace ge
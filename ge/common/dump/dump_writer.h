@@ -0,0 +1,87 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GE_COMMON_DUMP_DUMP_WRITER_H_
+#define GE_COMMON_DUMP_DUMP_WRITER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "framework/common/ge_inner_error_codes.h"
+
+namespace ge {
+// Writes host side dump files on background threads.
+// Device data is copied to host buffers by the caller, so device memory may be reused once Submit returns.
+// Bytes not written yet are bounded, callers wait when the bound is reached, or the dump is dropped
+// if env DUMP_WRITER_DROP_ON_FULL is set to 1. Every accepted dump gets a sequence number logged with its path.
+// Files are complete after Flush, which is called at finalize. If env DUMP_WRITER_SYNC is set to 1,
+// dumps are written by the caller and complete when Submit returns.
+class DumpWriter {
+ public:
+  using Buffer = std::vector<uint8_t>;
+
+  static DumpWriter &GetInstance();
+
+  ~DumpWriter();
+
+  DumpWriter(const DumpWriter &) = delete;
+  DumpWriter &operator=(const DumpWriter &) = delete;
+
+  static Status CopyDevMem(const void *addr, int64_t size, Buffer &buffer);
+
+  // buffers are written to file_path in order, seq is 0 if the dump is dropped,
+  // write failure is returned by Submit in sync mode, or by Flush otherwise
+  Status Submit(const std::string &file_path, std::vector<Buffer> &&buffers, uint64_t &seq);
+
+  // wait until all submitted dumps are written, returns the first write failure since last flush
+  Status Flush();
+
+ private:
+  struct DumpTask {
+    uint64_t seq = 0;
+    std::string file_path;
+    std::vector<Buffer> buffers;
+    size_t size = 0;
+  };
+
+  DumpWriter();
+  void StartWorkers();
+  void WorkerRun();
+  static Status WriteFile(const DumpTask &task);
+
+  size_t thread_num_;
+  size_t max_pending_bytes_;
+  bool drop_on_full_;
+  bool sync_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<DumpTask> tasks_;
+  size_t pending_bytes_ = 0;
+  size_t writing_num_ = 0;
+  uint64_t next_seq_ = 1;
+  bool stopped_ = false;
+  Status write_status_ = SUCCESS;
+  std::vector<std::thread> workers_;
+};
+}  // namespace ge
+#endif  // GE_COMMON_DUMP_DUMP_WRITER_H_
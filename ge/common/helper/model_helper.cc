@@ -16,6 +16,7 @@
 
 #include "framework/common/helper/model_helper.h"
 
+#include "common/auth/file_saver.h"
 #include "common/ge/ge_util.h"
 #include "common/util/error_manager/error_manager.h"
 #include "framework/common/debug/log.h"
@@ -33,14 +34,15 @@ using domi::ModelTaskDef;
 namespace {
 const int64_t kOriginalOmPartitionNum = 1;
 const uint32_t kStatiOmFileModelNum = 1;
+// model def and task info
+const uint32_t kMandatoryPartitionNum = 2;
 }
 
 
 namespace ge {
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ModelHelper::~ModelHelper() { (void)ReleaseLocalModelData(); }
 
-Status ModelHelper::SaveModelPartition(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper, ModelPartitionType type,
-                                       const uint8_t *data, size_t size, size_t model_index) {
+Status ModelHelper::CheckModelPartition(ModelPartitionType type, const uint8_t *data, size_t size) {
   if (size < 1 || size > UINT32_MAX) {
     GELOGE(PARAM_INVALID, "Add model partition failed, partition size %zu invalid", size);
     if (size > UINT32_MAX) {
@@ -65,6 +67,12 @@ Status ModelHelper::SaveModelPartition(std::shared_ptr<OmFileSaveHelper> &om_fil
     GELOGE(PARAM_INVALID, "Add model partition failed, data is null");
     return PARAM_INVALID;
   }
+  return SUCCESS;
+}
+
+Status ModelHelper::SaveModelPartition(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper, ModelPartitionType type,
+                                       const uint8_t *data, size_t size, size_t model_index) {
+  GE_CHK_STATUS_RET_NOLOG(CheckModelPartition(type, data, size));
   ModelPartition partition_model;
   partition_model.data = const_cast<uint8_t *>(data);
   partition_model.size = static_cast<uint32_t>(size);
@@ -82,11 +90,11 @@ Status ModelHelper::SaveSizeToModelDef(const GeModelPtr &ge_model) {
   GELOGD("SaveSizeToModelDef weight_data_size is %zu, %p", ge_model_weight.GetSize(), ge_model_weight.GetData());
   om_info.push_back(ge_model_weight.GetSize());
 
-  TBEKernelStore tbe_kernel_store = ge_model->GetTBEKernelStore();
+  const TBEKernelStore &tbe_kernel_store = ge_model->GetTBEKernelStore();
   GELOGD("SaveSizeToModelDef tbe_kernels_size is %zu", tbe_kernel_store.DataSize());
   om_info.push_back(tbe_kernel_store.DataSize());
 
-  CustAICPUKernelStore cust_aicpu_kernel_store = ge_model->GetCustAICPUKernelStore();
+  const CustAICPUKernelStore &cust_aicpu_kernel_store = ge_model->GetCustAICPUKernelStore();
   GELOGD("SaveSizeToModelDef cust aicpu kernels size is %zu", cust_aicpu_kernel_store.DataSize());
   om_info.push_back(cust_aicpu_kernel_store.DataSize());
 
@@ -106,8 +114,7 @@ Status ModelHelper::SaveSizeToModelDef(const GeModelPtr &ge_model) {
   return SUCCESS;
 }
 
-Status ModelHelper::SaveModelDef(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper,
-                                 const GeModelPtr &ge_model, ge::Buffer &model_buffer, size_t model_index) {
+Status ModelHelper::SerializeModelDef(const GeModelPtr &ge_model, ge::Buffer &model_buffer) {
   ModelPtr model_tmp = ge::MakeShared<ge::Model>(ge_model->GetName(), ge_model->GetPlatformVersion());
   if (model_tmp == nullptr) {
     GELOGE(FAILED, "Create Model %s Ptr failed", ge_model->GetName().c_str());
@@ -124,6 +131,12 @@ Status ModelHelper::SaveModelDef(std::shared_ptr<OmFileSaveHelper> &om_file_save
 
   (void)model_tmp->Save(model_buffer);
   GELOGD("MODEL_DEF size is %zu", model_buffer.GetSize());
+  return SUCCESS;
+}
+
+Status ModelHelper::SaveModelDef(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper,
+                                 const GeModelPtr &ge_model, ge::Buffer &model_buffer, size_t model_index) {
+  GE_CHK_STATUS_RET_NOLOG(SerializeModelDef(ge_model, model_buffer));
   if (model_buffer.GetSize() > 0) {
     if (SaveModelPartition(om_file_save_helper, ModelPartitionType::MODEL_DEF, model_buffer.GetData(),
                            model_buffer.GetSize(), model_index) != SUCCESS) {
@@ -150,36 +163,32 @@ Status ModelHelper::SaveModelWeights(std::shared_ptr<OmFileSaveHelper> &om_file_
 
 Status ModelHelper::SaveModelTbeKernel(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper,
                                        const GeModelPtr &ge_model, size_t model_index) {
-  TBEKernelStore tbe_kernel_store = ge_model->GetTBEKernelStore();
+  const TBEKernelStore &tbe_kernel_store = ge_model->GetTBEKernelStore();
   GELOGD("TBE_KERNELS size is %zu", tbe_kernel_store.DataSize());
   if (tbe_kernel_store.DataSize() > 0) {
     GE_CHK_STATUS_RET(
         SaveModelPartition(om_file_save_helper, ModelPartitionType::TBE_KERNELS,
-                           ge_model->GetTBEKernelStore().Data(), ge_model->GetTBEKernelStore().DataSize(),
+                           tbe_kernel_store.Data(), tbe_kernel_store.DataSize(),
                            model_index), "Add tbe kernel partition failed");
   }
-  // no need to check value, DATA->NetOutput
-  (void)tbe_kernel_store.Load(tbe_kernel_store.Data(), tbe_kernel_store.DataSize());
-
   return SUCCESS;
 }
 
 Status ModelHelper::SaveModelCustAICPU(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper,
                                        const GeModelPtr &ge_model, size_t model_index) {
-  CustAICPUKernelStore cust_aicpu_kernel_store = ge_model->GetCustAICPUKernelStore();
+  const CustAICPUKernelStore &cust_aicpu_kernel_store = ge_model->GetCustAICPUKernelStore();
   GELOGD("cust aicpu kernels size is %zu", cust_aicpu_kernel_store.DataSize());
   if (cust_aicpu_kernel_store.DataSize() > 0) {
     GE_CHK_STATUS_RET(SaveModelPartition(om_file_save_helper,
                                          ModelPartitionType::CUST_AICPU_KERNELS,
-                                         ge_model->GetCustAICPUKernelStore().Data(),
+                                         cust_aicpu_kernel_store.Data(),
                                          cust_aicpu_kernel_store.DataSize(), model_index),
                       "Add cust aicpu kernel partition failed");
   }
   return SUCCESS;
 }
 
-Status ModelHelper::SaveModelTaskDef(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper,
-                                     const GeModelPtr &ge_model, ge::Buffer &task_buffer, size_t model_index) {
+Status ModelHelper::SerializeModelTaskDef(const GeModelPtr &ge_model, ge::Buffer &task_buffer) {
   std::shared_ptr<ModelTaskDef> model_task_def = ge_model->GetModelTaskDefPtr();
   if (model_task_def == nullptr) {
     GELOGE(ACL_ERROR_GE_MEMORY_ALLOCATION, "Create model task def ptr failed");
@@ -199,9 +208,14 @@ Status ModelHelper::SaveModelTaskDef(std::shared_ptr<OmFileSaveHelper> &om_file_
 
   GELOGD("TASK_INFO op_size:%d, stream_num:%u", model_task_def->op().size(), model_task_def->stream_num());
   GELOGD("TASK_INFO size is %zu", partition_task_size);
+  return SUCCESS;
+}
 
+Status ModelHelper::SaveModelTaskDef(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper,
+                                     const GeModelPtr &ge_model, ge::Buffer &task_buffer, size_t model_index) {
+  GE_CHK_STATUS_RET_NOLOG(SerializeModelTaskDef(ge_model, task_buffer));
   if (SaveModelPartition(om_file_save_helper, ModelPartitionType::TASK_INFO, task_buffer.GetData(),
-                         partition_task_size, model_index) != SUCCESS) {
+                         task_buffer.GetSize(), model_index) != SUCCESS) {
     GELOGE(PARAM_INVALID, "Add model task def partition failed");
     return PARAM_INVALID;
   }
@@ -210,8 +224,11 @@ Status ModelHelper::SaveModelTaskDef(std::shared_ptr<OmFileSaveHelper> &om_file_
 
 Status ModelHelper::SaveModelHeader(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper,
                                     const GeModelPtr &ge_model, size_t model_num) {
+  return FillModelHeader(ge_model, model_num, om_file_save_helper->GetModelFileHeader());
+}
+
+Status ModelHelper::FillModelHeader(const GeModelPtr &ge_model, size_t model_num, ModelFileHeader &model_header) {
   // Save target/version to model_header
-  ModelFileHeader &model_header = om_file_save_helper->GetModelFileHeader();
   model_header.platform_type = ge_model->GetPlatformType();
   model_header.om_ir_version = ge_model->GetVersion();
   model_header.model_num = model_num;
@@ -281,6 +298,9 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::SaveToOmMod
   }
 
   GE_IF_BOOL_EXEC(ge_model == nullptr, GELOGE(FAILED, "Ge_model is nullptr"); return FAILED);
+  if (is_offline_) {
+    return SaveToOmFileByStream(ge_model, output_file);
+  }
   std::shared_ptr<OmFileSaveHelper> om_file_save_helper = ge::MakeShared<OmFileSaveHelper>();
   GE_CHECK_NOTNULL(om_file_save_helper);
   ge::Buffer model_buffer;
@@ -306,6 +326,59 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::SaveToOmMod
   return SUCCESS;
 }
 
+Status ModelHelper::SaveToOmFileByStream(const GeModelPtr &ge_model, const std::string &output_file) {
+#if !defined(NONSUPPORT_SAVE_TO_FILE)
+  GELOGI("Start to save model %s to %s", ge_model->GetName().c_str(), output_file.c_str());
+  // same partitions and order as SaveAllModelPartiton, weights and kernels are written from GeModel directly
+  const auto weight = ge_model->GetWeight();
+  const TBEKernelStore &tbe_kernel_store = ge_model->GetTBEKernelStore();
+  const CustAICPUKernelStore &cust_aicpu_kernel_store = ge_model->GetCustAICPUKernelStore();
+  uint32_t partition_num = kMandatoryPartitionNum;
+  partition_num += (weight.GetSize() > 0) ? 1 : 0;
+  partition_num += (tbe_kernel_store.DataSize() > 0) ? 1 : 0;
+  partition_num += (cust_aicpu_kernel_store.DataSize() > 0) ? 1 : 0;
+
+  OmFileStreamSaver stream_saver;
+  GE_CHK_STATUS_RET(stream_saver.Open(output_file, partition_num), "Open %s failed", output_file.c_str());
+  {
+    ge::Buffer model_buffer;
+    GE_CHK_STATUS_RET_NOLOG(SerializeModelDef(ge_model, model_buffer));
+    GE_CHK_STATUS_RET_NOLOG(CheckModelPartition(MODEL_DEF, model_buffer.GetData(), model_buffer.GetSize()));
+    GE_CHK_STATUS_RET(stream_saver.WritePartition(MODEL_DEF, model_buffer.GetData(), model_buffer.GetSize()),
+                      "Write model def partition failed");
+  }
+  if (weight.GetSize() > 0) {
+    GE_CHK_STATUS_RET_NOLOG(CheckModelPartition(WEIGHTS_DATA, weight.GetData(), weight.GetSize()));
+    GE_CHK_STATUS_RET(stream_saver.WritePartition(WEIGHTS_DATA, weight.GetData(), weight.GetSize()),
+                      "Write weight partition failed");
+  }
+  if (tbe_kernel_store.DataSize() > 0) {
+    GE_CHK_STATUS_RET_NOLOG(CheckModelPartition(TBE_KERNELS, tbe_kernel_store.Data(), tbe_kernel_store.DataSize()));
+    GE_CHK_STATUS_RET(stream_saver.WritePartition(TBE_KERNELS, tbe_kernel_store.Data(), tbe_kernel_store.DataSize()),
+                      "Write tbe kernel partition failed");
+  }
+  if (cust_aicpu_kernel_store.DataSize() > 0) {
+    GE_CHK_STATUS_RET_NOLOG(CheckModelPartition(CUST_AICPU_KERNELS, cust_aicpu_kernel_store.Data(),
+                                                cust_aicpu_kernel_store.DataSize()));
+    GE_CHK_STATUS_RET(stream_saver.WritePartition(CUST_AICPU_KERNELS, cust_aicpu_kernel_store.Data(),
+                                                  cust_aicpu_kernel_store.DataSize()),
+                      "Write cust aicpu kernel partition failed");
+  }
+  {
+    ge::Buffer task_buffer;
+    GE_CHK_STATUS_RET_NOLOG(SerializeModelTaskDef(ge_model, task_buffer));
+    GE_CHK_STATUS_RET(stream_saver.WritePartition(TASK_INFO, task_buffer.GetData(), task_buffer.GetSize()),
+                      "Write task def partition failed");
+  }
+
+  ModelFileHeader model_header;
+  GE_CHK_STATUS_RET(FillModelHeader(ge_model, kStatiOmFileModelNum, model_header), "Save model header failed");
+  GE_CHK_STATUS_RET(stream_saver.Finish(model_header), "Finish saving %s failed", output_file.c_str());
+  GELOGI("Model %s saved to %s", ge_model->GetName().c_str(), output_file.c_str());
+#endif
+  return SUCCESS;
+}
+
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ModelHelper::SaveToOmRootModel(
     const GeRootModelPtr &ge_root_model,
     const SaveParam &save_param,
@@ -16,6 +16,8 @@
 
 #include "common/profiling/profiling_manager.h"
 
+#include <algorithm>
+
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/debug/log.h"
 #include "framework/common/string_util.h"
@@ -27,9 +29,15 @@ namespace {
 const char *const kTrainingTrace = "training_trace";
 const char *const kFpPoint = "fp_point";
 const char *const kBpPoint = "bp_point";
+const size_t kReportMaxLen = 2048;
+const size_t kMaxPendingReportBytes = 64UL * 1024UL * 1024UL;
 
 #ifdef DAVINCI_SUPPORT_PROFILING
-const size_t kReportMaxLen = 2048;
+const char *const kTaskDescInfoTag = "task_desc_info";
+const char *const kGraphDescInfoTag = "graph_desc_info";
+const size_t kMaxIntegerLen = 24;
+const uint64_t kDecimalBase = 10;
+
 const int32_t kMaxDeviceNum = 256;
 const std::string kConfigNumsdev = "devNums";
 const std::string kConfigDevIdList = "devIdList";
@@ -37,6 +45,31 @@ const std::string kProfStart = "prof_start";
 const std::string kProfStop = "prof_stop";
 const std::string kProfModelSubscribe = "prof_model_subscribe";
 const std::string kProfModelUnsubscribe = "prof_model_cancel_subscribe";
+
+// same text as std::to_string, without the temporary string
+void AppendInteger(std::string &str, int64_t value) {
+  char buf[kMaxIntegerLen];
+  char *end = buf + kMaxIntegerLen;
+  char *pos = end;
+  uint64_t abs_value = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+  do {
+    *--pos = static_cast<char>('0' + abs_value % kDecimalBase);
+    abs_value /= kDecimalBase;
+  } while (abs_value != 0);
+  if (value < 0) {
+    *--pos = '-';
+  }
+  str.append(pos, end - pos);
+}
+
+void AppendShape(std::string &str, const std::vector<int64_t> &shape) {
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (i != 0) {
+      str.push_back(',');
+    }
+    AppendInteger(str, shape[i]);
+  }
+}
 #endif
 }  // namespace
 
@@ -47,7 +80,9 @@ ProfilingManager::ProfilingManager()
   prof_cb_.msprofReporterCallback = nullptr;
 }
 
-ProfilingManager::~ProfilingManager() {}
+ProfilingManager::~ProfilingManager() {
+  StopReportThread();
+}
 
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ProfilingManager &ProfilingManager::Instance() {
   static ProfilingManager profiling_manager;
@@ -210,43 +245,27 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::Profilin
     uint32_t model_id, const std::vector<TaskDescInfo> &task_desc_info, const int32_t &device_id) {
 #ifdef DAVINCI_SUPPORT_PROFILING
   std::string data;
+  std::string line;
   for (const auto &task : task_desc_info) {
-    std::string model_name = task.model_name;
-    std::string op_name = task.op_name;
-    uint32_t block_dim = task.block_dim;
-    uint32_t task_id = task.task_id;
-    uint32_t stream_id = task.stream_id;
-    std::string shape_type = task.shape_type;
-    int64_t cur_iter_num = task.cur_iter_num;
-    uint32_t task_type = task.task_type;
-    data = model_name.append(" ")
-                     .append(op_name).append(" ")
-                     .append(std::to_string(block_dim)).append(" ")
-                     .append(std::to_string(task_id)).append(" ")
-                     .append(std::to_string(stream_id)).append(" ")
-                     .append(std::to_string(model_id)).append(" ")
-                     .append(shape_type).append(" ")
-                     .append(std::to_string(cur_iter_num)).append(" ")
-                     .append(std::to_string(task_type)).append("\n");
-
-    ReporterData reporter_data{};
-    reporter_data.deviceId = device_id;
-    reporter_data.data = (unsigned char *)data.c_str();
-    reporter_data.dataLen = data.size();
-    int ret = memcpy_s(reporter_data.tag, MSPROF_ENGINE_MAX_TAG_LEN + 1, "task_desc_info", sizeof("task_desc_info"));
-    if (ret != EOK) {
-      GELOGE(ret, "Report data tag of task_desc_info memcpy error!");
-      return;
-    }
-
-    int32_t cb_ret = CallMsprofReport(reporter_data);
-    if (cb_ret != 0) {
-      GELOGE(cb_ret, "Reporter data of task_desc_info failed, ret:%d", cb_ret);
-      return;
-    }
-  }
-
-  data.clear();
+    line.clear();
+    line.append(task.model_name).push_back(' ');
+    line.append(task.op_name).push_back(' ');
+    AppendInteger(line, task.block_dim);
+    line.push_back(' ');
+    AppendInteger(line, task.task_id);
+    line.push_back(' ');
+    AppendInteger(line, task.stream_id);
+    line.push_back(' ');
+    AppendInteger(line, model_id);
+    line.push_back(' ');
+    line.append(task.shape_type).push_back(' ');
+    AppendInteger(line, task.cur_iter_num);
+    line.push_back(' ');
+    AppendInteger(line, task.task_type);
+    line.push_back('\n');
+    AppendReportLine(device_id, kTaskDescInfoTag, line, data);
+  }
+  ReportData(device_id, kTaskDescInfoTag, std::move(data));
 #endif
 }
 
@@ -254,102 +273,141 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::Profilin
     uint32_t model_id, const std::vector<ComputeGraphDescInfo> &compute_graph_desc_info, const int32_t &device_id) {
 #ifdef DAVINCI_SUPPORT_PROFILING
   std::string data;
+  std::string line;
   for (const auto &graph : compute_graph_desc_info) {
-    data.append("model_name:")
+    line.clear();
+    line.append("model_name:")
         .append(graph.model_name)
         .append(" op_name:")
         .append(graph.op_name)
         .append(" op_type:")
         .append(graph.op_type);
     for (size_t i = 0; i < graph.input_format.size(); ++i) {
-      data.append(" input_id:")
-          .append(std::to_string(i))
-          .append(" input_format:")
-          .append(std::to_string(graph.input_format.at(i)))
-          .append(" input_data_type:")
-          .append(std::to_string(graph.input_data_type.at(i)))
-          .append(" input_shape:\"");
-      size_t input_shape_len = graph.input_shape.at(i).size();
-      if (input_shape_len == 0) {
-        data.append("");
-      } else if (input_shape_len == 1) {
-        data.append(std::to_string(graph.input_shape.at(i).at(0)));
-      } else {
-        for (size_t j = 0; j < input_shape_len - 1; ++j) {
-          data.append(std::to_string(graph.input_shape.at(i).at(j))).append(",");
-        }
-        data.append(std::to_string(graph.input_shape.at(i).at(input_shape_len - 1)));
-      }
-
-      data.append("\"");
+      line.append(" input_id:");
+      AppendInteger(line, i);
+      line.append(" input_format:");
+      AppendInteger(line, graph.input_format.at(i));
+      line.append(" input_data_type:");
+      AppendInteger(line, graph.input_data_type.at(i));
+      line.append(" input_shape:\"");
+      AppendShape(line, graph.input_shape.at(i));
+      line.push_back('"');
     }
 
     for (size_t i = 0; i < graph.output_format.size(); ++i) {
-      data.append(" output_id:")
-          .append(std::to_string(i))
-          .append(" output_format:")
-          .append(std::to_string(graph.output_format.at(i)))
-          .append(" output_data_type:")
-          .append(std::to_string(graph.output_data_type.at(i)))
-          .append(" output_shape:\"");
-      size_t output_shape_len = graph.output_shape.at(i).size();
-      if (output_shape_len == 0) {
-        data.append("");
-      } else if (output_shape_len == 1) {
-        data.append(std::to_string(graph.output_shape.at(i).at(0)));
-      } else {
-        for (size_t j = 0; j < output_shape_len - 1; ++j) {
-          data.append(std::to_string(graph.output_shape.at(i).at(j))).append(",");
-        }
-        data.append(std::to_string(graph.output_shape.at(i).at(output_shape_len - 1)));
-      }
-      data.append("\"");
-    }
-
-    data.append(" model_id:").append(std::to_string(model_id));
-    data.append(" task_id:").append(std::to_string(graph.task_id));
-    data.append(" stream_id:").append(std::to_string(graph.stream_id));
-    data.append("\n");
+      line.append(" output_id:");
+      AppendInteger(line, i);
+      line.append(" output_format:");
+      AppendInteger(line, graph.output_format.at(i));
+      line.append(" output_data_type:");
+      AppendInteger(line, graph.output_data_type.at(i));
+      line.append(" output_shape:\"");
+      AppendShape(line, graph.output_shape.at(i));
+      line.push_back('"');
+    }
+
+    line.append(" model_id:");
+    AppendInteger(line, model_id);
+    line.append(" task_id:");
+    AppendInteger(line, graph.task_id);
+    line.append(" stream_id:");
+    AppendInteger(line, graph.stream_id);
+    line.push_back('\n');
+    AppendReportLine(device_id, kGraphDescInfoTag, line, data);
+  }
+  ReportData(device_id, kGraphDescInfoTag, std::move(data));
+#endif
+}
 
-    GraphDescReport(device_id, data);
+void ProfilingManager::AppendReportLine(int32_t device_id, const char *tag, const std::string &line,
+                                        std::string &data) {
+  // lines are packed into reports of at most kReportMaxLen bytes, only a line longer than that is split
+  if (!data.empty() && (data.size() + line.size() > kReportMaxLen)) {
+    ReportData(device_id, tag, std::move(data));
     data.clear();
   }
-#endif
+  data.append(line);
 }
 
-void ProfilingManager::GraphDescReport(const int32_t &device_id, const string &data) {
-#ifdef DAVINCI_SUPPORT_PROFILING
+void ProfilingManager::ReportData(int32_t device_id, const char *tag, std::string &&data) {
+  if (data.empty()) {
+    return;
+  }
+  PendingReport report;
+  report.device_id = device_id;
+  report.tag = tag;
+  report.data = std::move(data);
+
+  std::unique_lock<std::mutex> lk(report_mutex_);
+  if (!report_thread_.joinable()) {
+    report_thread_stopped_ = false;
+    report_thread_ = std::thread([this]() { ReportThreadRun(); });
+  }
+  // bounded, producers wait for the reporter thread instead of reordering or dropping data
+  report_cv_.wait(lk, [this]() { return pending_report_bytes_ < kMaxPendingReportBytes; });
+  pending_report_bytes_ += report.data.size();
+  pending_reports_.emplace_back(std::move(report));
+  lk.unlock();
+  report_cv_.notify_all();
+}
+
+void ProfilingManager::ReportThreadRun() {
+  std::unique_lock<std::mutex> lk(report_mutex_);
+  while (true) {
+    report_cv_.wait(lk, [this]() { return report_thread_stopped_ || !pending_reports_.empty(); });
+    if (pending_reports_.empty()) {
+      return;
+    }
+    std::deque<PendingReport> reports;
+    reports.swap(pending_reports_);
+    reporting_ = true;
+    lk.unlock();
+    size_t reported_bytes = 0;
+    for (auto &report : reports) {
+      SendReport(report);
+      reported_bytes += report.data.size();
+    }
+    lk.lock();
+    reporting_ = false;
+    pending_report_bytes_ -= reported_bytes;
+    report_cv_.notify_all();
+  }
+}
+
+void ProfilingManager::SendReport(const PendingReport &report) const {
   ReporterData reporter_data{};
-  int ret = -1;
-  int32_t cb_ret = -1;
-  size_t index = data.size() / kReportMaxLen;
-  if (index >= 1) {
-    reporter_data.deviceId = device_id;
-    ret = memcpy_s(reporter_data.tag, MSPROF_ENGINE_MAX_TAG_LEN + 1, "graph_desc_info", sizeof("graph_desc_info"));
-    GE_IF_BOOL_EXEC(ret != EOK, GELOGE(ret, "Report data tag of graph_desc_info memcpy error!"); return;);
-    for (size_t i = 0; i < index; ++i) {
-      reporter_data.data = (unsigned char *)data.c_str() + kReportMaxLen * i;
-      reporter_data.dataLen = kReportMaxLen;
-      cb_ret = CallMsprofReport(reporter_data);
-      GE_IF_BOOL_EXEC(cb_ret != 0, GELOGE(cb_ret, "Reporter data of graph_desc_info failed, ret:%d", cb_ret); return;);
-    }
-    reporter_data.dataLen = data.size() - kReportMaxLen * index;
-    if (reporter_data.dataLen != 0) {
-      reporter_data.data = (unsigned char *)data.c_str() + kReportMaxLen * index;
-      cb_ret = CallMsprofReport(reporter_data);
-      GE_IF_BOOL_EXEC(cb_ret != 0, GELOGE(cb_ret, "Reporter data of graph_desc_info failed, ret:%d", cb_ret); return;);
+  reporter_data.deviceId = report.device_id;
+  int ret = memcpy_s(reporter_data.tag, MSPROF_ENGINE_MAX_TAG_LEN + 1, report.tag.c_str(), report.tag.size() + 1);
+  if (ret != EOK) {
+    GELOGE(ret, "Report data tag of %s memcpy error!", report.tag.c_str());
+    return;
+  }
+  const auto &data = report.data;
+  for (size_t offset = 0; offset < data.size(); offset += kReportMaxLen) {
+    reporter_data.data = (unsigned char *)data.c_str() + offset;
+    reporter_data.dataLen = std::min(kReportMaxLen, data.size() - offset);
+    int32_t cb_ret = CallMsprofReport(reporter_data);
+    if (cb_ret != 0) {
+      GELOGE(cb_ret, "Reporter data of %s failed, ret:%d", report.tag.c_str(), cb_ret);
+      return;
     }
-  } else {
-    reporter_data.deviceId = device_id;
-    reporter_data.data = (unsigned char *)data.c_str();
-    reporter_data.dataLen = data.size();
-    ret = memcpy_s(reporter_data.tag, MSPROF_ENGINE_MAX_TAG_LEN + 1, "graph_desc_info", sizeof("graph_desc_info"));
-    GE_IF_BOOL_EXEC(ret != EOK, GELOGE(ret, "Report data tag of graph_desc_info memcpy error!"); return;);
+  }
+}
+
+void ProfilingManager::FlushReports() {
+  std::unique_lock<std::mutex> lk(report_mutex_);
+  report_cv_.wait(lk, [this]() { return pending_reports_.empty() && !reporting_; });
+}
 
-    cb_ret = CallMsprofReport(reporter_data);
-    GE_IF_BOOL_EXEC(cb_ret != 0, GELOGE(cb_ret, "Reporter data of graph_desc_info failed, ret:%d", cb_ret); return;);
+void ProfilingManager::StopReportThread() {
+  {
+    std::lock_guard<std::mutex> lk(report_mutex_);
+    report_thread_stopped_ = true;
+  }
+  report_cv_.notify_all();
+  if (report_thread_.joinable()) {
+    report_thread_.join();
   }
-#endif
 }
 
 FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::ReportProfilingData(
@@ -785,8 +843,10 @@ FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY Status ProfilingManager::Plugin
       nullptr, 0);
 }
 
-FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::PluginUnInit() const {
+FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY void ProfilingManager::PluginUnInit() {
 #ifdef DAVINCI_SUPPORT_PROFILING
+  // reports still queued must reach the reporter before it is uninitialized
+  FlushReports();
   if (prof_cb_.msprofReporterCallback == nullptr) {
     GELOGE(ge::PARAM_INVALID, "MsprofReporterCallback callback is nullptr.");
     return;
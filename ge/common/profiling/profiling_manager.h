@@ -18,9 +18,12 @@
 #define GE_COMMON_PROFILING_PROFILING_MANAGER_H_
 
 #include <nlohmann/json.hpp>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "framework/common/ge_inner_error_codes.h"
@@ -89,7 +92,7 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ProfilingManager {
   void ProfilingGraphDescInfo(uint32_t model_id, const std::vector<ComputeGraphDescInfo> &compute_graph_desc_info,
                               const int32_t &device_id);
   Status PluginInit() const;
-  void PluginUnInit() const;
+  void PluginUnInit();
   Status CallMsprofReport(ReporterData &reporter_data) const;
   struct MsprofCallback &GetMsprofCallback() { return prof_cb_; }
   void SetMsprofCtrlCallback(MsprofCtrlCallback func) { prof_cb_.msprofCtrlCallback = func; }
@@ -103,7 +106,19 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ProfilingManager {
   Status ProfParseDeviceId(const std::map<std::string, std::string> &config_para,
                                vector<int32_t> &device_list);
   uint64_t GetProfilingModule();
-  void GraphDescReport(const int32_t &device_id, const string &data);
+  // Text reports are packed by line and handed to a reporter thread, which feeds msprof in pieces of at most 2KB.
+  // Producers only block when too many bytes are pending, pending reports are flushed before plugin uninit.
+  struct PendingReport {
+    int32_t device_id = 0;
+    std::string tag;
+    std::string data;
+  };
+  void AppendReportLine(int32_t device_id, const char *tag, const std::string &line, std::string &data);
+  void ReportData(int32_t device_id, const char *tag, std::string &&data);
+  void ReportThreadRun();
+  void SendReport(const PendingReport &report) const;
+  void FlushReports();
+  void StopReportThread();
   void UpdateDeviceIdModuleMap(string prof_type, uint64_t module, const vector<int32_t> &device_list);
   void UpdateSubscribeDeviceModuleMap(std::string prof_type, uint32_t device_id, uint64_t module);
 
@@ -118,6 +133,13 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY ProfilingManager {
   MsprofCallback prof_cb_;
   std::string fp_point_;
   std::string bp_point_;
+  std::mutex report_mutex_;
+  std::condition_variable report_cv_;
+  std::deque<PendingReport> pending_reports_;
+  size_t pending_report_bytes_ = 0;
+  bool reporting_ = false;
+  bool report_thread_stopped_ = false;
+  std::thread report_thread_;
 };
 }  // namespace ge
 #endif  // GE_COMMON_PROFILING_PROFILING_MANAGER_H_
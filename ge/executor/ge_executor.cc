@@ -24,6 +24,7 @@
 #include "common/helper/model_helper.h"
 #include "common/profiling/profiling_manager.h"
 #include "common/dump/dump_manager.h"
+#include "common/dump/dump_writer.h"
 #include "common/util.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/util.h"
@@ -249,6 +250,11 @@ Status GeExecutor::Finalize() {
 
   (void) OpsKernelBuilderManager::Instance().Finalize();
 
+  // dump files are written in background, make sure they are complete
+  if (DumpWriter::GetInstance().Flush() != SUCCESS) {
+    GELOGW("Dump writer failed to write some dump files.");
+  }
+
   // Stop profiling
   if (ProfilingManager::Instance().ProfilingOn()) {
     ProfilingManager::Instance().StopProfiling();
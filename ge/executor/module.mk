@@ -5,6 +5,7 @@ local_ge_executor_src_files :=  \
     ../common/profiling/profiling_manager.cc \
     ../common/dump/dump_properties.cc \
     ../common/dump/dump_manager.cc \
+    ../common/dump/dump_writer.cc \
     ../common/dump/dump_op.cc \
     ../common/ge/plugin_manager.cc \
     ../common/ge/op_tiling_manager.cc \
@@ -67,6 +68,8 @@ local_ge_executor_src_files :=  \
     ../graph/common/local_context.cc \
     ../hybrid/common/tensor_value.cc                                        \
     ../hybrid/common/npu_memory_allocator.cc                                \
+    ../hybrid/common/memory_arena.cc                                        \
+    ../hybrid/common/pinned_host_memory_pool.cc                             \
     ../hybrid/executor/rt_callback_manager.cc                               \
     ../hybrid/executor/node_state.cc                                        \
     ../hybrid/executor/node_done_manager.cc                                 \
@@ -76,8 +79,11 @@ local_ge_executor_src_files :=  \
     ../hybrid/executor/hybrid_execution_context.cc                          \
     ../hybrid/executor/subgraph_context.cc                                  \
     ../hybrid/executor/subgraph_executor.cc                                 \
+    ../hybrid/executor/multi_stream_plan.cc                                 \
+    ../hybrid/executor/subgraph_executor_pool.cc                            \
     ../hybrid/executor/worker/task_compile_engine.cc                        \
     ../hybrid/executor/worker/shape_inference_engine.cc                     \
+    ../hybrid/executor/worker/shape_inference_cache.cc                      \
     ../hybrid/executor/worker/execution_engine.cc                           \
     ../hybrid/model/hybrid_model.cc                                         \
     ../hybrid/model/hybrid_model_builder.cc                                 \
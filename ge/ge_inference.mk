@@ -28,6 +28,7 @@ COMMON_LOCAL_SRC_FILES := \
     common/profiling/profiling_manager.cc \
     common/dump/dump_properties.cc \
     common/dump/dump_manager.cc \
+    common/dump/dump_writer.cc \
     common/dump/dump_op.cc \
     common/dump/dump_server.cc \
     common/helper/model_cache_helper.cc \
@@ -45,10 +46,12 @@ GRAPH_MANAGER_LOCAL_SRC_FILES := \
     opskernel_manager/ops_kernel_builder_manager.cc \
     graph/manager/graph_manager.cc \
     graph/manager/graph_manager_utils.cc \
+    graph/manager/subgraph_optimize_scheduler.cc \
     graph/manager/graph_context.cc \
     graph/preprocess/graph_preprocess.cc \
     graph/preprocess/multi_batch_options.cc \
     graph/preprocess/multi_batch_copy_graph.cc \
+    graph/preprocess/multi_batch_branch_cloner.cc \
     graph/execute/graph_execute.cc \
     graph/load/graph_loader.cc \
     graph/optimize/graph_optimize.cc \
@@ -117,6 +120,7 @@ OMG_HOST_SRC_FILES := \
     graph/passes/mark_agnostic_pass.cc \
     graph/common/omg_util.cc \
     graph/common/bcast.cc \
+    graph/common/folding_cache.cc \
     graph/common/local_context.cc \
     graph/passes/dimension_compute_pass.cc \
     graph/passes/dimension_adjust_pass.cc \
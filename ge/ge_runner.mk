@@ -27,6 +27,7 @@ LIBGE_LOCAL_SRC_FILES := \
     common/helper/model_cache_helper.cc \
     common/profiling/profiling_manager.cc \
     common/dump/dump_manager.cc \
+    common/dump/dump_writer.cc \
     common/dump/dump_properties.cc \
     common/dump/dump_op.cc \
     common/profiling/ge_profiling.cc \
@@ -44,6 +45,7 @@ LIBGE_LOCAL_SRC_FILES := \
     graph/build/stream_graph_optimizer.cc \
     graph/build/task_generator.cc \
     graph/common/bcast.cc \
+    graph/common/folding_cache.cc \
     graph/common/local_context.cc \
     graph/common/omg_util.cc \
     graph/common/transop_util.cc \
@@ -89,6 +91,7 @@ LIBGE_LOCAL_SRC_FILES := \
     graph/manager/graph_context.cc \
     graph/manager/graph_manager.cc \
     graph/manager/graph_manager_utils.cc \
+    graph/manager/subgraph_optimize_scheduler.cc \
     graph/manager/graph_mem_allocator.cc \
     graph/manager/graph_caching_allocator.cc \
     graph/manager/graph_var_manager.cc \
@@ -251,6 +254,7 @@ LIBGE_LOCAL_SRC_FILES := \
     graph/preprocess/insert_op/util_insert_aipp_op.cc \
     graph/preprocess/multi_batch_options.cc \
     graph/preprocess/multi_batch_copy_graph.cc \
+    graph/preprocess/multi_batch_branch_cloner.cc \
     init/gelib.cc \
     model/ge_model.cc \
     model/ge_root_model.cc \
@@ -270,6 +274,8 @@ LIBGE_LOCAL_SRC_FILES := \
     single_op/task/aicpu_kernel_task_builder.cc \
     hybrid/common/tensor_value.cc                                        \
     hybrid/common/npu_memory_allocator.cc                                \
+    hybrid/common/memory_arena.cc                                        \
+    hybrid/common/pinned_host_memory_pool.cc                             \
     hybrid/executor/rt_callback_manager.cc                               \
     hybrid/executor/node_state.cc                                        \
     hybrid/executor/node_done_manager.cc                                 \
@@ -279,8 +285,11 @@ LIBGE_LOCAL_SRC_FILES := \
     hybrid/executor/hybrid_execution_context.cc                          \
     hybrid/executor/subgraph_context.cc                                  \
     hybrid/executor/subgraph_executor.cc                                 \
+    hybrid/executor/multi_stream_plan.cc                                 \
+    hybrid/executor/subgraph_executor_pool.cc                            \
     hybrid/executor/worker/task_compile_engine.cc                        \
     hybrid/executor/worker/shape_inference_engine.cc                     \
+    hybrid/executor/worker/shape_inference_cache.cc                      \
     hybrid/executor/worker/execution_engine.cc                           \
     hybrid/model/hybrid_model.cc                                         \
     hybrid/model/hybrid_model_builder.cc                                 \
@@ -15,14 +15,20 @@
  */
 
 #include "graph/build/graph_builder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <set>
 #include "graph/build/memory/graph_mem_assigner.h"
 #include "common/ge/ge_util.h"
 #include "common/helper/model_helper.h"
+#include "common/thread_pool.h"
 #include "graph/build/logical_stream_allocator.h"
 #include "graph/build/run_context.h"
 #include "graph/build/stream_graph_optimizer.h"
 #include "graph/common/ge_call_wrapper.h"
+#include "graph/common/local_context.h"
 #include "graph/ge_context.h"
+#include "graph/ge_local_context.h"
 #include "graph/manager/graph_var_manager.h"
 #include "graph/passes/mark_same_addr_pass.h"
 #include "graph/utils/node_utils.h"
@@ -32,6 +38,7 @@
 #include "graph/ge_context.h"
 #include "opskernel_manager/ops_kernel_builder_manager.h"
 #include "graph/utils/op_desc_utils.h"
+#include "runtime/rt.h"
 
 using domi::BuildMode;
 
@@ -39,6 +46,7 @@ namespace {
 const int32_t kInvalidPerfLevel = -1;
 const int64_t kProfilingArStep = 2;
 const int64_t kProfilingArStartLogid = 3;
+const char *const kEnvBuildParallelNum = "SUBGRAPH_BUILD_PARALLEL_NUM";
 enum NodeType { kSubgraphData, kSubgraphNode, kOthers };
 }  // namespace
 namespace ge {
@@ -140,15 +148,16 @@ Status GraphBuilder::CalcOpParam(const ge::ComputeGraphPtr &graph) {
     }
     GE_CHK_STATUS_RET(AddOutputMemTypeForNode(node_ptr));
   }
+  GELOGI("Success to calculate op running param.");
+  return SUCCESS;
+}
 
-  auto parent_node = graph->GetParentNode();
+Status GraphBuilder::UpdateParentNodeOfSubgraph(const ge::ComputeGraphPtr &sub_graph) {
+  auto parent_node = sub_graph->GetParentNode();
   if (parent_node == nullptr) {
     return SUCCESS;
   }
-
-  GE_CHK_STATUS_RET(UpdateParentNodeOutputSize(graph, parent_node));
-  GELOGI("Success to calculate op running param.");
-  return SUCCESS;
+  return UpdateParentNodeOutputSize(sub_graph, parent_node);
 }
 
 Status GraphBuilder::UpdateParentNodeOutputSize(const ge::ComputeGraphPtr &graph, ge::NodePtr &parent_node_ptr) {
@@ -216,16 +225,19 @@ Status GraphBuilder::Build(ComputeGraphPtr &comp_graph, GeRootModelPtr &ge_root_
 }
 
 Status GraphBuilder::BuildForKnownShapeGraph(ComputeGraphPtr &comp_graph,
-                                             GeModelPtr &ge_model_ptr, uint64_t session_id) {
+                                             GeModelPtr &ge_model_ptr, uint64_t session_id,
+                                             GraphPartitioner *graph_partitioner) {
   if (ge::GetContext().GetHostExecFlag()) {
     GE_CHK_STATUS_RET(BuildForHostCpuGraph(comp_graph, ge_model_ptr, session_id), "Build for host-cpu graph failed.");
     return SUCCESS;
   }
 
   GELOGI("Begin to build known shape graph[%s].", comp_graph->GetName().c_str());
-  Status ret = SecondPartition(comp_graph);
+  // subgraphs built in parallel own their partitioners
+  auto &partitioner = graph_partitioner != nullptr ? *graph_partitioner : graph_partitioner_;
+  Status ret = SecondPartition(comp_graph, partitioner);
   GE_CHK_STATUS_RET(ret, "Graph[%s] second partition Failed.", comp_graph->GetName().c_str());
-  auto subgraph_map = graph_partitioner_.GetSubGraphMap();
+  auto subgraph_map = partitioner.GetSubGraphMap();
 
   GE_TIMESTAMP_START(BuildSubgraph);
   ge::ModelBuilder builder(session_id, comp_graph, subgraph_map, stream_max_parallel_num_, hcom_parallel_, build_mode_);
@@ -393,6 +405,15 @@ static Status InsertMemcpyNode(const ComputeGraphPtr &graph, const OutDataAnchor
   return SUCCESS;
 }
 
+static uint32_t GetBuildParallelNum() {
+  const char *parallel_num_str = std::getenv(kEnvBuildParallelNum);
+  if (parallel_num_str == nullptr) {
+    return 1;
+  }
+  int parallel_num = std::atoi(parallel_num_str);
+  return parallel_num > 1 ? static_cast<uint32_t>(parallel_num) : 1;
+}
+
 static Status GenerateTaskForConstant(const std::shared_ptr<ComputeGraph> &graph) {
   for (auto &node : graph->GetDirectNode()) {
     // CONSTANT not generate task, so insert IDENTITY between CONSTANT and NETOUTPUT
@@ -424,6 +445,47 @@ static Status GenerateTaskForConstant(const std::shared_ptr<ComputeGraph> &graph
   return SUCCESS;
 }
 
+// functional subgraphs in known subgraph are built with their parent graph
+static bool IsBuiltWithParentGraph(const ComputeGraphPtr &root_graph, const ComputeGraphPtr &sub_graph) {
+  return sub_graph->GetParentGraph() != nullptr && sub_graph->GetParentGraph() != root_graph &&
+         !sub_graph->GetParentGraph()->GetGraphUnknownFlag();
+}
+
+// in parallel build, parent nodes are updated after all subgraphs are built. it is the same as serial build
+// only if every parent graph is built before its subgraphs, as building the parent graph reads its nodes
+static bool IsAnyBuiltBeforeParentGraph(const ComputeGraphPtr &root_graph,
+                                        const std::vector<ComputeGraphPtr> &all_graphs) {
+  std::set<ComputeGraph *> built_graphs;
+  for (const auto &sub_graph : all_graphs) {
+    if (IsBuiltWithParentGraph(root_graph, sub_graph)) {
+      continue;
+    }
+    auto parent_graph = sub_graph->GetParentGraph();
+    if ((parent_graph != nullptr) && (parent_graph != root_graph) && (built_graphs.count(parent_graph.get()) == 0)) {
+      GELOGD("Graph[%s] is built before its parent graph[%s].", sub_graph->GetName().c_str(),
+             parent_graph->GetName().c_str());
+      return true;
+    }
+    built_graphs.emplace(sub_graph.get());
+  }
+  return false;
+}
+
+static Status PrepareSubgraphForBuild(const ComputeGraphPtr &root_graph, const ComputeGraphPtr &sub_graph) {
+  GE_CHK_STATUS_RET(GenerateTaskForConstant(sub_graph), "Generate task For constant node in subgraph failed.");
+  if (sub_graph->GetGraphUnknownFlag()) {
+    return SUCCESS;
+  }
+  // reset functional subgraph parent graph as known subgraph
+  for (const auto &node : sub_graph->GetDirectNode()) {
+    for (const auto &sub_graph_name : node->GetOpDesc()->GetSubgraphInstanceNames()) {
+      auto sub_sub_graph = root_graph->GetSubgraph(sub_graph_name);
+      GE_CHK_STATUS_RET(sub_graph->AddSubgraph(sub_sub_graph), "Failed add subgraph to known graph.");
+    }
+  }
+  return SUCCESS;
+}
+
 Status GraphBuilder::MarkFpBpProfilingTaskAttr(ComputeGraphPtr &com_graph) {
   bool original_unknown_shape_flag = com_graph->GetGraphUnknownFlag();
   com_graph->SetGraphUnknownFlag(false);
@@ -500,34 +562,114 @@ Status GraphBuilder::BuildForDynamicShapeGraph(ComputeGraphPtr &comp_graph,
   if (all_graphs.empty()) {
     all_graphs.push_back(comp_graph);
   }
+  uint32_t parallel_num = GetBuildParallelNum();
+  if ((parallel_num > 1) && IsAnyBuiltBeforeParentGraph(comp_graph, all_graphs)) {
+    GELOGI("Subgraph is built before its parent graph, build serially to keep the updates of parent nodes.");
+    parallel_num = 1;
+  }
+  if (parallel_num <= 1) {
+    for (auto &sub_graph : all_graphs) {
+      if (IsBuiltWithParentGraph(comp_graph, sub_graph)) {
+        continue;
+      }
+      GE_CHK_STATUS_RET_NOLOG(PrepareSubgraphForBuild(comp_graph, sub_graph));
+      GE_CHK_STATUS_RET_NOLOG(BuildSubgraph(sub_graph, ge_model_ptr, session_id, nullptr));
+      GE_CHK_STATUS_RET_NOLOG(UpdateParentNodeOfSubgraph(sub_graph));
+      ge_root_model_ptr->SetSubgraphInstanceNameToModel(sub_graph->GetName(), ge_model_ptr);
+    }
+    return SUCCESS;
+  }
+
+  // graph modifications are done before building
+  std::vector<ComputeGraphPtr> sub_graphs;
   for (auto &sub_graph : all_graphs) {
-    // exclude functional subgraph in known subgraph
-    if (sub_graph->GetParentGraph() != nullptr && sub_graph->GetParentGraph() != comp_graph &&
-        !sub_graph->GetParentGraph()->GetGraphUnknownFlag()) {
+    if (IsBuiltWithParentGraph(comp_graph, sub_graph)) {
       continue;
     }
+    GE_CHK_STATUS_RET_NOLOG(PrepareSubgraphForBuild(comp_graph, sub_graph));
+    sub_graphs.emplace_back(sub_graph);
+  }
+  std::vector<GeModelPtr> ge_models(sub_graphs.size());
+  GE_CHK_STATUS_RET_NOLOG(BuildSubgraphsInParallel(sub_graphs, ge_models, session_id, parallel_num));
+  // parent nodes belong to other graphs, they are updated and models are merged in the order of serial build
+  for (size_t i = 0; i < sub_graphs.size(); ++i) {
+    GE_CHK_STATUS_RET_NOLOG(UpdateParentNodeOfSubgraph(sub_graphs[i]));
+    ge_root_model_ptr->SetSubgraphInstanceNameToModel(sub_graphs[i]->GetName(), ge_models[i]);
+    ge_model_ptr = ge_models[i];
+  }
+  return SUCCESS;
+}
 
-    GE_CHK_STATUS_RET(GenerateTaskForConstant(sub_graph), "Generate task For constant node in subgraph failed.");
-
-    if (sub_graph->GetGraphUnknownFlag()) {
-      // unknown shape build flow
-      GE_CHK_STATUS_RET(BuildForUnknownShapeGraph(sub_graph, ge_model_ptr, session_id),
-                        "Build for unknown shape graph failed.");
-    } else {
-      // reset functional subgraph parent graph as known subgraph
-      for (const auto &node : sub_graph->GetDirectNode()) {
-        for (const auto &sub_graph_name : node->GetOpDesc()->GetSubgraphInstanceNames()) {
-          auto sub_sub_graph = comp_graph->GetSubgraph(sub_graph_name);
-          GE_CHK_STATUS_RET(sub_graph->AddSubgraph(sub_sub_graph), "Failed add subgraph to known graph.");
+Status GraphBuilder::BuildSubgraph(ComputeGraphPtr &sub_graph, GeModelPtr &ge_model_ptr, uint64_t session_id,
+                                   GraphPartitioner *graph_partitioner) {
+  if (sub_graph->GetGraphUnknownFlag()) {
+    // unknown shape build flow
+    GE_CHK_STATUS_RET(BuildForUnknownShapeGraph(sub_graph, ge_model_ptr, session_id),
+                      "Build for unknown shape graph failed.");
+  } else {
+    // known shape build flow
+    GE_CHK_STATUS_RET(BuildForKnownShapeGraph(sub_graph, ge_model_ptr, session_id, graph_partitioner),
+                      "Build for known shape graph failed.");
+  }
+  return SUCCESS;
+}
+
+Status GraphBuilder::BuildSubgraphsInParallel(std::vector<ComputeGraphPtr> &sub_graphs,
+                                              std::vector<GeModelPtr> &ge_models,
+                                              uint64_t session_id, uint32_t parallel_num) {
+  // submit the biggest subgraphs first, so that they do not lengthen the build
+  std::vector<size_t> build_order(sub_graphs.size());
+  for (size_t i = 0; i < build_order.size(); ++i) {
+    build_order[i] = i;
+  }
+  std::stable_sort(build_order.begin(), build_order.end(), [&sub_graphs](size_t lhs, size_t rhs) {
+    return sub_graphs[lhs]->GetAllNodesSize() > sub_graphs[rhs]->GetAllNodesSize();
+  });
+
+  parallel_num = std::min(parallel_num, static_cast<uint32_t>(sub_graphs.size()));
+  GEEVENT("Build %zu subgraphs with %u threads.", sub_graphs.size(), parallel_num);
+  uint64_t start_time = GetCurrentTimestamp();
+  OmgContext &omg_context = GetLocalOmgContext();
+  // engines and memory assignment may call runtime, the build threads share the rt context of the caller
+  rtContext_t rt_context = nullptr;
+  if (rtCtxGetCurrent(&rt_context) != RT_ERROR_NONE) {
+    GELOGD("No rt context to share with build threads.");
+    rt_context = nullptr;
+  }
+  std::vector<std::future<Status>> futures(sub_graphs.size());
+  {
+    ThreadPool thread_pool(parallel_num);
+    for (auto index : build_order) {
+      auto &sub_graph = sub_graphs[index];
+      auto &ge_model = ge_models[index];
+      futures[index] = thread_pool.commit([this, &sub_graph, &ge_model, &omg_context, session_id, rt_context](
+          const GEThreadLocalContext &ge_context) -> Status {
+        if (rt_context != nullptr) {
+          GE_CHK_RT_RET(rtCtxSetCurrent(rt_context));
         }
+        GetThreadLocalContext() = ge_context;
+        SetLocalOmgContext(omg_context);
+        GraphPartitioner graph_partitioner;
+        return BuildSubgraph(sub_graph, ge_model, session_id, &graph_partitioner);
+      }, GetThreadLocalContext());
+    }
+    // wait for all tasks before return, they refer to subgraphs and models on stack
+    Status ret = SUCCESS;
+    for (size_t i = 0; i < futures.size(); ++i) {
+      if (!futures[i].valid()) {
+        GELOGE(FAILED, "Failed to submit build task of graph[%s].", sub_graphs[i]->GetName().c_str());
+        ret = (ret == SUCCESS) ? FAILED : ret;
+        continue;
+      }
+      Status build_ret = futures[i].get();
+      if ((build_ret != SUCCESS) && (ret == SUCCESS)) {
+        GELOGE(build_ret, "Failed to build graph[%s].", sub_graphs[i]->GetName().c_str());
+        ret = build_ret;
       }
-      // known shape build flow
-      GE_CHK_STATUS_RET(BuildForKnownShapeGraph(sub_graph, ge_model_ptr, session_id),
-                        "Build for known shape graph failed.");
     }
-    ge_root_model_ptr->SetSubgraphInstanceNameToModel(sub_graph->GetName(), ge_model_ptr);
+    GE_CHK_STATUS_RET_NOLOG(ret);
   }
-
+  GEEVENT("Build %zu subgraphs cost %lu us.", sub_graphs.size(), GetCurrentTimestamp() - start_time);
   return SUCCESS;
 }
 
@@ -724,15 +866,15 @@ Status GraphBuilder::CalcDynShapeRootGraphDataSize(const ge::OpDescPtr &op_desc)
   return SUCCESS;
 }
 
-Status GraphBuilder::SecondPartition(ge::ComputeGraphPtr &comp_graph) {
+Status GraphBuilder::SecondPartition(ge::ComputeGraphPtr &comp_graph, GraphPartitioner &graph_partitioner) {
   GE_TIMESTAMP_START(GraphPartition2);
-  auto ret = graph_partitioner_.Partition(comp_graph, GraphPartitioner::kSecondPartitioning);
+  auto ret = graph_partitioner.Partition(comp_graph, GraphPartitioner::kSecondPartitioning);
   if (ret != SUCCESS) {
     GELOGE(ret, "Graph partition Failed");
     return ret;
   }
   GE_CHK_STATUS_RET(ret, "Graph partition Failed.");
-  const auto &graph_2_subgraphlist = graph_partitioner_.GetSubGraphMap();
+  const auto &graph_2_subgraphlist = graph_partitioner.GetSubGraphMap();
   if (graph_2_subgraphlist.find(comp_graph) == graph_2_subgraphlist.end()) {
     GELOGE(FAILED, "Find subgraph failed.");
     return FAILED;
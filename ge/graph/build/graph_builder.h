@@ -57,14 +57,21 @@ class GraphBuilder {
   Status SetInputSize(const ge::NodePtr &node_ptr);
   Status UpdateDataInputSize(const ge::NodePtr &node_ptr);
   Status UpdateParentNodeOutputSize(const ge::ComputeGraphPtr &graph, ge::NodePtr &parent_node_ptr);
+  Status UpdateParentNodeOfSubgraph(const ge::ComputeGraphPtr &sub_graph);
   Status CalcDynShapeRootGraphDataSize(const ge::OpDescPtr &op_desc);
-  Status SecondPartition(ge::ComputeGraphPtr &comp_graph);
+  Status SecondPartition(ge::ComputeGraphPtr &comp_graph, GraphPartitioner &graph_partitioner);
   Status MarkFpBpProfilingTaskAttr(ComputeGraphPtr &com_graph);
   Status BuildForDynamicShapeGraph(ComputeGraphPtr &comp_graph,
                                    GeRootModelPtr &ge_root_model_ptr, GeModelPtr &ge_model_ptr,
                                    uint64_t session_id = INVALID_SESSION_ID);
   Status BuildForKnownShapeGraph(ComputeGraphPtr &comp_graph,
-                                 GeModelPtr &ge_model_ptr, uint64_t session_id = INVALID_SESSION_ID);
+                                 GeModelPtr &ge_model_ptr, uint64_t session_id = INVALID_SESSION_ID,
+                                 GraphPartitioner *graph_partitioner = nullptr);
+  // only touches nodes of sub_graph, parent node is updated by UpdateParentNodeOfSubgraph afterwards
+  virtual Status BuildSubgraph(ComputeGraphPtr &sub_graph, GeModelPtr &ge_model_ptr, uint64_t session_id,
+                               GraphPartitioner *graph_partitioner);
+  Status BuildSubgraphsInParallel(std::vector<ComputeGraphPtr> &sub_graphs, std::vector<GeModelPtr> &ge_models,
+                                  uint64_t session_id, uint32_t parallel_num);
   Status BuildForUnknownShapeGraph(ComputeGraphPtr &comp_graph, GeModelPtr &ge_model_ptr,
                                    uint64_t session_id = INVALID_SESSION_ID);
   Status SetConstantInputOffset(ComputeGraphPtr &comp_graph);
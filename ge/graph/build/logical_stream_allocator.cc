@@ -15,6 +15,7 @@
  */
 
 #include "graph/build/logical_stream_allocator.h"
+#include <algorithm>
 #include <queue>
 #include "common/ge/ge_util.h"
 #include "framework/common/debug/ge_log.h"
@@ -22,6 +23,7 @@
 #include "framework/common/types.h"
 #include "graph/debug/ge_attr_define.h"
 #include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
 #include "graph/common/ge_call_wrapper.h"
 
 using std::map;
@@ -297,6 +299,255 @@ void AssignByDependencyPass::UpdateReusedSubgraphs() {
   }
 }
 
+namespace {
+// Cost of a node is the bytes it touches in units of kCostUnitBytes, plus the cost of launching it.
+// Cube ops take several times longer than vector ops with the same tensor sizes.
+const int64_t kCostUnitBytes = 1024;
+const int64_t kLaunchCost = 1;
+const int64_t kCubeOpFactor = 8;
+
+int64_t GetTensorBytes(const GeTensorDesc &tensor_desc) {
+  int64_t size = 0;
+  if ((TensorUtils::GetSize(tensor_desc, size) == GRAPH_SUCCESS) && (size > 0)) {
+    return size;
+  }
+  int64_t shape_size = tensor_desc.GetShape().GetShapeSize();
+  int type_size = GetSizeByDataType(tensor_desc.GetDataType());
+  return (shape_size > 0 && type_size > 0) ? shape_size * type_size : 0;
+}
+}  // namespace
+
+int64_t CriticalPathStreamPass::EstimateNodeCost(const NodePtr &node) {
+  static const set<string> kCubeOpTypes = {CONVOLUTION, DECONVOLUTION, FULL_CONNECTION, MATMUL, BATCHMATMUL,
+                                           CONV2DBACKPROPINPUT, "Conv2D", "Conv2DBackpropFilter", "MatMulV2",
+                                           "BatchMatMulV2", "DepthwiseConv2D"};
+  const auto &op_desc = node->GetOpDesc();
+  if ((op_desc == nullptr) || (node->GetType() == "PlaceHolder") || (node->GetType() == "End")) {
+    return 0;
+  }
+  int64_t bytes = 0;
+  for (const auto &tensor_desc : op_desc->GetAllInputsDescPtr()) {
+    bytes += (tensor_desc == nullptr) ? 0 : GetTensorBytes(*tensor_desc);
+  }
+  for (const auto &tensor_desc : op_desc->GetAllOutputsDescPtr()) {
+    bytes += (tensor_desc == nullptr) ? 0 : GetTensorBytes(*tensor_desc);
+  }
+  int64_t factor = (kCubeOpTypes.count(node->GetType()) > 0) ? kCubeOpFactor : 1;
+  return kLaunchCost + bytes / kCostUnitBytes * factor;
+}
+
+int64_t CriticalPathStreamPass::EstimateCost(const Subgraph &subgraph) const {
+  // nodes of skipped engines do not run on device streams
+  auto compute_graph = subgraph.subgraph_info.GetSubGraph();
+  if (IsEngineSkip(subgraph) || (compute_graph == nullptr)) {
+    return 0;
+  }
+  int64_t cost = 0;
+  for (const auto &node : compute_graph->GetDirectNode()) {
+    cost += EstimateNodeCost(node);
+  }
+  return cost;
+}
+
+bool CriticalPathStreamPass::InitDependencies(const vector<SubgraphPtr> &subgraphs) {
+  map<NodePtr, size_t> end_subgraph_map;
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    for (const auto &item : subgraphs[i]->subgraph_info.GetEnd2PldMap()) {
+      end_subgraph_map.emplace(item.first, i);
+    }
+  }
+
+  preds_.assign(subgraphs.size(), vector<size_t>());
+  succs_.assign(subgraphs.size(), vector<size_t>());
+  vector<size_t> in_degrees(subgraphs.size(), 0);
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    set<size_t> preds;
+    for (const auto &item : subgraphs[i]->subgraph_info.GetPld2EndMap()) {
+      auto iter = end_subgraph_map.find(item.second);
+      if ((iter != end_subgraph_map.end()) && (iter->second != i)) {
+        preds.emplace(iter->second);
+      }
+    }
+    for (auto pred : preds) {
+      preds_[i].emplace_back(pred);
+      succs_[pred].emplace_back(i);
+    }
+    in_degrees[i] = preds.size();
+  }
+
+  topo_order_.clear();
+  queue<size_t> ready;
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    if (in_degrees[i] == 0) {
+      ready.push(i);
+    }
+  }
+  while (!ready.empty()) {
+    size_t index = ready.front();
+    ready.pop();
+    topo_order_.emplace_back(index);
+    for (auto succ : succs_[index]) {
+      if (--in_degrees[succ] == 0) {
+        ready.push(succ);
+      }
+    }
+  }
+  return topo_order_.size() == subgraphs.size();
+}
+
+void CriticalPathStreamPass::InitMovableStreams(const vector<SubgraphPtr> &subgraphs, const Context &context) {
+  // <stream id, engines on it>
+  map<int64_t, set<string>> stream_engines;
+  for (const auto &subgraph : subgraphs) {
+    if (HasAssignedStream(*subgraph)) {
+      stream_engines[subgraph->stream_id].emplace(subgraph->engine_conf.id);
+    }
+  }
+  // <engine name, streams used by the engine only>
+  map<string, vector<int64_t>> engine_streams;
+  for (const auto &item : stream_engines) {
+    if ((item.second.size() == 1) && (item.first != context.default_stream)) {
+      engine_streams[*item.second.begin()].emplace_back(item.first);
+    }
+  }
+
+  movable_streams_.assign(subgraphs.size(), vector<int64_t>());
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    const Subgraph &subgraph = *subgraphs[i];
+    if (!HasAssignedStream(subgraph) || HasStreamLabel(subgraph) || IsEngineIndependent(subgraph) ||
+        IsEngineAttach(subgraph) || IsEngineSkip(subgraph)) {
+      continue;
+    }
+    auto iter = engine_streams.find(subgraph.engine_conf.id);
+    if ((iter == engine_streams.end()) || (iter->second.size() <= 1)) {
+      continue;
+    }
+    if (std::find(iter->second.begin(), iter->second.end(), subgraph.stream_id) != iter->second.end()) {
+      movable_streams_[i] = iter->second;
+    }
+  }
+}
+
+vector<int64_t> CriticalPathStreamPass::ScheduleByCriticalPath(const vector<SubgraphPtr> &subgraphs) const {
+  // length of the longest path from a subgraph to the end of graph
+  vector<int64_t> bottom_levels(subgraphs.size(), 0);
+  for (auto it = topo_order_.rbegin(); it != topo_order_.rend(); ++it) {
+    int64_t succ_level = 0;
+    for (auto succ : succs_[*it]) {
+      succ_level = std::max(succ_level, bottom_levels[succ]);
+    }
+    bottom_levels[*it] = costs_[*it] + succ_level;
+  }
+
+  // list scheduling, the ready subgraph on the longest path is placed first on the stream it starts earliest
+  vector<int64_t> stream_ids(subgraphs.size(), kInvalidStream);
+  vector<int64_t> finish_times(subgraphs.size(), 0);
+  vector<size_t> pred_nums(subgraphs.size(), 0);
+  map<int64_t, int64_t> stream_free_times;
+  auto compare = [&bottom_levels](size_t lhs, size_t rhs) {
+    return (bottom_levels[lhs] != bottom_levels[rhs]) ? (bottom_levels[lhs] < bottom_levels[rhs]) : (lhs > rhs);
+  };
+  std::priority_queue<size_t, vector<size_t>, decltype(compare)> ready(compare);
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    pred_nums[i] = preds_[i].size();
+    if (pred_nums[i] == 0) {
+      ready.push(i);
+    }
+  }
+  while (!ready.empty()) {
+    size_t index = ready.top();
+    ready.pop();
+    int64_t ready_time = 0;
+    for (auto pred : preds_[index]) {
+      ready_time = std::max(ready_time, finish_times[pred]);
+    }
+    int64_t stream_id = subgraphs[index]->stream_id;
+    int64_t start_time = ready_time;
+    if (stream_id != kInvalidStream) {
+      start_time = std::max(ready_time, stream_free_times[stream_id]);
+    }
+    for (auto candidate : movable_streams_[index]) {
+      int64_t candidate_start_time = std::max(ready_time, stream_free_times[candidate]);
+      if (candidate_start_time < start_time) {
+        start_time = candidate_start_time;
+        stream_id = candidate;
+      }
+    }
+    stream_ids[index] = stream_id;
+    finish_times[index] = start_time + costs_[index];
+    if (stream_id != kInvalidStream) {
+      stream_free_times[stream_id] = finish_times[index];
+    }
+    for (auto succ : succs_[index]) {
+      if (--pred_nums[succ] == 0) {
+        ready.push(succ);
+      }
+    }
+  }
+  return stream_ids;
+}
+
+int64_t CriticalPathStreamPass::PredictMakespan(const vector<int64_t> &stream_ids) const {
+  vector<int64_t> finish_times(stream_ids.size(), 0);
+  map<int64_t, int64_t> stream_free_times;
+  int64_t makespan = 0;
+  for (auto index : topo_order_) {
+    int64_t start_time = 0;
+    for (auto pred : preds_[index]) {
+      start_time = std::max(start_time, finish_times[pred]);
+    }
+    if (stream_ids[index] != kInvalidStream) {
+      start_time = std::max(start_time, stream_free_times[stream_ids[index]]);
+    }
+    finish_times[index] = start_time + costs_[index];
+    if (stream_ids[index] != kInvalidStream) {
+      stream_free_times[stream_ids[index]] = finish_times[index];
+    }
+    makespan = std::max(makespan, finish_times[index]);
+  }
+  return makespan;
+}
+
+Status CriticalPathStreamPass::Run(ComputeGraphPtr graph, const vector<SubgraphPtr> &subgraphs, Context &context) {
+  if (!context.enable_cost_model || (subgraphs.size() <= 1)) {
+    return NOT_CHANGED;
+  }
+  if (!InitDependencies(subgraphs)) {
+    GELOGW("Subgraphs of graph %s are not acyclic, skip cost model.", graph->GetName().c_str());
+    return NOT_CHANGED;
+  }
+  InitMovableStreams(subgraphs, context);
+  bool has_movable = std::any_of(movable_streams_.begin(), movable_streams_.end(),
+                                 [](const vector<int64_t> &streams) { return !streams.empty(); });
+  if (!has_movable) {
+    return NOT_CHANGED;
+  }
+
+  costs_.assign(subgraphs.size(), 0);
+  vector<int64_t> origin_stream_ids(subgraphs.size(), kInvalidStream);
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    costs_[i] = EstimateCost(*subgraphs[i]);
+    origin_stream_ids[i] = subgraphs[i]->stream_id;
+  }
+  vector<int64_t> stream_ids = ScheduleByCriticalPath(subgraphs);
+  int64_t origin_makespan = PredictMakespan(origin_stream_ids);
+  int64_t makespan = PredictMakespan(stream_ids);
+  GELOGI("Predicted makespan of graph %s is %ld by dependency, %ld by critical path.", graph->GetName().c_str(),
+         origin_makespan, makespan);
+  if (makespan >= origin_makespan) {
+    return NOT_CHANGED;
+  }
+
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    if (stream_ids[i] != subgraphs[i]->stream_id) {
+      GELOGI("Subgraph %s of engine %s moves from stream %ld to stream %ld, cost %ld.", subgraphs[i]->name.c_str(),
+             subgraphs[i]->engine_conf.id.c_str(), subgraphs[i]->stream_id, stream_ids[i], costs_[i]);
+      subgraphs[i]->stream_id = stream_ids[i];
+    }
+  }
+  return SUCCESS;
+}
+
 Status SingleStreamPass::Run(ComputeGraphPtr graph, const vector<SubgraphPtr> &subgraphs, Context &context) {
   // context.default_stream can be kInvalidStream only when graph is the root graph.
   int64_t new_stream = context.default_stream;
@@ -530,6 +781,8 @@ void LogicalStreamAllocator::EnableSingleStream(bool enable) { context_.enable_s
 
 void LogicalStreamAllocator::EnableHcomParallel(bool enable) { context_.enable_hcom_parallel = enable; }
 
+void LogicalStreamAllocator::EnableCostModel(bool enable) { context_.enable_cost_model = enable; }
+
 Status LogicalStreamAllocator::Assign(const ComputeGraphPtr &root_graph, const Graph2SubGraphInfoList &subgraph_map,
                                       int64_t &stream_num) {
   GE_CHECK_NOTNULL(root_graph);
@@ -654,6 +907,7 @@ Status LogicalStreamAllocator::RunPasses(const ComputeGraphPtr &graph, const vec
     passes.emplace_back(MakeShared<AssignByLabelPass>());
     passes.emplace_back(MakeShared<IndependentStreamPass>());
     passes.emplace_back(MakeShared<AssignByDependencyPass>());
+    passes.emplace_back(MakeShared<CriticalPathStreamPass>());
     passes.emplace_back(MakeShared<NodeStreamUpdatePass>());
     passes.emplace_back(MakeShared<AllReduceParallelPass>());
     passes.emplace_back(MakeShared<UpdateForSkippedEnginePass>());
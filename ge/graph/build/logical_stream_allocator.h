@@ -64,6 +64,7 @@ class LogicalStreamPass {
     int64_t next_stream = 0;
     bool enable_single_stream = false;
     bool enable_hcom_parallel = false;
+    bool enable_cost_model = false;
   };
 
   explicit LogicalStreamPass(const std::string &name);
@@ -135,6 +136,30 @@ class AssignByDependencyPass : public LogicalStreamPass {
   std::vector<std::pair<SubgraphPtr, SubgraphPtr>> reused_subgraphs_;
 };
 
+// Rebalance streams of subgraphs by predicted cost, so that parallel heavy chains do not queue on one stream.
+// Only streams used exclusively by one engine are exchanged, the number of streams is not changed.
+class CriticalPathStreamPass : public LogicalStreamPass {
+ public:
+  STREAM_PASS_DEFAULT_FUNC(CriticalPathStreamPass);
+  Status Run(ComputeGraphPtr graph, const std::vector<SubgraphPtr> &subgraphs, Context &context) override;
+
+ private:
+  static int64_t EstimateNodeCost(const NodePtr &node);
+  int64_t EstimateCost(const Subgraph &subgraph) const;
+  bool InitDependencies(const std::vector<SubgraphPtr> &subgraphs);
+  void InitMovableStreams(const std::vector<SubgraphPtr> &subgraphs, const Context &context);
+  std::vector<int64_t> ScheduleByCriticalPath(const std::vector<SubgraphPtr> &subgraphs) const;
+  // Finish time of the last subgraph, subgraphs of a stream run in topological order
+  int64_t PredictMakespan(const std::vector<int64_t> &stream_ids) const;
+
+  std::vector<int64_t> costs_;
+  std::vector<std::vector<size_t>> preds_;
+  std::vector<std::vector<size_t>> succs_;
+  std::vector<size_t> topo_order_;
+  // <index of subgraph, streams it could be moved to>, empty if it is not movable
+  std::vector<std::vector<int64_t>> movable_streams_;
+};
+
 // All nodes in the graph are assigned the same stream.
 class SingleStreamPass : public LogicalStreamPass {
  public:
@@ -190,6 +215,7 @@ class LogicalStreamAllocator {
 
   void EnableSingleStream(bool enable);
   void EnableHcomParallel(bool hcom_parallel);
+  void EnableCostModel(bool enable);
 
   Status Assign(const ComputeGraphPtr &root_graph, const Graph2SubGraphInfoList &subgraph_map, int64_t &stream_num);
 
@@ -16,6 +16,7 @@
 
 #include "graph/build/stream_allocator.h"
 #include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include "common/ge/ge_util.h"
 #include "framework/common/debug/ge_log.h"
@@ -38,6 +39,8 @@ const int64_t kTaskNumPerNormalNode = 3;
 const int64_t kTaskNumPerHcclNode = 245;
 const char *const kTrueStr = "true";
 const char *const kFalseStr = "false";
+// set to "true" to rebalance logical streams by predicted cost of subgraphs
+const char *const kEnvStreamCostModel = "STREAM_ASSIGN_COST_MODEL";
 
 inline bool HasContinuousStreamLabel(const ge::OpDescPtr &op_desc, std::string &continuous_stream_label) {
   if (ge::AttrUtils::GetStr(op_desc, ge::ATTR_NAME_CONTINUOUS_STREAM_LABEL, continuous_stream_label)) {
@@ -84,6 +87,8 @@ Status StreamAllocator::AssignLogicalStreams(const std::map<std::string, int> &m
   LogicalStreamAllocator logical_allocator(scheduler_confs, max_parallel_num);
   logical_allocator.EnableSingleStream(enable_single_stream_);
   logical_allocator.EnableHcomParallel(hcom_parallel);
+  const char *cost_model = std::getenv(kEnvStreamCostModel);
+  logical_allocator.EnableCostModel((cost_model != nullptr) && (string(cost_model) == kTrueStr));
 
   Status status = logical_allocator.Assign(whole_graph_, subgraphs_, stream_num_);
   if (status != SUCCESS) {
@@ -439,6 +444,7 @@ Status StreamAllocator::InsertEventsForSubgraph() {
 
 // Optimize the event in the graph, delete the redundant sync event according to the stream information
 Status StreamAllocator::OptimizeSyncEvents() {
+  uint32_t event_num_before = GetSyncEventNum();
   map<int64_t, vector<NodePtr>> stream_nodes;
 
   for (const auto &node : whole_graph_->GetNodes(whole_graph_->GetGraphUnknownFlag())) {
@@ -475,6 +481,14 @@ Status StreamAllocator::OptimizeSyncEvents() {
       }
     }
   }
+
+  status = OptimizeByTransitiveReduction();
+  if (status != SUCCESS) {
+    GELOGE(status, "OptimizeByTransitiveReduction failed!");
+    return status;
+  }
+  GELOGI("Optimize sync events of graph %s, event num from %u to %u.", whole_graph_->GetName().c_str(),
+         event_num_before, GetSyncEventNum());
   return SUCCESS;
 }
 
@@ -567,6 +581,114 @@ Status StreamAllocator::OptimizeByRecvEvents(const map<int64_t, vector<NodePtr>>
   return SUCCESS;
 }
 
+/// Scenario: the send node of an event is known to be done through other events
+/// Example:
+/// Stream0            Stream1            Stream2
+///   N1 - - - event - > N1
+///   |                  |
+///   |                  - - - event - - > N1
+///   |                                    |
+///   |                                    V
+///    - - - - event - - - - - - - - - - > N2  (removed, N1 of stream0 is done before N1 of stream2)
+/// Nodes of a stream run in order, each stream tracks the latest node of every stream known to be done,
+/// which is merged from the send node of every event it waits for.
+/// An event is redundant if its send node is known to be done by the recv stream without it.
+Status StreamAllocator::OptimizeByTransitiveReduction() {
+  if (stream_num_ <= 1) {
+    return SUCCESS;
+  }
+  struct SendNodeState {
+    int64_t stream_id;
+    vector<int64_t> done_positions;
+  };
+  // <stream id, latest position of each stream known to be done>, -1 means none
+  vector<vector<int64_t>> done_positions(stream_num_, vector<int64_t>(stream_num_, -1));
+  vector<int64_t> stream_positions(stream_num_, -1);
+  map<NodePtr, SendNodeState> send_node_states;
+  uint32_t removed_num = 0;
+
+  for (const auto &node : whole_graph_->GetNodes(whole_graph_->GetGraphUnknownFlag())) {
+    GE_CHECK_NOTNULL(node->GetOpDesc());
+    // events of nodes out of order are kept, and never used to remove others
+    if (!IsNodeOrderedInStream(node)) {
+      continue;
+    }
+    int64_t stream_id = node->GetOpDesc()->GetStreamId();
+    vector<int64_t> &done = done_positions[stream_id];
+    done[stream_id] = ++stream_positions[stream_id];
+
+    vector<uint32_t> recv_events;
+    GetRecvEventIdList(node, recv_events);
+    vector<std::pair<uint32_t, const SendNodeState *>> known_events;
+    for (const auto &event_id : recv_events) {
+      auto iter = send_node_states.find(GetNodeFromSendEventId(event_id));
+      if (iter != send_node_states.end()) {
+        known_events.emplace_back(event_id, &iter->second);
+      }
+    }
+
+    vector<bool> is_removed(known_events.size(), false);
+    for (size_t i = 0; i < known_events.size(); ++i) {
+      int64_t send_stream_id = known_events[i].second->stream_id;
+      int64_t send_position = known_events[i].second->done_positions[send_stream_id];
+      bool is_redundant = done[send_stream_id] >= send_position;
+      for (size_t j = 0; !is_redundant && (j < known_events.size()); ++j) {
+        is_redundant = (j != i) && !is_removed[j] &&
+                       (known_events[j].second->done_positions[send_stream_id] >= send_position);
+      }
+      if (!is_redundant) {
+        continue;
+      }
+      is_removed[i] = true;
+      uint32_t event_id = known_events[i].first;
+      NodePtr send_node_ptr = GetNodeFromSendEventId(event_id);
+      GE_CHECK_NOTNULL(send_node_ptr);
+      RmvSendEventId(send_node_ptr, event_id);
+      RmvRecvEventId(node, event_id);
+      ++removed_num;
+      GELOGI("Remove event %u between node %s and node %s, which is implied by other events.", event_id,
+             send_node_ptr->GetName().c_str(), node->GetName().c_str());
+    }
+
+    for (size_t i = 0; i < known_events.size(); ++i) {
+      if (is_removed[i]) {
+        continue;
+      }
+      const vector<int64_t> &send_done = known_events[i].second->done_positions;
+      for (int64_t id = 0; id < stream_num_; ++id) {
+        done[id] = std::max(done[id], send_done[id]);
+      }
+    }
+
+    auto iter = node_to_send_events_.find(node);
+    if ((iter != node_to_send_events_.end()) && !iter->second.empty()) {
+      send_node_states[node] = SendNodeState{stream_id, done};
+    }
+  }
+  GELOGD("Remove %u events by transitive reduction.", removed_num);
+  return SUCCESS;
+}
+
+// Nodes with stream label run only when their streams are activated, which is not in the order of the graph
+bool StreamAllocator::IsNodeOrderedInStream(const NodePtr &node) const {
+  int64_t stream_id = node->GetOpDesc()->GetStreamId();
+  if ((stream_id == kInvalidStream) || (stream_id >= stream_num_)) {
+    return false;
+  }
+  if (specific_activated_streams_.count(stream_id) > 0) {
+    return false;
+  }
+  return !AttrUtils::HasAttr(node->GetOpDesc(), ATTR_NAME_STREAM_LABEL);
+}
+
+uint32_t StreamAllocator::GetSyncEventNum() const {
+  uint32_t event_num = 0;
+  for (const auto &one_pair : node_to_send_events_) {
+    event_num += static_cast<uint32_t>(one_pair.second.size());
+  }
+  return event_num;
+}
+
 Status StreamAllocator::OptimizeByStreamActivate() {
   auto node_to_send_events_temp = node_to_send_events_;
   for (const auto &node_event_id_pair : node_to_send_events_temp) {
@@ -53,6 +53,9 @@ class StreamAllocator {
   Status OptimizeBySendEvents(const std::map<int64_t, std::vector<NodePtr>> &stream_nodes);
   Status OptimizeByRecvEvents(const std::map<int64_t, std::vector<NodePtr>> &stream_nodes);
   Status OptimizeByStreamActivate();
+  Status OptimizeByTransitiveReduction();
+  bool IsNodeOrderedInStream(const NodePtr &node) const;
+  uint32_t GetSyncEventNum() const;
   // Determine if the successor node of RecvNode is directly or indirectly activated by the SendNode precursor node
   bool IsRecvNodeActivatedBySendNode(const NodePtr &send_node_ptr, const NodePtr &recv_node_ptr) const;
   bool IsActiveAfterNextIteration(const NodePtr &active_node_ptr) const;
@@ -15,9 +15,15 @@
  */
 
 #include "graph/build/task_generator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <iterator>
+#include <set>
 #include <string>
 #include <utility>
 #include "common/profiling/profiling_manager.h"
+#include "common/thread_pool.h"
 #include "common/types.h"
 #include "common/util.h"
 #include "framework/common/debug/ge_log.h"
@@ -32,6 +38,7 @@
 #include "graph/common/ge_call_wrapper.h"
 #include "init/gelib.h"
 #include "graph/ge_local_context.h"
+#include "graph/common/local_context.h"
 #include "ge/ge_api_types.h"
 #include "opskernel_manager/ops_kernel_builder_manager.h"
 
@@ -57,6 +64,26 @@ const uint64_t kProfilingArEndLogid = 4;
 const uint64_t kProfilingIterEndLogid = 65535;
 const int64_t kHashFactor = 100000;
 const int64_t kInvalidGroupId = -1;
+const char *const kEnvTaskGenParallelNum = "TASK_GENERATE_PARALLEL_NUM";
+// engines appending tasks of the node only, without reading tasks generated before
+const std::set<std::string> kParallelTaskGenLibNames = {"AIcoreEngine", "aicpu_ascend_kernel", "aicpu_tf_kernel",
+                                                        "DNN_VM_GE_LOCAL_OP_STORE", "DNN_VM_HOST_CPU_OP_STORE"};
+
+uint32_t GetTaskGenParallelNum() {
+  const char *parallel_num_str = std::getenv(kEnvTaskGenParallelNum);
+  if (parallel_num_str == nullptr) {
+    return 1;
+  }
+  int parallel_num = std::atoi(parallel_num_str);
+  return parallel_num > 1 ? static_cast<uint32_t>(parallel_num) : 1;
+}
+
+struct EngineNodes {
+  std::vector<ge::NodePtr> nodes;
+  // tasks generated by the engine in node order, tasks of nodes[i] end at task_ends[i]
+  std::vector<domi::TaskDef> tasks;
+  std::vector<size_t> task_ends;
+};
 }  // namespace
 namespace ge {
 TaskGenerator::TaskGenerator(uint8_t *var_mem_base, uint64_t var_mem_size) {
@@ -287,6 +314,15 @@ Status TaskGenerator::GenerateTask(RunContext &run_context, ComputeGraphPtr &gra
   };
   GE_MAKE_GUARD(release, callback);
 
+  // fusion nodes must be generated continuously in the merge loop, keep serial generation for them.
+  // profiling tasks and tasks of other engines are generated serially in the merge loop
+  std::unordered_map<Node *, std::vector<domi::TaskDef>> pre_generated_tasks;
+  uint32_t parallel_num = GetTaskGenParallelNum();
+  if ((parallel_num > 1) && fusion_nodes.empty()) {
+    GE_CHK_STATUS_RET(PreGenerateTasks(run_context, graph, is_unknown_shape, parallel_num, pre_generated_tasks),
+                      "Pre generate tasks of graph %s failed.", graph->GetName().c_str());
+  }
+
   for (auto &node : graph->GetNodes(graph->GetGraphUnknownFlag())) {
     OpDescPtr op_desc = node->GetOpDesc();
     GE_CHECK_NOTNULL(op_desc);
@@ -341,7 +377,14 @@ Status TaskGenerator::GenerateTask(RunContext &run_context, ComputeGraphPtr &gra
     GELOGD("Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task.", op_kernel_lib_name.c_str(),
            name.c_str(), type.c_str(), op_id, stream_id);
     GE_TIMESTAMP_RESTART(GenerateTask);
-    auto ret = OpsKernelBuilderManager::Instance().GenerateTask(*node, run_context, task_def_list);
+    Status ret = SUCCESS;
+    auto iter = pre_generated_tasks.find(node.get());
+    if (iter != pre_generated_tasks.end()) {
+      task_def_list.insert(task_def_list.end(), std::make_move_iterator(iter->second.begin()),
+                           std::make_move_iterator(iter->second.end()));
+    } else {
+      ret = OpsKernelBuilderManager::Instance().GenerateTask(*node, run_context, task_def_list);
+    }
     GE_TIMESTAMP_ADD(GenerateTask);
     if (ret != SUCCESS) {
       GELOGE(ret, "Call %s to generate node[name:%s(%s), id:%ld, stream_id:%ld] task failed.",
@@ -377,6 +420,133 @@ Status TaskGenerator::GenerateTask(RunContext &run_context, ComputeGraphPtr &gra
   return SUCCESS;
 }
 
+Status TaskGenerator::PreGenerateTasks(const RunContext &run_context, const ComputeGraphPtr &graph,
+                                       bool is_unknown_shape, uint32_t parallel_num,
+                                       std::unordered_map<Node *, std::vector<domi::TaskDef>> &node_tasks) {
+  std::shared_ptr<GELib> ge_lib = GELib::GetInstance();
+  GE_CHECK_NOTNULL(ge_lib);
+  const OpsKernelManager &ops_kernel_manager = ge_lib->OpsKernelManagerObj();
+  // attrs and anchors read by engines are updated serially before engines are called,
+  // nodes failed to check are left to the merge loop, which reports the error as serial generation
+  std::vector<NodePtr> nodes;
+  for (auto &node : graph->GetNodes(graph->GetGraphUnknownFlag())) {
+    OpDescPtr op_desc = node->GetOpDesc();
+    GE_CHECK_NOTNULL(op_desc);
+    bool attr_notask = false;
+    if (ge::AttrUtils::GetBool(op_desc, ATTR_NAME_NOTASK, attr_notask) && attr_notask) {
+      continue;
+    }
+    const string &op_kernel_lib_name = op_desc->GetOpKernelLibName();
+    if (op_kernel_lib_name.empty() || (ops_kernel_manager.GetOpsKernelInfoStore(op_kernel_lib_name) == nullptr)) {
+      continue;
+    }
+    int64_t stream_id = op_desc->GetStreamId();
+    bool is_stream_valid = (stream_id >= 0) && (stream_id < static_cast<int64_t>(run_context.graphStreamList.size()));
+    if (!is_unknown_shape && !is_stream_valid) {
+      continue;
+    }
+    GE_CHK_STATUS_RET(UpdateOpIsVarAttr(op_desc, graph->GetSessionID()));
+    GE_CHK_STATUS_RET(UpdateAnchorStatus(node), "Call UpdateAnchorStatus node:%s(%s) failed",
+                      node->GetName().c_str(), node->GetType().c_str());
+    nodes.emplace_back(node);
+  }
+  GELOGD("Generate tasks of %zu nodes of graph %s in parallel.", nodes.size(), graph->GetName().c_str());
+  return GenerateTasksInParallel(run_context, nodes, is_unknown_shape, parallel_num, node_tasks);
+}
+
+Status TaskGenerator::GenerateTasksInParallel(const RunContext &run_context, const std::vector<NodePtr> &nodes,
+                                              bool is_unknown_shape, uint32_t parallel_num,
+                                              std::unordered_map<Node *, std::vector<domi::TaskDef>> &node_tasks) {
+  // a builder may be registered with several lib names, nodes are grouped by builder instance
+  std::map<const OpsKernelBuilder *, EngineNodes> engine_nodes;
+  for (const auto &node : nodes) {
+    const auto &op_kernel_lib_name = node->GetOpDesc()->GetOpKernelLibName();
+    if (kParallelTaskGenLibNames.count(op_kernel_lib_name) == 0) {
+      continue;
+    }
+    auto builder = OpsKernelBuilderManager::Instance().GetOpsKernelBuilder(op_kernel_lib_name);
+    if (builder == nullptr) {
+      continue;
+    }
+    engine_nodes[builder.get()].nodes.emplace_back(node);
+  }
+  if (engine_nodes.empty()) {
+    return SUCCESS;
+  }
+
+  parallel_num = std::min(parallel_num, static_cast<uint32_t>(engine_nodes.size()));
+  GELOGD("Generate tasks by %zu engines with %u threads.", engine_nodes.size(), parallel_num);
+  OmgContext &omg_context = GetLocalOmgContext();
+  // engines may call runtime, the threads share the rt context of the caller
+  rtContext_t rt_context = nullptr;
+  if (rtCtxGetCurrent(&rt_context) != RT_ERROR_NONE) {
+    GELOGD("No rt context to share with task generation threads.");
+    rt_context = nullptr;
+  }
+  std::vector<std::future<Status>> futures;
+  Status ret = SUCCESS;
+  {
+    ThreadPool thread_pool(parallel_num);
+    for (auto &it : engine_nodes) {
+      auto &engine = it.second;
+      auto future = thread_pool.commit([&run_context, &engine, &omg_context, rt_context,
+                                        is_unknown_shape](const GEThreadLocalContext &ge_context) -> Status {
+        if (rt_context != nullptr) {
+          GE_CHK_RT_RET(rtCtxSetCurrent(rt_context));
+        }
+        GetThreadLocalContext() = ge_context;
+        SetLocalOmgContext(omg_context);
+        RunContext engine_run_context = run_context;
+        for (const auto &node : engine.nodes) {
+          if (!is_unknown_shape) {
+            engine_run_context.stream = engine_run_context.graphStreamList[node->GetOpDesc()->GetStreamId()];
+          }
+          Status gen_ret = OpsKernelBuilderManager::Instance().GenerateTask(*node, engine_run_context, engine.tasks);
+          if (gen_ret != SUCCESS) {
+            GELOGE(gen_ret, "Call %s to generate node[name:%s(%s)] task failed.",
+                   node->GetOpDesc()->GetOpKernelLibName().c_str(), node->GetName().c_str(),
+                   node->GetType().c_str());
+            return gen_ret;
+          }
+          engine.task_ends.emplace_back(engine.tasks.size());
+        }
+        return SUCCESS;
+      }, GetThreadLocalContext());
+      if (!future.valid()) {
+        GELOGE(FAILED, "Failed to submit task generation of engine %s.",
+               it.second.nodes[0]->GetOpDesc()->GetOpKernelLibName().c_str());
+        ret = FAILED;
+        break;
+      }
+      futures.emplace_back(std::move(future));
+    }
+    // wait for all engines before return, they refer to nodes and task lists on stack
+    for (auto &future : futures) {
+      Status gen_ret = future.get();
+      ret = (ret == SUCCESS) ? gen_ret : ret;
+    }
+  }
+  GE_CHK_STATUS_RET_NOLOG(ret);
+
+  for (auto &it : engine_nodes) {
+    auto &engine = it.second;
+    size_t task_begin = 0;
+    for (size_t i = 0; i < engine.nodes.size(); ++i) {
+      size_t task_end = engine.task_ends[i];
+      if (task_end < task_begin) {
+        GELOGE(FAILED, "Call %s to generate node[name:%s] task, but task num is reduced.",
+               engine.nodes[i]->GetOpDesc()->GetOpKernelLibName().c_str(), engine.nodes[i]->GetName().c_str());
+        return FAILED;
+      }
+      auto &tasks = node_tasks[engine.nodes[i].get()];
+      tasks.assign(std::make_move_iterator(engine.tasks.begin() + task_begin),
+                   std::make_move_iterator(engine.tasks.begin() + task_end));
+      task_begin = task_end;
+    }
+  }
+  return SUCCESS;
+}
+
 Status TaskGenerator::GenerateTaskForFusionNode(FusionTaskInfo &fusion_task_info,
                                                 std::map<int64_t, std::vector<NodePtr>> &fusion_nodes,
                                                 std::unordered_set<Node *> &fusion_nodes_seen) {
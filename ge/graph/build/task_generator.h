@@ -20,6 +20,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "common/ge_inner_error_codes.h"
 #include "common/opskernel/ops_kernel_info_types.h"
@@ -96,6 +97,35 @@ class TaskGenerator {
   Status GenerateTask(RunContext &run_context, ComputeGraphPtr &graph, std::vector<domi::TaskDef> &task_def_list,
                       std::map<uint32_t, string> &op_name_map);
 
+  ///
+  /// call engines to generate tasks of nodes concurrently before the serial merge in GenerateTask.
+  /// @param run_context run context
+  /// @param graph compute graph
+  /// @param is_unknown_shape whether tasks are generated on the unknown shape stream
+  /// @param parallel_num max number of threads
+  /// @param node_tasks tasks generated of each node
+  /// @return SUCCESS:seccess
+  ///         Other: failed
+  ///
+  Status PreGenerateTasks(const RunContext &run_context, const ComputeGraphPtr &graph, bool is_unknown_shape,
+                          uint32_t parallel_num, std::unordered_map<Node *, std::vector<domi::TaskDef>> &node_tasks);
+
+  ///
+  /// nodes are grouped by builder instance and each builder is called in node order by one thread.
+  /// only engines in kParallelTaskGenLibNames are called, which do not read tasks generated before,
+  /// so the merged task list is the same as serial generation. other nodes are left to the merge loop.
+  /// @param run_context run context
+  /// @param nodes nodes to generate tasks, in the order of serial generation
+  /// @param is_unknown_shape whether tasks are generated on the unknown shape stream
+  /// @param parallel_num max number of threads
+  /// @param node_tasks tasks generated of each node
+  /// @return SUCCESS:seccess
+  ///         Other: failed
+  ///
+  static Status GenerateTasksInParallel(const RunContext &run_context, const std::vector<NodePtr> &nodes,
+                                        bool is_unknown_shape, uint32_t parallel_num,
+                                        std::unordered_map<Node *, std::vector<domi::TaskDef>> &node_tasks);
+
   ///
   /// AddModelTaskToModel
   /// @param model_task_def model task
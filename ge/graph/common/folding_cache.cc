@@ -0,0 +1,254 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/common/folding_cache.h"
+
+#include <cstdlib>
+#include <set>
+#include <google/protobuf/text_format.h>
+
+#include "common/ge/ge_util.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/types.h"
+#include "framework/common/util.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/detail/model_serialize_imp.h"
+#include "proto/ge_ir.pb.h"
+
+namespace ge {
+namespace {
+const char *const kEnvFoldingCacheSize = "GE_FOLDING_CACHE_SIZE";
+// the cache is opt-in, results of all graphs of the process are kept until evicted
+const uint64_t kDefaultMemoryBudgetMB = 0;
+const uint64_t kMegaBytes = 1024 * 1024;
+const char kKeySeparator = '|';
+const size_t kMaxDescTextSize = 64;
+
+// Results of these ops differ between calls although their inputs are the same
+const std::set<std::string> kNonDeterministicTypes = {
+    RANDOMUNIFORM, "RandomUniformInt", "RandomStandardNormal", "TruncatedNormal", "RandomShuffle", "Multinomial"};
+
+// Attrs carrying graph location only, they never change the folding result
+const std::vector<std::string> kLocationAttrs = {
+    ATTR_NAME_BATCH_LABEL, ATTR_NAME_STREAM_LABEL, ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES};
+
+void AppendTensorDesc(const GeTensorDesc &desc, std::string &key) {
+  key.append(std::to_string(static_cast<int32_t>(desc.GetDataType())));
+  key.push_back(kKeySeparator);
+  key.append(std::to_string(static_cast<int32_t>(desc.GetFormat())));
+  key.push_back(kKeySeparator);
+  for (auto dim : desc.GetShape().GetDims()) {
+    key.append(std::to_string(dim)).push_back(',');
+  }
+  key.push_back(kKeySeparator);
+}
+
+Status GetOpDescText(const NodePtr &node, std::string &op_text) {
+  proto::OpDef op_def;
+  ModelSerializeImp model_serialize_imp;
+  if (!model_serialize_imp.SerializeNode(node, &op_def, false)) {
+    GELOGW("Fail to serialize node[%s].", node->GetName().c_str());
+    return FAILED;
+  }
+  op_def.clear_name();
+  op_def.clear_input();
+  op_def.set_id(0);
+  auto attr = op_def.mutable_attr();
+  for (const auto &attr_name : kLocationAttrs) {
+    attr->erase(attr_name);
+  }
+  // Map fields are sorted by TextFormat, so the text is stable for the same op
+  if (!google::protobuf::TextFormat::PrintToString(op_def, &op_text)) {
+    GELOGW("Print OpDef of node[%s] to string failed.", node->GetName().c_str());
+    return FAILED;
+  }
+  return SUCCESS;
+}
+
+uint64_t GetMemoryBudgetFromEnv() {
+  const char *env = std::getenv(kEnvFoldingCacheSize);
+  if (env == nullptr) {
+    return kDefaultMemoryBudgetMB * kMegaBytes;
+  }
+  char *end = nullptr;
+  uint64_t size = std::strtoull(env, &end, 10);
+  if ((end == env) || (*end != '\0')) {
+    GELOGW("Invalid value [%s] of env %s, use default %lu MB.", env, kEnvFoldingCacheSize, kDefaultMemoryBudgetMB);
+    return kDefaultMemoryBudgetMB * kMegaBytes;
+  }
+  return size * kMegaBytes;
+}
+}  // namespace
+
+FoldingCache::FoldingCache() : memory_budget_(GetMemoryBudgetFromEnv()) {
+  GELOGI("Folding cache memory budget is %lu bytes.", memory_budget_);
+}
+
+FoldingCache &FoldingCache::Instance() {
+  static FoldingCache instance;
+  return instance;
+}
+
+Status FoldingCache::GenerateKey(const NodePtr &node, const std::vector<ConstGeTensorPtr> &inputs,
+                                 std::string &key) const {
+  key.clear();
+  GE_CHECK_NOTNULL(node);
+  uint64_t memory_budget = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memory_budget = memory_budget_;
+  }
+  if (memory_budget == 0) {
+    return NOT_CHANGED;
+  }
+  if (kNonDeterministicTypes.count(node->GetType()) > 0) {
+    GELOGD("Node %s type %s is non-deterministic, skip folding cache.", node->GetName().c_str(),
+           node->GetType().c_str());
+    return NOT_CHANGED;
+  }
+
+  // The key carries the whole op text and input data instead of digests of them, so a hit is always verified
+  // by the full compare of the hash map and a collision can never return the result of another fold.
+  std::string op_text;
+  if (GetOpDescText(node, op_text) != SUCCESS) {
+    return NOT_CHANGED;
+  }
+  uint64_t key_size = node->GetType().size() + op_text.size();
+  for (const auto &input : inputs) {
+    if (input == nullptr) {
+      return NOT_CHANGED;
+    }
+    key_size += input->GetData().size();
+  }
+  if (key_size > memory_budget) {
+    GELOGD("Key size %lu of node %s exceeds memory budget, skip folding cache.", key_size, node->GetName().c_str());
+    return NOT_CHANGED;
+  }
+
+  key.reserve(key_size + inputs.size() * kMaxDescTextSize);
+  key.append(node->GetType()).push_back(kKeySeparator);
+  key.append(std::to_string(op_text.size())).push_back(kKeySeparator);
+  key.append(op_text).push_back(kKeySeparator);
+  for (const auto &input : inputs) {
+    AppendTensorDesc(input->GetTensorDesc(), key);
+    const auto &data = input->GetData();
+    key.append(std::to_string(data.size())).push_back(kKeySeparator);
+    key.append(reinterpret_cast<const char *>(data.data()), data.size()).push_back(kKeySeparator);
+  }
+  return SUCCESS;
+}
+
+bool FoldingCache::Lookup(const std::string &key, std::vector<GeTensorPtr> &outputs) {
+  std::vector<ConstGeTensorPtr> cached_outputs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(key);
+    if (iter == entries_.end()) {
+      ++miss_count_;
+      return false;
+    }
+    ++hit_count_;
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second.lru_iter);
+    cached_outputs = iter->second.outputs;
+  }
+
+  // Weights of const nodes may be updated by later passes, so the cached tensors are never handed out directly
+  std::vector<GeTensorPtr> copied_outputs;
+  for (const auto &cached_output : cached_outputs) {
+    const auto &data = cached_output->GetData();
+    auto output = MakeShared<GeTensor>(cached_output->GetTensorDesc(), data.data(), data.size());
+    if (output == nullptr) {
+      GELOGW("Failed to copy folding result from cache.");
+      return false;
+    }
+    copied_outputs.emplace_back(output);
+  }
+  outputs.swap(copied_outputs);
+  return true;
+}
+
+void FoldingCache::Insert(const std::string &key, const std::vector<GeTensorPtr> &outputs) {
+  if (key.empty() || outputs.empty()) {
+    return;
+  }
+  CacheEntry entry;
+  for (const auto &output : outputs) {
+    if (output == nullptr) {
+      return;
+    }
+    const auto &data = output->GetData();
+    auto cached_output = MakeShared<GeTensor>(output->GetTensorDesc(), data.data(), data.size());
+    if (cached_output == nullptr) {
+      return;
+    }
+    entry.size += data.size();
+    entry.outputs.emplace_back(cached_output);
+  }
+
+  // key material is held by the entry as well
+  entry.size += key.size();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if ((entry.size > memory_budget_) || (entries_.count(key) > 0)) {
+    return;
+  }
+  EvictUntilFit(entry.size);
+  auto iter = entries_.emplace(key, std::move(entry)).first;
+  lru_list_.push_front(&iter->first);
+  iter->second.lru_iter = lru_list_.begin();
+  cached_size_ += iter->second.size;
+}
+
+void FoldingCache::EvictUntilFit(uint64_t size) {
+  while (!lru_list_.empty() && (cached_size_ + size > memory_budget_)) {
+    auto iter = entries_.find(*lru_list_.back());
+    if (iter != entries_.end()) {
+      cached_size_ -= iter->second.size;
+      entries_.erase(iter);
+      ++evict_count_;
+    }
+    lru_list_.pop_back();
+  }
+}
+
+void FoldingCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_list_.clear();
+  cached_size_ = 0;
+  hit_count_ = 0;
+  miss_count_ = 0;
+  evict_count_ = 0;
+}
+
+void FoldingCache::SetMemoryBudget(uint64_t memory_budget) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  memory_budget_ = memory_budget;
+  EvictUntilFit(0);
+}
+
+FoldingCacheStatistic FoldingCache::GetStatistic() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FoldingCacheStatistic statistic;
+  statistic.hit_count = hit_count_;
+  statistic.miss_count = miss_count_;
+  statistic.evict_count = evict_count_;
+  statistic.entry_count = entries_.size();
+  statistic.cached_size = cached_size_;
+  statistic.memory_budget = memory_budget_;
+  return statistic;
+}
+}  // namespace ge
@@ -0,0 +1,106 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_COMMON_FOLDING_CACHE_H_
+#define GE_GRAPH_COMMON_FOLDING_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/common/ge_inner_error_codes.h"
+#include "graph/ge_tensor.h"
+#include "graph/node.h"
+
+namespace ge {
+struct FoldingCacheStatistic {
+  uint64_t hit_count = 0;
+  uint64_t miss_count = 0;
+  uint64_t evict_count = 0;
+  uint64_t entry_count = 0;
+  uint64_t cached_size = 0;
+  uint64_t memory_budget = 0;
+};
+
+///
+/// Process-wide cache of constant folding results. An entry is addressed by the op type, the op attributes
+/// and tensor descs, and every input tensor (desc plus data), so identical folds in different graphs,
+/// sessions or multi-batch branches are computed only once. Keys hold the full material, not digests of it.
+/// The budget is taken from env GE_FOLDING_CACHE_SIZE in MB, the cache is disabled by default or when 0.
+///
+class FoldingCache {
+ public:
+  static FoldingCache &Instance();
+
+  FoldingCache(const FoldingCache &) = delete;
+  FoldingCache &operator=(const FoldingCache &) = delete;
+
+  ///
+  /// @ingroup ge
+  /// @brief generate the cache key of node with const inputs
+  /// @param [in] node: node to be folded
+  /// @param [in] inputs: const inputs of node
+  /// @param [out] key: generated key, empty if the node can not be cached
+  /// @return SUCCESS if node is cacheable
+  ///
+  Status GenerateKey(const NodePtr &node, const std::vector<ConstGeTensorPtr> &inputs, std::string &key) const;
+
+  ///
+  /// @ingroup ge
+  /// @brief look up folding result, the outputs are private copies which may be modified by caller
+  /// @return true if hit
+  ///
+  bool Lookup(const std::string &key, std::vector<GeTensorPtr> &outputs);
+
+  ///
+  /// @ingroup ge
+  /// @brief save folding result, outputs will be evicted by lru when the memory budget is exceeded
+  ///
+  void Insert(const std::string &key, const std::vector<GeTensorPtr> &outputs);
+
+  void Clear();
+
+  void SetMemoryBudget(uint64_t memory_budget);
+
+  FoldingCacheStatistic GetStatistic() const;
+
+ private:
+  struct CacheEntry {
+    std::vector<ConstGeTensorPtr> outputs;
+    uint64_t size = 0;
+    std::list<const std::string *>::iterator lru_iter;
+  };
+
+  FoldingCache();
+  ~FoldingCache() = default;
+
+  void EvictUntilFit(uint64_t size);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, CacheEntry> entries_;
+  std::list<const std::string *> lru_list_;  // keys owned by entries_
+  uint64_t memory_budget_ = 0;
+  uint64_t cached_size_ = 0;
+  uint64_t hit_count_ = 0;
+  uint64_t miss_count_ = 0;
+  uint64_t evict_count_ = 0;
+};
+}  // namespace ge
+
+#endif  // GE_GRAPH_COMMON_FOLDING_CACHE_H_
@@ -27,6 +27,25 @@
 #include "runtime/mem.h"
 
 namespace ge {
+namespace {
+const uint64_t kMinStagingSize = 512;
+const uint64_t kStagingPageSize = 1024 * 1024;
+// idle staging buffers above this size are freed instead of pooled
+const uint64_t kMaxIdleStagingSize = 256UL * 1024UL * 1024UL;
+
+// power of two below a page, page aligned above, so that a buffer is reused when its size changes slightly
+uint64_t GetStagingSizeClass(uint64_t size) {
+  if (size >= kStagingPageSize) {
+    return (size + kStagingPageSize - 1) / kStagingPageSize * kStagingPageSize;
+  }
+  uint64_t size_class = kMinStagingSize;
+  while (size_class < size) {
+    size_class <<= 1;
+  }
+  return size_class;
+}
+}  // namespace
+
 GraphExecutor::GraphExecutor()
     : init_flag_(false),
       train_graph_flag_(false),
@@ -35,21 +54,12 @@ GraphExecutor::GraphExecutor()
       graph_run_listener_(nullptr),
       graph_context_(nullptr),
       last_graph_id_(UINT32_MAX),
-      malloc_flag_(false) {}
+      malloc_flag_(false),
+      free_buffers_size_(0) {}
 
 GraphExecutor::~GraphExecutor() {
   outputs_desc_.clear();
-  if (malloc_flag_) {
-    for (auto &buffer_addr : buffer_addr_) {
-      rtError_t rt_ret;
-      rt_ret = rtFreeHost(buffer_addr);
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(RT_FAILED, "[GraphManager] subgraph free buffer failed, ret: 0x%X", rt_ret);
-      }
-    }
-  }
-  malloc_flag_ = false;
-  buffer_addr_.clear();
+  (void)FreeInOutBuffer();
 }
 
 Status GraphExecutor::SetCondition(std::mutex *mutex, std::condition_variable *cond,
@@ -100,64 +110,86 @@ Status GraphExecutor::SetDynamicSize(uint32_t model_id, const std::vector<uint64
 void GraphExecutor::SetTrainFlag(bool is_train_graph) { train_graph_flag_ = is_train_graph; }
 
 Status GraphExecutor::FreeInOutBuffer() {
-  if (malloc_flag_) {
-    for (auto iter = buffer_addr_.begin(); iter != buffer_addr_.end(); ++iter) {
-      rtError_t rt_ret;
-      rt_ret = rtFreeHost(*iter);
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(RT_FAILED, "[GraphManager] subgraph free buffer failed, ret: 0x%X", rt_ret);
-        (void)buffer_addr_.erase(buffer_addr_.begin(), iter);
-        return GE_GRAPH_FREE_FAILED;
-      }
-    }
-    buffer_addr_.clear();
-
-    malloc_flag_ = false;
-    return SUCCESS;
-  } else {
+  if (!malloc_flag_) {
     GELOGD("[GraphManager] not malloc buffer.");
     return SUCCESS;
   }
+  std::vector<void *> all_buffers;
+  for (const auto &buffer_addr : buffer_addr_) {
+    if (buffer_addr != nullptr) {
+      all_buffers.emplace_back(buffer_addr);
+    }
+  }
+  for (const auto &item : free_buffers_) {
+    all_buffers.insert(all_buffers.end(), item.second.begin(), item.second.end());
+  }
+  buffer_addr_.clear();
+  buffer_size_.clear();
+  free_buffers_.clear();
+  free_buffers_size_ = 0;
+
+  // all buffers are dropped even if some of them failed to free, a leak is better than a double free
+  Status ret = SUCCESS;
+  for (const auto &buffer_addr : all_buffers) {
+    rtError_t rt_ret = rtFreeHost(buffer_addr);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "[GraphManager] subgraph free buffer failed, ret: 0x%X", rt_ret);
+      ret = GE_GRAPH_FREE_FAILED;
+    }
+  }
+  malloc_flag_ = false;
+  return ret;
 }
 
 Status GraphExecutor::MallocInOutBuffer(const std::vector<uint64_t> &buffer_size, std::vector<void *> &data_addr) {
-  if (malloc_flag_) {
-    auto all_size_same = true;
-    if (buffer_size.size() == buffer_size_.size()) {
-      for (size_t i = 0; i < buffer_size.size(); i++) {
-        if (buffer_size[i] != buffer_size_[i]) {
-          all_size_same = false;
-          break;
-        }
-      }
-    } else {
-      all_size_same = false;
+  std::vector<void *> buffer_addr(buffer_size.size(), nullptr);
+  std::vector<uint64_t> buffer_class(buffer_size.size(), 0);
+  for (size_t i = 0; i < buffer_size.size(); ++i) {
+    buffer_class[i] = GetStagingSizeClass(buffer_size[i]);
+    if ((i < buffer_addr_.size()) && (buffer_size_[i] == buffer_class[i])) {
+      buffer_addr[i] = buffer_addr_[i];
+      buffer_addr_[i] = nullptr;
     }
-    if (all_size_same) {
-      data_addr = buffer_addr_;
-      return SUCCESS;
+  }
+  // buffers of last run not reused in place go back to pool
+  for (size_t i = 0; i < buffer_addr_.size(); ++i) {
+    if (buffer_addr_[i] == nullptr) {
+      continue;
     }
-    buffer_size_.clear();
-    auto rt_ret = FreeInOutBuffer();
-    if (rt_ret != SUCCESS) {
-      GELOGE(RT_FAILED, "[SubGraphInfo] MallocInOutBuffer free buffer failed, ret: 0x%X", rt_ret);
-      return RT_FAILED;
+    if (free_buffers_size_ + buffer_size_[i] > kMaxIdleStagingSize) {
+      rtError_t rt_ret = rtFreeHost(buffer_addr_[i]);
+      if (rt_ret != RT_ERROR_NONE) {
+        GELOGW("[GraphManager] free idle staging buffer failed, ret: 0x%X", rt_ret);
+      }
+      continue;
     }
+    free_buffers_[buffer_size_[i]].emplace_back(buffer_addr_[i]);
+    free_buffers_size_ += buffer_size_[i];
   }
+  buffer_addr_ = buffer_addr;
+  buffer_size_ = buffer_class;
 
-  rtError_t rt_ret;
-  for (size_t i = 0; i < buffer_size.size(); ++i) {
-    void *tmp_buf = nullptr;
-    rt_ret = rtMallocHost(&tmp_buf, buffer_size[i]);
+  for (size_t i = 0; i < buffer_addr_.size(); ++i) {
+    if (buffer_addr_[i] != nullptr) {
+      continue;
+    }
+    auto iter = free_buffers_.find(buffer_size_[i]);
+    if ((iter != free_buffers_.end()) && !iter->second.empty()) {
+      buffer_addr_[i] = iter->second.back();
+      iter->second.pop_back();
+      free_buffers_size_ -= buffer_size_[i];
+      continue;
+    }
+    rtError_t rt_ret = rtMallocHost(&buffer_addr_[i], buffer_size_[i]);
     if (rt_ret != RT_ERROR_NONE) {
+      buffer_addr_[i] = nullptr;
       GELOGE(RT_FAILED, "[GraphManager] subgraph malloc buffer failed, ret: 0x%X", rt_ret);
       return GE_GRAPH_MALLOC_FAILED;
     }
     malloc_flag_ = true;
-    data_addr.push_back(tmp_buf);
-    buffer_addr_.push_back(tmp_buf);
+    GELOGD("[GraphManager] malloc staging buffer of size class %lu.", buffer_size_[i]);
   }
-  buffer_size_ = buffer_size;
+  data_addr = buffer_addr_;
   return SUCCESS;
 }
 
@@ -167,17 +199,10 @@ Status GraphExecutor::PrepareInputData(const std::vector<GeTensor> &input_tensor
   graph_input_data.index = 0;
   graph_input_data.timeout = 0;
   graph_input_data.timestamp = 0;
-  std::size_t inputSize = input_tensor.size();
   std::size_t output_size = output_desc.size();
   std::vector<uint64_t> bufferSizeVec;
   std::vector<void *> addrVec;
 
-  for (std::size_t i = 0; i < inputSize; ++i) {
-    const GeTensor *InTensor = &input_tensor[i];
-    GE_CHECK_NOTNULL(InTensor);
-    bufferSizeVec.push_back(InTensor->GetData().size());
-  }
-
   for (const auto &desc : output_desc) {
     bufferSizeVec.push_back(desc.size);
   }
@@ -188,20 +213,13 @@ Status GraphExecutor::PrepareInputData(const std::vector<GeTensor> &input_tensor
     return GE_GRAPH_MALLOC_FAILED;
   }
 
-  for (std::size_t i = 0; i < input_tensor.size() && i < addrVec.size(); ++i) {
+  // the caller is blocked until the model finishes, so inputs are copied to device from its tensors directly,
+  // as RunGraphAsync does
+  for (std::size_t i = 0; i < input_tensor.size(); ++i) {
     const GeTensor *in_tensor = &input_tensor[i];
     GE_CHECK_NOTNULL(in_tensor);
-    if ((addrVec[i] != nullptr) && (in_tensor->GetData().data() != nullptr)) {
-      rtError_t rt_ret = rtMemcpy(addrVec[i], bufferSizeVec[i], in_tensor->GetData().data(),
-                                  in_tensor->GetData().size(), RT_MEMCPY_HOST_TO_HOST);
-      if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(RT_FAILED, "Call rt api failed, ret: 0x%X", rt_ret);
-        return RT_FAILED;
-      }
-    }
-
     DataBuffer in_data_buf;
-    in_data_buf.data = reinterpret_cast<uint8_t *>(addrVec[i]);
+    in_data_buf.data = const_cast<uint8_t *>(in_tensor->GetData().data());
     in_data_buf.length = in_tensor->GetData().size();
     in_data_buf.isDataSupportMemShare = false;
     graph_input_data.blobs.push_back(in_data_buf);
@@ -214,7 +232,7 @@ Status GraphExecutor::PrepareInputData(const std::vector<GeTensor> &input_tensor
     uint64_t buffer_size = desc.size;
 
     DataBuffer out_data_buf;
-    out_data_buf.data = reinterpret_cast<uint8_t *>(addrVec[inputSize + j]);
+    out_data_buf.data = reinterpret_cast<uint8_t *>(addrVec[j]);
     out_data_buf.length = buffer_size;
     out_data_buf.isDataSupportMemShare = false;
     graph_output_data.blobs.push_back(out_data_buf);
@@ -287,17 +305,6 @@ Status GraphExecutor::SyncExecuteModel(uint32_t model_id, const std::vector<GeTe
     CHECK_FALSE_EXEC(outputDataTmp.length != 0,
                      GELOGE(GE_GRAPH_EXECUTE_FAILED, "Failed to allocate memory, length is 0.");
                      return GE_GRAPH_EXECUTE_FAILED);
-    std::unique_ptr<uint8_t> outBufTmp(new (std::nothrow) uint8_t[outputDataTmp.length]);
-    if (outBufTmp == nullptr) {
-      GELOGE(FAILED, "Failed to allocate memory.");
-      return FAILED;
-    }
-    GE_PRINT_DYNAMIC_MEMORY(new, "the output memory of data on training.", sizeof(uint8_t) * outputDataTmp.length)
-    rtError_t ret_value = rtMemcpy(outBufTmp.get(), outputDataTmp.length, outputDataTmp.data, outputDataTmp.length,
-                                   RT_MEMCPY_HOST_TO_HOST);
-    CHECK_FALSE_EXEC(ret_value == RT_ERROR_NONE,
-                     GELOGE(GE_GRAPH_EXECUTE_FAILED, "Call rt api rtMemcpy failed, ret: 0x%X", ret);
-                     return GE_GRAPH_EXECUTE_FAILED);
     GeTensor outTensor;
     std::vector<int64_t> shapeDims;
     for (const auto &dim : output_desc[i].shape_info.dims) {
@@ -307,7 +314,8 @@ Status GraphExecutor::SyncExecuteModel(uint32_t model_id, const std::vector<GeTe
     GeShape outShape(shapeDims);
     outTensor.MutableTensorDesc().SetShape(outShape);
     outTensor.MutableTensorDesc().SetDataType((DataType)output_desc[i].data_type);
-    (void)outTensor.SetData(outBufTmp.get(), outputDataTmp.length);
+    // tensor owns a copy of staging buffer, which is reused by next run
+    (void)outTensor.SetData(reinterpret_cast<const uint8_t *>(outputDataTmp.data), outputDataTmp.length);
     output_tensor.push_back(outTensor);
   }
 
@@ -382,6 +390,40 @@ Status GraphExecutor::ExecuteGraphAsync(GraphId graph_id, const GeRootModelPtr &
   return SUCCESS;
 }
 
+Status GraphExecutor::ExecuteGraphWithDeviceBuffers(GraphId graph_id, const GeRootModelPtr &ge_root_model,
+                                                    rtStream_t stream, const std::vector<DataBuffer> &inputs,
+                                                    std::vector<DataBuffer> &outputs) {
+  GELOGI("[GraphExecutor] Start to execute graph with device buffers, graph_id=%u", graph_id);
+  if (!init_flag_) {
+    GELOGE(GE_GRAPH_EXECUTE_NOT_INIT, "[GraphExecutor] AI Core Engine without calling SetCondition!");
+    return GE_GRAPH_EXECUTE_NOT_INIT;
+  }
+  GE_CHECK_NOTNULL_EXEC(ge_root_model, return FAILED);
+  auto model_manager = ge::ModelManager::GetInstance();
+  GE_CHECK_NOTNULL(model_manager);
+
+  // no staging buffers, addresses of caller are patched into task args as the ACL path of offline models
+  uint32_t model_id = ge_root_model->GetModelId();
+  InputData input_data;
+  input_data.model_id = model_id;
+  input_data.blobs = inputs;
+  OutputData output_data;
+  output_data.model_id = model_id;
+  output_data.blobs = outputs;
+  std::vector<GeTensorDesc> input_desc;
+  std::vector<GeTensorDesc> output_desc;
+  bool async_mode = (stream != nullptr);
+  Status ret = model_manager->ExecuteModel(model_id, stream, async_mode, input_data, input_desc, output_data,
+                                           output_desc);
+  if (ret != SUCCESS) {
+    GELOGE(ret, "[GraphExecutor] Execute model with device buffers failed, modelId=%u.", model_id);
+    return ret;
+  }
+
+  GELOGI("[GraphExecutor] Execute graph with device buffers success, graph_id=%u", graph_id);
+  return SUCCESS;
+}
+
 Status GraphExecutor::AsyncExecuteModel(uint32_t model_id, const std::vector<InputTensorInfo> &inputs) {
   try {
     auto model_manager = ge::ModelManager::GetInstance();
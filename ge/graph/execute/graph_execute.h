@@ -21,6 +21,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -38,6 +39,7 @@
 #include "graph/model.h"
 #include "graph/utils/graph_utils.h"
 #include "graph/utils/tensor_utils.h"
+#include "runtime/base.h"
 
 namespace ge {
 class GraphExecutor {
@@ -52,6 +54,16 @@ class GraphExecutor {
   ge::Status ExecuteGraphAsync(GraphId graph_id, const GeRootModelPtr &ge_root_model,
                                const std::vector<InputTensorInfo> &input_tensor);
 
+  ///
+  /// @ingroup ge
+  /// @brief execute graph on device buffers of caller, which are fed to tasks by zero copy of the model
+  /// @param [in] stream: stream to execute on, or nullptr to execute synchronously
+  /// @param [in] inputs: device buffers of inputs
+  /// @param [out] outputs: device buffers to write outputs to, allocated by caller
+  ///
+  Status ExecuteGraphWithDeviceBuffers(GraphId graph_id, const GeRootModelPtr &ge_root_model, rtStream_t stream,
+                                       const std::vector<DataBuffer> &inputs, std::vector<DataBuffer> &outputs);
+
   Status SetCondition(std::mutex *mutex, std::condition_variable *cond, std::shared_ptr<GraphModelListener> listener);
 
   Status SetGraphContext(GraphContextPtr graph_context_ptr);
@@ -130,6 +142,8 @@ class GraphExecutor {
 
   Status FreeInOutBuffer();
 
+  // staging buffers are pooled by size class, they are kept when sizes change and freed with FreeInOutBuffer.
+  // idle buffers are kept up to 256MB in total
   Status MallocInOutBuffer(const std::vector<uint64_t> &buffer_size, std::vector<void *> &data_addr);
 
   bool init_flag_;
@@ -149,7 +163,11 @@ class GraphExecutor {
 
   bool malloc_flag_;
   std::vector<void *> buffer_addr_;
+  // size class of buffer_addr_
   std::vector<uint64_t> buffer_size_;
+  // <size class, idle staging buffers>
+  std::map<uint64_t, std::vector<void *>> free_buffers_;
+  uint64_t free_buffers_size_;
 };
 }  // namespace ge
 
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "common/debug/memory_dumper.h"
+#include "common/dump/dump_writer.h"
 #include "common/properties_manager.h"
 #include "common/util.h"
 #include "framework/common/debug/ge_log.h"
@@ -874,25 +875,28 @@ void DataDumper::PrintCheckLog(string &dump_list_key) {
   }
 }
 
-Status DataDumper::DumpExceptionInput(const OpDescInfo &op_desc_info, const string &dump_file) {
+Status DataDumper::DumpExceptionInput(const OpDescInfo &op_desc_info, std::vector<DumpWriter::Buffer> &buffers) {
   GELOGI("Start to dump exception input");
   for (size_t i = 0; i < op_desc_info.input_addrs.size(); i++) {
-    if (Debug::DumpDevMem(dump_file.data(), op_desc_info.input_addrs.at(i), op_desc_info.input_size.at(i)) != SUCCESS) {
+    DumpWriter::Buffer buffer;
+    if (DumpWriter::CopyDevMem(op_desc_info.input_addrs.at(i), op_desc_info.input_size.at(i), buffer) != SUCCESS) {
       GELOGE(PARAM_INVALID, "Dump the %zu input data failed", i);
       return PARAM_INVALID;
     }
+    buffers.emplace_back(std::move(buffer));
   }
   return SUCCESS;
 }
 
-Status DataDumper::DumpExceptionOutput(const OpDescInfo &op_desc_info, const string &dump_file) {
+Status DataDumper::DumpExceptionOutput(const OpDescInfo &op_desc_info, std::vector<DumpWriter::Buffer> &buffers) {
   GELOGI("Start to dump exception output");
   for (size_t i = 0; i < op_desc_info.output_addrs.size(); i++) {
-    if (Debug::DumpDevMem(dump_file.data(), op_desc_info.output_addrs.at(i), op_desc_info.output_size.at(i)) !=
-        SUCCESS) {
-      GELOGE(PARAM_INVALID, "Dump the %zu input data failed", i);
+    DumpWriter::Buffer buffer;
+    if (DumpWriter::CopyDevMem(op_desc_info.output_addrs.at(i), op_desc_info.output_size.at(i), buffer) != SUCCESS) {
+      GELOGE(PARAM_INVALID, "Dump the %zu output data failed", i);
       return PARAM_INVALID;
     }
+    buffers.emplace_back(std::move(buffer));
   }
   return SUCCESS;
 }
@@ -938,27 +942,37 @@ Status DataDumper::DumpExceptionInfo(const std::vector<rtExceptionInfo> exceptio
       GELOGI("The exception dump file path is %s", dump_file_path.c_str());
 
       uint64_t proto_size = dump_data.ByteSizeLong();
-      std::unique_ptr<char[]> proto_msg(new (std::nothrow) char[proto_size]);
-      bool ret = dump_data.SerializeToArray(proto_msg.get(), proto_size);
+      // file layout: proto size, proto msg, data of inputs, data of outputs
+      std::vector<DumpWriter::Buffer> buffers;
+      auto proto_size_addr = reinterpret_cast<const uint8_t *>(&proto_size);
+      buffers.emplace_back(proto_size_addr, proto_size_addr + sizeof(uint64_t));
+      buffers.emplace_back(proto_size);
+      bool ret = dump_data.SerializeToArray(buffers.back().data(), proto_size);
       if (!ret || proto_size == 0) {
         GELOGE(PARAM_INVALID, "Dump data proto serialize failed");
         return PARAM_INVALID;
       }
 
-      GE_CHK_STATUS_RET(MemoryDumper::DumpToFile(dump_file_path.c_str(), &proto_size, sizeof(uint64_t)),
-                        "Failed to dump proto size");
-      GE_CHK_STATUS_RET(MemoryDumper::DumpToFile(dump_file_path.c_str(), proto_msg.get(), proto_size),
-                        "Failed to dump proto msg");
-      if (DumpExceptionInput(op_desc_info, dump_file_path) != SUCCESS) {
+      if (DumpExceptionInput(op_desc_info, buffers) != SUCCESS) {
         GELOGE(PARAM_INVALID, "Dump exception input failed");
         return PARAM_INVALID;
       }
 
-      if (DumpExceptionOutput(op_desc_info, dump_file_path) != SUCCESS) {
+      if (DumpExceptionOutput(op_desc_info, buffers) != SUCCESS) {
         GELOGE(PARAM_INVALID, "Dump exception output failed");
         return PARAM_INVALID;
       }
-      GELOGI("Dump exception info SUCCESS");
+      // device data is snapshotted already, file is written by dump writer
+      uint64_t seq = 0;
+      GE_CHK_STATUS_RET(DumpWriter::GetInstance().Submit(dump_file_path, std::move(buffers), seq),
+                        "Failed to submit exception dump of op %s", op_desc_info.op_name.c_str());
+      if (seq == 0) {
+        GELOGW("Exception dump of op %s is dropped as dump writer is full, model = %s, file = %s",
+               op_desc_info.op_name.c_str(), model_name_.c_str(), dump_file_path.c_str());
+        continue;
+      }
+      GELOGI("Dump exception info of op %s SUCCESS, model = %s, dump sequence = %lu", op_desc_info.op_name.c_str(),
+             model_name_.c_str(), seq);
     } else {
       GELOGE(PARAM_INVALID, "Get op desc info failed,task id:%u,stream id:%u", iter.taskid, iter.streamid);
       return PARAM_INVALID;
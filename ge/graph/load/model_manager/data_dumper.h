@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "framework/common/ge_inner_error_codes.h"
+#include "common/dump/dump_writer.h"
 #include "common/properties_manager.h"
 #include "graph/node.h"
 #include "graph/compute_graph.h"
@@ -91,8 +92,8 @@ class DataDumper {
   const std::vector<OpDescInfo> &GetAllOpDescInfo() const { return op_desc_info_; }
 
   // Dump exception info
-  Status DumpExceptionInput(const OpDescInfo &op_desc_info, const string &dump_file);
-  Status DumpExceptionOutput(const OpDescInfo &op_desc_info, const string &dump_file);
+  Status DumpExceptionInput(const OpDescInfo &op_desc_info, std::vector<DumpWriter::Buffer> &buffers);
+  Status DumpExceptionOutput(const OpDescInfo &op_desc_info, std::vector<DumpWriter::Buffer> &buffers);
   Status DumpExceptionInfo(const std::vector<rtExceptionInfo> exception_infos);
 
  private:
@@ -3511,44 +3511,31 @@ Status DavinciModel::InitTbeHandle(const OpDescPtr &op_desc) {
 
   std::lock_guard<std::mutex> lock(tvm_bin_mutex_);
   if (rtQueryFunctionRegistered(bin_file_key) != RT_ERROR_NONE) {
-    void *bin_handle = nullptr;
-    if (!kernel_store.FindTBEHandle(bin_file_key, bin_handle)) {
-      GELOGD("TBE: can't find the kernel_name[%s] in HandleMap", bin_file_key);
-
-      rtDevBinary_t binary;
-      std::string json_string;
-      GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, TVM_ATTR_NAME_MAGIC, json_string),
-                      GELOGD("Get original type of session_graph_id."));
-      if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AICPU") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF_AICPU;
-      } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF;
-      } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AIVEC") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF_AIVEC;
-      } else {
-        GELOGE(PARAM_INVALID, "TBE: Invalid parameter magic number! json: %s", json_string.c_str());
-        return PARAM_INVALID;
-      }
-
-      binary.version = 0;
-      binary.data = tbe_kernel->GetBinData();
-      binary.length = tbe_kernel->GetBinDataSize();
-
-      GELOGD("TBE: binary.length: %lu", binary.length);
-      GE_CHK_RT_RET(rtDevBinaryRegister(&binary, &bin_handle));
-
-      std::string meta_data;
-      GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, TVM_ATTR_NAME_METADATA, meta_data),
-                      GELOGI("Get original type of json_string"));
-      GELOGD("TBE: meta data: %s", meta_data.empty() ? "null" : meta_data.c_str());
-      GE_IF_BOOL_EXEC(!meta_data.empty(), GE_CHK_RT_RET(rtMetadataRegister(bin_handle, meta_data.c_str())));
-
-      kernel_store.StoreTBEHandle(bin_file_key, bin_handle, tbe_kernel);
+    uint32_t magic = 0;
+    std::string json_string;
+    GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, TVM_ATTR_NAME_MAGIC, json_string),
+                    GELOGD("Get original type of session_graph_id."));
+    if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AICPU") {
+      magic = RT_DEV_BINARY_MAGIC_ELF_AICPU;
+    } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF") {
+      magic = RT_DEV_BINARY_MAGIC_ELF;
+    } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AIVEC") {
+      magic = RT_DEV_BINARY_MAGIC_ELF_AIVEC;
     } else {
-      GELOGI("TBE: find the kernel_name[%s] in HandleMap", bin_file_key);
-      kernel_store.ReferTBEHandle(bin_file_key);
+      GELOGE(PARAM_INVALID, "TBE: Invalid parameter magic number! json: %s", json_string.c_str());
+      return PARAM_INVALID;
     }
 
+    std::string meta_data;
+    GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, TVM_ATTR_NAME_METADATA, meta_data),
+                    GELOGI("Get original type of json_string"));
+    GELOGD("TBE: meta data: %s", meta_data.empty() ? "null" : meta_data.c_str());
+
+    // binary of same content registered by other model is shared, only the stub name is registered
+    void *bin_handle = nullptr;
+    GE_CHK_STATUS_RET(kernel_store.RegisterTBEHandle(bin_file_key, magic, meta_data, tbe_kernel, bin_handle),
+                      "TBE: register kernel_name[%s] failed.", bin_file_key);
+
     std::string kernel_name;
     GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc, op_desc->GetName() + "_kernelname", kernel_name),
                     GELOGD("Get original type of kernel_name"));
@@ -3558,11 +3545,11 @@ Status DavinciModel::InitTbeHandle(const OpDescPtr &op_desc) {
   }
 
   // Kernel registed, Increase used num in store.
-  StoreTbeHandle(bin_file_key);
+  StoreTbeHandle(bin_file_key, tbe_kernel);
   return SUCCESS;
 }
 
-void DavinciModel::StoreTbeHandle(const std::string &handle_key) {
+void DavinciModel::StoreTbeHandle(const std::string &handle_key, const TBEKernelPtr &tbe_kernel) {
   // Online mode FE may call rtFunctionRegister.
   TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
 
@@ -3579,6 +3566,9 @@ void DavinciModel::StoreTbeHandle(const std::string &handle_key) {
     // GE registered, increase reference.
     used_tbe_handle_map_[handle_key] = 1;  // Init used num to 1.
     kernel_store.ReferTBEHandle(handle_key);
+  } else if (kernel_store.ReferTBEBinary(handle_key, tbe_kernel)) {
+    // GE registered by a model unloaded, the name is erased while its function stays with the binary.
+    used_tbe_handle_map_[handle_key] = 1;  // Init used num to 1.
   }
 }
 
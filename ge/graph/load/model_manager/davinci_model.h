@@ -734,7 +734,7 @@ class DavinciModel {
   ///
   Status InitTbeHandle(const OpDescPtr &op_desc);
 
-  void StoreTbeHandle(const string &handle_key);
+  void StoreTbeHandle(const string &handle_key, const TBEKernelPtr &tbe_kernel);
   void CleanTbeHandle();
 
   ///
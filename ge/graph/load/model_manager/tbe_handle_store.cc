@@ -15,12 +15,37 @@
  */
 #include "tbe_handle_store.h"
 
+#include <cstring>
 #include <limits>
 #include "common/ge_inner_error_codes.h"
 #include "framework/common/debug/ge_log.h"
 #include "runtime/kernel.h"
 
 namespace ge {
+namespace {
+const uint64_t kFnvOffsetBasis = 14695981039346656037UL;
+const uint64_t kFnvPrime = 1099511628211UL;
+
+uint64_t HashBytes(const uint8_t *data, size_t size) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+bool IsSameBinary(const OpKernelBin &lhs, const OpKernelBin &rhs) {
+  if (lhs.GetBinDataSize() != rhs.GetBinDataSize()) {
+    return false;
+  }
+  if ((lhs.GetBinData() == rhs.GetBinData()) || (lhs.GetBinDataSize() == 0)) {
+    return true;
+  }
+  return memcmp(lhs.GetBinData(), rhs.GetBinData(), lhs.GetBinDataSize()) == 0;
+}
+}  // namespace
+
 void TbeHandleInfo::used_inc(uint32_t num) {
   if (used_ > std::numeric_limits<uint32_t>::max() - num) {
     GELOGE(INTERNAL_ERROR, "Used[%u] reach numeric max.", used_);
@@ -47,6 +72,10 @@ void *TbeHandleInfo::handle() const {
   return handle_;
 }
 
+const std::shared_ptr<OpKernelBin> &TbeHandleInfo::kernel() const {
+  return kernel_;
+}
+
 
 TBEHandleStore &TBEHandleStore::GetInstance() {
   static TBEHandleStore instance;
@@ -115,7 +144,7 @@ void TBEHandleStore::ReferTBEHandle(const std::string &name) {
 
 ///
 /// @ingroup ge
-/// @brief Erase TBE registered handle record.
+/// @brief Erase TBE registered handle record, binary is unregistered when no name refers to it.
 /// @param [in] names: handle names erase.
 /// @return NA
 ///
@@ -132,12 +161,215 @@ void TBEHandleStore::EraseTBEHandle(const std::map<std::string, uint32_t> &names
     if (info.used_num() > item.second) {
       info.used_dec(item.second);
     } else {
-      rtError_t rt_ret = rtDevBinaryUnRegister(info.handle());
+      ReleaseTBEBinary(item.first, info);
+      kernels_.erase(it);
+    }
+  }
+}
+
+///
+/// @ingroup ge
+/// @brief Register TBE kernel bin by name, binary of same content is registered to device only once.
+/// @param [in] name: TBE handle name to register.
+/// @param [in] magic: magic of device binary.
+/// @param [in] meta_data: meta data of kernel bin, registered with binary.
+/// @param [in] kernel: TBE kernel bin to register.
+/// @param [out] handle: TBE handle addr registered.
+/// @return Status
+///
+Status TBEHandleStore::RegisterTBEHandle(const std::string &name, uint32_t magic, const std::string &meta_data,
+                                         std::shared_ptr<OpKernelBin> &kernel, void *&handle) {
+  if (kernel == nullptr) {
+    GELOGE(PARAM_INVALID, "TBE: kernel bin of %s is null.", name.c_str());
+    return PARAM_INVALID;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = kernels_.find(name);
+  if (it != kernels_.end()) {
+    GELOGD("TBE: find the kernel_name[%s] in HandleMap, used num = %u.", name.c_str(), it->second.used_num());
+    it->second.used_inc();
+    handle = it->second.handle();
+    return SUCCESS;
+  }
+
+  uint64_t hash = HashBytes(kernel->GetBinData(), kernel->GetBinDataSize());
+  TbeBinaryInfo *binary_info = FindTBEBinary(hash, magic, meta_data, *kernel);
+  if (binary_info != nullptr) {
+    // same binary registered by other model or session, share the device handle and the host kernel bin.
+    binary_info->used++;
+    GELOGI("TBE: kernel_name[%s] shares binary of size %zu, binary used num = %u.", name.c_str(),
+           kernel->GetBinDataSize(), binary_info->used);
+  } else {
+    rtDevBinary_t binary;
+    binary.magic = magic;
+    binary.version = 0;
+    binary.data = kernel->GetBinData();
+    binary.length = kernel->GetBinDataSize();
+    GELOGD("TBE: binary.length: %lu", binary.length);
+    void *bin_handle = nullptr;
+    rtError_t rt_ret = rtDevBinaryRegister(&binary, &bin_handle);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(RT_FAILED, "TBE: kernel_name[%s] register binary failed, ret: 0x%X", name.c_str(), rt_ret);
+      return RT_ERROR_TO_GE_STATUS(rt_ret);
+    }
+    if (!meta_data.empty()) {
+      rt_ret = rtMetadataRegister(bin_handle, meta_data.c_str());
       if (rt_ret != RT_ERROR_NONE) {
-        GELOGE(INTERNAL_ERROR, "Kernel[%s] UnRegister handle fail:%u.", item.first.c_str(), rt_ret);
+        GELOGE(RT_FAILED, "TBE: kernel_name[%s] register meta data failed, ret: 0x%X", name.c_str(), rt_ret);
+        (void)rtDevBinaryUnRegister(bin_handle);
+        return RT_ERROR_TO_GE_STATUS(rt_ret);
       }
-      kernels_.erase(it);
     }
+
+    TbeBinaryInfo new_info;
+    new_info.handle = bin_handle;
+    new_info.kernel = kernel;
+    new_info.magic = magic;
+    new_info.meta_data = meta_data;
+    new_info.used = 1;
+    auto &binaries = binaries_[hash];
+    binaries.emplace_back(std::move(new_info));
+    binary_info = &binaries.back();
+  }
+
+  TbeHandleInfo info(binary_info->handle, binary_info->kernel);
+  info.used_inc();
+  kernels_.emplace(name, info);
+  name_hashes_[name] = hash;
+  handle = binary_info->handle;
+  return SUCCESS;
+}
+
+///
+/// @ingroup ge
+/// @brief Refer registered binary of same content by name, whose function is registered to the binary before.
+/// @param [in] name: TBE handle name to refer.
+/// @param [in] kernel: TBE kernel bin of the name.
+/// @return true: referred / false: no binary of same content registered.
+///
+bool TBEHandleStore::ReferTBEBinary(const std::string &name, const std::shared_ptr<OpKernelBin> &kernel) {
+  if (kernel == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = kernels_.find(name);
+  if (it != kernels_.end()) {
+    it->second.used_inc();
+    return true;
+  }
+
+  // Functions are unregistered with their binary, so the binary a registered function belongs to is still
+  // registered, and it is the only one of its content unless magic or meta data differs.
+  uint64_t hash = HashBytes(kernel->GetBinData(), kernel->GetBinDataSize());
+  auto bin_it = binaries_.find(hash);
+  if (bin_it == binaries_.end()) {
+    return false;
+  }
+  TbeBinaryInfo *binary_info = nullptr;
+  for (auto &candidate : bin_it->second) {
+    if (!IsSameBinary(*candidate.kernel, *kernel)) {
+      continue;
+    }
+    if (binary_info != nullptr) {
+      GELOGW("TBE: kernel_name[%s] matches more than one binary, not referred.", name.c_str());
+      return false;
+    }
+    binary_info = &candidate;
+  }
+  if (binary_info == nullptr) {
+    return false;
+  }
+
+  binary_info->used++;
+  TbeHandleInfo info(binary_info->handle, binary_info->kernel);
+  info.used_inc();
+  kernels_.emplace(name, info);
+  name_hashes_[name] = hash;
+  GELOGD("TBE: kernel_name[%s] refers binary again, binary used num = %u.", name.c_str(), binary_info->used);
+  return true;
+}
+
+///
+/// @ingroup ge
+/// @brief Get statistic of registered names and unique binaries.
+/// @return TbeHandleStatistic
+///
+TbeHandleStatistic TBEHandleStore::GetStatistic() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TbeHandleStatistic statistic;
+  for (const auto &item : kernels_) {
+    if (item.second.used_num() == 0) {
+      continue;
+    }
+    statistic.name_num++;
+    statistic.reference_num += item.second.used_num();
+  }
+  for (const auto &item : binaries_) {
+    for (const auto &binary_info : item.second) {
+      statistic.binary_num++;
+      statistic.binary_size += binary_info.kernel->GetBinDataSize();
+      statistic.shared_size += (binary_info.used - 1) * binary_info.kernel->GetBinDataSize();
+    }
+  }
+  return statistic;
+}
+
+TBEHandleStore::TbeBinaryInfo *TBEHandleStore::FindTBEBinary(uint64_t hash, uint32_t magic,
+                                                             const std::string &meta_data,
+                                                             const OpKernelBin &kernel) {
+  auto it = binaries_.find(hash);
+  if (it == binaries_.end()) {
+    return nullptr;
+  }
+  for (auto &binary_info : it->second) {
+    if ((binary_info.magic == magic) && (binary_info.meta_data == meta_data) &&
+        IsSameBinary(*binary_info.kernel, kernel)) {
+      return &binary_info;
+    }
+  }
+  return nullptr;
+}
+
+void TBEHandleStore::ReleaseTBEBinary(const std::string &name, const TbeHandleInfo &info) {
+  auto hash_it = name_hashes_.find(name);
+  if (hash_it == name_hashes_.end()) {
+    // stored by StoreTBEHandle, handle is owned by the name only.
+    rtError_t rt_ret = rtDevBinaryUnRegister(info.handle());
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(INTERNAL_ERROR, "Kernel[%s] UnRegister handle fail:%u.", name.c_str(), rt_ret);
+    }
+    return;
+  }
+
+  auto bin_it = binaries_.find(hash_it->second);
+  name_hashes_.erase(hash_it);
+  if (bin_it == binaries_.end()) {
+    GELOGE(INTERNAL_ERROR, "TBE: binary of kernel_name[%s] not found.", name.c_str());
+    return;
+  }
+  auto &binaries = bin_it->second;
+  for (auto iter = binaries.begin(); iter != binaries.end(); ++iter) {
+    if ((iter->handle != info.handle()) || (iter->kernel != info.kernel())) {
+      continue;
+    }
+    if (--iter->used > 0) {
+      GELOGD("TBE: kernel_name[%s] released, binary used num = %u.", name.c_str(), iter->used);
+      return;
+    }
+    // functions registered to the binary are unregistered with it
+    rtError_t rt_ret = rtDevBinaryUnRegister(iter->handle);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGE(INTERNAL_ERROR, "Kernel[%s] UnRegister handle fail:%u.", name.c_str(), rt_ret);
+    }
+    GELOGI("TBE: binary of size %zu unregistered with kernel_name[%s].", iter->kernel->GetBinDataSize(),
+           name.c_str());
+    binaries.erase(iter);
+    if (binaries.empty()) {
+      binaries_.erase(bin_it);
+    }
+    return;
   }
+  GELOGE(INTERNAL_ERROR, "TBE: binary of kernel_name[%s] not found.", name.c_str());
 }
 } // namespace ge
@@ -24,8 +24,10 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/fmk_types.h"
+#include "framework/common/ge_inner_error_codes.h"
 #include "graph/op_kernel_bin.h"
 
 namespace ge {
@@ -40,6 +42,7 @@ class TbeHandleInfo {
   uint32_t used_num() const;
 
   void *handle() const;
+  const std::shared_ptr<OpKernelBin> &kernel() const;
 
  private:
   uint32_t used_;
@@ -48,6 +51,14 @@ class TbeHandleInfo {
   std::shared_ptr<OpKernelBin> kernel_;
 };
 
+struct TbeHandleStatistic {
+  size_t name_num = 0;       // stub names referred by loaded models
+  size_t binary_num = 0;     // unique kernel binaries registered to device
+  size_t reference_num = 0;  // references of all stub names
+  size_t binary_size = 0;    // bytes of unique kernel binaries
+  size_t shared_size = 0;    // bytes not registered again since an identical binary was found, at present
+};
+
 class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
  public:
   static TBEHandleStore &GetInstance();
@@ -81,18 +92,62 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY TBEHandleStore {
 
   ///
   /// @ingroup ge
-  /// @brief Erase TBE registered handle record.
+  /// @brief Erase TBE registered handle record, binary is unregistered when no name refers to it.
   /// @param [in] names: handle names erase.
   /// @return NA
   ///
   void EraseTBEHandle(const std::map<std::string, uint32_t> &names);
 
+  ///
+  /// @ingroup ge
+  /// @brief Register TBE kernel bin by name, binary of same content is registered to device only once.
+  /// @param [in] name: TBE handle name to register.
+  /// @param [in] magic: magic of device binary.
+  /// @param [in] meta_data: meta data of kernel bin, registered with binary.
+  /// @param [in] kernel: TBE kernel bin to register.
+  /// @param [out] handle: TBE handle addr registered.
+  /// @return Status
+  ///
+  Status RegisterTBEHandle(const std::string &name, uint32_t magic, const std::string &meta_data,
+                           std::shared_ptr<OpKernelBin> &kernel, void *&handle);
+
+  ///
+  /// @ingroup ge
+  /// @brief Refer registered binary of same content by name, whose function is registered to the binary before.
+  /// @param [in] name: TBE handle name to refer.
+  /// @param [in] kernel: TBE kernel bin of the name.
+  /// @return true: referred / false: no binary of same content registered.
+  ///
+  bool ReferTBEBinary(const std::string &name, const std::shared_ptr<OpKernelBin> &kernel);
+
+  ///
+  /// @ingroup ge
+  /// @brief Get statistic of registered names and unique binaries.
+  /// @return TbeHandleStatistic
+  ///
+  TbeHandleStatistic GetStatistic();
+
  private:
   TBEHandleStore() = default;
   ~TBEHandleStore() = default;
 
+  // Device binary shared by all names whose kernel bin has the same content
+  struct TbeBinaryInfo {
+    void *handle = nullptr;
+    std::shared_ptr<OpKernelBin> kernel;
+    uint32_t magic = 0;
+    std::string meta_data;
+    uint32_t used = 0;  // number of names referring to the binary
+  };
+
+  TbeBinaryInfo *FindTBEBinary(uint64_t hash, uint32_t magic, const std::string &meta_data,
+                               const OpKernelBin &kernel);
+  void ReleaseTBEBinary(const std::string &name, const TbeHandleInfo &info);
+
   std::mutex mutex_;
   std::unordered_map<std::string, TbeHandleInfo> kernels_;
+  std::unordered_map<uint64_t, std::vector<TbeBinaryInfo>> binaries_;  // content hash to binaries
+  std::unordered_map<std::string, uint64_t> name_hashes_;               // name to content hash of its binary
 };
 }  // namespace ge
 
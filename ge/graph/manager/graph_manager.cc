@@ -27,11 +27,14 @@
 #include "common/math/math_util.h"
 #include "common/thread_pool.h"
 #include "analyzer/analyzer.h"
+#include "graph/common/folding_cache.h"
 #include "graph/common/ge_call_wrapper.h"
 #include "graph/common/local_context.h"
 #include "graph/common/transop_util.h"
 #include "graph/ge_context.h"
 #include "graph/ge_global_options.h"
+#include "graph/manager/graph_var_manager.h"
+#include "graph/manager/subgraph_optimize_scheduler.h"
 #include "graph/manager/util/rt_context_util.h"
 #include "graph/partition/dynamic_shape_partition.h"
 #include "graph/passes/enter_pass.h"
@@ -519,61 +522,75 @@ Status GraphManager::CopySubGraphAndMarkFusion(const ComputeGraphPtr &compute_gr
 Status GraphManager::OptimizeSubGraphWithMultiThreads(ComputeGraphPtr compute_graph,
                                                       Graph2SubGraphInfoList &sub_graph_map, uint64_t session_id) {
   GE_CHECK_NOTNULL(compute_graph);
-  // use default 16 multi thread
-  uint32_t thread_num = 16;
-
-  char *env = std::getenv("THREAD_MULTI_NUM");
-  if (env != nullptr) {
-    thread_num = atoi(env);
-    GEEVENT("OptimizeSubGraphWithMultiThreads thread num: %u", thread_num);
-  }
-
-
-  ThreadPool executor(thread_num);
-  std::vector<std::future<Status>> vector_future;
-  const auto &root_subgraph_list = sub_graph_map[compute_graph];
   std::string op_compile_strategy;
   (void)AttrUtils::GetStr(compute_graph, ATTR_NAME_OP_COMPILE_STRATEGY, op_compile_strategy);
   GELOGD("OptimizeSubGraphWithMultiThreads Process op_compile_strategy:%s", op_compile_strategy.c_str());
-  for (const auto &subgraph : root_subgraph_list) {
+  std::vector<SubGraphInfoPtr> all_subgraphs = sub_graph_map[compute_graph];
+  for (auto &function_graph : compute_graph->GetAllSubgraphs()) {
+    const auto &subgraph_list = sub_graph_map[function_graph];
+    all_subgraphs.insert(all_subgraphs.end(), subgraph_list.begin(), subgraph_list.end());
+  }
+  for (const auto &subgraph : all_subgraphs) {
+    GE_CHECK_NOTNULL(subgraph);
     if (!op_compile_strategy.empty()) {
       (void) AttrUtils::SetStr(subgraph->GetSubGraph(), ATTR_NAME_OP_COMPILE_STRATEGY, op_compile_strategy);
     }
-    std::future<Status> f = executor.commit(GraphManager::ProcessSubGraphWithMultiThreads, this,
-                                            compute_graph->GetGraphID(), subgraph,
-                                            compute_graph->GetName(), session_id,
-                                            GetThreadLocalContext());
+  }
+
+  // submit the most expensive subgraphs first, so that they do not lengthen the critical path
+  auto &scheduler = SubGraphOptimizeScheduler::Instance();
+  scheduler.SortByEstimatedCost(all_subgraphs);
+  auto &executor = scheduler.GetThreadPool();
+  std::vector<std::future<Status>> vector_future;
+  std::vector<uint64_t> costs(all_subgraphs.size(), 0);
+  uint64_t start_time = GetCurrentTimestamp();
+  Status ret = SUCCESS;
+  for (size_t i = 0; i < all_subgraphs.size(); ++i) {
+    const auto &subgraph = all_subgraphs[i];
+    auto &cost = costs[i];
+    std::future<Status> f = executor.commit([this, &compute_graph, &subgraph, &cost, session_id](
+        const GEThreadLocalContext &ge_context) -> Status {
+      uint64_t subgraph_start_time = GetCurrentTimestamp();
+      Status ret = GraphManager::ProcessSubGraphWithMultiThreads(this, compute_graph->GetGraphID(), subgraph,
+                                                                 compute_graph->GetName(), session_id, ge_context);
+      cost = GetCurrentTimestamp() - subgraph_start_time;
+      return ret;
+    }, GetThreadLocalContext());
     if (!f.valid()) {
+      // tasks already committed still have to be waited for
       GELOGE(FAILED, "Future is invalid");
-      return FAILED;
+      ret = FAILED;
+      break;
     }
     vector_future.emplace_back(std::move(f));
   }
-  for (auto &function_graph : compute_graph->GetAllSubgraphs()) {
-    auto subgraph_list = sub_graph_map[function_graph];
-    for (const auto &subgraph : subgraph_list) {
-      if (!op_compile_strategy.empty()) {
-        (void) AttrUtils::SetStr(subgraph->GetSubGraph(), ATTR_NAME_OP_COMPILE_STRATEGY, op_compile_strategy);
-      }
-      std::future<Status> f = executor.commit(GraphManager::ProcessSubGraphWithMultiThreads, this,
-                                              compute_graph->GetGraphID(), subgraph,
-                                              compute_graph->GetName(), session_id,
-                                              GetThreadLocalContext());
-      if (!f.valid()) {
-        GELOGE(FAILED, "Future is invalid");
-        return FAILED;
-      }
-      vector_future.emplace_back(std::move(f));
-    }
-  }
-  GELOGD("All sub graph num is %zu", vector_future.size());
+  GELOGD("All sub graph num is %zu, committed num is %zu", all_subgraphs.size(), vector_future.size());
   for (size_t i = 0; i < vector_future.size(); ++i) {
+    // wait for all tasks before return, they refer to costs and subgraphs on stack
     Status ret_status = vector_future[i].get();
-    if (ret_status != SUCCESS) {
+    if ((ret_status != SUCCESS) && (ret == SUCCESS)) {
       GELOGE(ret_status, "subgraph %zu optimize failed", i);
-      return ret_status;
+      ret = ret_status;
     }
   }
+  GE_CHK_STATUS_RET_NOLOG(ret);
+
+  size_t critical_index = 0;
+  for (size_t i = 0; i < all_subgraphs.size(); ++i) {
+    const auto &subgraph = all_subgraphs[i];
+    size_t node_num = subgraph->GetSubGraph() == nullptr ? 0 : subgraph->GetSubGraph()->GetAllNodesSize();
+    GELOGI("Optimize subgraph %s of engine %s, node num %zu, cost %lu us.",
+           subgraph->GetSubGraph() == nullptr ? "" : subgraph->GetSubGraph()->GetName().c_str(),
+           subgraph->GetEngineName().c_str(), node_num, costs[i]);
+    scheduler.RecordCost(subgraph->GetEngineName(), node_num, costs[i]);
+    critical_index = costs[i] > costs[critical_index] ? i : critical_index;
+  }
+  if (!all_subgraphs.empty()) {
+    GEEVENT("Optimize %zu subgraphs of graph %s cost %lu us, the longest is subgraph %s of engine %s, cost %lu us.",
+            all_subgraphs.size(), compute_graph->GetName().c_str(), GetCurrentTimestamp() - start_time,
+            all_subgraphs[critical_index]->GetSubGraph()->GetName().c_str(),
+            all_subgraphs[critical_index]->GetEngineName().c_str(), costs[critical_index]);
+  }
   return SUCCESS;
 }
 
@@ -896,6 +913,8 @@ Status GraphManager::StartForRunGraph(const GraphNodePtr &graph_node, const std:
       return ret;
     }
   }
+  // variables of the session stay unchanged until another graph is compiled, lookups go lock free from now on
+  VarManager::Instance(session_id)->PublishSnapshot();
   return ret;
 }
 Status GraphManager::LoadGraph(const GeRootModelPtr &ge_root_model, const GraphNodePtr &graph_node) {
@@ -2199,6 +2218,13 @@ Status GraphManager::OptimizeStage1(ge::ComputeGraphPtr &compute_graph) {
     GELOGI("The time cost of %s constant folding is [%lu] micro second, calls is %lu.",
            it.first.c_str(), it.second.second, it.second.first);
   }
+  auto folding_cache_statistic = FoldingCache::Instance().GetStatistic();
+  if (folding_cache_statistic.memory_budget > 0) {
+    GEEVENT("[GEPERFTRACE] Constant folding cache hit %lu, miss %lu, evict %lu, entries %lu, size %lu/%lu bytes.",
+            folding_cache_statistic.hit_count, folding_cache_statistic.miss_count, folding_cache_statistic.evict_count,
+            folding_cache_statistic.entry_count, folding_cache_statistic.cached_size,
+            folding_cache_statistic.memory_budget);
+  }
 
   GE_DUMP(compute_graph, "OptimizeStage1_2");
   PassManager graph_pass;
@@ -37,7 +37,7 @@ VarResource::~VarResource() {
 }
 
 ge::Status VarResource::GetVarAddr(const std::string &var_name, const ge::GeTensorDesc &tensor_desc, uint8_t **dev_ptr,
-                                   rtMemType_t &memory_type) {
+                                   rtMemType_t &memory_type) const {
   if (dev_ptr == nullptr) {
     GELOGE(FAILED, "[GetVarAddr] dev_ptr is null!");
     return FAILED;
@@ -106,12 +106,23 @@ ge::Status VarResource::SaveVarAddr(const std::string &var_name, const ge::GeTen
   return FAILED;
 }
 
-bool VarResource::IsVarExist(const std::string &var_name, const ge::GeTensorDesc &tensor_desc) {
+bool VarResource::IsVarExist(const std::string &var_name, const ge::GeTensorDesc &tensor_desc) const {
   std::string var_key = VarKey(var_name, tensor_desc);
   return var_addr_mgr_map_.count(var_key) != 0;
 }
 
-bool VarResource::IsVarExist(const std::string &var_name) { return cur_var_tensor_desc_map_.count(var_name) != 0; }
+bool VarResource::IsVarExist(const std::string &var_name) const { return cur_var_tensor_desc_map_.count(var_name) != 0; }
+
+std::shared_ptr<const VarResource> VarResource::CreateReadSnapshot() const {
+  std::shared_ptr<VarResource> snapshot(new (std::nothrow) VarResource(session_id_));
+  if (snapshot == nullptr) {
+    return nullptr;
+  }
+  snapshot->var_offset_map_ = var_offset_map_;
+  snapshot->var_addr_mgr_map_ = var_addr_mgr_map_;
+  snapshot->cur_var_tensor_desc_map_ = cur_var_tensor_desc_map_;
+  return snapshot;
+}
 
 std::string VarResource::VarKey(const std::string &var_name, const ge::GeTensorDesc &tensor_desc) {
   std::string var_key(var_name);
@@ -121,11 +132,12 @@ std::string VarResource::VarKey(const std::string &var_name, const ge::GeTensorD
   return var_key;
 }
 
-ge::Status VarResource::GetCurVarDesc(const std::string &var_name, ge::GeTensorDesc &tensor_desc) {
-  if (cur_var_tensor_desc_map_.count(var_name) == 0) {
+ge::Status VarResource::GetCurVarDesc(const std::string &var_name, ge::GeTensorDesc &tensor_desc) const {
+  auto iter = cur_var_tensor_desc_map_.find(var_name);
+  if (iter == cur_var_tensor_desc_map_.end()) {
     return FAILED;
   }
-  tensor_desc = cur_var_tensor_desc_map_[var_name];
+  tensor_desc = iter->second;
   return SUCCESS;
 }
 
@@ -206,11 +218,12 @@ ge::Status VarResource::SyncVarData(uint32_t graph_id, const std::string &var_na
   return SyncVarData2BroadCast(graph_id, var_name, var_tensor_desc, base_ptr);
 }
 
-bool VarResource::IsVarAddr(const int64_t &offset) { return var_offset_map_.count(offset) > 0; }
+bool VarResource::IsVarAddr(const int64_t &offset) const { return var_offset_map_.count(offset) > 0; }
 
-rtMemType_t VarResource::GetVarMemType(const int64_t &offset) {
-  if (var_offset_map_.count(offset) > 0) {
-    return var_offset_map_[offset];
+rtMemType_t VarResource::GetVarMemType(const int64_t &offset) const {
+  auto iter = var_offset_map_.find(offset);
+  if (iter != var_offset_map_.end()) {
+    return iter->second;
   }
   return RT_MEMORY_RESERVED;
 }
@@ -324,13 +337,36 @@ VarManager::VarManager(uint64_t session_id)
       use_max_mem_size_(kUseMaxMemorySize) {}
 
 VarManager *VarManager::Instance(uint64_t session_id) {
-  GELOGD("VarManager::Instance, session id = %lu", session_id);
   return VarManagerPool::Instance().GetVarManager(session_id);
 }
 
+std::shared_ptr<const VarResource> VarManager::GetReadSnapshot() const {
+  return std::atomic_load(&read_snapshot_);
+}
+
+void VarManager::PublishSnapshot() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (var_resource_ == nullptr) {
+    return;
+  }
+  auto snapshot = var_resource_->CreateReadSnapshot();
+  if (snapshot == nullptr) {
+    GELOGW("Failed to create read snapshot of VarManager, session id = %lu.", session_id_);
+    return;
+  }
+  std::atomic_store(&read_snapshot_, snapshot);
+  GELOGD("VarManager read snapshot published, session id = %lu.", session_id_);
+}
+
+void VarManager::InvalidateReadSnapshot() {
+  // called with mutex_ held
+  std::atomic_store(&read_snapshot_, std::shared_ptr<const VarResource>());
+}
+
 void VarManager::Destory() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   GELOGI("VarManager::Destory, session id = %lu.", session_id_);
+  InvalidateReadSnapshot();
   version_ = SessionVersion::OTHER_VERSION;
   device_id_ = 0;
   session_id_ = 0;
@@ -351,6 +387,7 @@ ge::Status VarManager::Init(const uint32_t &version, const uint64_t &session_id,
   device_id_ = device_id;
   session_id_ = session_id;
   job_id_ = job_id;
+  InvalidateReadSnapshot();
   var_resource_ = std::unique_ptr<VarResource>(new (std::nothrow) VarResource(session_id_));
   if (var_resource_ == nullptr) {
     GELOGW("VarManager has not been init.");
@@ -385,6 +422,7 @@ ge::Status VarManager::SetVarAddr(const std::string &var_name, const ge::GeTenso
     GELOGW("VarManager has not been init.");
     return ge::INTERNAL_ERROR;
   }
+  InvalidateReadSnapshot();
   var_resource_->SetVarAddr(var_name, tensor_desc, dev_ptr, memory_type);
   return ge::SUCCESS;
 }
@@ -400,12 +438,22 @@ ge::Status VarManager::SaveVarAddr(const std::string &var_name, const ge::GeTens
     GELOGW("VarManager has not been init.");
     return ge::INTERNAL_ERROR;
   }
+  InvalidateReadSnapshot();
   var_resource_->SaveVarAddr(var_name, tensor_desc, address, memory_type);
   return ge::SUCCESS;
 }
 
 ge::Status VarManager::GetVarAddr(const std::string &var_name, const ge::GeTensorDesc &tensor_desc, uint8_t **dev_ptr,
                                   rtMemType_t &memory_type) {
+  auto snapshot = GetReadSnapshot();
+  if (snapshot != nullptr) {
+    if (snapshot->GetVarAddr(var_name, tensor_desc, dev_ptr, memory_type) != SUCCESS) {
+      GELOGW("GetVarAddr fail.");
+      return ge::INTERNAL_ERROR;
+    }
+    return SUCCESS;
+  }
+
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   GELOGD("VarManager::GetVarAddr var_name = %s, data_type = %s, data_format = %s", var_name.c_str(),
          ge::TypeUtils::DataTypeToSerialString(tensor_desc.GetDataType()).c_str(),
@@ -424,7 +472,6 @@ ge::Status VarManager::GetVarAddr(const std::string &var_name, const ge::GeTenso
 }
 
 ge::Status VarManager::GetVarAddr(const std::string &var_name, const ge::GeTensorDesc &tensor_desc, uint8_t **dev_ptr) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
   rtMemType_t memory_type = RT_MEMORY_HBM;
   return GetVarAddr(var_name, tensor_desc, dev_ptr, memory_type);
 }
@@ -477,6 +524,7 @@ Status VarManager::UpdateVarMemSize(rtMemType_t memory_type, int64_t mem_size) {
 ge::Status VarManager::AssignVarMem(const std::string &var_name, const ge::GeTensorDesc &tensor_desc,
                                     rtMemType_t memory_type) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  InvalidateReadSnapshot();
   GELOGI("VarManager::AssignVarMem var_name = %s, data_type = %s, data_format = %s.", var_name.c_str(),
          ge::TypeUtils::DataTypeToSerialString(tensor_desc.GetDataType()).c_str(),
          ge::TypeUtils::FormatToSerialString(tensor_desc.GetFormat()).c_str());
@@ -557,6 +605,10 @@ ge::Status VarManager::AssignVarMem(const std::string &var_name, const ge::GeTen
 }
 
 bool VarManager::IsVarExist(const std::string &var_name, const ge::GeTensorDesc &tensor_desc) {
+  auto snapshot = GetReadSnapshot();
+  if (snapshot != nullptr) {
+    return snapshot->IsVarExist(var_name, tensor_desc);
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   GELOGD("VarManager::IsVarExist var_name = %s, data_type = %s, data_format = %s", var_name.c_str(),
          ge::TypeUtils::FormatToSerialString(tensor_desc.GetFormat()).c_str(),
@@ -570,6 +622,10 @@ bool VarManager::IsVarExist(const std::string &var_name, const ge::GeTensorDesc
 }
 
 bool VarManager::IsVarExist(const std::string &var_name) {
+  auto snapshot = GetReadSnapshot();
+  if (snapshot != nullptr) {
+    return snapshot->IsVarExist(var_name);
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (var_resource_ == nullptr) {
     GELOGW("VarManager has not been init.");
@@ -589,9 +645,13 @@ ge::Status VarManager::SyncVarData(uint32_t graph_id, const std::string &var_nam
 }
 
 ge::Status VarManager::GetCurVarDesc(const std::string &var_name, ge::GeTensorDesc &tensor_desc) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  GELOGI("VarManager::GetCurVarDesc var_name = %s.", var_name.c_str());
+  GELOGD("VarManager::GetCurVarDesc var_name = %s.", var_name.c_str());
+  auto snapshot = GetReadSnapshot();
+  if (snapshot != nullptr) {
+    return snapshot->GetCurVarDesc(var_name, tensor_desc);
+  }
 
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (var_resource_ == nullptr) {
     GELOGW("VarManager has not been init.");
     return ge::INTERNAL_ERROR;
@@ -634,6 +694,7 @@ ge::Status VarManager::RenewCurVarDesc(const std::string &var_name, ge::OpDescPt
     GELOGE(ge::INTERNAL_ERROR, "VarManager has not been init.");
     return ge::INTERNAL_ERROR;
   }
+  InvalidateReadSnapshot();
   return var_resource_->RenewCurVarDesc(var_name, std::move(op_desc));
 }
 
@@ -648,6 +709,10 @@ ge::Status VarManager::SyncBroadCastData2Var(uint32_t graph_id, const std::strin
 }
 
 bool VarManager::IsVarAddr(const int64_t &offset) {
+  auto snapshot = GetReadSnapshot();
+  if (snapshot != nullptr) {
+    return snapshot->IsVarAddr(offset);
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (var_resource_ == nullptr) {
     GELOGD("VarManager has not been init.");
@@ -657,6 +722,10 @@ bool VarManager::IsVarAddr(const int64_t &offset) {
 }
 
 rtMemType_t VarManager::GetVarMemType(const int64_t &offset) {
+  auto snapshot = GetReadSnapshot();
+  if (snapshot != nullptr) {
+    return snapshot->GetVarMemType(offset);
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (var_resource_ == nullptr) {
     GELOGW("VarManager has not been init.");
@@ -913,6 +982,7 @@ VarManagerPool &VarManagerPool::Instance() {
 
 void VarManagerPool::Destory() noexcept {
   std::lock_guard<std::mutex> lock(var_manager_mutex_);
+  generation_++;
   for (auto &it : var_manager_map_) {
     VarManager *var_manager = it.second;
     if (var_manager != nullptr) {
@@ -927,10 +997,25 @@ void VarManagerPool::Destory() noexcept {
 ge::Status VarManagerPool::Init() const { return SUCCESS; }
 
 VarManager *VarManagerPool::GetVarManager(uint64_t session_id) {
+  struct CachedVarManager {
+    uint64_t session_id = 0;
+    uint64_t generation = 0;
+    VarManager *var_manager = nullptr;
+  };
+  // most threads work on one session, skip the pool lock while no manager was deleted since cached
+  thread_local CachedVarManager cached;
+  uint64_t generation = generation_.load();
+  if ((cached.var_manager != nullptr) && (cached.session_id == session_id) && (cached.generation == generation)) {
+    return cached.var_manager;
+  }
+
   std::lock_guard<std::mutex> lock(var_manager_mutex_);
   auto it = var_manager_map_.find(session_id);
   if (it != var_manager_map_.end()) {
     GELOGD("VarManagerPool::GetVarManager");
+    cached.session_id = session_id;
+    cached.generation = generation;
+    cached.var_manager = it->second;
     return it->second;
   }
 
@@ -944,6 +1029,9 @@ VarManager *VarManagerPool::GetVarManager(uint64_t session_id) {
     return &new_var_manager;
   }
   var_manager_map_[session_id] = var_manager;
+  cached.session_id = session_id;
+  cached.generation = generation;
+  cached.var_manager = var_manager;
   return var_manager;
 }
 
@@ -955,6 +1043,7 @@ void VarManagerPool::RemoveVarManager(uint64_t session_id) {
     if (it != var_manager_map_.end()) {
       var_manager = it->second;
       var_manager_map_.erase(it);
+      generation_++;
     }
   }
 
@@ -100,7 +100,7 @@ class VarResource {
   ~VarResource();
 
   ge::Status GetVarAddr(const std::string &var_name, const ge::GeTensorDesc &tensor_desc, uint8_t **dev_ptr,
-                        rtMemType_t &memory_type);
+                        rtMemType_t &memory_type) const;
 
   void GetAllVarAddrMgr(std::unordered_map<std::string, VarAddrMgr> &var_addr_mgr_map);
 
@@ -110,7 +110,7 @@ class VarResource {
   ge::Status SaveVarAddr(const std::string &var_name, const ge::GeTensorDesc &tensor_desc, uint8_t *address,
                          rtMemType_t memory_type);
 
-  ge::Status GetCurVarDesc(const std::string &var_name, ge::GeTensorDesc &tensor_desc);
+  ge::Status GetCurVarDesc(const std::string &var_name, ge::GeTensorDesc &tensor_desc) const;
 
   ge::Status RenewCurVarDesc(const std::string &var_name, const ge::OpDescPtr &op_desc);
 
@@ -152,18 +152,24 @@ class VarResource {
 
   void RemoveAllocatedGraphId(const std::string &var_name) { var_names_to_allocated_graph_id_.erase(var_name); }
 
-  bool IsVarExist(const std::string &var_name, const ge::GeTensorDesc &tensor_desc);
+  bool IsVarExist(const std::string &var_name, const ge::GeTensorDesc &tensor_desc) const;
 
-  bool IsVarExist(const std::string &var_name);
+  bool IsVarExist(const std::string &var_name) const;
 
-  bool IsVarAddr(const int64_t &offset);
+  bool IsVarAddr(const int64_t &offset) const;
 
-  rtMemType_t GetVarMemType(const int64_t &offset);
+  rtMemType_t GetVarMemType(const int64_t &offset) const;
 
   std::unordered_map<std::string, ge::GeTensorDesc> GetAllVarDesc() const { return cur_var_tensor_desc_map_; }
 
+  ///
+  /// @brief copy the maps read by GetVarAddr, GetCurVarDesc, IsVarExist, IsVarAddr and GetVarMemType
+  /// @return resource only valid for these lookups, nullptr if out of memory
+  ///
+  std::shared_ptr<const VarResource> CreateReadSnapshot() const;
+
  private:
-  std::string VarKey(const std::string &var_name, const ge::GeTensorDesc &tensor_desc);
+  static std::string VarKey(const std::string &var_name, const ge::GeTensorDesc &tensor_desc);
 
   uint64_t session_id_;
   std::unordered_map<uint64_t, rtMemType_t> var_offset_map_;
@@ -219,6 +225,12 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY VarManager {
 
   void Destory();
 
+  ///
+  /// @brief publish a copy of the variable lookup maps, lookups read it without lock until the next write
+  ///        called when graphs of the session were compiled and loaded
+  ///
+  void PublishSnapshot();
+
   ge::Status AssignVarMem(const std::string &var_name, const ge::GeTensorDesc &tensor_desc, rtMemType_t memory_type);
 
   ge::Status SetVarAddr(const std::string &var_name, const ge::GeTensorDesc &tensor_desc, uint8_t *dev_ptr,
@@ -314,8 +326,13 @@ class FMK_FUNC_HOST_VISIBILITY FMK_FUNC_DEV_VISIBILITY VarManager {
   std::unique_ptr<ge::VarResource> var_resource_;
   map<rtMemType_t, MemResource *> mem_resource_map_;
   mutable std::recursive_mutex mutex_;
+  // immutable copy of the lookup maps of var_resource_ read without mutex_, set by PublishSnapshot
+  // and dropped on every write
+  std::shared_ptr<const VarResource> read_snapshot_;
 
   Status ParseMemoryMallocSize(std::string &memory_size, size_t &my_size);
+  std::shared_ptr<const VarResource> GetReadSnapshot() const;
+  void InvalidateReadSnapshot();
 };
 
 class VarManagerPool {
@@ -336,6 +353,8 @@ class VarManagerPool {
   VarManagerPool() = default;
   std::mutex var_manager_mutex_;
   map<uint64_t, VarManager *> var_manager_map_;
+  // bumped whenever a manager is deleted, invalidates managers cached by threads
+  std::atomic<uint64_t> generation_{0};
 };
 }  // namespace ge
 #endif  // GE_GRAPH_MANAGER_GRAPH_VAR_MANAGER_H_
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "graph/manager/subgraph_optimize_scheduler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace ge {
+namespace {
+const uint32_t kDefaultThreadNum = 16;
+const double kDefaultCostPerNode = 1.0;
+// weight of the latest sample in the moving average
+const double kCostSampleWeight = 0.5;
+}  // namespace
+
+SubGraphOptimizeScheduler &SubGraphOptimizeScheduler::Instance() {
+  static SubGraphOptimizeScheduler instance;
+  return instance;
+}
+
+uint32_t SubGraphOptimizeScheduler::GetThreadNum() {
+  const char *env = std::getenv("THREAD_MULTI_NUM");
+  if (env != nullptr) {
+    int thread_num = atoi(env);
+    if (thread_num > 0) {
+      return static_cast<uint32_t>(thread_num);
+    }
+    GELOGW("Invalid THREAD_MULTI_NUM: %s, use number of cores.", env);
+  }
+  uint32_t core_num = std::thread::hardware_concurrency();
+  return core_num > 0 ? core_num : kDefaultThreadNum;
+}
+
+ThreadPool &SubGraphOptimizeScheduler::GetThreadPool() {
+  std::call_once(thread_pool_flag_, [this]() {
+    uint32_t thread_num = GetThreadNum();
+    GEEVENT("OptimizeSubGraphWithMultiThreads thread num: %u", thread_num);
+    thread_pool_.reset(new (std::nothrow) ThreadPool(thread_num));
+  });
+  if (thread_pool_ == nullptr) {
+    // hardly happens, a pool of default size is better than failing the build
+    static ThreadPool default_thread_pool(kDefaultThreadNum);
+    return default_thread_pool;
+  }
+  return *thread_pool_;
+}
+
+double SubGraphOptimizeScheduler::GetCostPerNode(const std::string &engine_name) const {
+  auto it = cost_per_node_.find(engine_name);
+  if (it != cost_per_node_.end()) {
+    return it->second;
+  }
+  if (cost_per_node_.empty()) {
+    return kDefaultCostPerNode;
+  }
+  // engine never recorded, take the average of known engines so that costs stay comparable
+  double total_cost = 0.0;
+  for (const auto &engine_and_cost : cost_per_node_) {
+    total_cost += engine_and_cost.second;
+  }
+  return total_cost / cost_per_node_.size();
+}
+
+uint64_t SubGraphOptimizeScheduler::EstimateCost(const SubGraphInfoPtr &subgraph) {
+  if ((subgraph == nullptr) || (subgraph->GetSubGraph() == nullptr)) {
+    return 0;
+  }
+  size_t node_num = subgraph->GetSubGraph()->GetAllNodesSize();
+  std::lock_guard<std::mutex> lk(mu_);
+  return static_cast<uint64_t>(node_num * GetCostPerNode(subgraph->GetEngineName()));
+}
+
+void SubGraphOptimizeScheduler::SortByEstimatedCost(std::vector<SubGraphInfoPtr> &subgraphs) {
+  std::vector<std::pair<uint64_t, SubGraphInfoPtr>> cost_and_subgraphs;
+  for (const auto &subgraph : subgraphs) {
+    cost_and_subgraphs.emplace_back(EstimateCost(subgraph), subgraph);
+  }
+  std::stable_sort(cost_and_subgraphs.begin(), cost_and_subgraphs.end(),
+                   [](const std::pair<uint64_t, SubGraphInfoPtr> &lhs,
+                      const std::pair<uint64_t, SubGraphInfoPtr> &rhs) { return lhs.first > rhs.first; });
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    subgraphs[i] = cost_and_subgraphs[i].second;
+  }
+}
+
+void SubGraphOptimizeScheduler::RecordCost(const std::string &engine_name, size_t node_num, uint64_t cost_us) {
+  if (node_num == 0) {
+    return;
+  }
+  double sample = static_cast<double>(cost_us) / node_num;
+  std::lock_guard<std::mutex> lk(mu_);
+  auto it = cost_per_node_.find(engine_name);
+  if (it == cost_per_node_.end()) {
+    cost_per_node_.emplace(engine_name, sample);
+  } else {
+    it->second = it->second * (1 - kCostSampleWeight) + sample * kCostSampleWeight;
+  }
+}
+
+void SubGraphOptimizeScheduler::Clear() {
+  std::lock_guard<std::mutex> lk(mu_);
+  cost_per_node_.clear();
+}
+}  // namespace ge
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GE_GRAPH_MANAGER_SUBGRAPH_OPTIMIZE_SCHEDULER_H_
+#define GE_GRAPH_MANAGER_SUBGRAPH_OPTIMIZE_SCHEDULER_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/thread_pool.h"
+#include "graph/manager/graph_manager_utils.h"
+
+namespace ge {
+// Schedules optimizing of partitioned subgraphs on a process wide thread pool.
+// Subgraphs are submitted longest first, cost of a subgraph is estimated by its node num weighted by
+// the cost per node recorded for its engine, so one huge subgraph no longer starts last.
+class SubGraphOptimizeScheduler {
+ public:
+  static SubGraphOptimizeScheduler &Instance();
+
+  // sized by THREAD_MULTI_NUM if set, or number of available cores
+  ThreadPool &GetThreadPool();
+
+  uint64_t EstimateCost(const SubGraphInfoPtr &subgraph);
+
+  // stable sort, subgraphs with equal cost keep partition order
+  void SortByEstimatedCost(std::vector<SubGraphInfoPtr> &subgraphs);
+
+  void RecordCost(const std::string &engine_name, size_t node_num, uint64_t cost_us);
+
+  void Clear();
+
+ private:
+  SubGraphOptimizeScheduler() = default;
+  ~SubGraphOptimizeScheduler() = default;
+
+  static uint32_t GetThreadNum();
+  double GetCostPerNode(const std::string &engine_name) const;
+
+  std::mutex mu_;
+  std::map<std::string, double> cost_per_node_;  // moving average in us of each engine
+  std::once_flag thread_pool_flag_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+};
+}  // namespace ge
+#endif  // GE_GRAPH_MANAGER_SUBGRAPH_OPTIMIZE_SCHEDULER_H_
@@ -26,10 +26,16 @@
 #include "graph/types.h"
 #include "graph/utils/type_utils.h"
 #include "common/thread_pool.h"
+#include "framework/common/util.h"
+#include "securec.h"
 #include <algorithm>
+#include <atomic>
 
 namespace ge {
 namespace {
+// bound of host memory held by one batch when transferring vars, unless a single var is larger
+const size_t kMaxVarTransBatchSize = 16UL * 1024UL * 1024UL;
+
 class RtContextSwitchGuard {
  public:
   RtContextSwitchGuard(rtCtxMode_t mode, uint32_t device_id) : last_(nullptr), current_(nullptr) {
@@ -246,58 +252,198 @@ Status ReAssignVarAddr(uint64_t session_id,
   return SUCCESS;
 }
 
-Status TransVarData(const NodePtr &var, const VarTransRoad &trans_road, uint64_t session_id) {
+bool NeedTransOnHost(const VarTransRoad &trans_road) {
   // do not need to do anything if only all reshape/reformat node on the trans_road
-  GE_CHECK_NOTNULL(var);
-  bool need_trans = false;
   for (auto &road : trans_road) {
     if (road.node_type != RESHAPE && road.node_type != REFORMAT) {
-      need_trans = true;
-      break;
+      return true;
     }
   }
-  if (!need_trans) {
-    return SUCCESS;
+  return false;
+}
+
+struct VarTransTask {
+  NodePtr var;
+  const VarTransRoad *trans_road = nullptr;
+  uint8_t *src_addr = nullptr;
+  int64_t src_size = 0;
+  int64_t src_reserved_size = 0;
+};
+
+// variables with adjacent device memory, downloaded and uploaded with a few large memcpy
+struct VarTransBatch {
+  uint8_t *base = nullptr;
+  size_t size = 0;
+  const VarTransTask *last_task = nullptr;
+  std::vector<VarTransTask> tasks;
+};
+
+struct VarTransResult {
+  const VarTransTask *task = nullptr;
+  uint8_t *dst_addr = nullptr;
+  int64_t dst_reserved_size = 0;
+  formats::TransResult trans_result;
+};
+
+std::vector<VarTransBatch> CoalesceVarTransTasks(std::vector<VarTransTask> &tasks) {
+  std::sort(tasks.begin(), tasks.end(), [](const VarTransTask &lhs, const VarTransTask &rhs) {
+    return lhs.src_addr < rhs.src_addr;
+  });
+  std::vector<VarTransBatch> batches;
+  for (auto &task : tasks) {
+    if (!batches.empty()) {
+      auto &batch = batches.back();
+      size_t new_size = static_cast<size_t>(task.src_addr + task.src_size - batch.base);
+      if (TransVarDataUtils::IsAdjacentVarMem(batch.last_task->src_addr, batch.last_task->src_reserved_size,
+                                              task.src_addr) && new_size <= kMaxVarTransBatchSize) {
+        batch.size = new_size;
+        batch.last_task = &task;
+        batch.tasks.emplace_back(task);
+        continue;
+      }
+    }
+    VarTransBatch batch;
+    batch.base = task.src_addr;
+    batch.size = static_cast<size_t>(task.src_size);
+    batch.last_task = &task;
+    batch.tasks.emplace_back(task);
+    batches.emplace_back(std::move(batch));
   }
+  return batches;
+}
 
-  // Sync var data from device
-  std::unique_ptr<uint8_t[]> var_data;
-  if (trans_road.empty()) {
-    GELOGE(INTERNAL_ERROR, "Failed to get trans_road, trans_road is empty.");
-    return INTERNAL_ERROR;
+Status UploadVarTransResults(std::vector<VarTransResult> &results, std::atomic<size_t> &memcpy_count) {
+  std::sort(results.begin(), results.end(), [](const VarTransResult &lhs, const VarTransResult &rhs) {
+    return lhs.dst_addr < rhs.dst_addr;
+  });
+  size_t begin = 0;
+  while (begin < results.size()) {
+    uint8_t *base = results[begin].dst_addr;
+    size_t size = results[begin].trans_result.length;
+    size_t end = begin + 1;
+    while (end < results.size()) {
+      auto &last_result = results[end - 1];
+      auto &result = results[end];
+      size_t new_size = static_cast<size_t>(result.dst_addr + result.trans_result.length - base);
+      if (!TransVarDataUtils::IsAdjacentVarMem(last_result.dst_addr, last_result.dst_reserved_size, result.dst_addr) ||
+          new_size > kMaxVarTransBatchSize) {
+        break;
+      }
+      size = new_size;
+      ++end;
+    }
+
+    if (end == begin + 1) {
+      auto &result = results[begin];
+      GE_CHK_STATUS_RET(CopyVarToDevice(result.task->var, result.trans_result, result.dst_addr));
+    } else {
+      std::unique_ptr<uint8_t[]> host_buffer(new(std::nothrow) uint8_t[size]());
+      if (host_buffer == nullptr) {
+        GELOGE(OUT_OF_MEMORY, "Failed to malloc host memory for var upload, size %zu", size);
+        return OUT_OF_MEMORY;
+      }
+      for (size_t i = begin; i < end; ++i) {
+        auto &result = results[i];
+        auto offset = static_cast<size_t>(result.dst_addr - base);
+        if (memcpy_s(host_buffer.get() + offset, size - offset, result.trans_result.data.get(),
+                     result.trans_result.length) != EOK) {
+          GELOGE(INTERNAL_ERROR, "Failed to pack var %s, size %zu", result.task->var->GetName().c_str(),
+                 result.trans_result.length);
+          return INTERNAL_ERROR;
+        }
+      }
+      GELOGD("Copy %zu vars from host to device, size %zu", end - begin, size);
+      GE_CHK_RT_RET(rtMemcpy(base, size, host_buffer.get(), size, RT_MEMCPY_HOST_TO_DEVICE));
+    }
+    ++memcpy_count;
+    begin = end;
   }
-  const GeTensorDesc &input_desc = trans_road.begin()->input;
-  auto ret = CopyVarFromDevice(session_id, var, var_data, input_desc);
-  if (ret != SUCCESS) {
-    return ret;
+  return SUCCESS;
+}
+
+Status TransVarBatch(const VarTransBatch &batch, uint64_t session_id, std::atomic<size_t> &memcpy_count) {
+  std::unique_ptr<uint8_t[]> batch_data(new(std::nothrow) uint8_t[batch.size]);
+  if (batch_data == nullptr) {
+    GELOGE(OUT_OF_MEMORY, "Failed to malloc host memory for var download, size %zu", batch.size);
+    return OUT_OF_MEMORY;
   }
+  GE_CHK_RT_RET(rtMemcpy(batch_data.get(), batch.size, batch.base, batch.size, RT_MEMCPY_DEVICE_TO_HOST));
+  ++memcpy_count;
+  GELOGD("Copy %zu vars from device to host, size %zu", batch.tasks.size(), batch.size);
+
+  // all vars of the batch are downloaded before any upload, in case new addr of a var overlaps old one
+  std::vector<VarTransResult> results(batch.tasks.size());
+  for (size_t i = 0; i < batch.tasks.size(); ++i) {
+    auto &task = batch.tasks[i];
+    auto &result = results[i];
+    result.task = &task;
+    auto ret = TransVarOnHost(batch_data.get() + (task.src_addr - batch.base), *task.trans_road, result.trans_result);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Failed to trans var %s data on host, error code %u", task.var->GetName().c_str(), ret);
+      return ret;
+    }
 
-  formats::TransResult trans_result{};
-  ret = TransVarOnHost(var_data.get(), trans_road, trans_result);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "Failed to trans var data on host, error code %u", ret);
-    return ret;
+    /// It is a temporary solution to use the last GeTensorDesc to assign variable memory because the variable
+    /// manager depends on TensorDesc and it is difficult to be modified. The correct solution is to assign memory
+    /// based on the size of the converted variable. To complete the final solution, the dependency of the variable
+    /// manager on TensorDesc needs to be removed. This change is large and needs to be performed step by step.
+    void *var_device = nullptr;
+    const GeTensorDesc &output_desc = task.trans_road->rbegin()->output;
+    ret = ReAssignVarAddr(session_id, task.var->GetName(), output_desc, &var_device);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Failed to re-assign memory on device, size %zu", result.trans_result.length);
+      return ret;
+    }
+    result.dst_addr = static_cast<uint8_t *>(var_device);
+    result.dst_reserved_size = TransVarDataUtils::CalcVarReservedSize(output_desc);
   }
+  batch_data.reset();
 
-  void *var_device = nullptr;
+  GE_CHK_STATUS_RET(UploadVarTransResults(results, memcpy_count), "Failed to send var data to device");
+  return SUCCESS;
+}
 
-  /// It is a temporary solution to use the last GeTensorDesc to assign variable memory because the variable manager
-  /// depends on TensorDesc and it is difficult to be modified. The correct solution is to assign memory based on the
-  /// size of the converted variable. To complete the final solution, the dependency of the variable manager on
-  /// TensorDesc needs to be removed. This change is large and needs to be performed step by step.
-  ret = ReAssignVarAddr(session_id, var->GetName(), trans_road.rbegin()->output, &var_device);
+Status CollectVarTransTask(const NodePtr &node, uint64_t session_id, uint32_t graph_id,
+                           std::vector<VarTransTask> &tasks, std::vector<std::string> &trans_var_names) {
+  uint32_t allocated_graph_id = 0;
+  Status ret = VarManager::Instance(session_id)->GetAllocatedGraphId(node->GetName(), allocated_graph_id);
   if (ret != SUCCESS) {
-    GELOGE(ret, "Failed to re-assign memory on device, size %zu", trans_result.length);
-    return ret;
+    GELOGE(INTERNAL_ERROR, "var has not been allocated, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
+    return INTERNAL_ERROR;
+  }
+  uint32_t changed_graph_id = 0;
+  ret = VarManager::Instance(session_id)->GetChangedGraphId(node->GetName(), changed_graph_id);
+  bool call_trans_var = (ret == SUCCESS && changed_graph_id == graph_id && changed_graph_id != allocated_graph_id);
+  if (!call_trans_var) {
+    return SUCCESS;
   }
 
-  // sync new data to device
-  ret = CopyVarToDevice(var, trans_result, var_device);
-  if (ret != SUCCESS) {
-    GELOGE(ret, "Failed to send var data to device");
-    return ret;
+  GELOGI("VarManager::GetChangedGraphId() success, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
+  VarTransRoad *trans_road = VarManager::Instance(session_id)->GetTransRoad(node->GetName());
+  if (trans_road == nullptr) {
+    GELOGI("The variable %s does not have any trans road", node->GetName().c_str());
+    return SUCCESS;
+  }
+  trans_var_names.emplace_back(node->GetName());
+  if (!NeedTransOnHost(*trans_road)) {
+    return SUCCESS;
   }
 
+  VarTransTask task;
+  task.var = node;
+  task.trans_road = trans_road;
+  const GeTensorDesc &input_desc = trans_road->begin()->input;
+  void *src_addr = nullptr;
+  GE_CHK_STATUS_RET(ReAssignVarAddr(session_id, node->GetName(), input_desc, &src_addr),
+                    "Failed to get device addr of var %s", node->GetName().c_str());
+  task.src_addr = static_cast<uint8_t *>(src_addr);
+  task.src_size = CalcVarSizeInBytes(input_desc);
+  if (task.src_size <= 0) {
+    GELOGE(INTERNAL_ERROR, "Invalid size %ld of var %s", task.src_size, node->GetName().c_str());
+    return INTERNAL_ERROR;
+  }
+  task.src_reserved_size = TransVarDataUtils::CalcVarReservedSize(input_desc);
+  tasks.emplace_back(task);
   return SUCCESS;
 }
 
@@ -322,8 +468,7 @@ Status TransTensor(uint8_t *var_data, const NodePtr &var_src, const NodePtr &var
 
 Status CopyTensorFromSrcVarNode(const NodePtr &var_src,
                                 const NodePtr &var_dst,
-                                uint64_t session_id,
-                                uint32_t device_id) {
+                                uint64_t session_id) {
   /// after FE fusion pass, input num of applymomentum op was changed, 0th input is var_fp32, 6th input is
   /// var_fp16(new).
   /// unlink edges between var_fp32 and "dst_node" (need fp16) of var_fp32, add edge between var_fp16 and dst_node.
@@ -348,7 +493,6 @@ Status CopyTensorFromSrcVarNode(const NodePtr &var_src,
          TypeUtils::DataTypeToSerialString(data_type).c_str());
   // Sync var data from device
   std::unique_ptr<uint8_t[]> var_src_data;
-  RtContextSwitchGuard switch_context(RT_CTX_NORMAL_MODE, device_id);
   // copy from src_node
   auto ret = CopyVarFromDevice(session_id, var_src, var_src_data, output_desc);
   GE_IF_BOOL_EXEC(ret != SUCCESS, GELOGE(FAILED, "Copy Var From Device failed"); return ret);
@@ -430,13 +574,29 @@ Status TransVarDataUtils::SyncTensorToDevice(const string &var_name, const uint8
   return SUCCESS;
 }
 
+int64_t TransVarDataUtils::CalcVarReservedSize(const GeTensorDesc &tensor_desc) {
+  int64_t tensor_size = 0;
+  if (TensorUtils::GetSize(tensor_desc, tensor_size) != GRAPH_SUCCESS || tensor_size < 0) {
+    return -1;
+  }
+  // same as HbmMemResource::AssignVarMem
+  auto aligned_size = (static_cast<uint64_t>(tensor_size) + kSessionMemAlignSize - 1) / kSessionMemAlignSize *
+                      kSessionMemAlignSize;
+  return static_cast<int64_t>(aligned_size + kSessionMemAlignSize * kSessionMemAlignUnit);
+}
+
+bool TransVarDataUtils::IsAdjacentVarMem(const uint8_t *last_addr, int64_t last_reserved_size, const uint8_t *addr) {
+  return (last_reserved_size > 0) && (addr == last_addr + last_reserved_size);
+}
+
 Status TransVarDataUtils::TransAllVarData(const vector<NodePtr> &variable_nodes,
                                           uint64_t session_id,
                                           rtContext_t context,
                                           uint32_t graph_id,
                                           uint32_t thread_num) {
-  ThreadPool executor(thread_num);
-  std::vector<std::future<Status>> vector_future;
+  uint64_t start_time = GetCurrentTimestamp();
+  std::vector<VarTransTask> tasks;
+  std::vector<std::string> trans_var_names;
   for (auto &node : variable_nodes) {
     if (node == nullptr) {
       continue;
@@ -445,58 +605,48 @@ Status TransVarDataUtils::TransAllVarData(const vector<NodePtr> &variable_nodes,
     if (node->GetType() != VARIABLE) {
       continue;
     }
+    GE_CHK_STATUS_RET_NOLOG(CollectVarTransTask(node, session_id, graph_id, tasks, trans_var_names));
+  }
 
-    std::future<Status> f = executor.commit(
-        [](const ge::NodePtr &node, uint64_t session_id, rtContext_t ctx, uint32_t graph_id) -> Status {
-          rtError_t rt_ret = rtCtxSetCurrent(ctx);
-          if (rt_ret != RT_ERROR_NONE) {
-            GELOGE(RT_FAILED, "Failed to set context, error_code is: 0x%X.", rt_ret);
-            return RT_ERROR_TO_GE_STATUS(rt_ret);
-          }
-          uint32_t allocated_graph_id = 0;
-          Status ret = VarManager::Instance(session_id)->GetAllocatedGraphId(node->GetName(), allocated_graph_id);
-          if (ret != SUCCESS) {
-            GELOGE(INTERNAL_ERROR, "var has not been allocated, node:%s, graph_id:%u.", node->GetName().c_str(),
-                   graph_id);
-            return INTERNAL_ERROR;
-          }
-          uint32_t changed_graph_id = 0;
-          ret = VarManager::Instance(session_id)->GetChangedGraphId(node->GetName(), changed_graph_id);
-          bool call_trans_var =
-              (ret == SUCCESS && changed_graph_id == graph_id && changed_graph_id != allocated_graph_id);
-          if (call_trans_var) {
-            GELOGI("VarManager::GetChangedGraphId() success, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
-            VarTransRoad *trans_road = VarManager::Instance(session_id)->GetTransRoad(node->GetName());
-            if (trans_road == nullptr) {
-              GELOGI("The variable %s does not have any trans road", node->GetName().c_str());
-              return SUCCESS;
+  // vars are coalesced into batches by device addr, host side trans of batches runs in parallel
+  auto batches = CoalesceVarTransTasks(tasks);
+  std::atomic<size_t> memcpy_count(0);
+  {
+    ThreadPool executor(thread_num);
+    std::vector<std::future<Status>> vector_future;
+    for (const auto &batch : batches) {
+      std::future<Status> f = executor.commit(
+          [&batch, &memcpy_count](uint64_t session_id, rtContext_t ctx) -> Status {
+            rtError_t rt_ret = rtCtxSetCurrent(ctx);
+            if (rt_ret != RT_ERROR_NONE) {
+              GELOGE(RT_FAILED, "Failed to set context, error_code is: 0x%X.", rt_ret);
+              return RT_ERROR_TO_GE_STATUS(rt_ret);
             }
-            ret = TransVarData(node, *trans_road, session_id);
-            if (ret != SUCCESS) {
-              GELOGE(INTERNAL_ERROR, "TransVarData failed, node:%s, graph_id:%u.", node->GetName().c_str(), graph_id);
-              return INTERNAL_ERROR;
-            }
-            VarManager::Instance(session_id)->RemoveChangedGraphId(node->GetName());
-          }
-          return SUCCESS;
-        },
-        node, session_id, context, graph_id);
-    if (!f.valid()) {
-      GELOGE(FAILED, "Future is invalid");
-      return FAILED;
+            return TransVarBatch(batch, session_id, memcpy_count);
+          },
+          session_id, context);
+      if (!f.valid()) {
+        GELOGE(FAILED, "Future is invalid");
+        return FAILED;
+      }
+      vector_future.push_back(std::move(f));
     }
-    vector_future.push_back(std::move(f));
-  }
 
-  Status ret_status;
-  for (size_t i = 0; i < vector_future.size(); ++i) {
-    ret_status = vector_future[i].get();
-    if (ret_status != SUCCESS) {
-      GELOGE(ret_status, "TransAllVarData:: trans %zu vardata failed", i);
-      return ret_status;
+    Status ret_status;
+    for (size_t i = 0; i < vector_future.size(); ++i) {
+      ret_status = vector_future[i].get();
+      if (ret_status != SUCCESS) {
+        GELOGE(ret_status, "TransAllVarData:: trans var batch %zu failed, graph_id:%u.", i, graph_id);
+        return ret_status;
+      }
     }
   }
 
+  for (const auto &var_name : trans_var_names) {
+    VarManager::Instance(session_id)->RemoveChangedGraphId(var_name);
+  }
+  GELOGI("Trans %zu vars of graph %u in %zu batches with %zu memcpy, cost %lu us.",
+         tasks.size(), graph_id, batches.size(), memcpy_count.load(), GetCurrentTimestamp() - start_time);
   return SUCCESS;
 }
 
@@ -509,6 +659,8 @@ Status TransVarDataUtils::CopyVarData(const ComputeGraphPtr &compute_graph, uint
 
   string cp_from_node;
   bool copy_value = false;
+  // context is created once for all vars to copy
+  std::unique_ptr<RtContextSwitchGuard> switch_context;
   for (auto &node : compute_graph->GetAllNodes()) {
     GE_IF_BOOL_EXEC(node->GetOpDesc() == nullptr || node->GetOpDesc()->GetType() != VARIABLE, continue);
     GE_IF_BOOL_EXEC(ge::AttrUtils::GetStr(node->GetOpDesc(), "_copy_from_var_node", cp_from_node),
@@ -520,7 +672,11 @@ Status TransVarDataUtils::CopyVarData(const ComputeGraphPtr &compute_graph, uint
         GE_CHECK_NOTNULL(src_node);
         GELOGI("current_var_node__: [%s] copy_from_var_node__: [%s].", node->GetName().c_str(),
                src_node->GetName().c_str());
-        auto ret = CopyTensorFromSrcVarNode(src_node, node, session_id, device_id);
+        if (switch_context == nullptr) {
+          switch_context.reset(new(std::nothrow) RtContextSwitchGuard(RT_CTX_NORMAL_MODE, device_id));
+          GE_CHECK_NOTNULL(switch_context);
+        }
+        auto ret = CopyTensorFromSrcVarNode(src_node, node, session_id);
         GE_IF_BOOL_EXEC(ret != SUCCESS, GELOGE(FAILED, "copy tensor failed!"); return FAILED);
         // only copy once
         (void) ge::AttrUtils::SetBool(node->GetOpDesc(), "_copy_value", true);  // no need to check value
@@ -42,6 +42,14 @@ class TransVarDataUtils {
 
   static ge::Status CopyVarData(const ComputeGraphPtr &compute_graph, uint64_t session_id, uint32_t device_id);
 
+  /// Memory reserved for a var of tensor_desc, data and padding, see HbmMemResource::AssignVarMem.
+  /// @return -1 if size of tensor_desc is invalid
+  static int64_t CalcVarReservedSize(const GeTensorDesc &tensor_desc);
+
+  /// Whether var at addr is assigned right after the one at last_addr, so no other var lies between them
+  /// and the padding in between can be copied along. Vars are coalesced into one memcpy only if adjacent.
+  static bool IsAdjacentVarMem(const uint8_t *last_addr, int64_t last_reserved_size, const uint8_t *addr);
+
  private:
   static ge::Status SyncTensorToHost(const string &var_name, const ge::GeTensorDesc &src_tensor_desc,
                                      uint8_t **host_addr, int64_t &addr_size, uint64_t session_id_);
@@ -18,6 +18,7 @@
 
 #include <string>
 
+#include "common/dump/dump_writer.h"
 #include "common/ge/ge_util.h"
 #include "framework/common/debug/ge_log.h"
 
@@ -60,20 +61,16 @@ Status Debug::DumpDevMem(const char *file, const void *addr, int64_t size) {
     GELOGI("Dump data failed because the size is 0.");
     return SUCCESS;
   }
-  uint8_t *host_addr = nullptr;
-  rtError_t ret = rtMallocHost(reinterpret_cast<void **>(&host_addr), size);
-  if (ret != RT_ERROR_NONE) {
-    GELOGE(FAILED, "Call rt api rtMallocHost failed, ret: 0x%X", ret);
-    return FAILED;
+  GE_CHECK_NOTNULL(file);
+  std::vector<DumpWriter::Buffer> buffers(1);
+  GE_CHK_STATUS_RET(DumpWriter::CopyDevMem(addr, size, buffers[0]), "Failed to copy dev mem to dump to %s", file);
+  // file is written by dump writer, device memory may be reused once submitted
+  uint64_t seq = 0;
+  GE_CHK_STATUS_RET(DumpWriter::GetInstance().Submit(file, std::move(buffers), seq), "Failed to submit dump of %s",
+                    file);
+  if (seq == 0) {
+    GELOGW("Dump of %s is dropped as dump writer is full.", file);
   }
-  GE_MAKE_GUARD_RTMEM(host_addr);
-  ret = rtMemcpy(host_addr, size, addr, size, RT_MEMCPY_DEVICE_TO_HOST);
-  if (ret != RT_ERROR_NONE) {
-    GELOGE(FAILED, "Call rt api rtMemcpy failed, ret: 0x%X", ret);
-    return FAILED;
-  }
-
-  GE_CHK_STATUS_RET(MemoryDumper::DumpToFile(file, host_addr, size));
   return SUCCESS;
 }
 }  // namespace ge
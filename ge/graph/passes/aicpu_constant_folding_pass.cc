@@ -23,6 +23,7 @@
 #include "common/ge/ge_util.h"
 #include "common/types.h"
 #include "framework/common/debug/ge_log.h"
+#include "graph/common/folding_cache.h"
 #include "graph/debug/ge_attr_define.h"
 #include "graph/utils/attr_utils.h"
 #include "graph/utils/node_utils.h"
@@ -51,6 +52,13 @@ Status AicpuConstantFoldingPass::Run(ge::NodePtr &node) {
     return SUCCESS;
   }
   OpDescPtr node_desc = node->GetOpDesc();  // checked before
+  vector<GeTensorPtr> outputs;
+  std::string cache_key;
+  if ((FoldingCache::Instance().GenerateKey(node, weight_vec, cache_key) == SUCCESS) &&
+      FoldingCache::Instance().Lookup(cache_key, outputs)) {
+    GELOGD("[Node:%s] Aicpu constant folding result is found in cache", node->GetName().c_str());
+    return Folding(node, outputs);
+  }
   vector<DataPtrInfo> data_vec;
   vector<AddrAndType> input_addrs;
   vector<uint64_t> output_addrs;
@@ -88,7 +96,6 @@ Status AicpuConstantFoldingPass::Run(ge::NodePtr &node) {
   }
   GELOGI("[Node:%s] Launch memCopyTask success", node->GetName().c_str());
 
-  vector<GeTensorPtr> outputs;
   ret = GenerateGeTensor(node_desc, data_vec, outputs);
   if (ret != SUCCESS) {
     ReleaseMemory(input_addrs, output_addrs, data_vec);
@@ -96,6 +103,7 @@ Status AicpuConstantFoldingPass::Run(ge::NodePtr &node) {
   }
   ReleaseMemory(input_addrs, output_addrs, data_vec);
   GELOGI("[Node:%s] Generate geTensor success", node->GetName().c_str());
+  FoldingCache::Instance().Insert(cache_key, outputs);
   return Folding(node, outputs);
 }
 
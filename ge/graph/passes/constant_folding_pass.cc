@@ -17,6 +17,7 @@
 #include "graph/passes/constant_folding_pass.h"
 
 #include <vector>
+#include "graph/common/folding_cache.h"
 #include "graph/operator_factory.h"
 #include "graph/utils/node_utils.h"
 #include "graph/utils/type_utils.h"
@@ -81,6 +82,13 @@ Status ConstantFoldingPass::Run(ge::NodePtr &node) {
 
   auto inputs = OpDescUtils::GetInputData(input_nodes);
   vector<GeTensorPtr> outputs;
+  std::string cache_key;
+  if ((FoldingCache::Instance().GenerateKey(node, inputs, cache_key) == SUCCESS) &&
+      FoldingCache::Instance().Lookup(cache_key, outputs)) {
+    GELOGD("Node %s type %s, constant folding result is found in cache.", node->GetName().c_str(),
+           node->GetType().c_str());
+    return Folding(node, outputs);
+  }
   // Statistic of ge constant folding kernel
   uint64_t start_time = GetCurrentTimestamp();
   auto ret = RunOpKernelWithCheck(node, inputs, outputs);
@@ -134,6 +142,7 @@ Status ConstantFoldingPass::Run(ge::NodePtr &node) {
     return INTERNAL_ERROR;
   }
 
+  FoldingCache::Instance().Insert(cache_key, outputs);
   return Folding(node, outputs);
 }
 }  // namespace ge
@@ -19,6 +19,7 @@
 #include "common/formats/utils/formats_trans_utils.h"
 #include "common/ge/ge_util.h"
 #include "graph/common/local_context.h"
+#include "graph/preprocess/multi_batch_branch_cloner.h"
 #include "graph/preprocess/multi_batch_options.h"
 #include "graph/utils/node_utils.h"
 #include "graph/utils/op_desc_utils.h"
@@ -1047,11 +1048,17 @@ NodePtr MultiBatchClonePass::CreateDataNode(const ComputeGraphPtr &graph, const
 Status MultiBatchClonePass::CreateSubgraphs(const ComputeGraphPtr &graph, const ComputeGraphPtr &branch) {
   GELOGD("Start create subgraphs for %s.", graph->GetName().c_str());
   const auto &op_desc = case_node_->GetOpDesc();
+  // Topology of branch is resolved once and shared by all gears.
+  multibatch::BranchCloner branch_cloner(batch_shapes_.size(), kMultiBatchNodePostfix);
+  std::vector<NodePtr> branch_nodes;
+  for (const auto &node : branch->GetDirectNode()) {
+    branch_nodes.emplace_back(node);
+  }
+  GE_CHK_STATUS_RET(branch_cloner.Init(branch_nodes), "Init branch cloner for %s failed", branch->GetName().c_str());
   for (size_t i = 0; i < batch_shapes_.size(); ++i) {
     std::vector<NodePtr> input_nodes;
     std::vector<NodePtr> output_nodes;
-    const std::string postfix = kMultiBatchNodePostfix + std::to_string(i);
-    ComputeGraphPtr subgraph = (i == 0) ? branch : GraphUtils::CloneGraph(branch, postfix, input_nodes, output_nodes);
+    ComputeGraphPtr subgraph = (i == 0) ? branch : branch_cloner.CloneGraph(branch, i, input_nodes, output_nodes);
     GE_IF_BOOL_EXEC(subgraph == nullptr, GELOGE(FAILED, "Create multi-batch case node failed"); return FAILED);
     subgraph->SetName("Batch_" + std::to_string(i));
     subgraph->SetParentNode(case_node_);
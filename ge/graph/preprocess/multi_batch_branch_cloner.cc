@@ -0,0 +1,230 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/preprocess/multi_batch_branch_cloner.h"
+
+#include "common/debug/log.h"
+#include "common/ge/ge_util.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/types.h"
+#include "framework/common/util.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+
+namespace ge {
+namespace multibatch {
+Status BranchCloner::Init(const std::vector<NodePtr> &nodes) {
+  plans_.clear();
+  node_indexes_.clear();
+  plans_.resize(nodes.size());
+  node_indexes_.reserve(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    GE_CHECK_NOTNULL(nodes[i]);
+    GE_CHECK_NOTNULL(nodes[i]->GetOpDesc());
+    plans_[i].origin = nodes[i];
+    plans_[i].copies.resize(batch_num_, nullptr);
+    node_indexes_[nodes[i].get()] = i;
+  }
+  GELOGD("Branch cloner init with %zu nodes, %zu batches.", nodes.size(), batch_num_);
+  return SUCCESS;
+}
+
+Status BranchCloner::GetPlan(const NodePtr &node, NodePlan *&plan) {
+  auto iter = node_indexes_.find(node.get());
+  if (iter == node_indexes_.end()) {
+    GELOGE(INTERNAL_ERROR, "Node %s is not in batch branch.", node->GetName().c_str());
+    return INTERNAL_ERROR;
+  }
+  plan = &plans_[iter->second];
+  return SUCCESS;
+}
+
+Status BranchCloner::CloneNode(NodePlan &plan, const ComputeGraphPtr &graph, size_t batch_index) {
+  const auto &node = plan.origin;
+  const std::string name = node->GetName() + name_postfix_ + std::to_string(batch_index);
+  auto desc = AttrUtils::CopyOpDesc(node->GetOpDesc());
+  GE_IF_BOOL_EXEC(desc == nullptr, GELOGE(OUT_OF_MEMORY, "Failed to create op desc for copy node for node %s name %s",
+                                          node->GetName().c_str(), name.c_str());
+                  return OUT_OF_MEMORY);
+  if (GraphUtils::CopyTensorAttrs(desc, node) != GRAPH_SUCCESS) {
+    GELOGE(INTERNAL_ERROR, "Failed to copy tensor attrs from %s to %s.", node->GetName().c_str(), name.c_str());
+    return INTERNAL_ERROR;
+  }
+  desc->SetName(name);
+  if (decorator_ != nullptr) {
+    GE_CHK_STATUS_RET(decorator_(node, desc, batch_index), "Failed to update copy node %s.", name.c_str());
+  }
+
+  auto copy_node = graph->AddNode(desc);
+  GE_IF_BOOL_EXEC(copy_node == nullptr, GELOGE(INTERNAL_ERROR, "Failed to add node %s to graph %s.", name.c_str(),
+                                               graph->GetName().c_str());
+                  return INTERNAL_ERROR);
+  plan.copies[batch_index] = copy_node;
+  return SUCCESS;
+}
+
+Status BranchCloner::CloneNodeForAllBatches(const NodePtr &node, std::vector<NodePtr> &copies) {
+  NodePlan *plan = nullptr;
+  GE_CHK_STATUS_RET(GetPlan(node, plan));
+  auto graph = node->GetOwnerComputeGraph();
+  GE_CHECK_NOTNULL(graph);
+  copies.clear();
+  copies.reserve(batch_num_);
+  for (size_t i = 0; i < batch_num_; ++i) {
+    GE_CHK_STATUS_RET(CloneNode(*plan, graph, i), "Failed to copy node %s for batch %zu", node->GetName().c_str(), i);
+    copies.emplace_back(plan->copies[i]);
+  }
+  return SUCCESS;
+}
+
+Status BranchCloner::ResolveInEdges(NodePlan &plan, const DataSrcResolver &data_resolver,
+                                    const CtrlSrcResolver &ctrl_resolver) {
+  if (plan.edges_resolved) {
+    return SUCCESS;
+  }
+  const auto &node = plan.origin;
+  plan.data_edges.clear();
+  plan.data_edges.reserve(node->GetAllInDataAnchorsSize());
+  for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+    auto src_anchor = in_anchor->GetPeerOutAnchor();
+    if (src_anchor == nullptr) {
+      GELOGD("The node %s does not have input on index %d", node->GetName().c_str(), in_anchor->GetIdx());
+      continue;
+    }
+    DataInEdge edge;
+    edge.dst_index = in_anchor->GetIdx();
+    edge.src_out_index = src_anchor->GetIdx();
+    auto iter = node_indexes_.find(src_anchor->GetOwnerNode().get());
+    if (iter != node_indexes_.end()) {
+      edge.src_node_index = static_cast<int64_t>(iter->second);
+    } else if (data_resolver != nullptr) {
+      GE_CHK_STATUS_RET(data_resolver(src_anchor, node, edge.batch_srcs), "Failed to resolve input %d of node %s.",
+                        edge.dst_index, node->GetName().c_str());
+    } else {
+      edge.batch_srcs.emplace_back(src_anchor);
+    }
+    if ((edge.src_node_index < 0) && (edge.batch_srcs.size() != 1) && (edge.batch_srcs.size() != batch_num_)) {
+      GELOGE(INTERNAL_ERROR, "Input %d of node %s resolved to %zu sources, batch num %zu.", edge.dst_index,
+             node->GetName().c_str(), edge.batch_srcs.size(), batch_num_);
+      return INTERNAL_ERROR;
+    }
+    plan.data_edges.emplace_back(std::move(edge));
+  }
+
+  plan.ctrl_edges.clear();
+  for (const auto &src_node : node->GetInControlNodes()) {
+    CtrlInEdge edge;
+    auto iter = node_indexes_.find(src_node.get());
+    if (iter != node_indexes_.end()) {
+      edge.src_node_index = static_cast<int64_t>(iter->second);
+    } else {
+      edge.external_src = (ctrl_resolver != nullptr) ? ctrl_resolver(src_node) : src_node;
+      GE_CHECK_NOTNULL(edge.external_src);
+    }
+    plan.ctrl_edges.emplace_back(std::move(edge));
+  }
+  plan.edges_resolved = true;
+  return SUCCESS;
+}
+
+Status BranchCloner::LinkNode(const NodePlan &plan, size_t batch_index) {
+  const auto &copy_node = plan.copies[batch_index];
+  GE_CHECK_NOTNULL(copy_node);
+  for (const auto &edge : plan.data_edges) {
+    OutDataAnchorPtr src_anchor = nullptr;
+    if (edge.src_node_index >= 0) {
+      const auto &src_node = plans_[edge.src_node_index].copies[batch_index];
+      GE_CHECK_NOTNULL(src_node);
+      src_anchor = src_node->GetOutDataAnchor(edge.src_out_index);
+    } else {
+      src_anchor = (edge.batch_srcs.size() == 1) ? edge.batch_srcs[0] : edge.batch_srcs[batch_index];
+    }
+    GE_CHECK_NOTNULL(src_anchor);
+    auto ret = GraphUtils::AddEdge(src_anchor, copy_node->GetInDataAnchor(edge.dst_index));
+    if (ret != GRAPH_SUCCESS) {
+      GELOGE(INTERNAL_ERROR, "Failed to add data edge between %s(%d) to %s(%d), error-code %u",
+             src_anchor->GetOwnerNode()->GetName().c_str(), src_anchor->GetIdx(), copy_node->GetName().c_str(),
+             edge.dst_index, ret);
+      return INTERNAL_ERROR;
+    }
+  }
+
+  for (const auto &edge : plan.ctrl_edges) {
+    NodePtr src_node = (edge.src_node_index >= 0) ? plans_[edge.src_node_index].copies[batch_index]
+                                                  : edge.external_src;
+    GE_CHECK_NOTNULL(src_node);
+    auto ret = GraphUtils::AddEdge(src_node->GetOutControlAnchor(), copy_node->GetInControlAnchor());
+    if (ret != GRAPH_SUCCESS) {
+      GELOGE(INTERNAL_ERROR, "Failed to add control edge between %s to %s, error-code %u",
+             src_node->GetName().c_str(), copy_node->GetName().c_str(), ret);
+      return INTERNAL_ERROR;
+    }
+  }
+  return SUCCESS;
+}
+
+Status BranchCloner::LinkNodeForAllBatches(const NodePtr &node, const DataSrcResolver &data_resolver,
+                                           const CtrlSrcResolver &ctrl_resolver) {
+  NodePlan *plan = nullptr;
+  GE_CHK_STATUS_RET(GetPlan(node, plan));
+  GE_CHK_STATUS_RET(ResolveInEdges(*plan, data_resolver, ctrl_resolver), "Failed to resolve in edges of %s.",
+                    node->GetName().c_str());
+  for (size_t i = 0; i < batch_num_; ++i) {
+    GE_CHK_STATUS_RET(LinkNode(*plan, i), "Failed to link copy of node %s for batch %zu.", node->GetName().c_str(), i);
+  }
+  GELOGD("Link %zu data edges and %zu control edges for %zu copies of %s.", plan->data_edges.size(),
+         plan->ctrl_edges.size(), batch_num_, node->GetName().c_str());
+  return SUCCESS;
+}
+
+ComputeGraphPtr BranchCloner::CloneGraph(const ComputeGraphPtr &graph, size_t batch_index,
+                                         std::vector<NodePtr> &input_nodes, std::vector<NodePtr> &output_nodes) {
+  GE_CHK_BOOL_EXEC(graph != nullptr, return nullptr, "Original graph is null");
+  GE_CHK_BOOL_EXEC(batch_index < batch_num_, return nullptr, "Batch index %zu out of range %zu", batch_index,
+                   batch_num_);
+  ComputeGraphPtr new_graph = MakeShared<ComputeGraph>(graph->GetName());
+  GE_CHK_BOOL_EXEC(new_graph != nullptr, return nullptr, "Create new graph failed");
+
+  for (auto &plan : plans_) {
+    if (CloneNode(plan, new_graph, batch_index) != SUCCESS) {
+      return nullptr;
+    }
+    const auto &copy_node = plan.copies[batch_index];
+    if (copy_node->GetType() == DATA) {
+      input_nodes.emplace_back(copy_node);
+    } else if (copy_node->GetType() == NETOUTPUT) {
+      output_nodes.emplace_back(copy_node);
+    }
+  }
+
+  for (auto &plan : plans_) {
+    if ((ResolveInEdges(plan, nullptr, nullptr) != SUCCESS) || (LinkNode(plan, batch_index) != SUCCESS)) {
+      GELOGE(INTERNAL_ERROR, "Failed to link node %s in graph %s.", plan.origin->GetName().c_str(),
+             graph->GetName().c_str());
+      return nullptr;
+    }
+  }
+
+  std::string session_graph_id;
+  if (AttrUtils::GetStr(*graph, ATTR_NAME_SESSION_GRAPH_ID, session_graph_id)) {
+    GE_CHK_BOOL_EXEC(AttrUtils::SetStr(*new_graph, ATTR_NAME_SESSION_GRAPH_ID, session_graph_id), return nullptr,
+                     "Set attr ATTR_NAME_SESSION_GRAPH_ID failed.");
+  }
+  return new_graph;
+}
+}  // namespace multibatch
+}  // namespace ge
@@ -0,0 +1,114 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_GRAPH_PREPROCESS_MULTI_BATCH_BRANCH_CLONER_H_
+#define GE_GRAPH_PREPROCESS_MULTI_BATCH_BRANCH_CLONER_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "external/ge/ge_api_error_codes.h"
+#include "graph/compute_graph.h"
+
+namespace ge {
+namespace multibatch {
+///
+/// Clone the nodes of a batch branch once for every gear.
+/// Nodes are registered by Init, the in-edges of every node are resolved to node indexes only once,
+/// so each gear just copies the op desc and links edges by index, without any name or map lookup.
+/// Shared by MultiBatchGraphCopyer (copies in the same graph) and MultiBatchClonePass (copies in subgraphs).
+///
+class BranchCloner {
+ public:
+  /// Resolve the source of a data edge coming from out of the branch, called once for each edge.
+  /// Fill one anchor to share it between all gears, or one anchor for each gear.
+  using DataSrcResolver = std::function<Status(const OutDataAnchorPtr &origin_src, const NodePtr &origin_dst,
+                                               std::vector<OutDataAnchorPtr> &batch_srcs)>;
+  /// Resolve the source of a control edge coming from out of the branch, called once for each edge.
+  using CtrlSrcResolver = std::function<NodePtr(const NodePtr &origin_src)>;
+  /// Update the op desc copied for one gear before it is added to graph.
+  using CopyDecorator = std::function<Status(const NodePtr &origin, const OpDescPtr &copy_desc, size_t batch_index)>;
+
+  BranchCloner(size_t batch_num, const std::string &name_postfix)
+      : batch_num_(batch_num), name_postfix_(name_postfix) {}
+  ~BranchCloner() = default;
+
+  Status Init(const std::vector<NodePtr> &nodes);
+
+  void SetCopyDecorator(const CopyDecorator &decorator) { decorator_ = decorator; }
+
+  bool IsInBranch(const NodePtr &node) const { return node_indexes_.count(node.get()) > 0; }
+
+  ///
+  /// @ingroup ge
+  /// @brief copy node for every gear, the copies are added to the owner graph of node
+  /// @param [in] node: node in branch
+  /// @param [out] copies: copies of node, indexed by gear
+  /// @return SUCCESS / others
+  ///
+  Status CloneNodeForAllBatches(const NodePtr &node, std::vector<NodePtr> &copies);
+
+  ///
+  /// @ingroup ge
+  /// @brief link in-edges of all copies of node
+  ///
+  Status LinkNodeForAllBatches(const NodePtr &node, const DataSrcResolver &data_resolver,
+                               const CtrlSrcResolver &ctrl_resolver);
+
+  ///
+  /// @ingroup ge
+  /// @brief clone whole graph registered by Init for one gear, same as GraphUtils::CloneGraph
+  ///
+  ComputeGraphPtr CloneGraph(const ComputeGraphPtr &graph, size_t batch_index, std::vector<NodePtr> &input_nodes,
+                             std::vector<NodePtr> &output_nodes);
+
+ private:
+  struct DataInEdge {
+    int dst_index = 0;
+    int src_out_index = 0;
+    int64_t src_node_index = -1;  // -1 means src node is out of branch
+    std::vector<OutDataAnchorPtr> batch_srcs;
+  };
+
+  struct CtrlInEdge {
+    int64_t src_node_index = -1;  // -1 means src node is out of branch
+    NodePtr external_src;
+  };
+
+  struct NodePlan {
+    NodePtr origin;
+    std::vector<NodePtr> copies;
+    bool edges_resolved = false;
+    std::vector<DataInEdge> data_edges;
+    std::vector<CtrlInEdge> ctrl_edges;
+  };
+
+  Status GetPlan(const NodePtr &node, NodePlan *&plan);
+  Status ResolveInEdges(NodePlan &plan, const DataSrcResolver &data_resolver, const CtrlSrcResolver &ctrl_resolver);
+  Status CloneNode(NodePlan &plan, const ComputeGraphPtr &graph, size_t batch_index);
+  Status LinkNode(const NodePlan &plan, size_t batch_index);
+
+  size_t batch_num_;
+  std::string name_postfix_;
+  CopyDecorator decorator_;
+  std::vector<NodePlan> plans_;
+  std::unordered_map<const Node *, size_t> node_indexes_;
+};
+}  // namespace multibatch
+}  // namespace ge
+#endif  // GE_GRAPH_PREPROCESS_MULTI_BATCH_BRANCH_CLONER_H_
@@ -61,6 +61,7 @@ const int kStaticOutput = -1;
 const int kDivisionConst = 2;
 const int32_t kOneInDataNode = 1;
 const int32_t kFindNoMatch = 0;
+const char *const kMultiBatchNodePostfix = "_ascend_mbatch_batch_";
 
 
 inline bool IsDataLikeType(const std::string &node_type) { return (node_type == DATA) || (node_type == AIPP); }
@@ -111,50 +112,6 @@ NodePtr InsertMergeNodeToGraph(const std::string &name, size_t input_num, const
   return graph->AddNode(desc);
 }
 
-NodePtr InsertCopyNode(const NodePtr &node, size_t n) {
-  const std::string &name = node->GetName() + "_ascend_mbatch_batch_" + std::to_string(n);
-  auto src_op_desc = node->GetOpDesc();
-  GE_IF_BOOL_EXEC(src_op_desc == nullptr, GELOGE(INTERNAL_ERROR, "Failed to copy node %s to %s, the OpDesc is null",
-                                                 node->GetName().c_str(), name.c_str());
-                  return nullptr);
-
-  auto desc = AttrUtils::CopyOpDesc(src_op_desc);
-  GE_IF_BOOL_EXEC(desc == nullptr, GELOGE(OUT_OF_MEMORY, "Failed to create op desc for copy node for node %s name %s",
-                                          node->GetName().c_str(), name.c_str());
-                  return nullptr);
-
-  desc->SetName(name);
-  desc->CopyAttrsFrom(*src_op_desc);
-  for (uint32_t i = 0; i < node->GetAllInDataAnchorsSize(); ++i) {
-    auto input_desc = desc->MutableInputDesc(i);
-    GE_IF_BOOL_EXEC(input_desc == nullptr,
-                    GELOGW("Get null input desc by index %u from node %s when copy from %s", i,
-                           desc->GetName().c_str(), node->GetName().c_str());
-                    continue);
-
-    input_desc->CopyAttrsFrom(src_op_desc->GetInputDesc(i));
-  }
-  for (uint32_t i = 0; i < node->GetAllOutDataAnchorsSize(); ++i) {
-    auto output_desc = desc->MutableOutputDesc(i);
-    GE_IF_BOOL_EXEC(output_desc == nullptr,
-                    GELOGE(INTERNAL_ERROR, "Failed to get output desc by index %u from node %s when copy from %s", i,
-                           desc->GetName().c_str(), node->GetName().c_str());
-                    return nullptr);
-
-    output_desc->CopyAttrsFrom(src_op_desc->GetOutputDesc(i));
-  }
-  const std::string &batch_label = "Batch_" + std::to_string(n);
-  if (!AttrUtils::SetStr(desc, ATTR_NAME_BATCH_LABEL, batch_label)) {
-    GELOGE(FAILED, "set attr ATTR_NAME_BATCH_LABEL failed, node:%s.", name.c_str());
-    return nullptr;
-  }
-
-  (void)AttrUtils::SetListStr(desc, ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES, {node->GetName()});
-
-  auto graph = node->GetOwnerComputeGraph();
-  return graph->AddNode(desc);
-}
-
 bool IsAllDimsPositive(const std::vector<int64_t> &dims) {
   for (auto dim : dims) {
     if (dim < 0) {
@@ -758,6 +715,7 @@ Status MultiBatchGraphCopyer::CreateNewNodes() {
   GE_IF_BOOL_EXEC(shape_data_ == nullptr, GELOGE(INTERNAL_ERROR, "Failed to create the shape node for multi batch");
       return INTERNAL_ERROR);
   GE_CHECK_NOTNULL(shape_data_->GetOpDesc());
+  GE_CHK_STATUS_RET(InitBranchCloner(), "Failed to init branch cloner for multi batch");
 
   for (const auto &node : origin_all_nodes_) {
     GE_CHECK_NOTNULL(node->GetOpDesc());
@@ -876,100 +834,6 @@ NodePtr MultiBatchGraphCopyer::FindSwitchnNodeForDataEdge(const OutDataAnchorPtr
   return switchn;
 }
 
-Status MultiBatchGraphCopyer::CopyInDataEdges(const NodePtr &origin_node, int batch_num, const NodePtr &copyed_node) {
-  GELOGI("Start copy data edges for %s and %s.", origin_node->GetName().c_str(), copyed_node->GetName().c_str());
-  for (auto &in_anchor : origin_node->GetAllInDataAnchors()) {
-    auto origin_src_anchor = in_anchor->GetPeerOutAnchor();
-    if (origin_src_anchor == nullptr) {
-      GELOGD("The node %s does not have input on index %d", origin_node->GetName().c_str(), in_anchor->GetIdx());
-      continue;
-    }
-    auto origin_src_node = origin_src_anchor->GetOwnerNode();
-    auto dst_anchor = copyed_node->GetInDataAnchor(in_anchor->GetIdx());
-    GE_CHECK_NOTNULL(dst_anchor);
-    auto switchn = FindSwitchnNodeForDataEdge(origin_src_anchor, origin_node);
-    if (switchn != nullptr) {
-      auto ret = GraphUtils::AddEdge(switchn->GetOutDataAnchor(batch_num), dst_anchor);
-      if (ret != GRAPH_SUCCESS) {
-        GELOGE(INTERNAL_ERROR, "Failed to add data edge between %s(%d) to %s(%d), error-code %u",
-               switchn->GetName().c_str(), batch_num, copyed_node->GetName().c_str(), in_anchor->GetIdx(),
-               ret);
-        return INTERNAL_ERROR;
-      }
-      GELOGD("Add data edge from %s(%d) to %s(%d)", switchn->GetName().c_str(), batch_num,
-             copyed_node->GetName().c_str(), in_anchor->GetIdx());
-      continue;
-    }
-
-    auto batch_branch_iter = nodes_to_batch_nodes_.find(origin_src_node.get());
-    if (batch_branch_iter != nodes_to_batch_nodes_.end()) {
-      auto src_batch_node = batch_branch_iter->second.at(batch_num);
-      auto ret = GraphUtils::AddEdge(src_batch_node->GetOutDataAnchor(origin_src_anchor->GetIdx()), dst_anchor);
-      if (ret != GRAPH_SUCCESS) {
-        GELOGE(INTERNAL_ERROR, "Failed to add data edge between %s(%d) to %s(%d), error-code %u",
-               src_batch_node->GetName().c_str(), batch_num, copyed_node->GetName().c_str(), in_anchor->GetIdx(), ret);
-        return INTERNAL_ERROR;
-      }
-      GELOGD("Add data edge from %s(%d) to %s(%d)", src_batch_node->GetName().c_str(), batch_num,
-             copyed_node->GetName().c_str(), in_anchor->GetIdx());
-      continue;
-    }
-
-    auto ret = GraphUtils::AddEdge(origin_src_anchor, dst_anchor);
-    if (ret != GRAPH_SUCCESS) {
-      GELOGE(INTERNAL_ERROR, "Failed to add data edge between origin node %s(%d) to copyed %s(%d)",
-             origin_src_node->GetName().c_str(), origin_src_anchor->GetIdx(), copyed_node->GetName().c_str(),
-             dst_anchor->GetIdx());
-      return INTERNAL_ERROR;
-    }
-    GELOGD("Add data edge between branch-out %s(%d) to branch-in %s(%d)", origin_src_node->GetName().c_str(),
-           origin_src_anchor->GetIdx(), copyed_node->GetName().c_str(), dst_anchor->GetIdx());
-  }
-  return SUCCESS;
-}
-
-Status MultiBatchGraphCopyer::CopyInControlEdges(const NodePtr &node, int batch_num, const NodePtr &copyed_node) {
-  GELOGI("Start copy control edge for %s and %s.", node->GetName().c_str(), copyed_node->GetName().c_str());
-  for (auto &origin_src_node : node->GetInControlNodes()) {
-    auto switchn_iter = data_nodes_to_switchn_.find(origin_src_node.get());
-    if (switchn_iter != data_nodes_to_switchn_.end()) {
-      // reconnect data node
-      auto ret = GraphUtils::AddEdge(switchn_iter->second->GetOutControlAnchor(), copyed_node->GetInControlAnchor());
-      if (ret != GRAPH_SUCCESS) {
-        GELOGE(INTERNAL_ERROR, "Failed to add control edge between %s to %s, error-code %u",
-               switchn_iter->second->GetName().c_str(), copyed_node->GetName().c_str(), ret);
-        return INTERNAL_ERROR;
-      }
-      GELOGD("Add control edge from %s to %s", switchn_iter->second->GetName().c_str(), copyed_node->GetName().c_str());
-      continue;
-    }
-
-    auto batch_branch_iter = nodes_to_batch_nodes_.find(origin_src_node.get());
-    if (batch_branch_iter != nodes_to_batch_nodes_.end()) {
-      // reconnect node in batch branch
-      auto src_batch_node = batch_branch_iter->second.at(batch_num);
-      auto ret = GraphUtils::AddEdge(src_batch_node->GetOutControlAnchor(), copyed_node->GetInControlAnchor());
-      if (ret != GRAPH_SUCCESS) {
-        GELOGE(INTERNAL_ERROR, "Failed to add data edge between %s to %s, error-code %u",
-               src_batch_node->GetName().c_str(), copyed_node->GetName().c_str(), ret);
-        return INTERNAL_ERROR;
-      }
-      GELOGD("Add control edge from %s to %s", src_batch_node->GetName().c_str(), copyed_node->GetName().c_str());
-      continue;
-    }
-
-    auto ret = GraphUtils::AddEdge(origin_src_node->GetOutControlAnchor(), copyed_node->GetInControlAnchor());
-    if (ret != GRAPH_SUCCESS) {
-      GELOGE(INTERNAL_ERROR, "Failed to add control edge from origin %s to copyed %s",
-             origin_src_node->GetName().c_str(), copyed_node->GetName().c_str());
-      return INTERNAL_ERROR;
-    }
-    GELOGD("Add control edge between branch-out %s to branch-in %s", origin_src_node->GetName().c_str(),
-           copyed_node->GetName().c_str());
-  }
-  return SUCCESS;
-}
-
 NodePtr MultiBatchGraphCopyer::InsertShapeDataNode() {
   auto desc = MakeShared<OpDesc>();
   if (desc == nullptr) {
@@ -1440,18 +1304,37 @@ Status MultiBatchGraphCopyer::LinkGetDynamicDimsToNetOutput(const NodePtr &node)
   return SUCCESS;
 }
 
+Status MultiBatchGraphCopyer::InitBranchCloner() {
+  std::vector<NodePtr> branch_nodes;
+  for (const auto &node : origin_all_nodes_) {
+    if (GetNodeStatus(node) == kNodeInBatchBranch) {
+      branch_nodes.emplace_back(node);
+    }
+  }
+  branch_cloner_ =
+      std::unique_ptr<BranchCloner>(new (std::nothrow) BranchCloner(shapes_.size(), kMultiBatchNodePostfix));
+  GE_CHECK_NOTNULL(branch_cloner_);
+  branch_cloner_->SetCopyDecorator([](const NodePtr &origin, const OpDescPtr &copy_desc, size_t batch_index) {
+    const std::string &batch_label = "Batch_" + std::to_string(batch_index);
+    if (!AttrUtils::SetStr(copy_desc, ATTR_NAME_BATCH_LABEL, batch_label)) {
+      GELOGE(FAILED, "set attr ATTR_NAME_BATCH_LABEL failed, node:%s.", copy_desc->GetName().c_str());
+      return FAILED;
+    }
+    (void)AttrUtils::SetListStr(copy_desc, ATTR_NAME_DATA_DUMP_ORIGIN_OP_NAMES, {origin->GetName()});
+    return SUCCESS;
+  });
+  return branch_cloner_->Init(branch_nodes);
+}
+
 Status MultiBatchGraphCopyer::CopyNodeInBatchBranch(const NodePtr &node) {
   auto &copyed_nodes = nodes_to_batch_nodes_[node.get()];
-  for (size_t i = 0; i < shapes_.size(); ++i) {
-    auto copyed_node = InsertCopyNode(node, i);
-    if (copyed_node == nullptr) {
-      GELOGE(INTERNAL_ERROR, "Failed to add node to graph when copy node %s", node->GetName().c_str());
-      return INTERNAL_ERROR;
-    }
-    copyed_nodes.emplace_back(copyed_node);
-    GELOGI("Copy node %s type %s for shape %s, new node name %s", node->GetName().c_str(), node->GetType().c_str(),
-           formats::JoinToString(shapes_.at(i)).c_str(), copyed_node->GetName().c_str());
+  auto ret = branch_cloner_->CloneNodeForAllBatches(node, copyed_nodes);
+  if (ret != SUCCESS) {
+    GELOGE(INTERNAL_ERROR, "Failed to add node to graph when copy node %s", node->GetName().c_str());
+    return INTERNAL_ERROR;
   }
+  GELOGI("Copy node %s type %s for %zu shapes", node->GetName().c_str(), node->GetType().c_str(),
+         copyed_nodes.size());
   return SUCCESS;
 }
 
@@ -1603,18 +1486,26 @@ Status MultiBatchGraphCopyer::LinkToMerge(const NodePtr &node) {
 
 Status MultiBatchGraphCopyer::LinkToNodeInBranch(const NodePtr &node) {
   GELOGI("Start LinkToNodeInBranch for %s.", node->GetName().c_str());
-  auto &branch_nodes = nodes_to_batch_nodes_[node.get()];
-  for (size_t i = 0; i < branch_nodes.size(); ++i) {
-    auto ret = CopyInDataEdges(node, i, branch_nodes[i]);
-    if (ret != SUCCESS) {
-      return ret;
+  auto data_resolver = [this](const OutDataAnchorPtr &origin_src, const NodePtr &origin_dst,
+                              std::vector<OutDataAnchorPtr> &batch_srcs) -> Status {
+    auto switchn = FindSwitchnNodeForDataEdge(origin_src, origin_dst);
+    if (switchn == nullptr) {
+      batch_srcs.emplace_back(origin_src);
+      return SUCCESS;
     }
-    ret = CopyInControlEdges(node, i, branch_nodes[i]);
-    if (ret != SUCCESS) {
-      return ret;
+    for (size_t i = 0; i < shapes_.size(); ++i) {
+      auto switchn_out_anchor = switchn->GetOutDataAnchor(static_cast<int>(i));
+      GE_CHECK_NOTNULL(switchn_out_anchor);
+      batch_srcs.emplace_back(switchn_out_anchor);
     }
-  }
-  return SUCCESS;
+    return SUCCESS;
+  };
+  auto ctrl_resolver = [this](const NodePtr &origin_src) -> NodePtr {
+    // reconnect data node to the SwitchN inserted after it
+    auto switchn_iter = data_nodes_to_switchn_.find(origin_src.get());
+    return (switchn_iter != data_nodes_to_switchn_.end()) ? switchn_iter->second : origin_src;
+  };
+  return branch_cloner_->LinkNodeForAllBatches(node, data_resolver, ctrl_resolver);
 }
 
 Status MultiBatchGraphCopyer::LinkToNodeOutBranch(const NodePtr &node) {
@@ -16,6 +16,7 @@
 #ifndef GE_GRAPH_PREPROCESS_MULTI_BATCH_COPY_GRAPH_H_
 #define GE_GRAPH_PREPROCESS_MULTI_BATCH_COPY_GRAPH_H_
 #include <map>
+#include <memory>
 #include <queue>
 #include <vector>
 #include <set>
@@ -23,6 +24,7 @@
 #include "external/ge/ge_api_error_codes.h"
 
 #include "graph/compute_graph.h"
+#include "graph/preprocess/multi_batch_branch_cloner.h"
 
 namespace ge {
 namespace multibatch {
@@ -114,6 +116,7 @@ class MultiBatchGraphCopyer {
   /// @param index
   /// @return
   NodePtr InsertMergeNode(const NodePtr &node, int index);
+  Status InitBranchCloner();
   Status CopyNodeInBatchBranch(const NodePtr &node);
 
   // link edges functions
@@ -128,8 +131,6 @@ class MultiBatchGraphCopyer {
   Status LinkDataToMerge(const NodePtr &data, const NodePtr &merge, const NodePtr &switchn);
   Status LinkNodeToMerge(const NodePtr &node, int out_index, const NodePtr &merge);
   NodePtr FindSwitchnNodeForDataEdge(const OutDataAnchorPtr &data_out_anchor, const NodePtr &origin_node);
-  Status CopyInDataEdges(const NodePtr &origin_node, int batch_num, const NodePtr &copyed_node);
-  Status CopyInControlEdges(const NodePtr &node, int batch_num, const NodePtr &copyed_node);
   Status CheckAndParseDynamicData();
   bool IsInBatchBranch(const NodePtr &node);
   NodeStatus GetNodeStatus(const NodePtr &node) { return origin_nodes_status_[node.get()]; };
@@ -150,6 +151,7 @@ class MultiBatchGraphCopyer {
 
   // the nodes in-batch-branch, and the nodes copyed by shapes
   std::map<Node *, std::vector<NodePtr>> nodes_to_batch_nodes_;
+  std::unique_ptr<BranchCloner> branch_cloner_;
 
   // the data nodes, and the SwitchN nodes inserted after it
   std::map<Node *, NodePtr> data_nodes_to_switchn_;
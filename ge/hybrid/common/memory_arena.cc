@@ -0,0 +1,169 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hybrid/common/memory_arena.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/ge_inner_error_codes.h"
+#include "hybrid/common/npu_memory_allocator.h"
+
+namespace ge {
+namespace hybrid {
+namespace {
+// same padding as NpuMemoryAllocator, a padding unit is appended in case of overrun
+const size_t kArenaAlignment = NpuMemoryAllocator::kDefaultPadding;
+const size_t kArenaPaddingUnit = 2;
+}  // namespace
+
+MemoryArena::MemoryArena(NpuMemoryAllocator *allocator, size_t chunk_size)
+    : allocator_(allocator), chunk_size_(chunk_size) {}
+
+MemoryArena::~MemoryArena() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!retired_chunks_.empty()) {
+    GELOGW("%zu retired arena chunks are freed with tensors still referenced.", retired_chunks_.size());
+  }
+  FreeChunks(chunks_);
+  FreeChunks(retired_chunks_);
+  allocations_.clear();
+}
+
+bool MemoryArena::AddChunk(size_t size) {
+  size_t chunk_size = size > chunk_size_ ? size : chunk_size_;
+  auto base = static_cast<uint8_t *>(allocator_->Allocate(chunk_size));
+  if (base == nullptr) {
+    // caller falls back to allocator
+    GELOGW("Failed to allocate arena chunk of size %zu", chunk_size);
+    return false;
+  }
+  chunks_.emplace_back(Chunk{base, chunk_size, 0});
+  offset_ = 0;
+  GELOGD("Arena chunk added, size = %zu, chunk num = %zu", chunk_size, chunks_.size());
+  return true;
+}
+
+void MemoryArena::FreeChunks(std::vector<Chunk> &chunks) {
+  for (auto &chunk : chunks) {
+    allocator_->Deallocate(chunk.base);
+  }
+  chunks.clear();
+}
+
+size_t MemoryArena::FindChunk(const std::vector<Chunk> &chunks, const void *addr) {
+  auto ptr = static_cast<const uint8_t *>(addr);
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    if ((ptr >= chunks[i].base) && (ptr < chunks[i].base + chunks[i].size)) {
+      return i;
+    }
+  }
+  return chunks.size();
+}
+
+void *MemoryArena::Allocate(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+  size_t aligned_size = (size + kArenaPaddingUnit * kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+  std::lock_guard<std::mutex> lk(mu_);
+  if (chunks_.empty() || (chunks_.back().size - offset_ < aligned_size)) {
+    if (!AddChunk(aligned_size)) {
+      return nullptr;
+    }
+  }
+  void *addr = chunks_.back().base + offset_;
+  chunks_.back().live_count++;
+  offset_ += aligned_size;
+  used_size_ += aligned_size;
+  live_size_ += aligned_size;
+  peak_live_size_ = live_size_ > peak_live_size_ ? live_size_ : peak_live_size_;
+  alloc_count_++;
+  allocations_[addr] = aligned_size;
+  return addr;
+}
+
+void MemoryArena::Release(const void *addr) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto it = allocations_.find(addr);
+  if (it == allocations_.end()) {
+    GELOGW("Address %p is not allocated from arena or already released.", addr);
+    return;
+  }
+  live_size_ -= it->second;
+  allocations_.erase(it);
+
+  auto index = FindChunk(chunks_, addr);
+  if (index < chunks_.size()) {
+    chunks_[index].live_count--;
+    return;
+  }
+  index = FindChunk(retired_chunks_, addr);
+  if ((index < retired_chunks_.size()) && (--retired_chunks_[index].live_count == 0)) {
+    GELOGD("Retired arena chunk of size %zu is free, release it.", retired_chunks_[index].size);
+    allocator_->Deallocate(retired_chunks_[index].base);
+    retired_chunks_.erase(retired_chunks_.begin() + index);
+  }
+}
+
+bool MemoryArena::Contains(const void *addr) const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return (FindChunk(chunks_, addr) < chunks_.size()) || (FindChunk(retired_chunks_, addr) < retired_chunks_.size());
+}
+
+void MemoryArena::Reset() {
+  std::lock_guard<std::mutex> lk(mu_);
+  size_t total_size = 0;
+  std::vector<Chunk> free_chunks;
+  for (const auto &chunk : chunks_) {
+    total_size += chunk.size;
+    if (chunk.live_count > 0) {
+      // some tensor of last iteration is still referenced, keep the chunk until it is released
+      GELOGI("Arena chunk of size %zu is still in use by %zu tensors, retire it.", chunk.size, chunk.live_count);
+      retired_chunks_.emplace_back(chunk);
+    } else {
+      free_chunks.emplace_back(chunk);
+    }
+  }
+  chunks_.clear();
+  if ((free_chunks.size() == 1) && (free_chunks[0].size == total_size)) {
+    chunks_.swap(free_chunks);
+  } else {
+    FreeChunks(free_chunks);
+    if (total_size > 0) {
+      (void) AddChunk(total_size);
+    }
+  }
+  offset_ = 0;
+  used_size_ = 0;
+  peak_live_size_ = live_size_;
+  alloc_count_ = 0;
+}
+
+MemoryArenaStatistic MemoryArena::GetStatistic() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  MemoryArenaStatistic statistic;
+  for (const auto &chunk : chunks_) {
+    statistic.reserved_size += chunk.size;
+  }
+  for (const auto &chunk : retired_chunks_) {
+    statistic.retired_size += chunk.size;
+  }
+  statistic.reserved_size += statistic.retired_size;
+  statistic.used_size = used_size_;
+  statistic.peak_live_size = peak_live_size_;
+  statistic.alloc_count = alloc_count_;
+  return statistic;
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_HYBRID_COMMON_MEMORY_ARENA_H_
+#define GE_HYBRID_COMMON_MEMORY_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ge {
+namespace hybrid {
+class NpuMemoryAllocator;
+
+struct MemoryArenaStatistic {
+  size_t reserved_size = 0;   // memory held by arena
+  size_t used_size = 0;       // bump allocated in current iteration
+  size_t peak_live_size = 0;  // peak of memory still referenced, what a freeing allocator would need
+  size_t alloc_count = 0;
+  size_t retired_size = 0;    // chunks kept only for tensors outliving their iteration
+};
+
+// Iteration scoped memory of the hybrid executor.
+// Intermediate tensors and workspaces are bump allocated from big chunks, nothing is freed until Reset,
+// which is called once at the beginning of each iteration. Chunks of an iteration are merged into one on Reset,
+// so steady iterations allocate from a single chunk without touching the caching allocator.
+// A chunk still holding a tensor on Reset is retired: it is no longer allocated from and is freed once its last
+// tensor is released, the rest of the chunks are reclaimed as usual.
+class MemoryArena {
+ public:
+  MemoryArena(NpuMemoryAllocator *allocator, size_t chunk_size);
+  ~MemoryArena();
+
+  MemoryArena(const MemoryArena &) = delete;
+  MemoryArena &operator=(const MemoryArena &) = delete;
+
+  void *Allocate(size_t size);
+
+  // memory is only returned on Reset or, for a retired chunk, when its last allocation is released
+  void Release(const void *addr);
+
+  bool Contains(const void *addr) const;
+
+  void Reset();
+
+  MemoryArenaStatistic GetStatistic() const;
+
+ private:
+  struct Chunk {
+    uint8_t *base = nullptr;
+    size_t size = 0;
+    size_t live_count = 0;  // allocations still referenced
+  };
+
+  bool AddChunk(size_t size);
+  void FreeChunks(std::vector<Chunk> &chunks);
+  // index of chunk containing addr, size of chunks if not found
+  static size_t FindChunk(const std::vector<Chunk> &chunks, const void *addr);
+
+  NpuMemoryAllocator *allocator_;
+  size_t chunk_size_;
+  mutable std::mutex mu_;
+  std::vector<Chunk> chunks_;          // the last one is bump allocated from
+  std::vector<Chunk> retired_chunks_;  // chunks of earlier iterations whose tensors are still referenced
+  std::unordered_map<const void *, size_t> allocations_;  // padded size of allocations still referenced
+  size_t offset_ = 0;  // offset in the last chunk
+  size_t used_size_ = 0;
+  size_t live_size_ = 0;
+  size_t peak_live_size_ = 0;
+  size_t alloc_count_ = 0;
+};
+}  // namespace hybrid
+}  // namespace ge
+#endif // GE_HYBRID_COMMON_MEMORY_ARENA_H_
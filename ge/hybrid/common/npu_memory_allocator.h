@@ -36,6 +36,7 @@ class AllocationAttr {
   ~AllocationAttr() = default;
   void SetMemType(MemStorageType memType) { mem_type_ = memType; }
   MemStorageType GetMemType() { return mem_type_; }
+  void *GetTryReuseAddr() const { return try_reuse_addr_; }
 
  private:
   friend class NpuMemoryAllocator;
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "hybrid/common/pinned_host_memory_pool.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/ge_inner_error_codes.h"
+#include "runtime/mem.h"
+
+namespace ge {
+namespace hybrid {
+namespace {
+const size_t kMinSizeClass = 4096;
+}  // namespace
+
+PinnedHostMemoryPool::PinnedHostMemoryPool(size_t max_idle_size) : max_idle_size_(max_idle_size) {}
+
+PinnedHostMemoryPool::~PinnedHostMemoryPool() {
+  std::lock_guard<std::mutex> lk(mu_);
+  for (auto &it : idle_buffers_) {
+    for (auto buffer : it.second) {
+      (void) rtFreeHost(buffer);
+    }
+  }
+  idle_buffers_.clear();
+  if (!in_use_buffers_.empty()) {
+    GELOGW("%zu pinned host buffers are still in use on destruction.", in_use_buffers_.size());
+  }
+}
+
+size_t PinnedHostMemoryPool::GetSizeClass(size_t size) {
+  size_t size_class = kMinSizeClass;
+  while (size_class < size) {
+    size_class <<= 1U;
+  }
+  return size_class;
+}
+
+uint8_t *PinnedHostMemoryPool::Acquire(size_t size) {
+  auto size_class = GetSizeClass(size);
+  std::lock_guard<std::mutex> lk(mu_);
+  ++acquire_count_;
+  uint8_t *buffer = nullptr;
+  auto it = idle_buffers_.find(size_class);
+  if (it != idle_buffers_.end() && !it->second.empty()) {
+    buffer = it->second.back();
+    it->second.pop_back();
+    idle_size_ -= size_class;
+  } else {
+    auto rt_ret = rtMallocHost(reinterpret_cast<void **>(&buffer), size_class);
+    if (rt_ret != RT_ERROR_NONE || buffer == nullptr) {
+      GELOGE(RT_FAILED, "Failed to allocate pinned host memory of size %zu, ret = 0x%X", size_class, rt_ret);
+      return nullptr;
+    }
+    ++alloc_count_;
+    GELOGD("Pinned host buffer allocated, size = %zu", size_class);
+  }
+  in_use_buffers_.emplace(buffer, size_class);
+  return buffer;
+}
+
+void PinnedHostMemoryPool::Release(uint8_t *buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lk(mu_);
+  auto it = in_use_buffers_.find(buffer);
+  if (it == in_use_buffers_.end()) {
+    GELOGW("Buffer %p was not allocated by pinned host memory pool.", buffer);
+    return;
+  }
+  auto size_class = it->second;
+  in_use_buffers_.erase(it);
+  if (idle_size_ + size_class > max_idle_size_) {
+    (void) rtFreeHost(buffer);
+    return;
+  }
+  idle_buffers_[size_class].emplace_back(buffer);
+  idle_size_ += size_class;
+}
+
+PinnedHostMemoryStatistic PinnedHostMemoryPool::GetStatistic() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  PinnedHostMemoryStatistic statistic;
+  statistic.acquire_count = acquire_count_;
+  statistic.alloc_count = alloc_count_;
+  statistic.idle_size = idle_size_;
+  statistic.in_use_count = in_use_buffers_.size();
+  return statistic;
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GE_HYBRID_COMMON_PINNED_HOST_MEMORY_POOL_H_
+#define GE_HYBRID_COMMON_PINNED_HOST_MEMORY_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ge {
+namespace hybrid {
+struct PinnedHostMemoryStatistic {
+  uint64_t acquire_count = 0;
+  uint64_t alloc_count = 0;
+  size_t idle_size = 0;
+  size_t in_use_count = 0;
+};
+
+// Page-locked host buffers for async memcpy between host and device.
+// Buffers are grouped by power-of-two size classes and kept after release, so a steady stream of requests
+// with similar sizes stops calling rtMallocHost after warm up. Idle memory above max_idle_size is freed.
+class PinnedHostMemoryPool {
+ public:
+  explicit PinnedHostMemoryPool(size_t max_idle_size);
+  ~PinnedHostMemoryPool();
+
+  PinnedHostMemoryPool(const PinnedHostMemoryPool &) = delete;
+  PinnedHostMemoryPool &operator=(const PinnedHostMemoryPool &) = delete;
+
+  // buffer of at least size bytes, nullptr if failed
+  uint8_t *Acquire(size_t size);
+
+  // buffer must not be referenced by any pending async memcpy
+  void Release(uint8_t *buffer);
+
+  PinnedHostMemoryStatistic GetStatistic() const;
+
+ private:
+  static size_t GetSizeClass(size_t size);
+
+  mutable std::mutex mu_;
+  size_t max_idle_size_;
+  size_t idle_size_ = 0;
+  uint64_t acquire_count_ = 0;
+  uint64_t alloc_count_ = 0;
+  std::map<size_t, std::vector<uint8_t *>> idle_buffers_;
+  std::unordered_map<uint8_t *, size_t> in_use_buffers_;
+};
+}  // namespace hybrid
+}  // namespace ge
+#endif // GE_HYBRID_COMMON_PINNED_HOST_MEMORY_POOL_H_
@@ -17,6 +17,7 @@
 #include "hybrid/common/tensor_value.h"
 #include <sstream>
 #include "framework/common/debug/ge_log.h"
+#include "hybrid/common/memory_arena.h"
 #include "hybrid/common/npu_memory_allocator.h"
 
 namespace ge {
@@ -55,11 +56,37 @@ std::unique_ptr<TensorBuffer> TensorBuffer::Create(void *buffer, size_t size) {
   return std::unique_ptr<TensorBuffer>(new (std::nothrow) TensorBuffer(nullptr, buffer, size));
 }
 
+std::unique_ptr<TensorBuffer> TensorBuffer::Create(MemoryArena *arena, size_t size) {
+  if (arena == nullptr) {
+    GELOGE(INTERNAL_ERROR, "arena is NULL");
+    return nullptr;
+  }
+
+  void *buffer = arena->Allocate(size);
+  if (buffer == nullptr) {
+    GELOGW("Failed to allocate memory from arena. size = %zu", size);
+    return nullptr;
+  }
+
+  GELOGD("Tensor created from arena. addr = %p, size = %zu", buffer, size);
+  auto tensor_buffer = std::unique_ptr<TensorBuffer>(new (std::nothrow) TensorBuffer(nullptr, buffer, size));
+  if (tensor_buffer == nullptr) {
+    arena->Release(buffer);
+    return nullptr;
+  }
+  tensor_buffer->arena_ = arena;
+  return tensor_buffer;
+}
+
 TensorBuffer::~TensorBuffer() {
   if (allocator_ != nullptr) {
     allocator_->Deallocate(buffer_, mem_type_);
     buffer_ = nullptr;
   }
+  if (arena_ != nullptr) {
+    arena_->Release(buffer_);
+    buffer_ = nullptr;
+  }
 }
 
 TensorValue::TensorValue(std::shared_ptr<TensorBuffer> buffer) : buffer_(std::move(buffer)) {
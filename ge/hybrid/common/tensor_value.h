@@ -26,6 +26,7 @@ namespace ge {
 namespace hybrid {
 class NpuMemoryAllocator;
 class AllocationAttr;
+class MemoryArena;
 
 class TensorBuffer {
  public:
@@ -35,6 +36,9 @@ class TensorBuffer {
 
   static std::unique_ptr<TensorBuffer> Create(void *buffer, size_t size);
 
+  // allocated from iteration scoped arena, memory is reclaimed when the arena is reset
+  static std::unique_ptr<TensorBuffer> Create(MemoryArena *arena, size_t size);
+
   TensorBuffer(const TensorBuffer &) = delete;
   TensorBuffer &operator = (const TensorBuffer &) = delete;
   ~TensorBuffer();
@@ -51,6 +55,7 @@ class TensorBuffer {
   TensorBuffer(NpuMemoryAllocator *allocator, void *buffer, size_t size, MemStorageType mem_type = HBM);
 
   NpuMemoryAllocator *allocator_ = nullptr;
+  MemoryArena *arena_ = nullptr;
   void *buffer_ = nullptr;
   size_t size_ = 0;
   MemStorageType mem_type_;
@@ -23,12 +23,15 @@
 #include "common/properties_manager.h"
 #include "framework/common/debug/ge_log.h"
 #include "graph/ge_local_context.h"
+#include "hybrid/common/memory_arena.h"
 #include "hybrid/common/npu_memory_allocator.h"
 #include "hybrid/common/tensor_value.h"
 #include "hybrid/executor/hybrid_profiler.h"
+#include "hybrid/executor/multi_stream_plan.h"
 #include "hybrid/executor/node_done_manager.h"
 #include "hybrid/executor/node_state.h"
 #include "hybrid/executor/rt_callback_manager.h"
+#include "hybrid/executor/subgraph_executor_pool.h"
 #include "hybrid/model/hybrid_model.h"
 
 // If expr is not SUCCESS, print the log and return the same value
@@ -47,6 +50,34 @@
 
 namespace ge {
 namespace hybrid {
+struct ShapeInferenceStatistic {
+  void Reset() {
+    full_inference_count = 0;
+    cache_hit_count = 0;
+    rule_hit_count = 0;
+  }
+
+  std::atomic<uint64_t> full_inference_count{0};
+  std::atomic<uint64_t> cache_hit_count{0};
+  std::atomic<uint64_t> rule_hit_count{0};
+};
+
+struct MultiStreamStatistic {
+  MultiStreamStatistic() {
+    Reset();
+  }
+
+  void Reset() {
+    for (auto &count : launched_nodes) {
+      count = 0;
+    }
+    waited_events = 0;
+  }
+
+  std::atomic<uint64_t> launched_nodes[MultiStreamPlan::kMaxStreamNum];
+  std::atomic<uint64_t> waited_events;
+};
+
 struct GraphExecutionContext {
   GraphExecutionContext();
   ~GraphExecutionContext() = default;
@@ -60,10 +91,14 @@ struct GraphExecutionContext {
   const HybridModel *model = nullptr;
   const GEThreadLocalContext *ge_context = nullptr;
   rtStream_t stream = nullptr;
+  // streams besides stream for multi-stream execution, side_streams[i] is the stream i + 1 of MultiStreamPlan
+  std::vector<rtStream_t> side_streams;
   rtContext_t rt_context = nullptr;
   rtContext_t rt_gen_context = nullptr;
   std::unique_ptr<CallbackManager> callback_manager;
   NpuMemoryAllocator *allocator = nullptr;
+  std::unique_ptr<MemoryArena> memory_arena;
+  std::shared_ptr<SubgraphExecutorPool> subgraph_executor_pool;
   mutable std::unique_ptr<HybridProfiler> profiler;
   DumpProperties dump_properties;
   bool trace_enabled = false;
@@ -71,6 +106,8 @@ struct GraphExecutionContext {
   std::atomic_bool is_eos_;
   long profiling_level = 0;
   long iteration = 0;
+  ShapeInferenceStatistic shape_inference_statistic;
+  MultiStreamStatistic multi_stream_statistic;
 
  private:
   Status status = SUCCESS;
@@ -15,6 +15,7 @@
  */
 
 #include "hybrid/executor/hybrid_model_async_executor.h"
+#include "framework/common/util.h"
 #include "graph/load/model_manager/model_utils.h"
 #include "graph/utils/tensor_utils.h"
 #include "graph/utils/type_utils.h"
@@ -26,15 +27,22 @@ namespace hybrid {
 namespace {
 const int kDataOutputIndex = 0;
 const size_t kMinimumPiplineStages = 2;
+const char *const kEnvAsyncStaging = "HYBRID_ASYNC_STAGING";
+// one request staged while another one is executing
+const uint32_t kStagedInputQueueSize = 1;
+const size_t kMaxIdleStagingSize = 256UL * 1024UL * 1024UL;
 }
 HybridModelAsyncExecutor::HybridModelAsyncExecutor(HybridModel *model)
-    : model_(model), run_flag_(false) {
+    : model_(model), run_flag_(false), staged_inputs_(kStagedInputQueueSize) {
 }
 
 HybridModelAsyncExecutor::~HybridModelAsyncExecutor() {
   if (stream_ != nullptr) {
     GE_CHK_RT(rtStreamDestroy(stream_));
   }
+  if (copy_stream_ != nullptr) {
+    GE_CHK_RT(rtStreamDestroy(copy_stream_));
+  }
 }
 
 void HybridModelAsyncExecutor::SetDeviceId(uint32_t device_id) {
@@ -64,8 +72,17 @@ Status HybridModelAsyncExecutor::Start(const std::shared_ptr<ModelListener> &lis
     GetContext().SetSessionId(executor_->GetContext()->session_id);
     return RunInternal();
   });
-
   GE_CHK_BOOL_RET_STATUS(future_.valid(), INTERNAL_ERROR, "Failed to start.");
+
+  if (async_staging_) {
+    staged_inputs_.Restart();
+    stage_future_ = std::async(std::launch::async, [&]() -> Status {
+      GetThreadLocalContext() = *executor_->GetContext()->ge_context;
+      GetContext().SetSessionId(executor_->GetContext()->session_id);
+      return StageInputs();
+    });
+    GE_CHK_BOOL_RET_STATUS(stage_future_.valid(), INTERNAL_ERROR, "Failed to start input staging.");
+  }
   GELOGD("HybridModelExecutor::Start successfully");
   return SUCCESS;
 }
@@ -74,11 +91,15 @@ Status HybridModelAsyncExecutor::Stop() {
   std::lock_guard<std::mutex> lk(mu_);
   run_flag_ = false;
   data_inputer_->Stop();
+  staged_inputs_.Stop();
 
   Status ret = SUCCESS;
   if (future_.valid()) {
     ret = future_.get();
   }
+  if (stage_future_.valid()) {
+    (void) stage_future_.get();
+  }
 
   if (stream_ != nullptr) {
     GE_CHK_RT(rtStreamDestroy(stream_));
@@ -107,14 +128,70 @@ Status HybridModelAsyncExecutor::Init() {
 
   GE_CHK_STATUS_RET(InitInputDesc(), "Failed to init input tensors");
 
+  const char *async_staging = std::getenv(kEnvAsyncStaging);
+  if (async_staging != nullptr && std::string(async_staging) == "1" && !GetContext().GetHostExecFlag()) {
+    GE_CHK_RT_RET(rtStreamCreate(&copy_stream_, RT_STREAM_PRIORITY_DEFAULT));
+    staging_pool_.reset(new(std::nothrow) PinnedHostMemoryPool(kMaxIdleStagingSize));
+    GE_CHECK_NOTNULL(staging_pool_);
+    async_staging_ = true;
+    GELOGI("Async staging of inputs and outputs enabled, model_id = %u", model_id_);
+  }
+
   return SUCCESS;
 }
 
 Status HybridModelAsyncExecutor::PreRun(InputData &current_data, HybridModelExecutor::ExecuteArgs &args) {
   GE_CHK_STATUS_RET(SyncVarData(), "Failed to sync var data");
   RECORD_MODEL_EXECUTION_EVENT(executor_->GetContext(), "[SyncVarData] End");
-  GE_CHK_STATUS_RET(PrepareInputs(current_data, args), "Failed to copy input data to model");
-  RECORD_MODEL_EXECUTION_EVENT(executor_->GetContext(), "[CopyInputData] End");
+  if (!async_staging_) {
+    GE_CHK_STATUS_RET(PrepareInputs(current_data, args), "Failed to copy input data to model");
+    RECORD_MODEL_EXECUTION_EVENT(executor_->GetContext(), "[CopyInputData] End");
+  }
+  return SUCCESS;
+}
+
+Status HybridModelAsyncExecutor::StageInputs() {
+  // model thread waits on the queue, wake it up whatever way staging ends
+  GE_MAKE_GUARD(stop_staged_inputs, [&] { staged_inputs_.Stop(); });
+  auto device_id = static_cast<int32_t>(device_id_);
+  GE_CHK_RT_RET(rtSetDevice(device_id));
+  GE_MAKE_GUARD(not_used_var, [&] { GE_CHK_RT(rtDeviceReset(device_id)); });
+
+  while (run_flag_) {
+    std::shared_ptr<InputDataWrapper> data_wrapper;
+    Status ret = data_inputer_->Pop(data_wrapper);
+    if (data_wrapper == nullptr || ret != SUCCESS) {
+      GELOGI("data_wrapper is null!, ret = %u", ret);
+      continue;
+    }
+
+    auto staged_input = MakeShared<StagedInput>();
+    GE_CHECK_NOTNULL(staged_input);
+    staged_input->data_wrapper = data_wrapper;
+    staged_input->ret = PrepareInputs(data_wrapper->GetInput(), staged_input->args);
+    GELOGD("Input staged, data index = %u, ret = %u", data_wrapper->GetInput().index, staged_input->ret);
+    if (!staged_inputs_.Push(staged_input)) {
+      GELOGI("Staged input queue was stopped, model_id = %u", model_id_);
+      break;
+    }
+  }
+  return SUCCESS;
+}
+
+Status HybridModelAsyncExecutor::PopInput(std::shared_ptr<InputDataWrapper> &data_wrapper,
+                                          HybridModelExecutor::ExecuteArgs &args,
+                                          Status &prepare_ret) {
+  if (!async_staging_) {
+    return data_inputer_->Pop(data_wrapper);
+  }
+
+  std::shared_ptr<StagedInput> staged_input;
+  if (!staged_inputs_.Pop(staged_input) || staged_input == nullptr) {
+    return INTERNAL_ERROR;
+  }
+  data_wrapper = staged_input->data_wrapper;
+  args = std::move(staged_input->args);
+  prepare_ret = staged_input->ret;
   return SUCCESS;
 }
 
@@ -127,7 +204,13 @@ Status HybridModelAsyncExecutor::RunInternal() {
 
   while (run_flag_) {
     std::shared_ptr<InputDataWrapper> data_wrapper;
-    Status ret = data_inputer_->Pop(data_wrapper);
+    HybridModelExecutor::ExecuteArgs args;
+    Status prepare_ret = SUCCESS;
+    Status ret = PopInput(data_wrapper, args, prepare_ret);
+    if (async_staging_ && ret != SUCCESS) {
+      GELOGW("Staged input queue was stopped, quit model thread, model_id = %u", model_id_);
+      break;
+    }
     if (data_wrapper == nullptr || ret != SUCCESS) {
       GELOGI("data_wrapper is null!, ret = %u", ret);
       continue;
@@ -139,8 +222,7 @@ Status HybridModelAsyncExecutor::RunInternal() {
     GELOGI("Model thread Run begin, model id:%u, data index:%u.", model_id_, current_data.index);
 
     RECORD_MODEL_EXECUTION_EVENT(executor_->GetContext(), "[RunInternal] [iteration = %d] Start", iterator_count_);
-    HybridModelExecutor::ExecuteArgs args;
-    ret = PreRun(current_data, args);
+    ret = prepare_ret != SUCCESS ? prepare_ret : PreRun(current_data, args);
     GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(
         ret != SUCCESS, (void) HandleResult(ret, current_data.index, args, data_wrapper->GetOutput());
         CsaInteract::GetInstance().StoreInternalErrorCode(ret, ERROR_MODULE_FMK, JOBSUBSTATE_GRAPH_EXEC);
@@ -232,6 +314,9 @@ Status HybridModelAsyncExecutor::PrepareInputs(const InputData &current_data, Hy
   GE_CHECK_NOTNULL(allocator);
   args.input_desc.resize(input_tensor_desc_.size());
   const std::vector<DataBuffer> &blobs = current_data.blobs;
+  // staging buffers can not be reused until copy stream is synchronized, including on failure
+  std::vector<uint8_t *> staging_buffers;
+  GE_MAKE_GUARD(release_staging_buffers, [&] { ReleaseStagingBuffers(staging_buffers); });
   for (size_t input_index = 0; input_index < input_tensor_desc_.size(); ++input_index) {
     auto tensor_size = input_sizes_[input_index];
     if (is_input_dynamic_[input_index]) {
@@ -240,7 +325,12 @@ Status HybridModelAsyncExecutor::PrepareInputs(const InputData &current_data, Hy
                input_index, current_data.shapes.size());
         return PARAM_INVALID;
       }
-      auto &tensor_desc = input_tensor_desc_[input_index];
+      auto tensor_desc = input_tensor_desc_[input_index];
+      if (async_staging_) {
+        // staged while last request is executing, which still references the desc of input node
+        tensor_desc = MakeShared<GeTensorDesc>(*tensor_desc);
+        GE_CHECK_NOTNULL(tensor_desc);
+      }
       GeShape shape(current_data.shapes[input_index]);
       std::vector<std::pair<int64_t, int64_t>> range;
       auto range_ret = tensor_desc->GetShapeRange(range);
@@ -290,16 +380,49 @@ Status HybridModelAsyncExecutor::PrepareInputs(const InputData &current_data, Hy
            args.inputs[input_index].GetData(),
            mem_size,
            data_buf.length);
-    GE_CHK_RT_RET(rtMemcpy(args.inputs[input_index].MutableData(),
-                           mem_size,
-                           data_buf.data,
-                           data_buf.length,
-                           RT_MEMCPY_HOST_TO_DEVICE));
+    if (!async_staging_ || data_buf.length == 0) {
+      GE_CHK_RT_RET(rtMemcpy(args.inputs[input_index].MutableData(),
+                             mem_size,
+                             data_buf.data,
+                             data_buf.length,
+                             RT_MEMCPY_HOST_TO_DEVICE));
+      continue;
+    }
+
+    auto staging_buffer = staging_pool_->Acquire(data_buf.length);
+    GE_CHECK_NOTNULL(staging_buffer);
+    staging_buffers.emplace_back(staging_buffer);
+    GE_CHK_BOOL_RET_STATUS(memcpy_s(staging_buffer, data_buf.length, data_buf.data, data_buf.length) == EOK,
+                           INTERNAL_ERROR,
+                           "Failed to copy input[%zu] to staging buffer, size = %lu",
+                           input_index,
+                           data_buf.length);
+    GE_CHK_RT_RET(rtMemcpyAsync(args.inputs[input_index].MutableData(),
+                                mem_size,
+                                staging_buffer,
+                                data_buf.length,
+                                RT_MEMCPY_HOST_TO_DEVICE,
+                                copy_stream_));
   }
 
+  if (!staging_buffers.empty()) {
+    GE_CHK_RT_RET(rtStreamSynchronize(copy_stream_));
+  }
   return SUCCESS;
 }
 
+void HybridModelAsyncExecutor::ReleaseStagingBuffers(std::vector<uint8_t *> &staging_buffers) {
+  if (staging_buffers.empty()) {
+    return;
+  }
+  // no-op if already synchronized, otherwise wait for pending copies before buffers are reused
+  GE_CHK_RT(rtStreamSynchronize(copy_stream_));
+  for (auto staging_buffer : staging_buffers) {
+    staging_pool_->Release(staging_buffer);
+  }
+  staging_buffers.clear();
+}
+
 Status HybridModelAsyncExecutor::InitInputDesc() {
   int input_index = 0;
   for (const auto &input_node : model_->GetRootGraphItem()->GetInputNodes()) {
@@ -343,10 +466,8 @@ Status HybridModelAsyncExecutor::OnComputeDone(uint32_t data_index, uint32_t res
   return result_code;
 }
 
-Status HybridModelAsyncExecutor::CopyOutputs(HybridModelExecutor::ExecuteArgs &args,
-                                             OutputData *output_data,
-                                             std::vector<ge::OutputTensorInfo> &outputs) {
-  // copy output data from op to designated position
+Status HybridModelAsyncExecutor::CalcOutputSizes(HybridModelExecutor::ExecuteArgs &args,
+                                                 std::vector<int64_t> &output_sizes) {
   std::vector<ConstGeTensorDescPtr> &output_tensor_desc_list = args.output_desc;
   std::vector<TensorValue> &output_tensors = args.outputs;
   if (output_tensor_desc_list.size() != output_tensors.size()) {
@@ -389,7 +510,22 @@ Status HybridModelAsyncExecutor::CopyOutputs(HybridModelExecutor::ExecuteArgs &a
              i, output_tensor.GetSize(), tensor_desc->GetShape().ToString().c_str());
       return INTERNAL_ERROR;
     }
+    output_sizes.emplace_back(output_size);
+  }
+  return SUCCESS;
+}
 
+Status HybridModelAsyncExecutor::CopyOutputs(HybridModelExecutor::ExecuteArgs &args,
+                                             OutputData *output_data,
+                                             std::vector<ge::OutputTensorInfo> &outputs) {
+  // copy output data from op to designated position
+  std::vector<int64_t> output_sizes;
+  GE_CHK_STATUS_RET_NOLOG(CalcOutputSizes(args, output_sizes));
+  // listener takes the ownership of output data, device data is copied straight into the buffers handed over,
+  // as async D2H copies would need a pinned buffer and an extra host copy out of it
+  for (size_t i = 0; i < output_sizes.size(); ++i) {
+    auto &tensor_desc = args.output_desc[i];
+    auto output_size = output_sizes[i];
     ge::OutputTensorInfo output;
     output.data_type = static_cast<uint32_t>(tensor_desc->GetDataType());
     output.dims = tensor_desc->GetShape().GetDims();
@@ -399,7 +535,7 @@ Status HybridModelAsyncExecutor::CopyOutputs(HybridModelExecutor::ExecuteArgs &a
       GE_CHECK_NOTNULL(data_buf);
       GE_CHK_RT_RET(rtMemcpy(data_buf.get(),
                              output_size,
-                             output_tensor.GetData(),
+                             args.outputs[i].GetData(),
                              output_size,
                              RT_MEMCPY_DEVICE_TO_HOST));
       output.data = std::move(data_buf);
@@ -417,7 +553,45 @@ Status HybridModelAsyncExecutor::CopyOutputs(HybridModelExecutor::ExecuteArgs &a
            tensor_desc->GetShape().ToString().c_str(),
            output_size);
   }
+  return SUCCESS;
+}
 
+Status HybridModelAsyncExecutor::CopyOutputsByStaging(HybridModelExecutor::ExecuteArgs &args,
+                                                      std::vector<GeTensor> &outputs) {
+  std::vector<int64_t> output_sizes;
+  GE_CHK_STATUS_RET_NOLOG(CalcOutputSizes(args, output_sizes));
+  // issue all D2H copies before a single sync, instead of one blocking copy per output
+  std::vector<uint8_t *> staging_buffers(output_sizes.size(), nullptr);
+  // buffers go back to the pool once data is copied out, or on failure after pending copies are done
+  GE_MAKE_GUARD(release_staging_buffers, [&] { ReleaseStagingBuffers(staging_buffers); });
+  for (size_t i = 0; i < output_sizes.size(); ++i) {
+    auto output_size = output_sizes[i];
+    if (output_size == 0) {
+      continue;
+    }
+    staging_buffers[i] = staging_pool_->Acquire(static_cast<size_t>(output_size));
+    GE_CHECK_NOTNULL(staging_buffers[i]);
+    GE_CHK_RT_RET(rtMemcpyAsync(staging_buffers[i],
+                                output_size,
+                                args.outputs[i].GetData(),
+                                output_size,
+                                RT_MEMCPY_DEVICE_TO_HOST,
+                                copy_stream_));
+  }
+  GE_CHK_RT_RET(rtStreamSynchronize(copy_stream_));
+
+  // output tensors take a copy of their data, so they are set from staging buffers directly
+  outputs.resize(output_sizes.size());
+  for (size_t i = 0; i < output_sizes.size(); ++i) {
+    auto &ge_tensor = outputs[i];
+    if (output_sizes[i] > 0) {
+      GE_CHK_GRAPH_STATUS_RET(ge_tensor.SetData(staging_buffers[i], static_cast<size_t>(output_sizes[i])),
+                              "Failed to set output[%zu].", i);
+    } else {
+      GELOGW("Output[%zu] is empty. shape = [%s]", i, args.output_desc[i]->GetShape().ToString().c_str());
+    }
+    ge_tensor.MutableTensorDesc() = *args.output_desc[i];
+  }
   return SUCCESS;
 }
 
@@ -477,6 +651,11 @@ Status HybridModelAsyncExecutor::Execute(const vector<GeTensor> &inputs, vector<
   GE_CHK_STATUS_RET(PrepareInputs(input_data, args), "Failed to copy input data to model");
   GELOGD("Done copying input data successfully.");
   GE_CHK_STATUS_RET(executor_->Execute(args), "Failed to execute model.");
+  if (async_staging_) {
+    GE_CHK_STATUS_RET(CopyOutputsByStaging(args, outputs), "Failed to copy outputs.");
+    GELOGD("Done copying output data successfully. output count = %zu", outputs.size());
+    return SUCCESS;
+  }
 
   std::vector<ge::OutputTensorInfo> output_tensor_info_list;
   OutputData output_data;
@@ -21,7 +21,9 @@
 #include <future>
 #include "external/ge/ge_api_error_codes.h"
 #include "external/ge/ge_api_types.h"
+#include "common/blocking_queue.h"
 #include "graph/load/model_manager/data_inputer.h"
+#include "hybrid/common/pinned_host_memory_pool.h"
 #include "hybrid/executor/hybrid_model_executor.h"
 #include "hybrid/executor/hybrid_model_pipeline_executor.h"
 #include "runtime/stream.h"
@@ -54,10 +56,23 @@ class HybridModelAsyncExecutor {
   Status EnqueueData(const std::shared_ptr<InputDataWrapper> &data);
 
  private:
+  struct StagedInput {
+    std::shared_ptr<InputDataWrapper> data_wrapper;
+    HybridModelExecutor::ExecuteArgs args;
+    Status ret = SUCCESS;
+  };
+
   Status InitInputDesc();
 
   Status RunInternal();
 
+  // copy inputs of next request while current one is executing
+  Status StageInputs();
+
+  Status PopInput(std::shared_ptr<InputDataWrapper> &data_wrapper,
+                  HybridModelExecutor::ExecuteArgs &args,
+                  Status &prepare_ret);
+
   Status SyncVarData();
 
   Status HandleResult(Status exec_ret,
@@ -75,6 +90,12 @@ class HybridModelAsyncExecutor {
 
   Status PrepareInputs(const InputData &current_data, HybridModelExecutor::ExecuteArgs &args);
 
+  Status CalcOutputSizes(HybridModelExecutor::ExecuteArgs &args, std::vector<int64_t> &output_sizes);
+
+  Status CopyOutputsByStaging(HybridModelExecutor::ExecuteArgs &args, std::vector<GeTensor> &outputs);
+
+  void ReleaseStagingBuffers(std::vector<uint8_t *> &staging_buffers);
+
   std::mutex mu_;
   HybridModel *model_;
   uint32_t device_id_ = 0U;
@@ -84,9 +105,15 @@ class HybridModelAsyncExecutor {
   std::unique_ptr<HybridModelExecutor> executor_;
   std::unique_ptr<HybridModelPipelineExecutor> pipe_executor_;
   std::future<Status> future_;
+  std::future<Status> stage_future_;
   uint64_t iterator_count_ = 0;
 
   rtStream_t stream_ = nullptr;
+  // inputs, and outputs of Execute to GeTensor, are copied through pinned host buffers on copy_stream_ if enabled
+  bool async_staging_ = false;
+  rtStream_t copy_stream_ = nullptr;
+  std::unique_ptr<PinnedHostMemoryPool> staging_pool_;
+  BlockingQueue<std::shared_ptr<StagedInput>> staged_inputs_;
   std::map<uint32_t, int64_t> input_sizes_;
   std::map<uint32_t, GeTensorDescPtr> input_tensor_desc_;
   std::vector<bool> is_input_dynamic_;
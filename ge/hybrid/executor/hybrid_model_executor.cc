@@ -23,12 +23,18 @@ namespace hybrid {
 namespace {
 const int kIntBase = 10;
 const char *const kEnvProfilingLevel = "HYBRID_PROFILING_LEVEL";
+const char *const kEnvArenaChunkSize = "HYBRID_ARENA_CHUNK_SIZE";
+const size_t kMegaBytes = 1024UL * 1024UL;
+const double kPercentage = 100.0;
 } // namespace
 HybridModelExecutor::HybridModelExecutor(HybridModel *model, uint32_t device_id, rtStream_t stream)
     : model_(model), device_id_(device_id), stream_(stream) {
 }
 
 HybridModelExecutor::~HybridModelExecutor() {
+  for (auto stream : context_.side_streams) {
+    (void) rtStreamDestroy(stream);
+  }
   if (context_.rt_gen_context != nullptr) {
     (void) rtCtxDestroy(context_.rt_gen_context);
   }
@@ -51,11 +57,24 @@ Status HybridModelExecutor::Execute(HybridModelExecutor::ExecuteArgs &args) {
   Cleanup();
   RECORD_MODEL_EXECUTION_EVENT(&context_, "[Cleanup] End");
   GELOGD("Model executed successfully.");
+  ReportStreamStatistic();
   if (context_.profiler != nullptr) {
     context_.profiler->Dump(std::cout);
     context_.profiler->Reset();
   }
 
+  const auto &statistic = context_.shape_inference_statistic;
+  GELOGI("Shape inference of iteration %ld: full inference = %lu, cache hit = %lu, rule hit = %lu.",
+         context_.iteration, statistic.full_inference_count.load(), statistic.cache_hit_count.load(),
+         statistic.rule_hit_count.load());
+  context_.shape_inference_statistic.Reset();
+  if (context_.memory_arena != nullptr) {
+    // peak live size is what a freeing allocator needs at least, compare it with used size of arena
+    auto arena_statistic = context_.memory_arena->GetStatistic();
+    GELOGI("Arena memory of iteration %ld: allocations = %zu, used = %zu, peak live = %zu, reserved = %zu, "
+           "retired = %zu.", context_.iteration, arena_statistic.alloc_count, arena_statistic.used_size,
+           arena_statistic.peak_live_size, arena_statistic.reserved_size, arena_statistic.retired_size);
+  }
   context_.iteration += 1;
   if (ret == END_OF_SEQUENCE) {
     args.is_eos = true;
@@ -65,6 +84,26 @@ Status HybridModelExecutor::Execute(HybridModelExecutor::ExecuteArgs &args) {
   return SUCCESS;
 }
 
+void HybridModelExecutor::ReportStreamStatistic() {
+  if (context_.side_streams.empty()) {
+    return;
+  }
+  auto &statistic = context_.multi_stream_statistic;
+  uint64_t total_launched = 0;
+  for (size_t i = 0; i <= context_.side_streams.size(); ++i) {
+    total_launched += statistic.launched_nodes[i].load();
+  }
+  for (size_t i = 0; i <= context_.side_streams.size(); ++i) {
+    auto launched = statistic.launched_nodes[i].load();
+    double ratio = total_launched == 0 ? 0.0 : static_cast<double>(launched) * kPercentage / total_launched;
+    RECORD_MODEL_EXECUTION_EVENT(&context_, "[MultiStream] stream[%zu] launched nodes = %lu (%.1f%%)",
+                                 i, launched, ratio);
+    GELOGI("Stream[%zu] of iteration %ld: launched nodes = %lu (%.1f%%).", i, context_.iteration, launched, ratio);
+  }
+  GELOGI("Cross-stream waits of iteration %ld: %lu.", context_.iteration, statistic.waited_events.load());
+  statistic.Reset();
+}
+
 Status HybridModelExecutor::ExecuteGraphInternal(SubgraphExecutor &executor,
                                                  HybridModelExecutor::ExecuteArgs &args) {
   RECORD_MODEL_EXECUTION_EVENT(&context_, "[InitContext] Start");
@@ -107,6 +146,19 @@ Status HybridModelExecutor::InitExecutionContext() {
   GE_CHECK_NOTNULL(context_.allocator);
   context_.callback_manager = std::unique_ptr<CallbackManager>(new(std::nothrow)CallbackManager());
   GE_CHECK_NOTNULL(context_.callback_manager);
+  context_.subgraph_executor_pool = MakeShared<SubgraphExecutorPool>();
+  GE_CHECK_NOTNULL(context_.subgraph_executor_pool);
+  const char *arena_chunk_size = std::getenv(kEnvArenaChunkSize);
+  if (arena_chunk_size != nullptr) {
+    auto chunk_size = std::strtol(arena_chunk_size, nullptr, kIntBase);
+    if (chunk_size > 0) {
+      GELOGI("Iteration arena enabled, chunk size = %ld MB", chunk_size);
+      context_.memory_arena.reset(new(std::nothrow)MemoryArena(context_.allocator,
+                                                              static_cast<size_t>(chunk_size) * kMegaBytes));
+      GE_CHECK_NOTNULL(context_.memory_arena);
+    }
+  }
+  GE_CHK_STATUS_RET_NOLOG(InitSideStreams());
   context_.dump_properties = PropertiesManager::Instance().GetDumpProperties(context_.session_id);
   const char *profiling_level = std::getenv(kEnvProfilingLevel);
   if (profiling_level != nullptr) {
@@ -124,8 +176,32 @@ Status HybridModelExecutor::InitExecutionContext() {
   return SUCCESS;
 }
 
+Status HybridModelExecutor::InitSideStreams() {
+  auto stream_num = MultiStreamPlan::GetStreamNumFromEnv();
+  if (stream_num <= 1) {
+    return SUCCESS;
+  }
+  // memory released by a node may be reused by a node of another stream before the release is executed,
+  // tensors of iteration arena are never reused within the iteration
+  if (context_.memory_arena == nullptr) {
+    GELOGW("Multi-stream execution requires iteration arena, set %s to enable it.", kEnvArenaChunkSize);
+    return SUCCESS;
+  }
+  for (int i = 1; i < stream_num; ++i) {
+    rtStream_t stream = nullptr;
+    GE_CHK_RT_RET(rtStreamCreate(&stream, RT_STREAM_PRIORITY_DEFAULT));
+    context_.side_streams.emplace_back(stream);
+  }
+  GELOGI("Multi-stream execution enabled, stream num = %d", stream_num);
+  return SUCCESS;
+}
+
 Status HybridModelExecutor::ResetExecutionContext(GraphExecutionContext &context) {
   GE_CHK_STATUS_RET_NOLOG(context.callback_manager->Init());
+  if (context.memory_arena != nullptr) {
+    // tensors of last iteration were all released after the root subgraph executor destroyed
+    context.memory_arena->Reset();
+  }
   string ctx_id = std::to_string(context.context_id);
   RuntimeInferenceContext::DestroyContext(ctx_id);
   GE_CHK_GRAPH_STATUS_RET(RuntimeInferenceContext::CreateContext(ctx_id), "Failed to Destroy RuntimeInferenceContext");
@@ -51,6 +51,8 @@ class HybridModelExecutor {
   Status ExecuteGraphInternal(SubgraphExecutor &executor, ExecuteArgs &args);
   Status Cleanup();
   Status InitExecutionContext();
+  Status InitSideStreams();
+  void ReportStreamStatistic();
   static Status ResetExecutionContext(GraphExecutionContext &context);
 
   HybridModel *model_;
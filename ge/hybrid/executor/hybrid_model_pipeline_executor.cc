@@ -104,6 +104,11 @@ Status StageExecutor::Start(const std::vector<TensorValue> &inputs, const std::v
     if (task_info.stage >= pipe_config_->num_stages - 1) {
       RECORD_MODEL_EXECUTION_EVENT(&context_, "[iteration = %d] Schedule End", task_info.iteration);
       GELOGD("[Executor: %d] End of iteration [%ld]", id_, task_info.iteration);
+      const auto &statistic = context_.shape_inference_statistic;
+      GELOGI("[Executor: %d] Shape inference of iteration %ld: full inference = %lu, cache hit = %lu, rule hit = %lu.",
+             id_, task_info.iteration, statistic.full_inference_count.load(), statistic.cache_hit_count.load(),
+             statistic.rule_hit_count.load());
+      context_.shape_inference_statistic.Reset();
       context_.callback_manager->Destroy();
       RuntimeInferenceContext::DestroyContext(std::to_string(context_.context_id));
     }
@@ -144,6 +149,8 @@ Status StageExecutor::InitExecutionContext() {
   GE_CHECK_NOTNULL(context_.allocator);
   context_.callback_manager = std::unique_ptr<CallbackManager>(new (std::nothrow) CallbackManager());
   GE_CHECK_NOTNULL(context_.callback_manager);
+  context_.subgraph_executor_pool = MakeShared<SubgraphExecutorPool>();
+  GE_CHECK_NOTNULL(context_.subgraph_executor_pool);
   context_.dump_properties = PropertiesManager::Instance().GetDumpProperties(context_.session_id);
   if (IsLogEnable(GE_MODULE_NAME, DLOG_DEBUG)) {
     context_.trace_enabled = true;
@@ -0,0 +1,187 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "hybrid/executor/multi_stream_plan.h"
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+#include "common/ge/ge_util.h"
+#include "framework/common/debug/log.h"
+#include "hybrid/model/graph_item.h"
+#include "hybrid/node_executor/node_executor.h"
+
+namespace ge {
+namespace hybrid {
+namespace {
+const char *const kEnvStreamNum = "HYBRID_STREAM_NUM";
+const int kIntBase = 10;
+const int kMainStreamId = 0;
+
+enum class LaunchKind {
+  kMainStream,
+  kAnyStream,
+  kBarrier
+};
+
+LaunchKind GetLaunchKind(const NodeItem &node_item) {
+  if (!node_item.ref_outputs.empty() || !node_item.reuse_inputs.empty() || !node_item.reuse_outputs.empty()) {
+    return LaunchKind::kBarrier;
+  }
+  switch (NodeExecutorManager::GetInstance().ResolveExecutorType(*node_item.node)) {
+    case NodeExecutorManager::ExecutorType::AICORE:
+    case NodeExecutorManager::ExecutorType::AICPU_TF:
+    case NodeExecutorManager::ExecutorType::AICPU_CUSTOM:
+    case NodeExecutorManager::ExecutorType::COMPILED_SUBGRAPH:
+      return LaunchKind::kAnyStream;
+    case NodeExecutorManager::ExecutorType::CONTROL_OP:
+    case NodeExecutorManager::ExecutorType::DYNAMIC_SUBGRAPH:
+    case NodeExecutorManager::ExecutorType::HCCL:
+      return LaunchKind::kBarrier;
+    default:
+      return LaunchKind::kMainStream;
+  }
+}
+
+struct StreamState {
+  int tail = -1;      // last node launched on the stream
+  int num_nodes = 0;  // positions of nodes on the stream start from 1
+  // synced[i] = position of the last node on stream i known to be done before the next node of this stream
+  std::vector<int> synced;
+};
+}  // namespace
+
+int MultiStreamPlan::GetStreamNumFromEnv() {
+  const char *stream_num_str = std::getenv(kEnvStreamNum);
+  if (stream_num_str == nullptr) {
+    return 1;
+  }
+  auto stream_num = std::strtol(stream_num_str, nullptr, kIntBase);
+  if (stream_num <= 1) {
+    return 1;
+  }
+  return stream_num > kMaxStreamNum ? kMaxStreamNum : static_cast<int>(stream_num);
+}
+
+std::shared_ptr<MultiStreamPlan> MultiStreamPlan::Build(const GraphItem &graph_item, int stream_num) {
+  if (stream_num <= 1 || !graph_item.IsDynamic()) {
+    return nullptr;
+  }
+  const auto &node_items = graph_item.GetAllNodes();
+  std::unordered_map<const Node *, int> node_indices;
+  for (size_t i = 0; i < node_items.size(); ++i) {
+    node_indices.emplace(node_items[i]->node.get(), static_cast<int>(i));
+  }
+
+  auto plan = MakeShared<MultiStreamPlan>();
+  if (plan == nullptr) {
+    GELOGW("[%s] Failed to create multi-stream plan.", graph_item.GetName().c_str());
+    return nullptr;
+  }
+  plan->stream_num_ = stream_num;
+  plan->node_infos_.resize(node_items.size());
+  std::vector<StreamState> streams(stream_num);
+  for (auto &stream : streams) {
+    stream.synced.resize(stream_num, 0);
+  }
+  // position of each node on its stream, and what its stream had synchronized with when it was launched
+  std::vector<int> positions(node_items.size(), 0);
+  std::vector<std::vector<int>> synced_at(node_items.size());
+  int last_barrier = -1;
+  bool use_side_stream = false;
+
+  for (size_t i = 0; i < node_items.size(); ++i) {
+    const auto &node_item = *node_items[i];
+    auto &node_info = plan->node_infos_[i];
+    if (node_item.node_type == NETOUTPUT) {
+      // not launched, all streams are joined to stream 0 after the subgraph was launched
+      continue;
+    }
+    std::vector<int> producers;
+    for (const auto &in_node : node_item.node->GetInAllNodes()) {
+      auto it = node_indices.find(in_node.get());
+      if (it != node_indices.end() && it->second < static_cast<int>(i)) {
+        producers.emplace_back(it->second);
+      }
+    }
+    for (auto dependency : node_item.execution_dependencies) {
+      producers.emplace_back(dependency->graph_index);
+    }
+
+    auto launch_kind = GetLaunchKind(node_item);
+    int stream_id = kMainStreamId;
+    if (launch_kind == LaunchKind::kAnyStream) {
+      stream_id = -1;
+      for (auto producer : producers) {
+        auto producer_stream = plan->node_infos_[producer].stream_id;
+        if (streams[producer_stream].tail == producer) {
+          stream_id = producer_stream;
+          break;
+        }
+      }
+      if (stream_id < 0) {
+        stream_id = kMainStreamId;
+        for (int j = 1; j < stream_num; ++j) {
+          stream_id = streams[j].num_nodes < streams[stream_id].num_nodes ? j : stream_id;
+        }
+      }
+    } else if (launch_kind == LaunchKind::kBarrier) {
+      for (int j = 0; j < stream_num; ++j) {
+        if (streams[j].tail >= 0) {
+          producers.emplace_back(streams[j].tail);
+        }
+      }
+    }
+    if (last_barrier >= 0) {
+      producers.emplace_back(last_barrier);
+    }
+
+    auto &stream = streams[stream_id];
+    for (auto producer : producers) {
+      auto producer_stream = plan->node_infos_[producer].stream_id;
+      if (producer_stream == stream_id || stream.synced[producer_stream] >= positions[producer]) {
+        continue;
+      }
+      auto &producer_info = plan->node_infos_[producer];
+      if (producer_info.event_index < 0) {
+        producer_info.event_index = plan->event_num_++;
+      }
+      node_info.wait_events.emplace_back(producer_info.event_index);
+      const auto &producer_synced = synced_at[producer];
+      for (int j = 0; j < stream_num; ++j) {
+        stream.synced[j] = std::max(stream.synced[j], producer_synced[j]);
+      }
+    }
+
+    node_info.stream_id = stream_id;
+    positions[i] = ++stream.num_nodes;
+    stream.tail = static_cast<int>(i);
+    stream.synced[stream_id] = positions[i];
+    synced_at[i] = stream.synced;
+    last_barrier = launch_kind == LaunchKind::kBarrier ? static_cast<int>(i) : last_barrier;
+    use_side_stream = use_side_stream || (stream_id != kMainStreamId);
+  }
+
+  if (!use_side_stream) {
+    GELOGD("[%s] No node can be launched to side streams.", graph_item.GetName().c_str());
+    return nullptr;
+  }
+  GELOGI("[%s] Multi-stream plan built, stream num = %d, event num = %d.", graph_item.GetName().c_str(),
+         stream_num, plan->event_num_);
+  return plan;
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GE_HYBRID_EXECUTOR_MULTI_STREAM_PLAN_H_
+#define GE_HYBRID_EXECUTOR_MULTI_STREAM_PLAN_H_
+
+#include <memory>
+#include <vector>
+#include "hybrid/model/node_item.h"
+
+namespace ge {
+namespace hybrid {
+class GraphItem;
+
+// Static assignment of the nodes of a dynamic subgraph to a small set of streams, stream 0 is the stream of
+// the execution context, the others are side streams.
+// A node continues the stream of a producer it is the first consumer of, other nodes go to the least loaded stream.
+// Nodes that are not launched to device asynchronously stay on stream 0. Nodes that may write memory read by
+// other nodes (ref/reuse outputs, control ops, collective ops) are barriers, they wait for all streams and
+// all streams wait for them before launching further nodes.
+// Events are only recorded for producers of cross-stream consumers, and a wait is skipped if the consumer
+// stream has already synchronized with the producer, directly or transitively.
+class MultiStreamPlan {
+ public:
+  static constexpr int kMaxStreamNum = 8;
+
+  struct NodeStreamInfo {
+    int stream_id = 0;
+    int event_index = -1;            // event to record after the node was launched, -1 if no cross-stream consumer
+    std::vector<int> wait_events;    // events to wait before the node is launched
+  };
+
+  MultiStreamPlan() = default;
+  ~MultiStreamPlan() = default;
+
+  // number of streams set by env HYBRID_STREAM_NUM, 1 if multi-stream execution is disabled
+  static int GetStreamNumFromEnv();
+
+  // returns nullptr if no node of the graph would go to a side stream
+  static std::shared_ptr<MultiStreamPlan> Build(const GraphItem &graph_item, int stream_num);
+
+  const NodeStreamInfo &GetNodeStreamInfo(const NodeItem &node_item) const {
+    return node_infos_[node_item.graph_index];
+  }
+
+  int GetStreamNum() const {
+    return stream_num_;
+  }
+
+  int GetEventNum() const {
+    return event_num_;
+  }
+
+ private:
+  std::vector<NodeStreamInfo> node_infos_;
+  int stream_num_ = 1;
+  int event_num_ = 0;
+};
+}  // namespace hybrid
+}  // namespace ge
+#endif // GE_HYBRID_EXECUTOR_MULTI_STREAM_PLAN_H_
@@ -52,29 +52,41 @@ bool NodeDoneManager::Cond::IsRelease() {
   return is_released_;
 }
 
-NodeDoneManager::Cond *NodeDoneManager::GetSubject(const NodePtr &node) {
+void NodeDoneManager::Init(size_t num_nodes) {
+  std::lock_guard<std::mutex> lk(mu_);
+  subjects_.resize(num_nodes);
+}
+
+NodeDoneManager::Cond *NodeDoneManager::GetSubject(const NodeItem &node_item) {
   std::lock_guard<std::mutex> lk(mu_);
   if (destroyed_) {
     GELOGD("Already destroyed.");
     return nullptr;
   }
 
-  auto it = subjects_.find(node);
-  if (it == subjects_.end()) {
-    return &subjects_[node];
+  auto index = node_item.graph_index;
+  if (index < 0 || static_cast<size_t>(index) >= subjects_.size()) {
+    GELOGE(INTERNAL_ERROR, "[%s] Invalid node index %d, node num = %zu",
+           node_item.NodeName().c_str(), index, subjects_.size());
+    return nullptr;
   }
 
-  return &it->second;
+  auto &subject = subjects_[index];
+  if (subject == nullptr) {
+    subject.reset(new(std::nothrow) Cond());
+  }
+  return subject.get();
 }
 
 void NodeDoneManager::Destroy() {
   GELOGD("Start to reset NodeDoneManager.");
   std::lock_guard<std::mutex> lk(mu_);
   GELOGD("Cond size = %zu.", subjects_.size());
-  for (auto &sub : subjects_) {
-    if (!sub.second.IsRelease()) {
-      sub.second.Cancel();
-      GELOGD("[%s] Node canceled.", sub.first->GetName().c_str());
+  for (size_t i = 0; i < subjects_.size(); ++i) {
+    auto &sub = subjects_[i];
+    if (sub != nullptr && !sub->IsRelease()) {
+      sub->Cancel();
+      GELOGD("Node of index %zu canceled.", i);
     }
   }
 
@@ -83,23 +95,23 @@ void NodeDoneManager::Destroy() {
   GELOGD("Done resetting NodeDoneManager successfully.");
 }
 
-void NodeDoneManager::NodeDone(const NodePtr &node) {
-  auto sub = GetSubject(node);
+void NodeDoneManager::NodeDone(const NodeItem &node_item) {
+  auto sub = GetSubject(node_item);
   if (sub != nullptr) {
     sub->Release();
-    GELOGD("[%s] Node released.", node->GetName().c_str());
+    GELOGD("[%s] Node released.", node_item.NodeName().c_str());
   }
 }
 
-bool NodeDoneManager::Await(const NodePtr &node) {
-  auto sub = GetSubject(node);
+bool NodeDoneManager::Await(const NodeItem &node_item) {
+  auto sub = GetSubject(node_item);
   if (sub == nullptr) {
     return false;
   }
 
-  GELOGD("[%s] Await start. is_released = %s", node->GetName().c_str(), sub->IsRelease() ? "true" : "false");
+  GELOGD("[%s] Await start. is_released = %s", node_item.NodeName().c_str(), sub->IsRelease() ? "true" : "false");
   bool ret = sub->Await();
-  GELOGD("[%s] Await ended. is_released = %s", node->GetName().c_str(), sub->IsRelease() ? "true" : "false");
+  GELOGD("[%s] Await ended. is_released = %s", node_item.NodeName().c_str(), sub->IsRelease() ? "true" : "false");
   return ret;
 }
 }  // namespace hybrid
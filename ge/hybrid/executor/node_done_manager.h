@@ -20,16 +20,19 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
-#include "graph/node.h"
+#include <vector>
+#include "hybrid/model/node_item.h"
 
 namespace ge {
 namespace hybrid {
 class NodeDoneManager {
  public:
-  void NodeDone(const NodePtr &node);
+  // nodes are indexed by NodeItem::graph_index
+  void Init(size_t num_nodes);
 
-  bool Await(const NodePtr &node);
+  void NodeDone(const NodeItem &node_item);
+
+  bool Await(const NodeItem &node_item);
 
   void Destroy();
 
@@ -47,9 +50,9 @@ class NodeDoneManager {
     bool is_cancelled_ = false;
   };
 
-  Cond *GetSubject(const NodePtr &node);
+  Cond *GetSubject(const NodeItem &node_item);
   std::mutex mu_;
-  std::unordered_map<NodePtr, Cond> subjects_;
+  std::vector<std::unique_ptr<Cond>> subjects_;
   bool destroyed_ = false;
 };
 }  // namespace hybrid
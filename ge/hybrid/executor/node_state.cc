@@ -194,25 +194,25 @@ NodeState::NodeState(const NodeItem &node_item, SubgraphContext *subgraph_contex
 }
 
 Status NodeState::AwaitInputTensors(GraphExecutionContext &context) const {
-  for (auto &src_node : node_item_->dependents_for_execution) {
+  for (auto src_node : node_item_->execution_dependencies) {
     GELOGD("[%s] Start to wait for data dependent node: [%s]",
            node_item_->NodeName().c_str(),
-           src_node->GetName().c_str());
+           src_node->NodeName().c_str());
     RECORD_EXECUTION_EVENT(&context,
                            node_item_->NodeName().c_str(),
                            "[AwaitNodeDone] [%s] Start",
-                           src_node->GetName().c_str());
+                           src_node->NodeName().c_str());
 
-    HYBRID_CHK_STATUS_RET(subgraph_context_->Await(src_node),
+    HYBRID_CHK_STATUS_RET(subgraph_context_->Await(*src_node),
                           "[%s] Await node [%s] failed.",
                           GetName().c_str(),
-                          src_node->GetName().c_str());
+                          src_node->NodeName().c_str());
 
     RECORD_EXECUTION_EVENT(&context,
                            node_item_->NodeName().c_str(),
                            "[AwaitNodeDone] [%s] End",
-                           src_node->GetName().c_str());
-    GELOGD("[%s] Done waiting node.", src_node->GetName().c_str());
+                           src_node->NodeName().c_str());
+    GELOGD("[%s] Done waiting node.", src_node->NodeName().c_str());
   }
 
   return SUCCESS;
@@ -245,7 +245,7 @@ std::shared_ptr<TaskContext> NodeState::GetTaskContext() {
 
 Status ShapeFuture::Get(GeShape &ori_shape, GeShape &shape) {
   GELOGD("Start to wait node: %s for getting shape", src_node_->GetName().c_str());
-  HYBRID_CHK_STATUS_RET(subgraph_context_->Await(src_node_->GetNodeItem()->node), "cancelled");
+  HYBRID_CHK_STATUS_RET(subgraph_context_->Await(*src_node_->GetNodeItem()), "cancelled");
   auto &output_desc = src_node_->GetShapeInferenceState().GetOutputTensorDesc().at(src_index_);
   shape = output_desc.GetShape();
   ori_shape = output_desc.GetOriginShape();
@@ -256,7 +256,7 @@ Status ShapeFuture::Get(GeShape &ori_shape, GeShape &shape) {
 Status ShapeFuture::GetTensorDesc(const GeTensorDesc **tensor_desc) {
   GE_CHECK_NOTNULL(tensor_desc);
   GELOGD("Start to wait node: %s for getting shape", src_node_->GetName().c_str());
-  HYBRID_CHK_STATUS_RET(subgraph_context_->Await(src_node_->GetNodeItem()->node), "cancelled");
+  HYBRID_CHK_STATUS_RET(subgraph_context_->Await(*src_node_->GetNodeItem()), "cancelled");
   *tensor_desc = &src_node_->GetShapeInferenceState().GetOutputTensorDesc().at(src_index_);
   return SUCCESS;
 }
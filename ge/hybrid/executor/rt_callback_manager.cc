@@ -15,29 +15,98 @@
  */
 
 #include "hybrid/executor/rt_callback_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
+#include <thread>
+#include "external/runtime/rt_error_codes.h"
 #include "framework/common/ge_inner_error_codes.h"
 #include "framework/common/debug/ge_log.h"
 #include "framework/common/util.h"
 
 namespace ge {
 namespace hybrid {
+namespace {
+const char *const kEnvCallbackQueryMode = "HYBRID_CALLBACK_QUERY_MODE";
+const int kIntBase = 10;
+const size_t kMaxPooledEvents = 512;
+// bound the delay of the earliest callback sharing an event
+const size_t kMaxCoalescedCallbacks = 16;
+const uint32_t kQuerySpinCount = 64;
+const uint32_t kMinBackoffUs = 1;
+const uint32_t kMaxBackoffUs = 1000;
+
+bool IsQueryModeEnabled() {
+  const char *query_mode = std::getenv(kEnvCallbackQueryMode);
+  return (query_mode != nullptr) && (std::strtol(query_mode, nullptr, kIntBase) > 0);
+}
+}  // namespace
+
+CallbackManager::~CallbackManager() {
+  for (auto event : free_events_) {
+    (void) rtEventDestroy(event);
+  }
+  free_events_.clear();
+}
+
+Status CallbackManager::AcquireEvent(rtEvent_t &event) {
+  if (!free_events_.empty()) {
+    event = free_events_.back();
+    free_events_.pop_back();
+    return SUCCESS;
+  }
+  GE_CHK_RT_RET(rtEventCreate(&event));
+  return SUCCESS;
+}
+
+void CallbackManager::ReleaseEvent(rtEvent_t event) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (free_events_.size() < kMaxPooledEvents) {
+      free_events_.emplace_back(event);
+      return;
+    }
+  }
+  GE_CHK_RT(rtEventDestroy(event));
+}
+
+void CallbackManager::PushEntry(CallbackEntry &&entry) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    pending_entries_.emplace_back(std::move(entry));
+  }
+  cv_.notify_one();
+}
+
 Status CallbackManager::RegisterCallback(rtStream_t stream, rtCallback_t callback, void *user_data) {
   GELOGD("To register callback");
-  rtEvent_t event = nullptr;
-  GE_CHK_RT_RET(rtEventCreate(&event));
-  auto rt_ret = rtEventRecord(event, stream);
+  std::unique_lock<std::mutex> lk(mu_);
+  if (!pending_entries_.empty()) {
+    auto &last_entry = pending_entries_.back();
+    if ((last_entry.event != nullptr) && (last_entry.stream == stream) &&
+        (last_entry.callbacks.size() < kMaxCoalescedCallbacks)) {
+      // entry is not taken by callback thread yet, move its event behind the work launched since last record
+      GE_CHK_RT_RET(rtEventRecord(last_entry.event, stream));
+      last_entry.callbacks.emplace_back(callback, user_data);
+      GELOGD("Callback coalesced, callback num of event = %zu", last_entry.callbacks.size());
+      return SUCCESS;
+    }
+  }
+
+  CallbackEntry entry;
+  GE_CHK_STATUS_RET_NOLOG(AcquireEvent(entry.event));
+  auto rt_ret = rtEventRecord(entry.event, stream);
   if (rt_ret != RT_ERROR_NONE) {
     GELOGE(RT_FAILED, "Failed to invoke rtEventRecord, error code = %d", rt_ret);
-    (void) rtEventDestroy(event);
+    (void) rtEventDestroy(entry.event);
     return RT_FAILED;
   }
-
-  auto cb = std::pair<rtCallback_t, void *>(callback, user_data);
-  auto entry = std::pair<rtEvent_t, std::pair<rtCallback_t, void *>>(event, std::move(cb));
-  if (!callback_queue_.Push(entry)) {
-    (void) rtEventDestroy(event);
-    return INTERNAL_ERROR;
-  }
+  entry.stream = stream;
+  entry.callbacks.emplace_back(callback, user_data);
+  pending_entries_.emplace_back(std::move(entry));
+  lk.unlock();
+  cv_.notify_one();
 
   GELOGD("Registering callback successfully");
   return SUCCESS;
@@ -46,6 +115,9 @@ Status CallbackManager::RegisterCallback(rtStream_t stream, rtCallback_t callbac
 Status CallbackManager::Init() {
   rtContext_t ctx = nullptr;
   GE_CHK_RT_RET(rtCtxGetCurrent(&ctx));
+  query_mode_ = IsQueryModeEnabled();
+  backoff_us_ = kMinBackoffUs;
+  GELOGD("Callback query mode = %d", static_cast<int>(query_mode_));
   ret_future_ = std::async(std::launch::async, [&](rtContext_t context) ->Status {
     return CallbackProcess(context);
   }, ctx);
@@ -57,32 +129,83 @@ Status CallbackManager::Init() {
   return SUCCESS;
 }
 
-Status CallbackManager::CallbackProcess(rtContext_t context) {
-  GE_CHK_RT_RET(rtCtxSetCurrent(context));
-  std::pair<rtEvent_t, std::pair<rtCallback_t, void *>> entry;
-  while (true) {
-    if (!callback_queue_.Pop(entry)) {
-      GELOGI("CallbackManager stopped");
-      return INTERNAL_ERROR;
-    }
-
-    auto event = entry.first;
-    if (event == nullptr) {
-      return SUCCESS;
-    }
-
+Status CallbackManager::WaitEvent(rtEvent_t event) {
+  if (!query_mode_) {
     auto rt_err = rtEventSynchronize(event);
     if (rt_err != RT_ERROR_NONE) {
       GELOGE(RT_FAILED, "rtEventSynchronize failed. ret = %d", rt_err);
-      GE_CHK_RT(rtEventDestroy(event));
       return RT_FAILED;
     }
+    return SUCCESS;
+  }
 
-    GE_CHK_RT(rtEventDestroy(event));
+  // spin a while before sleeping, the sleep interval adapts to how long recent events took
+  uint32_t query_count = 0;
+  while (true) {
+    auto rt_err = rtEventQuery(event);
+    if (rt_err == RT_ERROR_NONE) {
+      break;
+    }
+    if (rt_err != ACL_ERROR_RT_EVENT_NOT_COMPLETE) {
+      GELOGE(RT_FAILED, "rtEventQuery failed. ret = %d", rt_err);
+      return RT_FAILED;
+    }
+    if (++query_count <= kQuerySpinCount) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(backoff_us_));
+    backoff_us_ = std::min(backoff_us_ * 2, kMaxBackoffUs);
+  }
+  if (query_count == 0) {
+    backoff_us_ = std::max(backoff_us_ / 2, kMinBackoffUs);
+  }
+  return SUCCESS;
+}
 
-    auto cb_func = entry.second.first;
-    auto cb_args = entry.second.second;
-    cb_func(cb_args);
+Status CallbackManager::CallbackProcess(rtContext_t context) {
+  GE_CHK_RT_RET(rtCtxSetCurrent(context));
+  std::deque<CallbackEntry> entries;
+  Status ret = SUCCESS;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      cv_.wait(lk, [this]() { return !pending_entries_.empty(); });
+      entries.swap(pending_entries_);
+    }
+    GELOGD("Fetched %zu callback entries", entries.size());
+
+    while (!entries.empty()) {
+      auto &entry = entries.front();
+      auto event = entry.event;
+      if (event == nullptr) {
+        entries.pop_front();
+        // entries registered after eof belong to next round
+        std::lock_guard<std::mutex> lk(mu_);
+        pending_entries_.insert(pending_entries_.begin(), std::make_move_iterator(entries.begin()),
+                                std::make_move_iterator(entries.end()));
+        return ret;
+      }
+
+      if (ret == SUCCESS) {
+        ret = WaitEvent(event);
+      }
+      if (ret == SUCCESS) {
+        ReleaseEvent(event);
+      } else {
+        // after a failed wait, events until eof are not waited or reused, callbacks still run to release
+        // what they hold, and the error is returned by Destroy
+        GELOGW("Skip waiting event of %zu callbacks, as waiting event failed before.", entry.callbacks.size());
+        GE_CHK_RT(rtEventDestroy(event));
+      }
+
+      for (const auto &callback : entry.callbacks) {
+        auto cb_func = callback.first;
+        auto cb_args = callback.second;
+        cb_func(cb_args);
+      }
+      entries.pop_front();
+    }
   }
 }
 
@@ -93,9 +216,7 @@ Status CallbackManager::Destroy() {
     return SUCCESS;
   }
 
-  std::pair<rtEvent_t, std::pair<rtCallback_t, void *>> eof_entry;
-  eof_entry.first = nullptr;
-  callback_queue_.Push(eof_entry);
+  PushEntry(CallbackEntry());
 
   auto ret = ret_future_.get();
   GELOGI("Callback manager ended. ret = %u", ret);
@@ -18,20 +18,25 @@
 #define GE_HYBRID_EXECUTOR_RT_CALLBACK_MANAGER_H_
 
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <vector>
 
-#include "common/blocking_queue.h"
 #include "ge/ge_api_error_codes.h"
 #include "runtime/rt.h"
 
 namespace ge {
 namespace hybrid {
+// Callbacks are invoked by a dedicated thread once the work launched before their registration is done.
+// Events are recycled through a pool, and consecutive callbacks of the same stream which are not taken by
+// the callback thread yet share one event, which is re-recorded on each registration.
 class CallbackManager {
  public:
   CallbackManager() = default;
-  ~CallbackManager() = default;
+  virtual ~CallbackManager();
 
   Status Init();
 
@@ -41,10 +46,25 @@ class CallbackManager {
   Status RegisterCallback(rtStream_t stream, const std::function<void()> &callback);
 
  private:
+  struct CallbackEntry {
+    rtEvent_t event = nullptr;  // nullptr for eof
+    rtStream_t stream = nullptr;
+    std::vector<std::pair<rtCallback_t, void *>> callbacks;
+  };
+
   Status CallbackProcess(rtContext_t context);
+  virtual Status WaitEvent(rtEvent_t event);
+  Status AcquireEvent(rtEvent_t &event);
+  void ReleaseEvent(rtEvent_t event);
+  void PushEntry(CallbackEntry &&entry);
   static void RtCallbackFunc(void *data);
 
-  BlockingQueue<std::pair<rtEvent_t, std::pair<rtCallback_t, void *>>> callback_queue_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<CallbackEntry> pending_entries_;
+  std::vector<rtEvent_t> free_events_;
+  bool query_mode_ = false;
+  uint32_t backoff_us_ = 0;
   std::future<Status> ret_future_;
 };
 }  // namespace hybrid
@@ -33,13 +33,23 @@ Status SubgraphContext::Init() {
          graph_item_->TotalOutputs());
   all_inputs_.resize(static_cast<unsigned long>(graph_item_->TotalInputs()));
   all_outputs_.resize(static_cast<unsigned long>(graph_item_->TotalOutputs()));
+  node_states_.resize(graph_item_->GetAllNodes().size());
+  node_done_manager_.Init(graph_item_->GetAllNodes().size());
 
   return SUCCESS;
 }
 
 NodeStatePtr SubgraphContext::GetOrCreateNodeState(const NodeItem *node_item) {
+  auto index = node_item->graph_index;
+  if (index < 0 || static_cast<size_t>(index) >= node_states_.size() ||
+      graph_item_->GetAllNodes()[index] != node_item) {
+    GELOGE(INTERNAL_ERROR, "[%s] Node of index %d is not in graph [%s]",
+           node_item->NodeName().c_str(), index, graph_item_->GetName().c_str());
+    return nullptr;
+  }
+
   std::lock_guard<std::mutex> lk(mu_);
-  auto &node_state = node_states_[node_item];
+  auto &node_state = node_states_[index];
   if (node_state == nullptr) {
     node_state.reset(new(std::nothrow)NodeState(*node_item, this));
   }
@@ -112,8 +122,8 @@ Status SubgraphContext::GetOutputs(std::vector<TensorValue> &outputs) {
   return SUCCESS;
 }
 
-Status SubgraphContext::Await(const NodePtr &node) {
-  if (node_done_manager_.Await(node)) {
+Status SubgraphContext::Await(const NodeItem &node_item) {
+  if (node_done_manager_.Await(node_item)) {
     return SUCCESS;
   }
 
@@ -131,8 +141,8 @@ void SubgraphContext::OnError(Status error) {
   node_done_manager_.Destroy();
 }
 
-void SubgraphContext::NodeDone(const NodePtr &node) {
-  node_done_manager_.NodeDone(node);
+void SubgraphContext::NodeDone(const NodeItem &node_item) {
+  node_done_manager_.NodeDone(node_item);
 }
 }  // namespace hybrid
 }  // namespace ge
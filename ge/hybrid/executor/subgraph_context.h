@@ -44,8 +44,8 @@ class SubgraphContext {
   Status GetInput(int index, TensorValue &tensor);
   Status GetOutputs(std::vector<TensorValue> &outputs);
 
-  Status Await(const NodePtr &node);
-  void NodeDone(const NodePtr &node);
+  Status Await(const NodeItem &node_item);
+  void NodeDone(const NodeItem &node_item);
 
  private:
   friend class TaskContext;
@@ -55,7 +55,8 @@ class SubgraphContext {
   std::vector<TensorValue> all_inputs_;
   std::vector<TensorValue> all_outputs_;
   NodeDoneManager node_done_manager_;
-  std::unordered_map<const NodeItem *, NodeStatePtr> node_states_;
+  // indexed by NodeItem::graph_index
+  std::vector<NodeStatePtr> node_states_;
 };
 }  // namespace hybrid
 }  // namespace ge
@@ -15,6 +15,8 @@
  */
 
 #include "hybrid/executor/subgraph_executor.h"
+#include "common/ge/ge_util.h"
+#include "common/profiling/profiling_manager.h"
 #include "graph/ge_context.h"
 #include "hybrid/executor/worker/task_compile_engine.h"
 #include "hybrid/executor/worker/execution_engine.h"
@@ -26,6 +28,7 @@ namespace {
 constexpr int kDefaultThreadNum = 4;
 constexpr int kDefaultQueueSize = 16;
 constexpr int kDataInputIndex = 0;
+constexpr size_t kMaxDeferredCallbacks = 16;
 }
 
 SubgraphExecutor::SubgraphExecutor(const GraphItem *graph_item, GraphExecutionContext *context, bool force_infer_shape)
@@ -37,9 +40,22 @@ SubgraphExecutor::SubgraphExecutor(const GraphItem *graph_item, GraphExecutionCo
 }
 
 SubgraphExecutor::~SubgraphExecutor() {
+  for (auto event : stream_events_) {
+    (void) rtEventDestroy(event);
+  }
   GELOGD("[%s] SubgraphExecutor destroyed.", graph_item_->GetName().c_str());
 }
 
+void SubgraphExecutor::Reset(bool force_infer_shape) {
+  force_infer_shape_ = force_infer_shape;
+  known_shape_task_context_.reset();
+  shape_inference_engine_.reset();
+  subgraph_context_.reset();
+  ready_queue_.Clear();
+  ready_queue_.Restart();
+  deferred_callbacks_.clear();
+}
+
 Status SubgraphExecutor::Init(const std::vector<TensorValue> &inputs,
                               const std::vector<ConstGeTensorDescPtr> &input_desc) {
   subgraph_context_.reset(new(std::nothrow)SubgraphContext(graph_item_, context_));
@@ -316,7 +332,8 @@ Status SubgraphExecutor::LaunchTasks() {
 
     if (node_state == nullptr) {
       GELOGD("[%s] Got EOF from queue.", graph_item_->GetName().c_str());
-      return SUCCESS;
+      GE_CHK_STATUS_RET_NOLOG(FlushAllDeferredCallbacks());
+      return JoinStreams();
     }
 
     if (node_state->GetType() == NETOUTPUT) {
@@ -334,15 +351,148 @@ Status SubgraphExecutor::LaunchTasks() {
     auto shared_task_context = node_state->GetTaskContext();
     GE_CHECK_NOTNULL(shared_task_context);
     shared_task_context->SetForceInferShape(force_infer_shape_);
+    size_t stream_index = 0;
+    const MultiStreamPlan::NodeStreamInfo *stream_info = nullptr;
+    if (stream_plan_ != nullptr) {
+      stream_info = &stream_plan_->GetNodeStreamInfo(*node_state->GetNodeItem());
+      stream_index = static_cast<size_t>(stream_info->stream_id);
+      auto stream = GetPlanStream(stream_info->stream_id);
+      for (auto event_index : stream_info->wait_events) {
+        GE_CHK_RT_RET(rtStreamWaitEvent(stream, stream_events_[event_index]));
+      }
+      shared_task_context->SetStream(stream);
+      context_->multi_stream_statistic.launched_nodes[stream_info->stream_id]++;
+      context_->multi_stream_statistic.waited_events += stream_info->wait_events.size();
+    }
+    std::vector<std::function<void()>> *deferred_callbacks = nullptr;
+    if (CanDeferCallback(*node_state->GetNodeItem())) {
+      if (deferred_callbacks_.size() <= stream_index) {
+        deferred_callbacks_.resize(stream_index + 1);
+      }
+      deferred_callbacks = &deferred_callbacks_[stream_index];
+    }
+    shared_task_context->SetDeferredCallbacks(deferred_callbacks);
     HYBRID_CHK_STATUS_RET(ExecutionEngine::ExecuteAsync(*node_state, shared_task_context, *context_),
                           "[%s] Execute node failed.",
                           node_state->GetName().c_str());
+    shared_task_context->SetDeferredCallbacks(nullptr);
+    if ((stream_info != nullptr) && (stream_info->event_index >= 0)) {
+      GE_CHK_RT_RET(rtEventRecord(stream_events_[stream_info->event_index], shared_task_context->GetStream()));
+    }
+    if ((deferred_callbacks != nullptr) && (deferred_callbacks->size() >= kMaxDeferredCallbacks)) {
+      GE_CHK_STATUS_RET_NOLOG(FlushDeferredCallbacks(stream_index));
+    }
     GELOGD("[%s] Done executing node successfully.", node_state->GetName().c_str());
   }
 }
 
+Status SubgraphExecutor::InitStreamEvents(const MultiStreamPlan &stream_plan) {
+  size_t event_num = static_cast<size_t>(stream_plan.GetEventNum() + stream_plan.GetStreamNum());
+  while (stream_events_.size() < event_num) {
+    rtEvent_t event = nullptr;
+    GE_CHK_RT_RET(rtEventCreate(&event));
+    stream_events_.emplace_back(event);
+  }
+  return SUCCESS;
+}
+
+rtStream_t SubgraphExecutor::GetPlanStream(int stream_id) const {
+  return stream_id == 0 ? context_->stream : context_->side_streams[stream_id - 1];
+}
+
+Status SubgraphExecutor::ForkStreams() {
+  stream_plan_ = nullptr;
+  auto stream_plan = graph_item_->GetStreamPlan();
+  if ((stream_plan == nullptr) || context_->side_streams.empty() ||
+      (static_cast<size_t>(stream_plan->GetStreamNum()) > context_->side_streams.size() + 1)) {
+    return SUCCESS;
+  }
+  GE_CHK_STATUS_RET_NOLOG(InitStreamEvents(*stream_plan));
+  // inputs of the subgraph are produced on stream of the execution context
+  auto fork_event = stream_events_[stream_plan->GetEventNum()];
+  GE_CHK_RT_RET(rtEventRecord(fork_event, context_->stream));
+  for (int i = 1; i < stream_plan->GetStreamNum(); ++i) {
+    GE_CHK_RT_RET(rtStreamWaitEvent(GetPlanStream(i), fork_event));
+  }
+  stream_plan_ = stream_plan;
+  GELOGD("[%s] Streams forked, stream num = %d.", graph_item_->GetName().c_str(), stream_plan->GetStreamNum());
+  return SUCCESS;
+}
+
+Status SubgraphExecutor::JoinStreams() {
+  if (stream_plan_ == nullptr) {
+    return SUCCESS;
+  }
+  // outputs are consumed and synchronized on stream of the execution context
+  for (int i = 1; i < stream_plan_->GetStreamNum(); ++i) {
+    auto join_event = stream_events_[stream_plan_->GetEventNum() + i];
+    GE_CHK_RT_RET(rtEventRecord(join_event, GetPlanStream(i)));
+    GE_CHK_RT_RET(rtStreamWaitEvent(context_->stream, join_event));
+  }
+  stream_plan_ = nullptr;
+  GELOGD("[%s] Streams joined.", graph_item_->GetName().c_str());
+  return SUCCESS;
+}
+
+bool SubgraphExecutor::CanDeferCallback(const NodeItem &node_item) const {
+  // callbacks of other nodes do more than releasing inputs, or are awaited by other nodes
+  return defer_callbacks_ && node_item.is_kernel_launch && !node_item.has_observer &&
+         node_item.to_const_output_id_list.empty() &&
+         (node_item.shape_inference_type != DEPEND_SHAPE_RANGE) && (node_item.shape_inference_type != DEPEND_COMPUTE);
+}
+
+Status SubgraphExecutor::FlushDeferredCallbacks(size_t stream_index) {
+  auto &deferred_callbacks = deferred_callbacks_[stream_index];
+  if (deferred_callbacks.empty()) {
+    return SUCCESS;
+  }
+  auto callbacks = MakeShared<std::vector<std::function<void()>>>(std::move(deferred_callbacks));
+  deferred_callbacks.clear();
+  GE_CHECK_NOTNULL(callbacks);
+  auto stream = (stream_plan_ != nullptr) ? GetPlanStream(static_cast<int>(stream_index)) : context_->stream;
+  GELOGD("[%s] Register %zu deferred callbacks.", graph_item_->GetName().c_str(), callbacks->size());
+  GE_CHK_STATUS_RET(context_->callback_manager->RegisterCallback(stream, [callbacks]() {
+                      for (const auto &callback : *callbacks) {
+                        callback();
+                      }
+                    }),
+                    "[%s] Failed to register deferred callbacks.", graph_item_->GetName().c_str());
+  return SUCCESS;
+}
+
+void SubgraphExecutor::RunDeferredCallbacks() {
+  // kernels launched before the failure may still be using the task contexts held by the callbacks
+  for (size_t i = 0; i < deferred_callbacks_.size(); ++i) {
+    auto &deferred_callbacks = deferred_callbacks_[i];
+    if (deferred_callbacks.empty()) {
+      continue;
+    }
+    auto stream = (stream_plan_ != nullptr) ? GetPlanStream(static_cast<int>(i)) : context_->stream;
+    auto rt_ret = rtStreamSynchronize(stream);
+    if (rt_ret != RT_ERROR_NONE) {
+      GELOGW("[%s] Failed to synchronize stream before running %zu deferred callbacks, ret = %d.",
+             graph_item_->GetName().c_str(), deferred_callbacks.size(), rt_ret);
+    }
+    GELOGD("[%s] Run %zu deferred callbacks.", graph_item_->GetName().c_str(), deferred_callbacks.size());
+    for (const auto &callback : deferred_callbacks) {
+      callback();
+    }
+    deferred_callbacks.clear();
+  }
+}
+
+Status SubgraphExecutor::FlushAllDeferredCallbacks() {
+  for (size_t i = 0; i < deferred_callbacks_.size(); ++i) {
+    GE_CHK_STATUS_RET_NOLOG(FlushDeferredCallbacks(i));
+  }
+  return SUCCESS;
+}
+
 Status SubgraphExecutor::ScheduleTasks(int group) {
   GELOGD("[%s] Start to schedule prepare workers.", graph_item_->GetName().c_str());
+  GE_CHK_STATUS_RET(ForkStreams(), "[%s] Failed to fork streams.", graph_item_->GetName().c_str());
+  defer_callbacks_ = (context_->profiling_level == 0) && context_->dump_properties.GetDumpPath().empty() &&
+                     !ProfilingManager::Instance().ProfilingModelExecuteOn();
   auto prepare_future = std::async(std::launch::async, [&]() -> Status {
     GetContext().SetSessionId(context_->session_id);
     auto ret = PrepareNodes(group);
@@ -353,16 +503,21 @@ Status SubgraphExecutor::ScheduleTasks(int group) {
   GELOGD("[%s] Start to execute subgraph.", graph_item_->GetName().c_str());
   auto ret = LaunchTasks();
   if (ret != SUCCESS) {
+    reusable_ = false;
     subgraph_context_->OnError(ret);
     context_->SetErrorCode(ret);
     ready_queue_.Stop();
     prepare_future.wait();
+    RunDeferredCallbacks();
     return ret;
   }
 
-  GE_CHK_STATUS_RET(prepare_future.get(),
-                    "[%s] Error occurred in task preparation.",
-                    graph_item_->GetName().c_str());
+  ret = prepare_future.get();
+  if (ret != SUCCESS) {
+    reusable_ = false;
+    GELOGE(ret, "[%s] Error occurred in task preparation.", graph_item_->GetName().c_str());
+    return ret;
+  }
 
   GELOGD("[%s] Done launching all tasks successfully.", graph_item_->GetName().c_str());
   return SUCCESS;
@@ -391,7 +546,11 @@ Status SubgraphExecutor::GetOutputs(vector<TensorValue> &outputs, std::vector<Co
 
 Status SubgraphExecutor::Synchronize() {
   GELOGD("[%s] Synchronize start.", graph_item_->GetName().c_str());
-  GE_CHK_STATUS_RET_NOLOG(context_->Synchronize(context_->stream));
+  auto ret = context_->Synchronize(context_->stream);
+  if (ret != SUCCESS) {
+    reusable_ = false;
+    return ret;
+  }
   GELOGD("[%s] Done synchronizing successfully.", graph_item_->GetName().c_str());
   return SUCCESS;
 }
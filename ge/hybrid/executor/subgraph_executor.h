@@ -24,6 +24,7 @@
 #include "hybrid/executor/subgraph_context.h"
 #include "hybrid/executor/node_state.h"
 #include "hybrid/executor/hybrid_execution_context.h"
+#include "hybrid/executor/multi_stream_plan.h"
 #include "hybrid/executor/worker/shape_inference_engine.h"
 #include "hybrid/model/graph_item.h"
 #include "hybrid/node_executor/task_context.h"
@@ -91,6 +92,21 @@ class SubgraphExecutor {
    */
   Status GetOutputs(std::vector<TensorValue> &outputs, std::vector<ConstGeTensorDescPtr> &output_desc);
 
+  /**
+   * Release states of last execution, prepare workers and ready queue are kept for next execution
+   * @param force_infer_shape   force infer shape for next execution
+   */
+  void Reset(bool force_infer_shape = false);
+
+  bool IsReusable() const { return reusable_; }
+
+  /**
+   * Never reuse this executor, device work launched by it may still be pending
+   */
+  void Discard() { reusable_ = false; }
+
+  const GraphItem *GetGraphItem() const { return graph_item_; }
+
  private:
   Status PrepareForExecution(GraphExecutionContext *ctx, NodeState &node_state);
   Status EnableOutputZeroCopy(const std::vector<TensorValue> &outputs);
@@ -105,6 +121,14 @@ class SubgraphExecutor {
   Status PrepareNodes(int group = -1);
   Status LaunchTasks();
   Status SetOutputsToParentNode(TaskContext &task_context);
+  Status InitStreamEvents(const MultiStreamPlan &stream_plan);
+  Status ForkStreams();
+  Status JoinStreams();
+  rtStream_t GetPlanStream(int stream_id) const;
+  bool CanDeferCallback(const NodeItem &node_item) const;
+  Status FlushDeferredCallbacks(size_t stream_index);
+  Status FlushAllDeferredCallbacks();
+  void RunDeferredCallbacks();
 
   const GraphItem *graph_item_;
   GraphExecutionContext *context_;
@@ -114,6 +138,16 @@ class SubgraphExecutor {
   BlockingQueue<NodeState *> ready_queue_;
   std::unique_ptr<ShapeInferenceEngine> shape_inference_engine_;
   std::shared_ptr<TaskContext> known_shape_task_context_;
+  // false once scheduling failed, as prepare tasks may still be in flight
+  bool reusable_ = true;
+  // not null if nodes are launched to multiple streams in current execution
+  const MultiStreamPlan *stream_plan_ = nullptr;
+  // events of stream plan, followed by the fork event and the join events of side streams
+  std::vector<rtEvent_t> stream_events_;
+  // done callbacks of nodes not awaited by others are invoked by a single callback of every batch,
+  // instead of an event per node. Batches are indexed by stream id of stream plan
+  bool defer_callbacks_ = false;
+  std::vector<std::vector<std::function<void()>>> deferred_callbacks_;
 };
 }  // namespace hybrid
 }  // namespace ge
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "hybrid/executor/subgraph_executor_pool.h"
+#include "hybrid/executor/subgraph_executor.h"
+
+namespace ge {
+namespace hybrid {
+namespace {
+// executors of a subgraph in use at the same time, more than that are destroyed on release
+const size_t kMaxIdleExecutorsPerGraph = 4;
+}  // namespace
+
+SubgraphExecutorPool::~SubgraphExecutorPool() = default;
+
+std::shared_ptr<SubgraphExecutor> SubgraphExecutorPool::Acquire(const GraphItem *graph_item,
+                                                                GraphExecutionContext *context,
+                                                                bool force_infer_shape) {
+  std::unique_ptr<SubgraphExecutor> executor;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto &idle_executors = idle_executors_[graph_item];
+    if (!idle_executors.empty()) {
+      executor = std::move(idle_executors.back());
+      idle_executors.pop_back();
+    }
+  }
+
+  if (executor != nullptr) {
+    executor->Reset(force_infer_shape);
+    GELOGD("[%s] Reuse subgraph executor from pool.", graph_item->GetName().c_str());
+  } else {
+    executor.reset(new (std::nothrow) SubgraphExecutor(graph_item, context, force_infer_shape));
+    if (executor == nullptr) {
+      GELOGE(MEMALLOC_FAILED, "[%s] Failed to create subgraph executor.", graph_item->GetName().c_str());
+      return nullptr;
+    }
+  }
+
+  std::weak_ptr<SubgraphExecutorPool> weak_pool = shared_from_this();
+  return std::shared_ptr<SubgraphExecutor>(executor.release(), [weak_pool](SubgraphExecutor *released) {
+    auto pool = weak_pool.lock();
+    if (pool == nullptr) {
+      delete released;
+      return;
+    }
+    pool->Release(released);
+  });
+}
+
+void SubgraphExecutorPool::Release(SubgraphExecutor *executor) {
+  std::unique_ptr<SubgraphExecutor> released(executor);
+  if (!released->IsReusable()) {
+    // prepare tasks of a failed execution may still be running, never reuse it
+    return;
+  }
+  // drop tensors and node states of the finished execution before it idles
+  released->Reset();
+  std::lock_guard<std::mutex> lk(mu_);
+  auto &idle_executors = idle_executors_[released->GetGraphItem()];
+  if (idle_executors.size() < kMaxIdleExecutorsPerGraph) {
+    idle_executors.emplace_back(std::move(released));
+  }
+}
+
+size_t SubgraphExecutorPool::NumIdleExecutors(const GraphItem *graph_item) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto it = idle_executors_.find(graph_item);
+  return it == idle_executors_.end() ? 0 : it->second.size();
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,57 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GE_HYBRID_EXECUTOR_SUBGRAPH_EXECUTOR_POOL_H_
+#define GE_HYBRID_EXECUTOR_SUBGRAPH_EXECUTOR_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ge {
+namespace hybrid {
+class GraphItem;
+class SubgraphExecutor;
+struct GraphExecutionContext;
+
+// Idle executors of control op subgraphs, kept per GraphItem.
+// An executor acquired from the pool goes back to it once the last reference is dropped, so branches and loop
+// iterations reuse its prepare workers and ready queue instead of creating new ones on every execution.
+class SubgraphExecutorPool : public std::enable_shared_from_this<SubgraphExecutorPool> {
+ public:
+  SubgraphExecutorPool() = default;
+  ~SubgraphExecutorPool();
+
+  SubgraphExecutorPool(const SubgraphExecutorPool &) = delete;
+  SubgraphExecutorPool &operator=(const SubgraphExecutorPool &) = delete;
+
+  std::shared_ptr<SubgraphExecutor> Acquire(const GraphItem *graph_item,
+                                            GraphExecutionContext *context,
+                                            bool force_infer_shape = false);
+
+  size_t NumIdleExecutors(const GraphItem *graph_item);
+
+ private:
+  void Release(SubgraphExecutor *executor);
+
+  std::mutex mu_;
+  std::unordered_map<const GraphItem *, std::vector<std::unique_ptr<SubgraphExecutor>>> idle_executors_;
+};
+}  // namespace hybrid
+}  // namespace ge
+#endif // GE_HYBRID_EXECUTOR_SUBGRAPH_EXECUTOR_POOL_H_
@@ -0,0 +1,304 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hybrid/executor/worker/shape_inference_cache.h"
+#include <climits>
+#include <set>
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/types.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/op_desc_utils.h"
+#include "graph/utils/tensor_utils.h"
+
+namespace ge {
+namespace hybrid {
+namespace {
+const size_t kMaxCacheEntries = 8;
+const int kReshapeShapeIndex = 1;
+const int kBroadcastInputNum = 2;
+const int64_t kReshapeInferredDim = -1;
+const char *const kAttrNameAxis = "axis";
+const char *const kAttrNameNumAxes = "num_axes";
+
+const std::set<std::string> kSameAsInputTypes = {
+    IDENTITY, CAST, "Relu", RELU, "Relu6", SIGMOID, "Tanh", TANH, "Exp", "Log", SQRT, RSQRT, NEG, "Abs",
+    SQUARE, "Reciprocal", "Erf", "Gelu", "Floor", "Ceil", "Round", "Sign", "LogicalNot", "ZerosLike",
+    "OnesLike", "StopGradient", "Softplus", "Elu", "LeakyRelu", "Swish"};
+
+const std::set<std::string> kBroadcastTypes = {
+    ADD, "AddV2", SUB, MUL, REALDIV, "Div", MAXIMUM, MINIMUM, "Pow", EQUAL, "NotEqual", GREATER, "GreaterEqual",
+    LESS, "LessEqual", "LogicalAnd", "LogicalOr", "FloorDiv", "FloorMod", "SquaredDifference"};
+
+bool IsConstType(const NodePtr &node) {
+  return (node->GetType() == CONSTANT) || (node->GetType() == CONSTANTOP);
+}
+
+// shape and origin shape of rule inferred tensors are the same, so formats must not be transformed
+bool IsAllFormatsOrigin(const NodeItem &node_item) {
+  for (int i = 0; i < node_item.num_inputs; ++i) {
+    auto input_desc = node_item.MutableInputDesc(i);
+    if ((input_desc == nullptr) || (input_desc->GetFormat() != input_desc->GetOriginFormat())) {
+      return false;
+    }
+  }
+  for (int i = 0; i < node_item.num_outputs; ++i) {
+    auto output_desc = node_item.MutableOutputDesc(i);
+    if ((output_desc == nullptr) || (output_desc->GetFormat() != output_desc->GetOriginFormat())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SetOutputDims(const NodeItem &node_item, int index, const std::vector<int64_t> &dims) {
+  auto output_desc = node_item.MutableOutputDesc(index);
+  output_desc->SetShape(GeShape(dims));
+  output_desc->SetOriginShape(GeShape(dims));
+}
+}  // namespace
+
+std::shared_ptr<ShapeInferenceCache> ShapeInferenceCache::Create(const NodeItem &node_item) {
+  if ((node_item.shape_inference_type != DEPEND_IN_SHAPE) || (node_item.fused_subgraph != nullptr) ||
+      node_item.IsControlOp() || (node_item.num_outputs == 0)) {
+    return nullptr;
+  }
+  for (const auto &src_node : node_item.dependents_for_shape_inference) {
+    if (!IsConstType(src_node)) {
+      GELOGD("[%s] Shape inference depends on value of %s, cache disabled.",
+             node_item.NodeName().c_str(), src_node->GetName().c_str());
+      return nullptr;
+    }
+  }
+
+  std::shared_ptr<ShapeInferenceCache> cache(new (std::nothrow) ShapeInferenceCache());
+  if (cache == nullptr) {
+    GELOGW("[%s] Failed to create shape inference cache.", node_item.NodeName().c_str());
+    return nullptr;
+  }
+  cache->CompileRule(node_item);
+  GELOGD("[%s] Shape inference cache created, rule = %d.", node_item.NodeName().c_str(),
+         static_cast<int>(cache->rule_));
+  return cache;
+}
+
+void ShapeInferenceCache::CompileRule(const NodeItem &node_item) {
+  if ((node_item.num_outputs != 1) || node_item.has_optional_inputs || !IsAllFormatsOrigin(node_item)) {
+    return;
+  }
+  const auto &node_type = node_item.NodeType();
+  if ((kSameAsInputTypes.count(node_type) > 0) && (node_item.num_inputs == 1)) {
+    rule_ = ShapeRule::kSameAsInput;
+  } else if ((kBroadcastTypes.count(node_type) > 0) && (node_item.num_inputs == kBroadcastInputNum)) {
+    rule_ = ShapeRule::kBroadcast;
+  } else if ((node_type == RESHAPE) && CompileReshapeRule(node_item)) {
+    rule_ = ShapeRule::kReshapeConst;
+  }
+}
+
+bool ShapeInferenceCache::CompileReshapeRule(const NodeItem &node_item) {
+  int64_t axis = 0;
+  int64_t num_axes = kReshapeInferredDim;
+  (void) AttrUtils::GetInt(node_item.op_desc, kAttrNameAxis, axis);
+  (void) AttrUtils::GetInt(node_item.op_desc, kAttrNameNumAxes, num_axes);
+  if ((node_item.num_inputs != kReshapeShapeIndex + 1) || (axis != 0) || (num_axes != kReshapeInferredDim)) {
+    return false;
+  }
+
+  auto in_anchor = node_item.node->GetInDataAnchor(kReshapeShapeIndex);
+  if ((in_anchor == nullptr) || (in_anchor->GetPeerOutAnchor() == nullptr)) {
+    return false;
+  }
+  auto src_node = in_anchor->GetPeerOutAnchor()->GetOwnerNode();
+  if ((src_node == nullptr) || !IsConstType(src_node)) {
+    return false;
+  }
+  auto weights = OpDescUtils::MutableWeights(src_node);
+  if (weights.empty() || (weights[0] == nullptr)) {
+    return false;
+  }
+
+  const auto &tensor = *weights[0];
+  const auto data_type = tensor.GetTensorDesc().GetDataType();
+  const uint8_t *data = tensor.GetData().data();
+  size_t size = tensor.GetData().size();
+  std::vector<int64_t> dims;
+  if (data_type == DT_INT32) {
+    auto values = reinterpret_cast<const int32_t *>(data);
+    dims.assign(values, values + size / sizeof(int32_t));
+  } else if (data_type == DT_INT64) {
+    auto values = reinterpret_cast<const int64_t *>(data);
+    dims.assign(values, values + size / sizeof(int64_t));
+  } else {
+    return false;
+  }
+
+  int num_inferred = 0;
+  for (auto dim : dims) {
+    // 0 copies dim from input for some frameworks, leave it to infer func
+    if ((dim == 0) || (dim < kReshapeInferredDim)) {
+      return false;
+    }
+    num_inferred += (dim == kReshapeInferredDim) ? 1 : 0;
+  }
+  if (num_inferred > 1) {
+    return false;
+  }
+  reshape_dims_ = std::move(dims);
+  return true;
+}
+
+bool ShapeInferenceCache::InferBroadcast(const std::vector<int64_t> &dims1, const std::vector<int64_t> &dims2,
+                                         std::vector<int64_t> &dims) {
+  const auto &longer = (dims1.size() >= dims2.size()) ? dims1 : dims2;
+  const auto &shorter = (dims1.size() >= dims2.size()) ? dims2 : dims1;
+  size_t offset = longer.size() - shorter.size();
+  dims = longer;
+  for (size_t i = 0; i < shorter.size(); ++i) {
+    int64_t dim1 = longer[i + offset];
+    int64_t dim2 = shorter[i];
+    if ((dim1 < 0) || (dim2 < 0)) {
+      return false;
+    }
+    if ((dim1 == dim2) || (dim2 == 1)) {
+      continue;
+    }
+    if (dim1 != 1) {
+      // not broadcastable, let infer func report the error
+      return false;
+    }
+    dims[i + offset] = dim2;
+  }
+  return true;
+}
+
+bool ShapeInferenceCache::InferReshape(const NodeItem &node_item) const {
+  const auto &input_dims = node_item.MutableInputDesc(0)->GetShape().GetDims();
+  int64_t num_elements = 1;
+  for (auto dim : input_dims) {
+    if ((dim < 0) || ((dim != 0) && (num_elements > INT64_MAX / dim))) {
+      return false;
+    }
+    num_elements *= dim;
+  }
+
+  int64_t known_elements = 1;
+  int inferred_index = -1;
+  for (size_t i = 0; i < reshape_dims_.size(); ++i) {
+    if (reshape_dims_[i] == kReshapeInferredDim) {
+      inferred_index = static_cast<int>(i);
+    } else if (known_elements > INT64_MAX / reshape_dims_[i]) {
+      return false;
+    } else {
+      known_elements *= reshape_dims_[i];
+    }
+  }
+
+  auto dims = reshape_dims_;
+  if (inferred_index >= 0) {
+    if ((known_elements == 0) || (num_elements % known_elements != 0)) {
+      return false;
+    }
+    dims[inferred_index] = num_elements / known_elements;
+  } else if (known_elements != num_elements) {
+    return false;
+  }
+  SetOutputDims(node_item, 0, dims);
+  return true;
+}
+
+bool ShapeInferenceCache::ApplyRule(const NodeItem &node_item) const {
+  switch (rule_) {
+    case ShapeRule::kSameAsInput:
+      SetOutputDims(node_item, 0, node_item.MutableInputDesc(0)->GetShape().GetDims());
+      return true;
+    case ShapeRule::kBroadcast: {
+      std::vector<int64_t> dims;
+      if (!InferBroadcast(node_item.MutableInputDesc(0)->GetShape().GetDims(),
+                          node_item.MutableInputDesc(1)->GetShape().GetDims(), dims)) {
+        return false;
+      }
+      SetOutputDims(node_item, 0, dims);
+      return true;
+    }
+    case ShapeRule::kReshapeConst:
+      return InferReshape(node_item);
+    default:
+      return false;
+  }
+}
+
+bool ShapeInferenceCache::MatchInputs(const NodeItem &node_item, const CacheEntry &entry) const {
+  for (int i = 0; i < node_item.num_inputs; ++i) {
+    auto input_desc = node_item.MutableInputDesc(i);
+    if ((input_desc == nullptr) || (input_desc->GetShape().GetDims() != entry.inputs[i].dims) ||
+        (input_desc->GetOriginShape().GetDims() != entry.inputs[i].origin_dims)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ShapeInferenceCache::Lookup(const NodeItem &node_item) {
+  std::lock_guard<std::mutex> lk(mu_);
+  for (const auto &entry : entries_) {
+    if (!MatchInputs(node_item, entry)) {
+      continue;
+    }
+    for (int i = 0; i < node_item.num_outputs; ++i) {
+      auto output_desc = node_item.MutableOutputDesc(i);
+      const auto &output = entry.outputs[i];
+      output_desc->SetShape(GeShape(output.dims));
+      output_desc->SetOriginShape(GeShape(output.origin_dims));
+      TensorUtils::SetSize(*output_desc, output.size);
+    }
+    return true;
+  }
+  return false;
+}
+
+void ShapeInferenceCache::Save(const NodeItem &node_item) {
+  CacheEntry entry;
+  entry.inputs.resize(node_item.num_inputs);
+  for (int i = 0; i < node_item.num_inputs; ++i) {
+    auto input_desc = node_item.MutableInputDesc(i);
+    if (input_desc == nullptr) {
+      return;
+    }
+    entry.inputs[i].dims = input_desc->GetShape().GetDims();
+    entry.inputs[i].origin_dims = input_desc->GetOriginShape().GetDims();
+  }
+  entry.outputs.resize(node_item.num_outputs);
+  for (int i = 0; i < node_item.num_outputs; ++i) {
+    auto output_desc = node_item.MutableOutputDesc(i);
+    if (output_desc == nullptr) {
+      return;
+    }
+    entry.outputs[i].dims = output_desc->GetShape().GetDims();
+    entry.outputs[i].origin_dims = output_desc->GetOriginShape().GetDims();
+    (void) TensorUtils::GetSize(*output_desc, entry.outputs[i].size);
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  if (entries_.size() < kMaxCacheEntries) {
+    entries_.emplace_back(std::move(entry));
+    return;
+  }
+  // shapes of one node seldom vary much, replace in turn
+  entries_[next_replaced_] = std::move(entry);
+  next_replaced_ = (next_replaced_ + 1) % kMaxCacheEntries;
+}
+}  // namespace hybrid
+}  // namespace ge
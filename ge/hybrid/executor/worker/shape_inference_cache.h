@@ -0,0 +1,84 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_HYBRID_EXECUTOR_WORKER_SHAPE_INFERENCE_CACHE_H_
+#define GE_HYBRID_EXECUTOR_WORKER_SHAPE_INFERENCE_CACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "hybrid/model/node_item.h"
+
+namespace ge {
+namespace hybrid {
+// Shape inference result of one node, saved per input shapes so that repeated shapes skip the infer func.
+// Some common ops are inferred by precompiled rules instead of the infer func.
+class ShapeInferenceCache {
+ public:
+  enum class ShapeRule {
+    kNone,
+    kSameAsInput,   // elementwise unary, cast, identity
+    kBroadcast,     // elementwise binary
+    kReshapeConst,  // reshape with const shape
+  };
+
+  ~ShapeInferenceCache() = default;
+
+  // return nullptr if shape inference of the node may depend on something other than input shapes and const inputs
+  static std::shared_ptr<ShapeInferenceCache> Create(const NodeItem &node_item);
+
+  // restore output shapes and sizes if the input shapes were inferred before
+  bool Lookup(const NodeItem &node_item);
+
+  // infer output shapes by rule, return false if no rule is available or inputs are not suitable
+  bool ApplyRule(const NodeItem &node_item) const;
+
+  // save current output shapes and sizes, should be called after output sizes are calculated
+  void Save(const NodeItem &node_item);
+
+  ShapeRule GetRule() const {
+    return rule_;
+  }
+
+ private:
+  struct TensorShapes {
+    std::vector<int64_t> dims;
+    std::vector<int64_t> origin_dims;
+    int64_t size = 0;
+  };
+
+  struct CacheEntry {
+    std::vector<TensorShapes> inputs;
+    std::vector<TensorShapes> outputs;
+  };
+
+  ShapeInferenceCache() = default;
+  void CompileRule(const NodeItem &node_item);
+  bool CompileReshapeRule(const NodeItem &node_item);
+  bool MatchInputs(const NodeItem &node_item, const CacheEntry &entry) const;
+  bool InferReshape(const NodeItem &node_item) const;
+  static bool InferBroadcast(const std::vector<int64_t> &dims1, const std::vector<int64_t> &dims2,
+                             std::vector<int64_t> &dims);
+
+  ShapeRule rule_ = ShapeRule::kNone;
+  std::vector<int64_t> reshape_dims_;
+  std::mutex mu_;
+  std::vector<CacheEntry> entries_;
+  size_t next_replaced_ = 0;
+};
+}  // namespace hybrid
+}  // namespace ge
+#endif // GE_HYBRID_EXECUTOR_WORKER_SHAPE_INFERENCE_CACHE_H_
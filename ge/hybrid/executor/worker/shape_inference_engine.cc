@@ -15,6 +15,7 @@
  */
 
 #include "hybrid/executor/worker/shape_inference_engine.h"
+#include "hybrid/executor/worker/shape_inference_cache.h"
 #include "graph/shape_refiner.h"
 #include "graph/utils/node_utils.h"
 #include "graph/utils/tensor_utils.h"
@@ -65,7 +66,26 @@ Status ShapeInferenceEngine::InferShape(NodeState &node_state) {
     }
   }
 
+  // Skip infer func if input shapes were inferred before, or the output shapes can be inferred by rule
+  auto &statistic = execution_context_->shape_inference_statistic;
+  const auto &shape_inference_cache = node_item.shape_inference_cache;
+  if (shape_inference_cache != nullptr) {
+    if (shape_inference_cache->Lookup(node_item)) {
+      statistic.cache_hit_count++;
+      GELOGD("[%s] Output shapes restored from shape inference cache.", node_item.NodeName().c_str());
+      return SUCCESS;
+    }
+    if (shape_inference_cache->ApplyRule(node_item)) {
+      GE_CHK_STATUS_RET_NOLOG(CalcOutputTensorSizes(node_item));
+      shape_inference_cache->Save(node_item);
+      statistic.rule_hit_count++;
+      GELOGD("[%s] Output shapes inferred by rule.", node_item.NodeName().c_str());
+      return SUCCESS;
+    }
+  }
+
   // Do shape inference
+  statistic.full_inference_count++;
   GELOGD("[%s] Start to invoke InferShapeAndType", node_item.NodeName().c_str());
   {
     RECORD_SHAPE_INFERENCE_EVENT(execution_context_, node_item.NodeName().c_str(), "[InferShapeAndType] Start");
@@ -79,6 +99,9 @@ Status ShapeInferenceEngine::InferShape(NodeState &node_state) {
   RECORD_COMPILE_EVENT(execution_context_, node_item.NodeName().c_str(), "[CalcOpRunningParam] Start");
   GE_CHK_STATUS_RET_NOLOG(CalcOutputTensorSizes(node_item, node_item.shape_inference_type == DEPEND_SHAPE_RANGE));
   RECORD_COMPILE_EVENT(execution_context_, node_item.NodeName().c_str(), "[CalcOpRunningParam] End");
+  if (shape_inference_cache != nullptr) {
+    shape_inference_cache->Save(node_item);
+  }
 
   GELOGD("[%s] [HybridTrace] After shape inference. Node = %s",
          node_item.NodeName().c_str(),
@@ -90,20 +113,20 @@ Status ShapeInferenceEngine::InferShape(NodeState &node_state) {
 
 Status ShapeInferenceEngine::AwaitDependentNodes(NodeState &node_state) {
   auto &node_item = *node_state.GetNodeItem();
-  for (auto &src_node : node_item.dependents_for_shape_inference) {
+  for (auto src_node : node_item.shape_inference_dependencies) {
     GELOGI("[%s] Start to wait for data dependent node: %s",
            node_item.NodeName().c_str(),
-           src_node->GetName().c_str());
+           src_node->NodeName().c_str());
     RECORD_SHAPE_INFERENCE_EVENT(execution_context_,
                                  node_item.NodeName().c_str(),
                                  "[AwaitNodeDone] [%s] Start",
-                                 src_node->GetName().c_str());
-    HYBRID_CHK_STATUS_RET(subgraph_context_->Await(src_node), "[%s] Await node failed.", src_node->GetName().c_str());
+                                 src_node->NodeName().c_str());
+    HYBRID_CHK_STATUS_RET(subgraph_context_->Await(*src_node), "[%s] Await node failed.", src_node->NodeName().c_str());
     RECORD_SHAPE_INFERENCE_EVENT(execution_context_,
                                  node_item.NodeName().c_str(),
                                  "[AwaitNodeDone] [%s] End",
-                                 src_node->GetName().c_str());
-    GELOGI("[%s] Done waiting node.", src_node->GetName().c_str());
+                                 src_node->NodeName().c_str());
+    GELOGI("[%s] Done waiting node.", src_node->NodeName().c_str());
   }
 
   return SUCCESS;
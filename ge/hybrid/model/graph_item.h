@@ -22,6 +22,8 @@
 
 namespace ge {
 namespace hybrid {
+class MultiStreamPlan;
+
 class GraphItem {
  public:
   GraphItem() = default;
@@ -58,6 +60,10 @@ class GraphItem {
   int GetParentOutputIndex(size_t index) const;
   const vector<int> &GetInputIndexMapping() const;
 
+  const MultiStreamPlan *GetStreamPlan() const {
+    return stream_plan_.get();
+  }
+
  private:
   friend class HybridModelBuilder;
   std::string name_;
@@ -73,6 +79,7 @@ class GraphItem {
   bool is_dynamic_ = true;
   std::vector<int> input_index_mapping_;
   std::vector<int> output_index_mapping_;
+  std::shared_ptr<MultiStreamPlan> stream_plan_;
 };
 }  // namespace hybrid
 }  // namespace ge
@@ -29,6 +29,8 @@
 #include "graph/manager/host_mem_allocator.h"
 #include "graph/utils/graph_utils.h"
 #include "hybrid/common/npu_memory_allocator.h"
+#include "hybrid/executor/multi_stream_plan.h"
+#include "hybrid/executor/worker/shape_inference_cache.h"
 #include "hybrid/node_executor/node_executor.h"
 
 namespace ge {
@@ -204,6 +206,7 @@ Status HybridModelBuilder::BuildNodeItem(const NodePtr &node, NodeItem &node_ite
   }
 
   GE_CHK_STATUS_RET_NOLOG(ResolveRefIo(node_item));
+  node_item.shape_inference_cache = ShapeInferenceCache::Create(node_item);
   return SUCCESS;
 }
 
@@ -254,9 +257,10 @@ Status HybridModelBuilder::GetOrCreateNodeItem(const NodePtr &node, NodeItem **n
   new_node->op_desc->SetId(node_index);
   node_index += 1;
   NodeExecutorManager::ExecutorType executor_type = NodeExecutorManager::GetInstance().ResolveExecutorType(*node);
-  new_node->is_profiling_report = (executor_type == NodeExecutorManager::ExecutorType::AICORE) ||
-                                  (executor_type == NodeExecutorManager::ExecutorType::AICPU_TF) ||
-                                  (executor_type == NodeExecutorManager::ExecutorType::AICPU_CUSTOM);
+  new_node->is_kernel_launch = (executor_type == NodeExecutorManager::ExecutorType::AICORE) ||
+                               (executor_type == NodeExecutorManager::ExecutorType::AICPU_TF) ||
+                               (executor_type == NodeExecutorManager::ExecutorType::AICPU_CUSTOM);
+  new_node->is_profiling_report = new_node->is_kernel_launch;
   *node_item = new_node.get();
   node_items[node] = std::move(new_node);
   return SUCCESS;
@@ -795,6 +799,47 @@ Status HybridModelBuilder::LoadGraph() {
   }
 
   GELOGI("Done loading all subgraphs successfully.");
+  GE_CHK_STATUS_RET_NOLOG(IndexNodeItems(*hybrid_model_.root_graph_item_));
+  for (auto &it : hybrid_model_.subgraph_items_) {
+    GE_CHK_STATUS_RET_NOLOG(IndexNodeItems(*it.second));
+  }
+  return SUCCESS;
+}
+
+Status HybridModelBuilder::IndexNodeItems(GraphItem &graph_item) {
+  const auto &node_items = graph_item.GetAllNodes();
+  for (size_t i = 0; i < node_items.size(); ++i) {
+    node_items[i]->graph_index = static_cast<int>(i);
+  }
+  for (auto node_item : node_items) {
+    GE_CHK_STATUS_RET_NOLOG(ResolveDependentNodeItems(graph_item, *node_item, node_item->dependents_for_execution,
+                                                      node_item->execution_dependencies));
+    GE_CHK_STATUS_RET_NOLOG(ResolveDependentNodeItems(graph_item, *node_item,
+                                                      node_item->dependents_for_shape_inference,
+                                                      node_item->shape_inference_dependencies));
+  }
+  graph_item.stream_plan_ = MultiStreamPlan::Build(graph_item, MultiStreamPlan::GetStreamNumFromEnv());
+  return SUCCESS;
+}
+
+Status HybridModelBuilder::ResolveDependentNodeItems(const GraphItem &graph_item,
+                                                     const NodeItem &node_item,
+                                                     const std::vector<NodePtr> &dependents,
+                                                     std::vector<const NodeItem *> &dependent_items) {
+  const auto &node_items = graph_item.GetAllNodes();
+  dependent_items.clear();
+  for (const auto &dependent : dependents) {
+    auto dependent_item = GetNodeItem(dependent);
+    // node done states are kept per subgraph, a dependent node must be in the same graph
+    if (dependent_item == nullptr || dependent_item->graph_index < 0 ||
+        static_cast<size_t>(dependent_item->graph_index) >= node_items.size() ||
+        node_items[dependent_item->graph_index] != dependent_item) {
+      GELOGE(INTERNAL_ERROR, "[%s] Dependent node [%s] is not in graph [%s]", node_item.NodeName().c_str(),
+             dependent->GetName().c_str(), graph_item.GetName().c_str());
+      return INTERNAL_ERROR;
+    }
+    dependent_items.emplace_back(dependent_item);
+  }
   return SUCCESS;
 }
 
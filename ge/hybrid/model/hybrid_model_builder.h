@@ -56,6 +56,11 @@ class HybridModelBuilder {
   Status BuildOutputMapping(GraphItem &partitioned_call, const NodeItem &node_item, bool is_root_graph);
   Status ValidateParams();
   Status LoadGraph();
+  Status IndexNodeItems(GraphItem &graph_item);
+  Status ResolveDependentNodeItems(const GraphItem &graph_item,
+                                   const NodeItem &node_item,
+                                   const std::vector<NodePtr> &dependents,
+                                   std::vector<const NodeItem *> &dependent_items);
   Status LoadGeModel(ComputeGraph &graph, const GeModelPtr &ge_model);
   Status LoadTasks();
   Status IdentifyVariableOutputs(NodeItem &node_item);
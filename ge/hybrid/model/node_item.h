@@ -28,6 +28,7 @@ namespace ge {
 namespace hybrid {
 class NodeTask;
 class NodeExecutor;
+class ShapeInferenceCache;
 
 struct FusedSubgraph {
   std::map<int, std::vector<GeTensorDescPtr>> input_mapping;
@@ -74,6 +75,7 @@ struct NodeItem {
   NodePtr node;
   OpDesc *op_desc;
   int node_id = -1;
+  int graph_index = -1;  // index in GetAllNodes() of the owning GraphItem
   int group = -1;
   int num_inputs = 0;
   int num_outputs = 0;
@@ -88,6 +90,9 @@ struct NodeItem {
   std::string node_type;
   std::vector<ge::NodePtr> dependents_for_shape_inference;
   std::vector<ge::NodePtr> dependents_for_execution;
+  // resolved from dependents_for_*, so that no NodePtr is looked up on execution
+  std::vector<const NodeItem *> shape_inference_dependencies;
+  std::vector<const NodeItem *> execution_dependencies;
   std::set<int> to_const_output_id_list;
 
   // src_output_id, dst_anchor_id, dst_node
@@ -95,12 +100,14 @@ struct NodeItem {
 
   std::shared_ptr<NodeTask> kernel_task;
   std::unique_ptr<FusedSubgraph> fused_subgraph;
+  std::shared_ptr<ShapeInferenceCache> shape_inference_cache;
   const NodeExecutor *node_executor = nullptr;
   std::map<int, ge::NodePtr> ref_outputs;
   std::map<int, int> reuse_inputs;
   std::map<int, int> reuse_outputs;
   int num_static_input_shapes = 0;
   bool is_profiling_report = false;
+  bool is_kernel_launch = false;  // AiCore or AiCpu kernel, done callback only releases inputs unless awaited
 
  private:
   explicit NodeItem(NodePtr node);
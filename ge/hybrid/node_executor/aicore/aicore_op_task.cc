@@ -31,6 +31,8 @@ namespace {
 constexpr char const *kAttrSupportDynamicShape = "support_dynamicshape";
 constexpr char const *kAttrOpParamSize = "op_para_size";
 constexpr char const *kAttrAtomicOpParamSize = "atomic_op_para_size";
+constexpr char const *kAttrTilingDependShapeOnly = "tiling_depend_shape_only";
+constexpr size_t kMaxTilingCacheEntries = 4;
 }  // namespace
 
 Status AiCoreOpTask::Init(const OpDesc &op_desc, const domi::TaskDef &task_def) {
@@ -67,38 +69,27 @@ Status AiCoreOpTask::RegisterTbeHandle(const OpDesc &op_desc) {
   TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
   rtError_t rt_ret = rtQueryFunctionRegistered(stub_name_.c_str());
   if (rt_ret != RT_ERROR_NONE || is_single_op_) {
-    void *bin_handle = nullptr;
-    if (!kernel_store.FindTBEHandle(stub_name_.c_str(), bin_handle)) {
-      GELOGI("TBE: can't find the kernel_name[%s] in HandleMap", stub_name_.c_str());
-      rtDevBinary_t binary;
-      std::string json_string;
-      GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc_ptr, TVM_ATTR_NAME_MAGIC, json_string),
-                      GELOGI("Get original type of session_graph_id."));
-      if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AICPU") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF_AICPU;
-      } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF;
-      } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AIVEC") {
-        binary.magic = RT_DEV_BINARY_MAGIC_ELF_AIVEC;
-      } else {
-        GELOGE(PARAM_INVALID, "TBE: Invalid parameter magic number! json: %s", json_string.c_str());
-        return PARAM_INVALID;
-      }
-      binary.version = 0;
-      binary.data = tbe_kernel->GetBinData();
-      binary.length = tbe_kernel->GetBinDataSize();
-      GELOGI("TBE: binary.length: %lu", binary.length);
-      GE_CHK_RT_RET(rtDevBinaryRegister(&binary, &bin_handle));
-      std::string meta_data;
-      GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc_ptr, TVM_ATTR_NAME_METADATA, meta_data),
-                      GELOGI("Get original type of json_string"));
-      GELOGI("TBE: meta data: %s", meta_data.empty() ? "null" : meta_data.c_str());
-      GE_IF_BOOL_EXEC(!meta_data.empty(), GE_CHK_RT_RET(rtMetadataRegister(bin_handle, meta_data.c_str())));
-      kernel_store.StoreTBEHandle(stub_name_.c_str(), bin_handle, tbe_kernel);
+    uint32_t magic = 0;
+    std::string json_string;
+    GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc_ptr, TVM_ATTR_NAME_MAGIC, json_string),
+                    GELOGI("Get original type of session_graph_id."));
+    if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AICPU") {
+      magic = RT_DEV_BINARY_MAGIC_ELF_AICPU;
+    } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF") {
+      magic = RT_DEV_BINARY_MAGIC_ELF;
+    } else if (json_string == "RT_DEV_BINARY_MAGIC_ELF_AIVEC") {
+      magic = RT_DEV_BINARY_MAGIC_ELF_AIVEC;
     } else {
-      GELOGI("TBE: find the kernel_name[%s] in HandleMap", stub_name_.c_str());
-      kernel_store.ReferTBEHandle(stub_name_.c_str());
+      GELOGE(PARAM_INVALID, "TBE: Invalid parameter magic number! json: %s", json_string.c_str());
+      return PARAM_INVALID;
     }
+    std::string meta_data;
+    GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc_ptr, TVM_ATTR_NAME_METADATA, meta_data),
+                    GELOGI("Get original type of json_string"));
+    GELOGI("TBE: meta data: %s", meta_data.empty() ? "null" : meta_data.c_str());
+    void *bin_handle = nullptr;
+    GE_CHK_STATUS_RET(kernel_store.RegisterTBEHandle(stub_name_, magic, meta_data, tbe_kernel, bin_handle),
+                      "TBE: register kernel_name[%s] failed.", stub_name_.c_str());
     std::string kernel_name;
     GE_IF_BOOL_EXEC(AttrUtils::GetStr(op_desc_ptr, op_desc_ptr->GetName() + "_kernelname", kernel_name),
                     GELOGI("Get original type of kernel_name"));
@@ -187,12 +178,87 @@ Status AiCoreOpTask::PrepareWithShape(TaskContext &context) {
   return SUCCESS;
 }
 
+std::string AiCoreOpTask::GenerateTilingKey(const OpDesc &op_desc) {
+  std::string shape_key;
+  for (const auto &tensor_desc : op_desc.GetAllInputsDescPtr()) {
+    shape_key.append(tensor_desc->GetShape().ToString()).push_back(';');
+  }
+  shape_key.push_back('|');
+  for (const auto &tensor_desc : op_desc.GetAllOutputsDescPtr()) {
+    shape_key.append(tensor_desc->GetShape().ToString()).push_back(';');
+  }
+  return shape_key;
+}
+
+bool AiCoreOpTask::LookupTilingCache(const std::string &shape_key, OpDesc &op_desc) {
+  for (const auto &entry : tiling_cache_) {
+    if (entry.shape_key != shape_key) {
+      continue;
+    }
+    block_dim_ = entry.block_dim;
+    op_desc.SetWorkspaceBytes(entry.workspaces);
+    clear_atomic_ = entry.clear_atomic;
+    if (entry.tiling_data != tiling_data_) {
+      tiling_data_ = entry.tiling_data;
+      tiling_data_copied_ = false;
+    }
+    return true;
+  }
+  return false;
+}
+
+void AiCoreOpTask::SaveTilingCache(const std::string &shape_key, const std::vector<int64_t> &workspaces) {
+  TilingCacheEntry entry;
+  entry.shape_key = shape_key;
+  entry.block_dim = block_dim_;
+  entry.workspaces = workspaces;
+  entry.clear_atomic = clear_atomic_;
+  entry.tiling_data = tiling_data_;
+  if (tiling_cache_.size() < kMaxTilingCacheEntries) {
+    tiling_cache_.emplace_back(std::move(entry));
+    return;
+  }
+  tiling_cache_[next_replaced_tiling_] = std::move(entry);
+  next_replaced_tiling_ = (next_replaced_tiling_ + 1) % kMaxTilingCacheEntries;
+}
+
+Status AiCoreOpTask::CopyTilingData(TaskContext &context) {
+  // tiling buffer is owned by this task, the data on device is still valid if tiling data not changed
+  if (tiling_data_copied_) {
+    GELOGD("[%s] Tiling data not changed, skip copying.", stub_name_.c_str());
+    return SUCCESS;
+  }
+  if (tiling_data_.size() > tiling_buffer_->GetSize()) {
+    GELOGE(INTERNAL_ERROR, "[%s] Tiling data size now (%zu) shouldn't larger than we alloc before (%zu).",
+           stub_name_.c_str(), tiling_data_.size(), tiling_buffer_->GetSize());
+    return INTERNAL_ERROR;
+  }
+
+  auto execution_context = context.GetExecutionContext();
+  RECORD_EXECUTION_EVENT(execution_context, context.GetNodeName(), "[CopyTilingInfo] Start");
+  GE_CHK_RT_RET(rtMemcpy(tiling_buffer_->GetData(), tiling_buffer_->GetSize(),
+                         tiling_data_.c_str(), tiling_data_.size(),
+                         RT_MEMCPY_HOST_TO_DEVICE));
+  RECORD_EXECUTION_EVENT(execution_context, context.GetNodeName(), "[CopyTilingInfo] End");
+  tiling_data_copied_ = true;
+  return SUCCESS;
+}
+
 Status AiCoreOpTask::UpdateTilingInfo(TaskContext &context) {
   auto node = context.GetNodeItem().node;
   GE_CHECK_NOTNULL(node);
   auto op_desc = node->GetOpDesc();
   GE_CHECK_NOTNULL(op_desc);
 
+  std::string shape_key;
+  if (tiling_cacheable_) {
+    shape_key = GenerateTilingKey(*op_desc);
+    if (LookupTilingCache(shape_key, *op_desc)) {
+      GELOGD("[%s] Tiling info restored from cache for task: [%s]", node->GetName().c_str(), stub_name_.c_str());
+      return CopyTilingData(context);
+    }
+  }
+
   GELOGD("[%s] Start to update tiling info for task: [%s]", node->GetName().c_str(), stub_name_.c_str());
   OpRunInfo tiling_info;
   tiling_info.block_dim = -1; // codex: Using uninitialized value
@@ -212,23 +278,17 @@ Status AiCoreOpTask::UpdateTilingInfo(TaskContext &context) {
   clear_atomic_ = tiling_info.clear_atomic;
 
   tiling_data_ = tiling_info.tiling_data.str();
+  tiling_data_copied_ = false;
   if (tiling_data_.empty()) {
     GELOGE(INTERNAL_ERROR, "[%s] Tiling data is empty.", stub_name_.c_str());
     return INTERNAL_ERROR;
   }
 
-  if (tiling_data_.size() > tiling_buffer_->GetSize()) {
-    GELOGE(INTERNAL_ERROR, "[%s] Tiling data size now (%zu) shouldn't larger than we alloc before (%zu).",
-           stub_name_.c_str(), tiling_data_.size(), tiling_buffer_->GetSize());
-    return INTERNAL_ERROR;
+  GE_CHK_STATUS_RET_NOLOG(CopyTilingData(context));
+  if (!shape_key.empty()) {
+    SaveTilingCache(shape_key, tiling_info.workspaces);
   }
 
-  RECORD_EXECUTION_EVENT(execution_context, context.GetNodeName(), "[CopyTilingInfo] Start");
-  GE_CHK_RT_RET(rtMemcpy(tiling_buffer_->GetData(), tiling_buffer_->GetSize(),
-                         tiling_data_.c_str(), tiling_data_.size(),
-                         RT_MEMCPY_HOST_TO_DEVICE));
-  RECORD_EXECUTION_EVENT(execution_context, context.GetNodeName(), "[CopyTilingInfo] End");
-
   GELOGD("[%s] Done updating tiling info for task: [%s]", node->GetName().c_str(), stub_name_.c_str());
   return SUCCESS;
 }
@@ -303,6 +363,8 @@ Status AiCoreOpTask::LaunchKernel(rtStream_t stream) {
 }
 
 Status AiCoreOpTask::InitTilingInfo(const OpDesc &op_desc) {
+  // tiling results are cached by tensor shapes only for ops declaring that tiling reads no tensor values
+  (void) AttrUtils::GetBool(op_desc, kAttrTilingDependShapeOnly, tiling_cacheable_);
   bool dynamic_supported = false;
   (void) AttrUtils::GetBool(op_desc, kAttrSupportDynamicShape, dynamic_supported);
   if (!dynamic_supported) {
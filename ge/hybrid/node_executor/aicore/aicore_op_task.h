@@ -63,7 +63,20 @@ class AiCoreOpTask {
   uint32_t max_arg_count_ = 0;
 
  private:
+  // tiling result of one group of tensor shapes
+  struct TilingCacheEntry {
+    std::string shape_key;
+    uint32_t block_dim = 1;
+    std::vector<int64_t> workspaces;
+    bool clear_atomic = true;
+    std::string tiling_data;
+  };
+
   static Status ValidateTaskDef(const domi::TaskDef &task_def);
+  static std::string GenerateTilingKey(const OpDesc &op_desc);
+  bool LookupTilingCache(const std::string &shape_key, OpDesc &op_desc);
+  void SaveTilingCache(const std::string &shape_key, const std::vector<int64_t> &workspaces);
+  Status CopyTilingData(TaskContext &context);
   Status InitWithTaskDef(const OpDesc &node, const domi::TaskDef &task_def);
   Status InitTilingInfo(const OpDesc &op_desc);
   Status RegisterTbeHandle(const OpDesc &op_desc);
@@ -76,6 +89,10 @@ class AiCoreOpTask {
   bool clear_atomic_ = true;
   bool is_single_op_ = false;
   std::vector<int> output_indices_to_skip_;
+  bool tiling_cacheable_ = false;
+  std::vector<TilingCacheEntry> tiling_cache_;
+  size_t next_replaced_tiling_ = 0;
+  bool tiling_data_copied_ = false;
 };
 
 class AtomicAddrCleanOpTask : public AiCoreOpTask {
@@ -605,14 +605,17 @@ Status AicpuTfNodeTask::UpdateIoAddr(TaskContext &context) {
     }
   }
 
-  // if has input and output, need copy to ioaddr
-  if (!io_addrs.empty()) {
+  // if has input and output, need copy to ioaddr.
+  // the kernel only reads ioaddr, so the copy is skipped if addresses are the same as the last copied ones
+  if (!io_addrs.empty() && (io_addrs != copied_io_addrs_)) {
     // copy input and output to device
+    copied_io_addrs_.clear();
     GE_CHK_RT_RET(rtMemcpy(input_output_addr_->GetData(),
                            input_output_addr_->GetSize(),
                            &io_addrs[0],
                            sizeof(uint64_t) * io_addrs.size(),
                            RT_MEMCPY_HOST_TO_DEVICE));
+    copied_io_addrs_ = std::move(io_addrs);
   }
   return SUCCESS;
 }
@@ -131,6 +131,8 @@ class AicpuTfNodeTask : public AicpuNodeTaskBase {
 
   // input and output addr, device mem
   std::unique_ptr<TensorBuffer> input_output_addr_;
+  // input and output addr last copied to input_output_addr_
+  std::vector<uint64_t> copied_io_addrs_;
 
   // just used for depend DEPEND_COMPUTE op
   std::unique_ptr<TensorBuffer> copy_task_args_buf_;
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "control_op_executor.h"
+#include "framework/common/scope_guard.h"
 #include "graph/utils/node_utils.h"
 #include "graph/utils/type_utils.h"
 #include "hybrid/executor/hybrid_execution_context.h"
@@ -33,6 +34,22 @@ Status CopyScalarValueToHost(const TensorValue &tensor, T &value) {
                          RT_MEMCPY_DEVICE_TO_HOST));
   return SUCCESS;
 }
+
+template<typename T>
+bool HostScalarToBool(const void *data) {
+  T val{};
+  (void)memcpy_s(&val, sizeof(val), data, sizeof(val));
+  return val != 0;
+}
+
+std::shared_ptr<SubgraphExecutor> AcquireSubgraphExecutor(const GraphItem *subgraph,
+                                                          GraphExecutionContext *execution_context,
+                                                          bool force_infer_shape = false) {
+  if (execution_context->subgraph_executor_pool != nullptr) {
+    return execution_context->subgraph_executor_pool->Acquire(subgraph, execution_context, force_infer_shape);
+  }
+  return MakeShared<SubgraphExecutor>(subgraph, execution_context, force_infer_shape);
+}
 }
 
 Status ControlOpNodeTask::ExecuteSubgraph(const GraphItem *subgraph,
@@ -40,7 +57,7 @@ Status ControlOpNodeTask::ExecuteSubgraph(const GraphItem *subgraph,
                                           const std::function<void()> &done_callback) {
   GELOGD("[%s] Start to execute subgraph.", subgraph->GetName().c_str());
   auto execution_context = const_cast<GraphExecutionContext *>(task_context.GetExecutionContext());
-  auto executor = MakeShared<SubgraphExecutor>(subgraph, execution_context);
+  auto executor = AcquireSubgraphExecutor(subgraph, execution_context);
   GE_CHECK_NOTNULL(executor);
   GE_CHK_STATUS_RET(executor->ExecuteAsync(task_context),
                     "[%s] Failed to execute partitioned call.",
@@ -88,6 +105,30 @@ Status ControlOpNodeTask::ToBool(const TensorValue &tensor, DataType data_type,
   return SUCCESS;
 }
 
+Status ControlOpNodeTask::ToBool(const void *host_data, DataType data_type, bool &value) {
+  switch (data_type) {
+#define CASE(DT, T)                              \
+  case (DT): {                                   \
+    value = HostScalarToBool<T>(host_data);      \
+    break;                                       \
+  }
+    CASE(DT_FLOAT, float)
+    CASE(DT_DOUBLE, double)
+    CASE(DT_INT32, int32_t)
+    CASE(DT_UINT8, uint8_t)
+    CASE(DT_INT16, int16_t)
+    CASE(DT_INT8, int8_t)
+    CASE(DT_INT64, int64_t)
+    CASE(DT_BOOL, uint8_t)
+#undef CASE
+    default:
+      GELOGE(UNSUPPORTED, "Data type %s is not support by cond.", TypeUtils::DataTypeToSerialString(data_type).c_str());
+      return UNSUPPORTED;
+  }
+
+  return SUCCESS;
+}
+
 Status ControlOpNodeTask::UpdateArgs(TaskContext &context) {
   // do nothing
   return SUCCESS;
@@ -236,8 +277,14 @@ Status WhileOpNodeTask::DoExecuteAsync(TaskContext &task_context, const std::fun
     return INTERNAL_ERROR;
   }
 
+  // cond value of every iteration is copied here in stream before the sync, instead of a blocking copy after it
+  void *cond_host_buffer = nullptr;
+  GE_CHK_RT_RET(rtMallocHost(&cond_host_buffer, kCondHostBufferSize));
+  GE_MAKE_GUARD(cond_host_buffer, [cond_host_buffer]() { GE_CHK_RT(rtFreeHost(cond_host_buffer)); });
+
   bool is_continue = false;
-  GE_CHK_STATUS_RET(ExecuteOneLoop(task_context, is_continue),
+  std::shared_ptr<SubgraphExecutor> body_executor;
+  GE_CHK_STATUS_RET(ExecuteOneLoop(task_context, cond_host_buffer, is_continue, body_executor),
                     "[%s] Failed to execute iteration 0.",
                     task_context.GetNodeName());
   if (!is_continue) {
@@ -269,7 +316,7 @@ Status WhileOpNodeTask::DoExecuteAsync(TaskContext &task_context, const std::fun
   int iteration = 1;
   while (true) {
     GELOGD("[%s] Start to execute, iteration = %d", task_context.GetNodeName(), iteration);
-    GE_CHK_STATUS_RET(ExecuteOneLoop(task_context, is_continue),
+    GE_CHK_STATUS_RET(ExecuteOneLoop(task_context, cond_host_buffer, is_continue, body_executor),
                       "[%s] Failed to execute iteration %d.",
                       task_context.GetNodeName(),
                       iteration);
@@ -298,7 +345,31 @@ Status WhileOpNodeTask::DoExecuteAsync(TaskContext &task_context, const std::fun
   return SUCCESS;
 }
 
-Status WhileOpNodeTask::ExecuteCond(TaskContext &task_context, bool &is_continue) const {
+Status WhileOpNodeTask::CopyCondValueAsync(SubgraphExecutor &executor, rtStream_t stream, void *cond_host_buffer,
+                                           bool &is_copied) const {
+  is_copied = false;
+  std::vector<TensorValue> cond_outputs;
+  std::vector<ConstGeTensorDescPtr> cond_output_desc_list;
+  GE_CHK_STATUS_RET_NOLOG(executor.GetOutputs(cond_outputs, cond_output_desc_list));
+  if ((cond_outputs.size() != kCondOutputSize) || (cond_outputs[0].GetData() == nullptr) ||
+      !cond_output_desc_list[0]->GetShape().IsScalar()) {
+    // not known before the stream is synchronized, e.g. output of DEPEND_COMPUTE node
+    return SUCCESS;
+  }
+
+  auto data_type = cond_output_desc_list[0]->GetDataType();
+  int64_t value_size = GetSizeByDataType(data_type);
+  if ((value_size <= 0) || (static_cast<size_t>(value_size) > kCondHostBufferSize) ||
+      (cond_outputs[0].GetSize() < static_cast<size_t>(value_size))) {
+    return SUCCESS;
+  }
+  GE_CHK_RT_RET(rtMemcpyAsync(cond_host_buffer, kCondHostBufferSize, cond_outputs[0].GetData(),
+                              static_cast<uint64_t>(value_size), RT_MEMCPY_DEVICE_TO_HOST, stream));
+  is_copied = true;
+  return SUCCESS;
+}
+
+Status WhileOpNodeTask::ExecuteCond(TaskContext &task_context, void *cond_host_buffer, bool &is_continue) const {
   std::vector<TensorValue> inputs;
   std::vector<ConstGeTensorDescPtr> input_desc;
   std::vector<ConstGeTensorDescPtr> output_desc;
@@ -310,16 +381,20 @@ Status WhileOpNodeTask::ExecuteCond(TaskContext &task_context, bool &is_continue
   }
 
   auto execution_context = const_cast<GraphExecutionContext *>(task_context.GetExecutionContext());
-  auto executor = MakeShared<SubgraphExecutor>(cond_, execution_context, task_context.IsForceInferShape());
+  auto executor = AcquireSubgraphExecutor(cond_, execution_context, task_context.IsForceInferShape());
   GE_CHECK_NOTNULL(executor);
+  // on any failure the stream may still run cond, the executor is destroyed instead of going back to the pool
+  GE_MAKE_GUARD(cond_executor, [&executor]() { executor->Discard(); });
   GELOGD("[%s] Start to execute cond-subgraph.", task_context.GetNodeName());
   GE_CHK_STATUS_RET(executor->ExecuteAsync(inputs, input_desc), "Failed to execute partitioned call.");
   GELOGD("[%s] Done executing cond-subgraph successfully.", cond_->GetName().c_str());
-  GE_CHK_STATUS_RET_NOLOG(task_context.RegisterCallback([executor]() mutable {
-    executor.reset();
-  }));
 
-  // get cond output
+  // scalar cond value is copied within the same stream sync, so an iteration costs one host round trip
+  bool is_copied = false;
+  GE_CHK_STATUS_RET(CopyCondValueAsync(*executor, execution_context->stream, cond_host_buffer, is_copied),
+                    "[%s] Failed to copy cond value.", cond_->GetName().c_str());
+
+  // get cond output, executor of cond is released once returned as the stream is synchronized
   GE_CHK_STATUS_RET(executor->Synchronize(), "[%s] Failed to sync cond-subgraph result.", cond_->GetName().c_str());
   std::vector<TensorValue> cond_outputs;
   std::vector<ConstGeTensorDescPtr> cond_output_desc_list;
@@ -338,9 +413,15 @@ Status WhileOpNodeTask::ExecuteCond(TaskContext &task_context, bool &is_continue
   const auto &shape = cond_tensor_desc->GetShape();
   if (shape.IsScalar()) {
     auto data_type = cond_tensor_desc->GetDataType();
-    GE_CHK_STATUS_RET(ToBool(cond_outputs[0], data_type, is_continue),
-                      "[%s] Failed to get cond value.",
-                      task_context.GetNodeName());
+    if (is_copied) {
+      GE_CHK_STATUS_RET(ToBool(cond_host_buffer, data_type, is_continue),
+                        "[%s] Failed to get cond value.",
+                        task_context.GetNodeName());
+    } else {
+      GE_CHK_STATUS_RET(ToBool(cond_outputs[0], data_type, is_continue),
+                        "[%s] Failed to get cond value.",
+                        task_context.GetNodeName());
+    }
   } else {
     // true if num elements is non-zero
     is_continue = shape.GetShapeSize() > 0;
@@ -350,6 +431,7 @@ Status WhileOpNodeTask::ExecuteCond(TaskContext &task_context, bool &is_continue
            is_continue);
   }
 
+  GE_DISMISS_GUARD(cond_executor);
   return SUCCESS;
 }
 
@@ -378,17 +460,30 @@ Status WhileOpNodeTask::MoveOutputs2Inputs(TaskContext &task_context) {
   return SUCCESS;
 }
 
-Status WhileOpNodeTask::ExecuteOneLoop(TaskContext &task_context, bool &is_continue) const {
-  GE_CHK_STATUS_RET(ExecuteCond(task_context, is_continue),
+Status WhileOpNodeTask::ExecuteOneLoop(TaskContext &task_context, void *cond_host_buffer, bool &is_continue,
+                                       std::shared_ptr<SubgraphExecutor> &body_executor) const {
+  // on failure body may still run on the stream, its executor is destroyed instead of going back to the pool
+  GE_MAKE_GUARD(body_executor, [&body_executor]() {
+    if (body_executor != nullptr) {
+      body_executor->Discard();
+    }
+  });
+  GE_CHK_STATUS_RET(ExecuteCond(task_context, cond_host_buffer, is_continue),
                     "[%s] Failed to execute cond-subgraph",
                     task_context.GetNodeName());
+  // stream was synchronized by cond, body of last iteration is done and its executor can be reused
+  body_executor.reset();
   if (!is_continue) {
+    GE_DISMISS_GUARD(body_executor);
     return SUCCESS;
   }
 
   GELOGD("[%s] Start to execute body-subgraph.", task_context.GetNodeName());
-  GE_CHK_STATUS_RET(ExecuteSubgraph(body_, task_context, nullptr),
-                    "[%s] Failed to execute cond-subgraph", task_context.GetNodeName());
+  auto execution_context = const_cast<GraphExecutionContext *>(task_context.GetExecutionContext());
+  body_executor = AcquireSubgraphExecutor(body_, execution_context);
+  GE_CHECK_NOTNULL(body_executor);
+  GE_CHK_STATUS_RET(body_executor->ExecuteAsync(task_context),
+                    "[%s] Failed to execute body-subgraph", task_context.GetNodeName());
   GELOGD("[%s] Done executing body-subgraph successfully.", task_context.GetNodeName());
 
   // set outputs to inputs for next iteration
@@ -396,6 +491,7 @@ Status WhileOpNodeTask::ExecuteOneLoop(TaskContext &task_context, bool &is_conti
                     "[%s] Failed to move outputs to inputs",
                     task_context.GetNodeName());
 
+  GE_DISMISS_GUARD(body_executor);
   return SUCCESS;
 }
 
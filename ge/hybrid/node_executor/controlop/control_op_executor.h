@@ -23,6 +23,8 @@
 
 namespace ge {
 namespace hybrid {
+class SubgraphExecutor;
+
 class ControlOpNodeTask : public NodeTask {
  public:
   using NodeTask::Init;
@@ -34,6 +36,7 @@ class ControlOpNodeTask : public NodeTask {
  protected:
   virtual Status DoExecuteAsync(TaskContext &task_context, const std::function<void()> &done_callback) const = 0;
   static Status ToBool(const TensorValue &tensor_value, DataType data_type, bool &value);
+  static Status ToBool(const void *host_data, DataType data_type, bool &value);
   static Status ExecuteSubgraph(const GraphItem *subgraph,
                                 TaskContext &task_context,
                                 const std::function<void()> &done_callback);
@@ -77,16 +80,20 @@ class WhileOpNodeTask : public ControlOpNodeTask {
 
  protected:
   Status DoExecuteAsync(TaskContext &task_context, const std::function<void()> &done_callback) const override;
-  Status ExecuteCond(TaskContext &task_context, bool &is_continue) const;
+  Status ExecuteCond(TaskContext &task_context, void *cond_host_buffer, bool &is_continue) const;
+  Status CopyCondValueAsync(SubgraphExecutor &executor, rtStream_t stream, void *cond_host_buffer,
+                            bool &is_copied) const;
 
   static Status MoveOutputs2Inputs(TaskContext &task_context);
 
-  Status ExecuteOneLoop(TaskContext &task_context, bool &is_continue) const;
+  Status ExecuteOneLoop(TaskContext &task_context, void *cond_host_buffer, bool &is_continue,
+                        std::shared_ptr<SubgraphExecutor> &body_executor) const;
 
  private:
   static constexpr int kCondBranchIndex = 0;
   static constexpr int kBodyBranchIndex = 1;
   static constexpr size_t kCondOutputSize = 1;
+  static constexpr size_t kCondHostBufferSize = sizeof(int64_t);
 
   const GraphItem *cond_ = nullptr;
   const GraphItem *body_ = nullptr;
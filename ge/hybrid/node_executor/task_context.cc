@@ -36,8 +36,13 @@ TaskContext::TaskContext(GraphExecutionContext *execution_context,
 
 TaskContext::~TaskContext() {
   GELOGD("[%s] TaskContext destroyed.", node_item_->NodeName().c_str());
+  auto &memory_arena = execution_context_->memory_arena;
   for (auto ws_addr : workspaces_) {
-    execution_context_->allocator->Deallocate(ws_addr);
+    if ((memory_arena != nullptr) && memory_arena->Contains(ws_addr)) {
+      memory_arena->Release(ws_addr);
+    } else {
+      execution_context_->allocator->Deallocate(ws_addr);
+    }
   }
 
   // release output
@@ -140,8 +145,20 @@ const TensorValue *TaskContext::GetInput(int index) const {
 
 Status TaskContext::AllocateWorkspaces() {
   auto workspace_sizes = node_item_->node->GetOpDesc()->GetWorkspaceBytes();
+  auto &memory_arena = execution_context_->memory_arena;
   for (auto size : workspace_sizes) {
-    void *workspace = execution_context_->allocator->Allocate(size);
+    void *workspace = nullptr;
+    if ((memory_arena != nullptr) && (size > 0)) {
+      workspace = memory_arena->Allocate(size);
+      if ((workspace == nullptr) && IsMultiStream()) {
+        GELOGE(MEMALLOC_FAILED, "[%s] Failed to allocate workspace of size %ld from arena in multi-stream execution",
+               GetNodeName(), size);
+        return MEMALLOC_FAILED;
+      }
+    }
+    if (workspace == nullptr) {
+      workspace = execution_context_->allocator->Allocate(size);
+    }
     if (workspace == nullptr) {
       GELOGE(MEMALLOC_FAILED, "Failed to allocate workspace of size: %ld", size);
       return MEMALLOC_FAILED;
@@ -157,6 +174,10 @@ Status TaskContext::RegisterCallback(const std::function<void()> &callback_fun)
     GELOGW("[%s] Callback is NULL", GetNodeName());
     return SUCCESS;
   }
+  if (deferred_callbacks_ != nullptr) {
+    deferred_callbacks_->emplace_back(callback_fun);
+    return SUCCESS;
+  }
   auto ret = execution_context_->callback_manager->RegisterCallback(GetStream(), callback_fun);
   if (ret != SUCCESS) {
     GELOGE(ret, "[%s] Failed to register callback", GetNodeName());
@@ -181,7 +202,8 @@ string TaskContext::TensorDesc2String(const GeTensorDesc &desc) {
   return ss.str();
 }
 
-Status TaskContext::AllocateTensor(const GeTensorDesc &tensor_desc, TensorValue &tensor, AllocationAttr *attr) {
+Status TaskContext::AllocateTensor(const GeTensorDesc &tensor_desc, TensorValue &tensor, AllocationAttr *attr,
+                                   bool use_arena) {
   int64_t size = 0;
   if (ge::TensorUtils::GetSize(tensor_desc, size) != GRAPH_SUCCESS) {
     GELOGE(INTERNAL_ERROR, "Failed to get tensor size");
@@ -192,6 +214,20 @@ Status TaskContext::AllocateTensor(const GeTensorDesc &tensor_desc, TensorValue
     GELOGW("size from tensor_desc == 0");
   }
 
+  if (use_arena && (size > 0)) {
+    auto arena_buffer = TensorBuffer::Create(execution_context_->memory_arena.get(), size);
+    if (arena_buffer != nullptr) {
+      tensor = TensorValue(shared_ptr<TensorBuffer>(arena_buffer.release()));
+      return SUCCESS;
+    }
+    if (IsMultiStream()) {
+      GELOGE(MEMALLOC_FAILED, "[%s] Failed to allocate tensor of size %ld from arena in multi-stream execution",
+             GetNodeName(), size);
+      return MEMALLOC_FAILED;
+    }
+    GELOGW("[%s] Failed to allocate from arena, fall back to allocator.", GetNodeName());
+  }
+
   auto buffer = TensorBuffer::Create(execution_context_->allocator, size, attr);
   GE_CHECK_NOTNULL(buffer);
   tensor = TensorValue(shared_ptr<TensorBuffer>(buffer.release()));
@@ -247,7 +283,8 @@ Status TaskContext::AllocateOutput(int index,
         GELOGD("[%s] Output[%d] is referenced to input[%d]", GetNodeName(), index, reuse_input->second);
         outputs_start_[index] = inputs_start_[reuse_input->second];
       } else {
-        GE_CHK_STATUS_RET_NOLOG(AllocateTensor(tensor_desc, outputs_start_[index], attr));
+        GE_CHK_STATUS_RET_NOLOG(AllocateTensor(tensor_desc, outputs_start_[index], attr,
+                                               CanAllocateFromArena(index, attr)));
         GELOGD("Allocating output successfully. node: %s. index = %d, size = %zu",
                node_item_->NodeName().c_str(), index, outputs_start_[index].GetSize());
       }
@@ -265,6 +302,30 @@ Status TaskContext::AllocateOutput(int index,
   return SUCCESS;
 }
 
+bool TaskContext::CanAllocateFromArena(int output_index, AllocationAttr *attr) const {
+  if (execution_context_->memory_arena == nullptr) {
+    return false;
+  }
+  if ((attr != nullptr) && ((attr->GetMemType() != HBM) || (attr->GetTryReuseAddr() != nullptr))) {
+    return false;
+  }
+  // net outputs may be held by caller after the iteration, they never come from arena
+  for (const auto &dst_input_index_and_node : node_item_->outputs[output_index]) {
+    if (dst_input_index_and_node.second->node_type == NETOUTPUT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Memory freed to the allocator may be handed to a node of another stream while its last user is still running,
+// so nodes of a multi-stream subgraph must not fall back to the allocator for memory released in the iteration.
+// Net outputs, user provided and non-HBM memory are not released in the iteration and may still use it.
+bool TaskContext::IsMultiStream() const {
+  return !execution_context_->side_streams.empty() && (subgraph_context_ != nullptr) &&
+         (subgraph_context_->graph_item_->GetStreamPlan() != nullptr);
+}
+
 Status TaskContext::AllocateOutputs(AllocationAttr *attr) {
   for (int i = 0; i < node_item_->num_outputs; ++i) {
     const auto &output_desc = node_item_->MutableOutputDesc(i);
@@ -313,7 +374,15 @@ Status TaskContext::SetOutput(int index, const TensorValue &tensor) {
 }
 
 rtStream_t TaskContext::GetStream() const {
-  return execution_context_->stream;
+  return stream_ != nullptr ? stream_ : execution_context_->stream;
+}
+
+void TaskContext::SetStream(rtStream_t stream) {
+  stream_ = stream;
+}
+
+void TaskContext::SetDeferredCallbacks(std::vector<std::function<void()>> *deferred_callbacks) {
+  deferred_callbacks_ = deferred_callbacks;
 }
 
 int64_t TaskContext::GetSessionId() const {
@@ -463,7 +532,7 @@ void TaskContext::SetForceInferShape(bool force_infer_shape) {
 }
 
 void TaskContext::NodeDone() {
-  subgraph_context_->NodeDone(node_item_->node);
+  subgraph_context_->NodeDone(*node_item_);
 }
 
 void TaskContext::OnError(Status error) {
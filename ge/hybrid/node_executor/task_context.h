@@ -61,6 +61,12 @@ class TaskContext {
   TensorValue *MutableOutput(int index);
   TensorValue *GetVariable(const std::string &name);
   rtStream_t GetStream() const;
+
+  // launch the node to stream instead of the stream of the execution context
+  void SetStream(rtStream_t stream);
+
+  // callbacks are appended to deferred_callbacks instead of being registered if not null
+  void SetDeferredCallbacks(std::vector<std::function<void()>> *deferred_callbacks);
   int64_t GetSessionId() const;
   uint64_t GetIterationNumber() const;
 
@@ -125,7 +131,10 @@ class TaskContext {
               SubgraphContext *subgraph_context);
 
   static string TensorDesc2String(const GeTensorDesc &desc);
-  Status AllocateTensor(const GeTensorDesc &tensor_desc, TensorValue &tensor, AllocationAttr *attr);
+  Status AllocateTensor(const GeTensorDesc &tensor_desc, TensorValue &tensor, AllocationAttr *attr,
+                        bool use_arena = false);
+  bool CanAllocateFromArena(int output_index, AllocationAttr *attr) const;
+  bool IsMultiStream() const;
 
   NodeState *node_state_ = nullptr;
   const NodeItem *node_item_ = nullptr;
@@ -139,6 +148,8 @@ class TaskContext {
   uint64_t iteration_ = 0;
   uint32_t task_id_ = 0;
   uint32_t stream_id_ = 0;
+  rtStream_t stream_ = nullptr;
+  std::vector<std::function<void()>> *deferred_callbacks_ = nullptr;
   std::vector<TaskDescInfo> task_desc_info;
   std::vector<ComputeGraphDescInfo> compute_graph_info;
 };
@@ -24,6 +24,7 @@
 #include <string>
 #include <utility>
 
+#include "common/dump/dump_writer.h"
 #include "common/ge/ge_util.h"
 #include "common/ge/plugin_manager.h"
 #include "common/profiling/profiling_manager.h"
@@ -447,6 +448,13 @@ Status GELib::Finalize() {
     final_state = mid_state;
   }
 
+  GELOGI("DumpWriter flush.");
+  mid_state = DumpWriter::GetInstance().Flush();
+  if (mid_state != SUCCESS) {
+    GELOGW("Dump writer failed to write some dump files");
+    final_state = mid_state;
+  }
+
   GELOGI("opsBuilderManager finalization.");
   mid_state = OpsKernelBuilderManager::Instance().Finalize();
   if (mid_state != SUCCESS) {
@@ -19,10 +19,14 @@
 #include <gflags/gflags.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <climits>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include "common/gflags_util.h"
 #include "common/util.h"
 #include "common/util/error_manager/error_manager.h"
@@ -42,6 +46,7 @@
 #include "omg/parser/parser_inner_ctx.h"
 #include "parser/common/register_tbe.h"
 #include "register/op_registry.h"
+#include "single_op_build_scheduler.h"
 #include "single_op_parser.h"
 #include "external/ge/ge_ir_build.h"
 
@@ -73,6 +78,9 @@ static const char *const kCaffeFormatSupport = "only support NCHW, ND in Caffe m
 static const char *const kTFFormatSupport = "only support NCHW, NHWC, ND, NCDHW, NDHWC in TF model";
 static const char *const kONNXFormatSupport = "only support NCHW, ND in ONNX model";
 
+// print progress of single op generating every 10 percent
+const size_t kProgressStepNum = 10;
+
 // limit available mem size 2G
 const long kMinAvailableMem = 2097152;  // 2 * 1024 * 1024
 
@@ -152,6 +160,8 @@ DEFINE_string(optypelist_for_implmode, "",
 
 DEFINE_string(singleop, "", "Optional; If set, generate single op model with the given json file.");
 
+DEFINE_int32(singleop_parallel_num, 1, "Optional; number of workers generating single op models in parallel.");
+
 DEFINE_int32(disable_reuse_memory, 0, "Optional; If set to 1, disable reuse memory when generating if.");
 
 DEFINE_string(auto_tune_mode, "", "Optional; Set tune mode.");
@@ -252,6 +262,8 @@ class GFlagUtils {
         "                      E.g.: \"dims1_n1,dims1_n2;dims2_n1,dims2_n2\"\n"
         "  --singleop          Single op definition file. atc will generate offline "
         "model(s) for single op if --singleop is set.\n"
+        "  --singleop_parallel_num Number of workers generating single op models in parallel, "
+        "used with singleop. Default value is: 1\n"
         "\n[Output]\n"
         "  --output            Output file path&name(needn't suffix, will add .om automatically). \n"
         "                      If --singleop is set, this arg specifies the directory to "
@@ -1061,6 +1073,108 @@ static void SetEnvForSingleOp(std::map<string, string> &options) {
   options.emplace(ge::OP_BANK_PATH_FLAG, FLAGS_op_bank_path);
 }
 
+static string GetSingleOpOutputPath(const ge::SingleOpBuildParam &param) {
+  string output_path;
+  if (!FLAGS_output.empty()) {
+    output_path = FLAGS_output + "/";
+  }
+  output_path += param.file_name;
+  return output_path;
+}
+
+static domi::Status CopySingleOpModel(const string &src_path, const string &dst_path) {
+  std::ifstream src(src_path, std::ios::binary);
+  std::ofstream dst(dst_path, std::ios::binary | std::ios::trunc);
+  if (!src.is_open() || !dst.is_open()) {
+    DOMI_LOGE("Failed to copy single op model from %s to %s", src_path.c_str(), dst_path.c_str());
+    return domi::FAILED;
+  }
+  dst << src.rdbuf();
+  if (!dst.good()) {
+    DOMI_LOGE("Failed to write single op model %s", dst_path.c_str());
+    return domi::FAILED;
+  }
+  return domi::SUCCESS;
+}
+
+///
+/// Build single op models with FLAGS_singleop_parallel_num workers.
+/// Process wide state shared by the workers:
+///  - GELib and the engine, kernel and builder managers it owns are initialized before and finalized after
+///    the workers run, the workers only read them. Graph optimizers and kernel builders of the engines are
+///    already called from several threads by GraphManager when it optimizes subgraphs.
+///  - OpsProtoManager is initialized by GeGenerator::Initialize, the generators of all workers are initialized
+///    and finalized on this thread, never while other workers build.
+///  - Options parsed by GeGenerator::Initialize are kept by the graph manager of each generator, the
+///    omg context is copied per worker and each worker thread starts with a copy of the thread local context.
+///  - Graph and session ids are taken from atomics, VarManagerPool is guarded by its own lock.
+///  - The session id in the global GEContext is written by the subgraph optimizing threads of every worker.
+///    Single op graphs hold no variable, so no engine depends on which worker's session id it reads.
+///
+static domi::Status BuildSingleOpModels(const std::map<string, string> &options, ge::GeGenerator &generator,
+                                        vector<ge::SingleOpBuildParam> &build_params) {
+  // ops with identical definition are built once, the model is copied to the others
+  vector<string> signatures;
+  for (const auto &param : build_params) {
+    signatures.emplace_back(param.signature);
+  }
+  ge::SingleOpBuildScheduler scheduler(signatures);
+  size_t worker_num = std::min(static_cast<size_t>(FLAGS_singleop_parallel_num), scheduler.GetTasks().size());
+
+  // worker 0 uses the generator of the caller, the others own generators with their own graph manager
+  vector<ge::GeGenerator *> worker_generators{&generator};
+  vector<std::unique_ptr<ge::OmgContext>> omg_contexts;
+  vector<std::unique_ptr<ge::GeGenerator>> generators;
+  for (size_t i = 1; i < worker_num; ++i) {
+    std::unique_ptr<ge::OmgContext> omg_context(new (std::nothrow) ge::OmgContext(domi::GetContext()));
+    std::unique_ptr<ge::GeGenerator> worker_generator(new (std::nothrow) ge::GeGenerator());
+    if ((omg_context == nullptr) || (worker_generator == nullptr) ||
+        (worker_generator->Initialize(options, *omg_context) != SUCCESS)) {
+      GELOGW("Failed to initialize generator of worker %zu, build with %zu workers", i, worker_generators.size());
+      break;
+    }
+    worker_generators.emplace_back(worker_generator.get());
+    omg_contexts.emplace_back(std::move(omg_context));
+    generators.emplace_back(std::move(worker_generator));
+  }
+
+  const size_t task_num = scheduler.GetTasks().size();
+  const size_t progress_step = std::max<size_t>(task_num / kProgressStepNum, 1);
+  std::atomic<size_t> finished_num{0};
+  std::mutex progress_mu;
+  auto build_func = [&](size_t worker_index, size_t op_index) -> ge::Status {
+    auto &param = build_params[op_index];
+    string output_path = GetSingleOpOutputPath(param);
+    auto ret = worker_generators[worker_index]->BuildSingleOpModel(param.op_desc, param.inputs, param.outputs,
+                                                                   output_path);
+    if (ret != SUCCESS) {
+      DOMI_LOGE("Compile op failed. ge ret = %u, op index = %zu", ret, op_index);
+      return ret;
+    }
+    GELOGI("Compile op success. op index = %zu, output = %s", op_index, output_path.c_str());
+    size_t finished = finished_num.fetch_add(1) + 1;
+    if ((finished % progress_step == 0) || (finished == task_num)) {
+      std::lock_guard<std::mutex> lk(progress_mu);
+      std::cout << "Compile op progress: " << finished << "/" << task_num << std::endl;
+    }
+    return SUCCESS;
+  };
+  auto ret = scheduler.Run(worker_generators.size(), build_func);
+  for (auto &worker_generator : generators) {
+    (void)worker_generator->Finalize();
+  }
+  if (ret != SUCCESS) {
+    DOMI_LOGE("Compile op failed. ge ret = %u, first failed op index = %zu", scheduler.GetFailedRet(),
+              scheduler.GetFailedIndex());
+    return domi::FAILED;
+  }
+
+  return scheduler.CopyDuplicates([&build_params](size_t src_index, size_t dst_index) -> ge::Status {
+    return CopySingleOpModel(GetSingleOpOutputPath(build_params[src_index]),
+                             GetSingleOpOutputPath(build_params[dst_index]));
+  });
+}
+
 domi::Status GenerateSingleOp(const std::string& json_file_path) {
   if (!FLAGS_output.empty() && !ge::CheckOutputPathValid(FLAGS_output, "--output")) {
     DOMI_LOGE("output path %s is not valid!", FLAGS_output.c_str());
@@ -1070,6 +1184,13 @@ domi::Status GenerateSingleOp(const std::string& json_file_path) {
   GE_CHK_BOOL_TRUE_EXEC_WITH_LOG(
       ge::CheckImplmodeParamValid(FLAGS_optypelist_for_implmode, FLAGS_op_select_implmode) != ge::SUCCESS,
       return ge::FAILED, "check optypelist_for_implmode and op_select_implmode failed!");
+  if (FLAGS_singleop_parallel_num < 1) {
+    ErrorManager::GetInstance().ATCReportErrMessage("E10001", {"parameter", "value", "reason"},
+        {"--singleop_parallel_num", std::to_string(FLAGS_singleop_parallel_num), "it must be greater than 0"});
+    GELOGE(ge::PARAM_INVALID, "Invalid value for --singleop_parallel_num[%d], it must be greater than 0.",
+           FLAGS_singleop_parallel_num);
+    return domi::FAILED;
+  }
 
   std::map<string, string> options;
   // need to be changed when ge.ini plan is done
@@ -1097,23 +1218,7 @@ domi::Status GenerateSingleOp(const std::string& json_file_path) {
     return domi::FAILED;
   }
 
-  int index = 0;
-  for (auto &param : build_params) {
-    string output_path;
-    if (!FLAGS_output.empty()) {
-      output_path = FLAGS_output + "/";
-    }
-    output_path += param.file_name;
-    ret = generator.BuildSingleOpModel(param.op_desc, param.inputs, param.outputs, output_path);
-    if (ret != SUCCESS) {
-      DOMI_LOGE("Compile op failed. ge ret = %u, op index = %d", ret, index);
-      ret = domi::FAILED;
-      break;
-    }
-    GELOGI("Compile op success. op index = %d, output = %s", index, output_path.c_str());
-    index += 1;
-  }
-
+  ret = BuildSingleOpModels(options, generator, build_params);
   (void)generator.Finalize();
   (void)ge::GELib::GetInstance()->Finalize();
   return ret;
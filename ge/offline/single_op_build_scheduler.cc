@@ -0,0 +1,104 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "single_op_build_scheduler.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include "common/thread_pool.h"
+#include "framework/common/debug/ge_log.h"
+#include "framework/common/debug/log.h"
+#include "graph/ge_local_context.h"
+
+namespace ge {
+SingleOpBuildScheduler::SingleOpBuildScheduler(const std::vector<std::string> &signatures)
+    : origin_indexes_(signatures.size()) {
+  std::unordered_map<std::string, size_t> signature_to_index;
+  for (size_t i = 0; i < signatures.size(); ++i) {
+    auto it = signature_to_index.emplace(signatures[i], i);
+    origin_indexes_[i] = it.first->second;
+    if (it.second) {
+      tasks_.emplace_back(i);
+    }
+  }
+}
+
+Status SingleOpBuildScheduler::RunWorker(size_t worker_index, const BuildFunc &build_func) {
+  while (!failed_.load()) {
+    size_t task_index = next_task_.fetch_add(1);
+    if (task_index >= tasks_.size()) {
+      break;
+    }
+    size_t op_index = tasks_[task_index];
+    Status ret = build_func(worker_index, op_index);
+    if (ret != SUCCESS) {
+      GELOGE(ret, "Worker %zu failed to build op index %zu.", worker_index, op_index);
+      std::lock_guard<std::mutex> lk(mu_);
+      // other workers may still fail on smaller indexes taken before the stop
+      if (op_index < failed_index_) {
+        failed_index_ = op_index;
+        failed_ret_ = ret;
+      }
+      failed_.store(true);
+      return ret;
+    }
+  }
+  return SUCCESS;
+}
+
+Status SingleOpBuildScheduler::Run(size_t worker_num, const BuildFunc &build_func) {
+  worker_num = std::max<size_t>(std::min(worker_num, tasks_.size()), 1);
+  GELOGI("Build single ops, op num = %zu, unique op num = %zu, worker num = %zu",
+         origin_indexes_.size(), tasks_.size(), worker_num);
+  if (worker_num == 1) {
+    return RunWorker(0, build_func);
+  }
+
+  std::vector<std::future<Status>> futures;
+  {
+    ThreadPool thread_pool(static_cast<uint32_t>(worker_num - 1));
+    const GEThreadLocalContext &ge_context = GetThreadLocalContext();
+    for (size_t i = 1; i < worker_num; ++i) {
+      auto future = thread_pool.commit([this, i, &build_func](const GEThreadLocalContext &context) -> Status {
+        GetThreadLocalContext() = context;
+        return RunWorker(i, build_func);
+      }, ge_context);
+      if (!future.valid()) {
+        GELOGW("Failed to start single op build worker %zu, build with %zu workers.", i, futures.size() + 1);
+        break;
+      }
+      futures.emplace_back(std::move(future));
+    }
+    (void)RunWorker(0, build_func);
+    // wait for all workers before return, they refer to build_func of the caller
+    for (auto &future : futures) {
+      (void)future.get();
+    }
+  }
+  return failed_.load() ? failed_ret_ : SUCCESS;
+}
+
+Status SingleOpBuildScheduler::CopyDuplicates(const CopyFunc &copy_func) const {
+  for (size_t i = 0; i < origin_indexes_.size(); ++i) {
+    if (origin_indexes_[i] == i) {
+      continue;
+    }
+    GELOGI("Op index %zu is identical to op index %zu, reuse its model", i, origin_indexes_[i]);
+    GE_CHK_STATUS_RET_NOLOG(copy_func(origin_indexes_[i], i));
+  }
+  return SUCCESS;
+}
+}  // namespace ge
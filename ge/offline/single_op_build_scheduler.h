@@ -0,0 +1,76 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GE_OFFLINE_SINGLE_OP_BUILD_SCHEDULER_H_
+#define GE_OFFLINE_SINGLE_OP_BUILD_SCHEDULER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ge/ge_api_error_codes.h"
+
+namespace ge {
+///
+/// Schedules the ops of a single op list on a number of workers.
+/// Ops with identical signature are built once, by the first of them in the list.
+/// The caller copies the result to the others with CopyDuplicates after a successful Run.
+///
+class SingleOpBuildScheduler {
+ public:
+  using BuildFunc = std::function<Status(size_t worker_index, size_t op_index)>;
+  using CopyFunc = std::function<Status(size_t src_op_index, size_t dst_op_index)>;
+
+  explicit SingleOpBuildScheduler(const std::vector<std::string> &signatures);
+  ~SingleOpBuildScheduler() = default;
+
+  /// op indexes that are built, in list order
+  const std::vector<size_t> &GetTasks() const { return tasks_; }
+
+  /// index of the op whose result is reused by op_index, op_index itself when it is built
+  size_t GetOriginIndex(size_t op_index) const { return origin_indexes_[op_index]; }
+
+  ///
+  /// Build the tasks with worker_num workers, worker 0 runs on the calling thread.
+  /// Every worker thread starts with a copy of the thread local context of the caller.
+  /// Workers stop taking tasks after the first failure.
+  ///
+  Status Run(size_t worker_num, const BuildFunc &build_func);
+
+  /// Called in list order for every op that reuses the result of another op
+  Status CopyDuplicates(const CopyFunc &copy_func) const;
+
+  /// smallest failed op index, SIZE_MAX when no op failed
+  size_t GetFailedIndex() const { return failed_index_; }
+  Status GetFailedRet() const { return failed_ret_; }
+
+ private:
+  Status RunWorker(size_t worker_index, const BuildFunc &build_func);
+
+  std::vector<size_t> tasks_;
+  std::vector<size_t> origin_indexes_;
+  std::atomic<size_t> next_task_{0};
+  std::atomic<bool> failed_{false};
+  std::mutex mu_;
+  size_t failed_index_ = SIZE_MAX;
+  Status failed_ret_ = SUCCESS;
+};
+}  // namespace ge
+
+#endif  // GE_OFFLINE_SINGLE_OP_BUILD_SCHEDULER_H_
@@ -592,6 +592,7 @@ Status SingleOpParser::ParseSingleOpList(const std::string &file, std::vector<Si
         return ret;
       }
 
+      param.signature = single_op_json.dump();
       op_list.emplace_back(param);
       GELOGI("Parse the index[%d] of op success", index);
       index += 1;
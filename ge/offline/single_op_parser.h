@@ -62,6 +62,7 @@ struct SingleOpBuildParam {
   std::vector<ge::GeTensor> inputs;
   std::vector<ge::GeTensor> outputs;
   std::string file_name;
+  std::string signature;  // dumped op json, ops with identical signature generate identical models
 };
 
 void from_json(const nlohmann::json &json, SingleOpTensorDesc &desc);
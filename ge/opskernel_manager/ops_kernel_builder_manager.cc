@@ -82,6 +82,10 @@ Status OpsKernelBuilderManager::Finalize() {
   }
 
   ops_kernel_builders_.clear();
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    builder_mutexes_.clear();
+  }
   plugin_manager_.reset();
   return SUCCESS;
 }
@@ -136,6 +140,7 @@ Status OpsKernelBuilderManager::CalcOpRunningParam(Node &node) const {
   }
 
   GELOGD("To invoke CalcOpRunningParam, node = %s, lib name = %s", op_desc->GetName().c_str(), lib_name.c_str());
+  std::lock_guard<std::mutex> lk(GetBuilderMutex(it->second.get()));
   GE_CHK_STATUS_RET(it->second->CalcOpRunningParam(node),
                     "Failed to invoke CalcOpRunningParam, libName = %s, node = %s",
                     lib_name.c_str(),
@@ -160,6 +165,7 @@ Status OpsKernelBuilderManager::GenerateTask(const Node &node,
   }
 
   GELOGD("To invoke GenerateTask, node = %s, lib name = %s", op_desc->GetName().c_str(), lib_name.c_str());
+  std::lock_guard<std::mutex> lk(GetBuilderMutex(it->second.get()));
   GE_CHK_STATUS_RET(it->second->GenerateTask(node, context, tasks),
                     "Failed to invoke GenerateTask, libName = %s, node = %s",
                     lib_name.c_str(),
@@ -168,4 +174,10 @@ Status OpsKernelBuilderManager::GenerateTask(const Node &node,
   return SUCCESS;
 }
 
+std::mutex &OpsKernelBuilderManager::GetBuilderMutex(const OpsKernelBuilder *builder) const {
+  // map nodes are stable, the mutex outlives the lock of mu_
+  std::lock_guard<std::mutex> lk(mu_);
+  return builder_mutexes_[builder];
+}
+
 }  // namespace ge
@@ -17,6 +17,7 @@
 #ifndef GE_OPSKERNEL_MANAGER_OPS_KERNEL_BUILDER_MANAGER_H_
 #define GE_OPSKERNEL_MANAGER_OPS_KERNEL_BUILDER_MANAGER_H_
 
+#include <mutex>
 #include "common/ge/plugin_manager.h"
 #include "common/opskernel/ops_kernel_builder.h"
 #include "external/ge/ge_api_error_codes.h"
@@ -46,12 +47,18 @@ class GE_FUNC_VISIBILITY OpsKernelBuilderManager {
   Status GenerateTask(const Node &node, RunContext &context,
                       std::vector<domi::TaskDef> &tasks) const;
 
+  // builders are not required to be reentrant, calls to the same builder hold its mutex
+  std::mutex &GetBuilderMutex(const OpsKernelBuilder *builder) const;
+
  private:
   OpsKernelBuilderManager() = default;
   static Status GetLibPaths(const std::map<std::string, std::string> &options, std::string &lib_paths);
 
   std::unique_ptr<PluginManager> plugin_manager_;
   std::map<std::string, OpsKernelBuilderPtr> ops_kernel_builders_{};
+  // builders may be registered with several lib names, mutexes are indexed by instance
+  mutable std::mutex mu_;
+  mutable std::map<const OpsKernelBuilder *, std::mutex> builder_mutexes_;
 };
 }  // namespace ge
 #endif  // GE_OPSKERNEL_MANAGER_OPS_KERNEL_BUILDER_MANAGER_H_
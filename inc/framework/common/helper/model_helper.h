@@ -80,8 +80,11 @@ class GE_FUNC_VISIBILITY ModelHelper {
   Status LoadCustAICPUKernelStore(OmFileLoadHelper &om_load_helper);
   Status LoadCustAICPUKernelStore(OmFileLoadHelper &om_load_helper, GeModelPtr &cur_model, size_t mode_index);
   Status ReleaseLocalModelData() noexcept;
+  Status CheckModelPartition(ModelPartitionType type, const uint8_t *data, size_t size);
   Status SaveModelPartition(std::shared_ptr<OmFileSaveHelper> &om_file_save_helper, ModelPartitionType type,
                             const uint8_t *data, size_t size, size_t model_index);
+  Status SerializeModelDef(const GeModelPtr &ge_model, Buffer &model_buffer);
+  Status SerializeModelTaskDef(const GeModelPtr &ge_model, Buffer &task_buffer);
   Status SaveModelDef(shared_ptr<OmFileSaveHelper> &om_file_save_helper, const GeModelPtr &ge_model,
                       Buffer &model_buffer, size_t model_index = 0);
   Status SaveSizeToModelDef(const GeModelPtr &ge_model);
@@ -95,8 +98,11 @@ class GE_FUNC_VISIBILITY ModelHelper {
                           Buffer &task_buffer, size_t model_index = 0);
   Status SaveModelHeader(shared_ptr<OmFileSaveHelper> &om_file_save_helper, const GeModelPtr &ge_model,
                          size_t model_num = 1);
+  Status FillModelHeader(const GeModelPtr &ge_model, size_t model_num, ModelFileHeader &model_header);
   Status SaveAllModelPartiton(shared_ptr<OmFileSaveHelper> &om_file_save_helper, const GeModelPtr &ge_model,
                               Buffer &model_buffer, Buffer &task_buffer, size_t model_index = 0);
+  // offline save of a single model, each partition is written to file once it is produced
+  Status SaveToOmFileByStream(const GeModelPtr &ge_model, const std::string &output_file);
 };
 }  // namespace ge
 #endif  // INC_FRAMEWORK_COMMON_HELPER_MODEL_HELPER_H_
@@ -47,6 +47,8 @@ rtError_t rtEventRecord(rtEvent_t event, rtStream_t stream) { return RT_ERROR_NO
 
 rtError_t rtEventSynchronize(rtEvent_t event) { return RT_ERROR_NONE; }
 
+rtError_t rtEventQuery(rtEvent_t event) { return RT_ERROR_NONE; }
+
 rtError_t rtEventDestroy(rtEvent_t event) {
   delete[](int *) event;
   return RT_ERROR_NONE;
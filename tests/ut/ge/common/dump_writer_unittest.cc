@@ -0,0 +1,152 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define private public
+#define protected public
+#include "common/dump/dump_writer.h"
+#include "graph/manager/util/debug.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+DumpWriter::Buffer ReadFile(const std::string &file_path) {
+  std::ifstream ifs(file_path, std::ios::binary);
+  return DumpWriter::Buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+}
+
+bool FileExists(const std::string &file_path) {
+  std::ifstream ifs(file_path);
+  return ifs.good();
+}
+}  // namespace
+
+class UtestDumpWriter : public testing::Test {
+ protected:
+  void SetUp() {
+    ASSERT_EQ(DumpWriter::GetInstance().Flush(), SUCCESS);
+  }
+
+  void TearDown() {
+    auto &writer = DumpWriter::GetInstance();
+    EXPECT_EQ(writer.Flush(), SUCCESS);
+    EXPECT_EQ(writer.pending_bytes_, 0);
+    for (const auto &file_path : file_paths_) {
+      (void) remove(file_path.c_str());
+    }
+  }
+
+  std::vector<std::string> file_paths_;
+};
+
+TEST_F(UtestDumpWriter, write_buffers_in_order) {
+  auto &writer = DumpWriter::GetInstance();
+  file_paths_ = {"./dump_writer_ut.0", "./dump_writer_ut.1"};
+  std::vector<DumpWriter::Buffer> buffers;
+  buffers.emplace_back(DumpWriter::Buffer(8, 1));
+  buffers.emplace_back(DumpWriter::Buffer(16, 2));
+  uint64_t seq1 = 0;
+  EXPECT_EQ(writer.Submit(file_paths_[0], std::move(buffers), seq1), SUCCESS);
+  uint64_t seq2 = 0;
+  EXPECT_EQ(writer.Submit(file_paths_[1], std::vector<DumpWriter::Buffer>(), seq2), SUCCESS);
+  EXPECT_GT(seq1, 0);
+  EXPECT_EQ(seq2, seq1 + 1);
+  ASSERT_EQ(writer.Flush(), SUCCESS);
+
+  DumpWriter::Buffer expected(8, 1);
+  expected.insert(expected.end(), 16, 2);
+  EXPECT_EQ(ReadFile(file_paths_[0]), expected);
+  EXPECT_TRUE(FileExists(file_paths_[1]));
+  EXPECT_TRUE(ReadFile(file_paths_[1]).empty());
+}
+
+TEST_F(UtestDumpWriter, rewrite_existing_file) {
+  auto &writer = DumpWriter::GetInstance();
+  file_paths_ = {"./dump_writer_ut.2"};
+  std::vector<DumpWriter::Buffer> buffers;
+  buffers.emplace_back(DumpWriter::Buffer(32, 1));
+  uint64_t seq = 0;
+  EXPECT_EQ(writer.Submit(file_paths_[0], std::move(buffers), seq), SUCCESS);
+  ASSERT_EQ(writer.Flush(), SUCCESS);
+
+  // content of last dump is not kept
+  buffers.clear();
+  buffers.emplace_back(DumpWriter::Buffer(4, 3));
+  buffers.emplace_back(DumpWriter::Buffer(4, 4));
+  EXPECT_EQ(writer.Submit(file_paths_[0], std::move(buffers), seq), SUCCESS);
+  ASSERT_EQ(writer.Flush(), SUCCESS);
+  EXPECT_EQ(ReadFile(file_paths_[0]), DumpWriter::Buffer({3, 3, 3, 3, 4, 4, 4, 4}));
+}
+
+TEST_F(UtestDumpWriter, write_by_caller_in_sync_mode) {
+  auto &writer = DumpWriter::GetInstance();
+  file_paths_ = {"./dump_writer_ut.3"};
+  writer.sync_ = true;
+  std::vector<DumpWriter::Buffer> buffers;
+  buffers.emplace_back(DumpWriter::Buffer(8, 5));
+  uint64_t seq = 0;
+  auto ret = writer.Submit(file_paths_[0], std::move(buffers), seq);
+  writer.sync_ = false;
+  EXPECT_EQ(ret, SUCCESS);
+  EXPECT_GT(seq, 0);
+  // complete without flush
+  EXPECT_EQ(writer.pending_bytes_, 0);
+  EXPECT_EQ(ReadFile(file_paths_[0]), DumpWriter::Buffer(8, 5));
+}
+
+TEST_F(UtestDumpWriter, drop_on_full) {
+  auto &writer = DumpWriter::GetInstance();
+  file_paths_ = {"./dump_writer_ut.4"};
+  auto max_pending_bytes = writer.max_pending_bytes_;
+  writer.drop_on_full_ = true;
+  writer.max_pending_bytes_ = 1;
+  writer.pending_bytes_ = 1;  // as if a dump was being written
+
+  std::vector<DumpWriter::Buffer> buffers;
+  buffers.emplace_back(DumpWriter::Buffer(8, 1));
+  uint64_t seq = 1;
+  EXPECT_EQ(writer.Submit(file_paths_[0], std::move(buffers), seq), SUCCESS);
+  EXPECT_EQ(seq, 0);
+
+  writer.pending_bytes_ = 0;
+  writer.max_pending_bytes_ = max_pending_bytes;
+  writer.drop_on_full_ = false;
+  ASSERT_EQ(writer.Flush(), SUCCESS);
+  EXPECT_FALSE(FileExists(file_paths_[0]));
+}
+
+TEST_F(UtestDumpWriter, dump_dev_mem_by_writer) {
+  file_paths_ = {"./dump_writer_ut.5"};
+  uint8_t dev_mem[64] = {0};
+  EXPECT_EQ(Debug::DumpDevMem(file_paths_[0].c_str(), dev_mem, sizeof(dev_mem)), SUCCESS);
+  ASSERT_EQ(DumpWriter::GetInstance().Flush(), SUCCESS);
+  // content is not copied by runtime stub
+  EXPECT_EQ(ReadFile(file_paths_[0]).size(), sizeof(dev_mem));
+
+  // nothing to dump
+  EXPECT_EQ(Debug::DumpDevMem("./dump_writer_ut.6", dev_mem, 0), SUCCESS);
+  ASSERT_EQ(DumpWriter::GetInstance().Flush(), SUCCESS);
+  EXPECT_FALSE(FileExists("./dump_writer_ut.6"));
+}
+}  // namespace ge
@@ -0,0 +1,210 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/passes/graph_builder_utils.h"
+#include "graph/utils/tensor_utils.h"
+
+#define private public
+#define protected public
+#include "graph/build/graph_builder.h"
+#include "model/ge_model.h"
+#include "model/ge_root_model.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+const char *const kEnvBuildParallelNum = "SUBGRAPH_BUILD_PARALLEL_NUM";
+const int64_t kCalcOutputSize = 64;
+
+// stands in for engines and memory assignment, which write the outputs of nodes in the subgraph,
+// and read them back later in the build
+class FakeSubgraphBuilder : public GraphBuilder {
+ public:
+  Status BuildSubgraph(ComputeGraphPtr &sub_graph, GeModelPtr &ge_model_ptr, uint64_t session_id,
+                       GraphPartitioner *graph_partitioner) override {
+    for (const auto &node : sub_graph->GetDirectNode()) {
+      auto op_desc = node->GetOpDesc();
+      if (node->GetType() == NETOUTPUT) {
+        TensorUtils::SetSize(*op_desc->MutableInputDesc(0), kCalcOutputSize * (sub_graph->GetAllNodesSize() + 1));
+        continue;
+      }
+      for (size_t i = 0; i < op_desc->GetOutputsSize(); ++i) {
+        TensorUtils::SetSize(*op_desc->MutableOutputDesc(i), kCalcOutputSize);
+      }
+    }
+    // gives a racing writer of the parent node a chance to show up
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::vector<int64_t> sizes;
+    for (const auto &node : sub_graph->GetDirectNode()) {
+      for (const auto &output_desc : node->GetOpDesc()->GetAllOutputsDescPtr()) {
+        int64_t size = 0;
+        (void) TensorUtils::GetSize(*output_desc, size);
+        sizes.emplace_back(size);
+      }
+    }
+    ge_model_ptr = MakeShared<GeModel>();
+    ge_model_ptr->SetName(sub_graph->GetName());
+
+    std::lock_guard<std::mutex> lk(mu_);
+    read_sizes_[sub_graph->GetName()] = sizes;
+    thread_ids_.emplace(std::this_thread::get_id());
+    return SUCCESS;
+  }
+
+  std::mutex mu_;
+  std::map<std::string, std::vector<int64_t>> read_sizes_;
+  std::set<std::thread::id> thread_ids_;
+};
+
+ComputeGraphPtr MakeSubgraph(const std::string &name, const ComputeGraphPtr &parent_graph,
+                             const NodePtr &parent_node) {
+  ut::GraphBuilder builder(name);
+  auto net_output = builder.AddNode(name + "_net_output", NETOUTPUT, 1, 0);
+  (void) AttrUtils::SetInt(net_output->GetOpDesc()->MutableInputDesc(0), ATTR_NAME_PARENT_NODE_INDEX, 0);
+  auto sub_graph = builder.GetGraph();
+  sub_graph->SetParentGraph(parent_graph);
+  sub_graph->SetParentNode(parent_node);
+  parent_node->GetOpDesc()->AddSubgraphName(name);
+  parent_node->GetOpDesc()->SetSubgraphInstanceName(0, name);
+  return sub_graph;
+}
+
+// root graph calls known subgraphs sub_0, sub_1 and unknown subgraph sub_u, which calls known subgraph sub_2
+ComputeGraphPtr MakeDynamicGraph(bool child_first) {
+  ut::GraphBuilder root_builder("root");
+  auto call_0 = root_builder.AddNode("call_0", PARTITIONEDCALL, 0, 1);
+  auto call_1 = root_builder.AddNode("call_1", PARTITIONEDCALL, 0, 1);
+  auto call_u = root_builder.AddNode("call_u", PARTITIONEDCALL, 0, 1);
+  auto root_graph = root_builder.GetGraph();
+  (void) AttrUtils::SetBool(root_graph, ATTR_NAME_DYNAMIC_SHAPE_PARTITIONED, true);
+
+  auto sub_0 = MakeSubgraph("sub_0", root_graph, call_0);
+  auto sub_1 = MakeSubgraph("sub_1", root_graph, call_1);
+  ut::GraphBuilder unknown_builder("sub_u");
+  auto call_2 = unknown_builder.AddNode("call_2", PARTITIONEDCALL, 0, 1);
+  auto net_output = unknown_builder.AddNode("sub_u_net_output", NETOUTPUT, 1, 0);
+  (void) AttrUtils::SetInt(net_output->GetOpDesc()->MutableInputDesc(0), ATTR_NAME_PARENT_NODE_INDEX, 0);
+  unknown_builder.AddDataEdge(call_2, 0, net_output, 0);
+  auto sub_u = unknown_builder.GetGraph();
+  sub_u->SetGraphUnknownFlag(true);
+  sub_u->SetParentGraph(root_graph);
+  sub_u->SetParentNode(call_u);
+  call_u->GetOpDesc()->AddSubgraphName("sub_u");
+  call_u->GetOpDesc()->SetSubgraphInstanceName(0, "sub_u");
+  auto sub_2 = MakeSubgraph("sub_2", sub_u, call_2);
+
+  std::vector<ComputeGraphPtr> sub_graphs = {sub_0, sub_1, sub_u, sub_2};
+  if (child_first) {
+    sub_graphs = {sub_0, sub_1, sub_2, sub_u};
+  }
+  for (const auto &sub_graph : sub_graphs) {
+    EXPECT_EQ(root_graph->AddSubgraph(sub_graph->GetName(), sub_graph), GRAPH_SUCCESS);
+  }
+  return root_graph;
+}
+
+std::map<std::string, int64_t> GetOutputSizes(const ComputeGraphPtr &root_graph) {
+  std::map<std::string, int64_t> output_sizes;
+  for (const auto &node : root_graph->GetAllNodes()) {
+    for (const auto &output_desc : node->GetOpDesc()->GetAllOutputsDescPtr()) {
+      int64_t size = 0;
+      (void) TensorUtils::GetSize(*output_desc, size);
+      output_sizes[node->GetName()] = size;
+    }
+  }
+  return output_sizes;
+}
+
+struct BuildResult {
+  std::map<std::string, int64_t> output_sizes;
+  std::map<std::string, std::vector<int64_t>> read_sizes;
+  std::vector<std::string> model_names;
+  std::string last_model_name;
+  size_t thread_num = 0;
+};
+
+BuildResult BuildDynamicGraph(const char *parallel_num, bool child_first) {
+  BuildResult result;
+  setenv(kEnvBuildParallelNum, parallel_num, 1);
+  auto root_graph = MakeDynamicGraph(child_first);
+  FakeSubgraphBuilder builder;
+  GeRootModelPtr root_model = MakeShared<GeRootModel>(root_graph);
+  GeModelPtr ge_model;
+  EXPECT_EQ(builder.BuildForDynamicShapeGraph(root_graph, root_model, ge_model, 0), SUCCESS);
+  unsetenv(kEnvBuildParallelNum);
+
+  result.output_sizes = GetOutputSizes(root_graph);
+  result.read_sizes = builder.read_sizes_;
+  for (const auto &it : root_model->GetSubgraphInstanceNameToModel()) {
+    result.model_names.emplace_back(it.first + ":" + it.second->GetName());
+  }
+  result.last_model_name = (ge_model == nullptr) ? "" : ge_model->GetName();
+  result.thread_num = builder.thread_ids_.size();
+  return result;
+}
+}  // namespace
+
+class UtestGraphBuilder : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestGraphBuilder, parallel_build_same_as_serial) {
+  auto serial = BuildDynamicGraph("1", false);
+  EXPECT_EQ(serial.thread_num, 1);
+  for (int i = 0; i < 3; ++i) {
+    auto parallel = BuildDynamicGraph("4", false);
+    EXPECT_GT(parallel.thread_num, 1);
+    EXPECT_EQ(parallel.output_sizes, serial.output_sizes);
+    EXPECT_EQ(parallel.read_sizes, serial.read_sizes);
+    EXPECT_EQ(parallel.model_names, serial.model_names);
+    EXPECT_EQ(parallel.last_model_name, serial.last_model_name);
+  }
+
+  // parent nodes are updated with sizes of subgraph outputs
+  EXPECT_EQ(serial.output_sizes["call_0"], kCalcOutputSize * 2);
+  EXPECT_EQ(serial.output_sizes["call_2"], kCalcOutputSize * 2);
+  // not updated by unknown subgraph
+  EXPECT_EQ(serial.output_sizes["call_u"], 0);
+  // building sub_u reads its own size of call_2, which is updated after sub_2 is built
+  EXPECT_EQ(serial.read_sizes["sub_u"], std::vector<int64_t>({kCalcOutputSize}));
+}
+
+TEST_F(UtestGraphBuilder, subgraph_before_parent_built_serially) {
+  auto serial = BuildDynamicGraph("1", true);
+  auto parallel = BuildDynamicGraph("4", true);
+  EXPECT_EQ(parallel.thread_num, 1);
+  EXPECT_EQ(parallel.output_sizes, serial.output_sizes);
+  EXPECT_EQ(parallel.read_sizes, serial.read_sizes);
+  EXPECT_EQ(parallel.model_names, serial.model_names);
+  // size of call_2 updated by sub_2 is overwritten by building sub_u afterwards
+  EXPECT_EQ(serial.output_sizes["call_2"], kCalcOutputSize);
+}
+}  // namespace ge
@@ -188,6 +188,14 @@ class UtestLogicalStreamAllocator : public testing::Test {
 
   bool ExpectStreamEq(SubGraphInfoPtr subgraph, int64_t expect) { return GetStream(subgraph) == expect; }
 
+  void SetHeavy(SubGraphInfoPtr subgraph) {
+    NodePtr node = subgraph->GetSubGraph()->FindNode("relu");
+    assert(node != nullptr);
+    GeTensorDesc tensor_desc(GeShape({1024, 1024}), FORMAT_ND, DT_FLOAT);
+    node->GetOpDesc()->UpdateInputDesc(0, tensor_desc);
+    node->GetOpDesc()->UpdateOutputDesc(0, tensor_desc);
+  }
+
   bool ExpectStreamNe(SubGraphInfoPtr subgraph, int64_t expect) { return GetStream(subgraph) != expect; }
   Status AssignLogicalStreams(Graph2SubGraphInfoList &subgraph_map, vector<EngineConfPtr> &confs,
                               std::map<std::string, int> &max_parallel_num, ComputeGraphPtr &whole_graph) {
@@ -218,6 +226,7 @@ class UtestLogicalStreamAllocator : public testing::Test {
     map<string, SchedulerConf> scheduler_confs;
     scheduler_confs["scheduler"] = scheduler_conf;
     LogicalStreamAllocator allocator(scheduler_confs, max_parallel_num);
+    allocator.EnableCostModel(enable_cost_model_);
     int64_t stream_num = 0;
     return allocator.Assign(whole_graph, subgraph_map, stream_num);
   }
@@ -393,6 +402,8 @@ class UtestLogicalStreamAllocator : public testing::Test {
     node_f->GetOpDesc()->SetStreamId(2);
     node_g->GetOpDesc()->SetStreamId(2);
   }
+
+  bool enable_cost_model_ = false;
 };
 
 // case of single subgraph (without streamlabel)
@@ -860,6 +871,39 @@ TEST_F(UtestLogicalStreamAllocator, test_reassign_stream) {
   EXPECT_EQ(GetStream(subgraph3), 0);
 }
 
+/// heavy1 and heavy2 share a stream by round robin, the cost model moves heavy2 to the stream of light ones
+///                sub1
+///     /       |       |       \
+/// heavy1  light1  heavy2  light2
+TEST_F(UtestLogicalStreamAllocator, test_critical_path_stream_pass) {
+  SubGraphInfoPtr data = CreateDataSubgraph();
+  SubGraphInfoPtr subgraph1 = CreateSubgraph("engine1", "", 1, 4);
+  SubGraphInfoPtr heavy1 = CreateSubgraph("engine1");
+  SubGraphInfoPtr light1 = CreateSubgraph("engine1");
+  SubGraphInfoPtr heavy2 = CreateSubgraph("engine1");
+  SubGraphInfoPtr light2 = CreateSubgraph("engine1");
+  SetHeavy(heavy1);
+  SetHeavy(heavy2);
+  LinkSubGraph(data, "end", subgraph1, "placeholder");
+  LinkSubGraph(subgraph1, "end1", heavy1, "placeholder");
+  LinkSubGraph(subgraph1, "end2", light1, "placeholder");
+  LinkSubGraph(subgraph1, "end3", heavy2, "placeholder");
+  LinkSubGraph(subgraph1, "end4", light2, "placeholder");
+
+  std::map<std::string, int> max_parallel_num;
+  max_parallel_num["engine1"] = 2;
+  Status status = AssignLogicalStreams({subgraph1, heavy1, light1, heavy2, light2}, max_parallel_num);
+  EXPECT_EQ(status, ge::SUCCESS);
+  EXPECT_EQ(GetStream(heavy1), GetStream(heavy2));
+
+  enable_cost_model_ = true;
+  status = AssignLogicalStreams({subgraph1, heavy1, light1, heavy2, light2}, max_parallel_num);
+  EXPECT_EQ(status, ge::SUCCESS);
+  EXPECT_NE(GetStream(heavy1), GetStream(heavy2));
+  EXPECT_EQ(GetStream(light1), GetStream(heavy2));
+  EXPECT_EQ(GetStream(light1), GetStream(light2));
+}
+
 TEST_F(UtestLogicalStreamAllocator, test_all_reduce_parallel_pass) {
   graphStatus ret = GRAPH_SUCCESS;
 
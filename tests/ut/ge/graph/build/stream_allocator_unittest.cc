@@ -0,0 +1,119 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "graph/debug/ge_attr_define.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+
+#define protected public
+#define private public
+#include "graph/build/stream_allocator.h"
+#undef protected
+#undef private
+
+using namespace std;
+using namespace testing;
+
+namespace ge {
+class UtestStreamAllocator : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+
+  NodePtr AddNode(ComputeGraphPtr &graph, const string &name, int64_t stream_id) {
+    auto op_desc = make_shared<OpDesc>(name, "Some");
+    op_desc->SetStreamId(stream_id);
+    return graph->AddNode(op_desc);
+  }
+};
+
+///
+///    A(0)
+///    |  \
+///    |   B(1)
+///    |   |
+///    |   C(2)
+///     \ /
+///     D(2)
+///
+TEST_F(UtestStreamAllocator, test_transitive_reduction_remove_implied_event) {
+  auto graph = make_shared<ComputeGraph>("test");
+  auto a = AddNode(graph, "A", 0);
+  auto b = AddNode(graph, "B", 1);
+  auto c = AddNode(graph, "C", 2);
+  auto d = AddNode(graph, "D", 2);
+  Graph2SubGraphInfoList subgraphs;
+  StreamAllocator allocator(graph, subgraphs);
+  allocator.stream_num_ = 3;
+  allocator.AddEventId(a, nullptr, b, false);
+  allocator.AddEventId(b, nullptr, c, false);
+  allocator.AddEventId(a, nullptr, d, false);
+  EXPECT_EQ(allocator.GetSyncEventNum(), 3);
+
+  EXPECT_EQ(allocator.OptimizeByTransitiveReduction(), SUCCESS);
+  EXPECT_EQ(allocator.GetSyncEventNum(), 2);
+  vector<uint32_t> recv_events;
+  allocator.GetRecvEventIdList(d, recv_events);
+  EXPECT_TRUE(recv_events.empty());
+  allocator.GetRecvEventIdList(c, recv_events);
+  EXPECT_EQ(recv_events.size(), 1);
+}
+
+///
+///    A(0)    B(1)
+///      \     /
+///       C(2)
+///
+TEST_F(UtestStreamAllocator, test_transitive_reduction_keep_independent_events) {
+  auto graph = make_shared<ComputeGraph>("test");
+  auto a = AddNode(graph, "A", 0);
+  auto b = AddNode(graph, "B", 1);
+  auto c = AddNode(graph, "C", 2);
+  Graph2SubGraphInfoList subgraphs;
+  StreamAllocator allocator(graph, subgraphs);
+  allocator.stream_num_ = 3;
+  allocator.AddEventId(a, nullptr, c, false);
+  allocator.AddEventId(b, nullptr, c, false);
+
+  EXPECT_EQ(allocator.OptimizeByTransitiveReduction(), SUCCESS);
+  EXPECT_EQ(allocator.GetSyncEventNum(), 2);
+}
+
+///
+///    A(0) -> C(2, labeled) -> D(1)
+///      \______________________/
+///
+TEST_F(UtestStreamAllocator, test_transitive_reduction_skip_labeled_stream) {
+  auto graph = make_shared<ComputeGraph>("test");
+  auto a = AddNode(graph, "A", 0);
+  auto c = AddNode(graph, "C", 2);
+  auto d = AddNode(graph, "D", 1);
+  (void)AttrUtils::SetStr(c->GetOpDesc(), ATTR_NAME_STREAM_LABEL, "label");
+  Graph2SubGraphInfoList subgraphs;
+  StreamAllocator allocator(graph, subgraphs);
+  allocator.stream_num_ = 3;
+  allocator.AddEventId(a, nullptr, c, false);
+  allocator.AddEventId(c, nullptr, d, false);
+  allocator.AddEventId(a, nullptr, d, false);
+
+  EXPECT_EQ(allocator.OptimizeByTransitiveReduction(), SUCCESS);
+  EXPECT_EQ(allocator.GetSyncEventNum(), 3);
+}
+}  // namespace ge
@@ -0,0 +1,200 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "graph/passes/graph_builder_utils.h"
+#include "runtime/rt_model.h"
+
+#define private public
+#define protected public
+#include "graph/build/task_generator.h"
+#include "opskernel_manager/ops_kernel_builder_manager.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+const char *const kLibAiCore = "AIcoreEngine";
+const char *const kLibAiCpu = "aicpu_ascend_kernel";
+const char *const kLibGeLocal = "DNN_VM_GE_LOCAL_OP_STORE";
+const char *const kLibRts = "DNN_VM_RTS_OP_STORE";
+
+// generates one task per node, or two for nodes named with prefix "two".
+// if reads_tasks, the number of tasks generated before is kept in the task, as engines referring to other tasks
+class FakeTaskBuilder : public OpsKernelBuilder {
+ public:
+  FakeTaskBuilder(uint32_t type, bool reads_tasks) : type_(type), reads_tasks_(reads_tasks) {}
+
+  Status Initialize(const map<std::string, std::string> &options) override {
+    return SUCCESS;
+  }
+
+  Status Finalize() override {
+    return SUCCESS;
+  }
+
+  Status CalcOpRunningParam(Node &node) override {
+    return SUCCESS;
+  }
+
+  Status GenerateTask(const Node &node, RunContext &context, std::vector<domi::TaskDef> &tasks) override {
+    std::lock_guard<std::mutex> lk(mu_);
+    thread_ids_.insert(std::this_thread::get_id());
+    size_t task_num = (node.GetName().compare(0, 3, "two") == 0) ? 2 : 1;
+    for (size_t i = 0; i < task_num; ++i) {
+      domi::TaskDef task_def;
+      task_def.set_type(type_);
+      task_def.mutable_kernel()->set_kernel_name(node.GetName() + "_" + std::to_string(i));
+      if (reads_tasks_) {
+        task_def.set_id(static_cast<uint32_t>(tasks.size()));
+      }
+      tasks.emplace_back(task_def);
+    }
+    return SUCCESS;
+  }
+
+  std::mutex mu_;
+  std::set<std::thread::id> thread_ids_;
+
+ private:
+  uint32_t type_;
+  bool reads_tasks_;
+};
+
+// as the merge loop of TaskGenerator::GenerateTask, with a profiling task inserted before nodes named "fp*"
+Status MergeTasks(const std::vector<NodePtr> &nodes,
+                  std::unordered_map<Node *, std::vector<domi::TaskDef>> &node_tasks,
+                  std::vector<domi::TaskDef> &task_def_list) {
+  RunContext run_context;
+  for (const auto &node : nodes) {
+    if (node->GetName().compare(0, 2, "fp") == 0) {
+      domi::TaskDef profiling_task;
+      profiling_task.set_type(RT_MODEL_TASK_PROFILER_TRACE);
+      profiling_task.mutable_log_timestamp()->set_logid(1);
+      task_def_list.emplace_back(profiling_task);
+    }
+    auto iter = node_tasks.find(node.get());
+    if (iter != node_tasks.end()) {
+      task_def_list.insert(task_def_list.end(), iter->second.begin(), iter->second.end());
+      continue;
+    }
+    GE_CHK_STATUS_RET_NOLOG(OpsKernelBuilderManager::Instance().GenerateTask(*node, run_context, task_def_list));
+  }
+  return SUCCESS;
+}
+
+std::vector<std::string> SerializeTasks(const std::vector<domi::TaskDef> &task_def_list) {
+  std::vector<std::string> task_bytes;
+  for (const auto &task_def : task_def_list) {
+    std::string bytes;
+    EXPECT_TRUE(task_def.SerializeToString(&bytes));
+    task_bytes.emplace_back(bytes);
+  }
+  return task_bytes;
+}
+}  // namespace
+
+class UtestTaskGenerator : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {
+    OpsKernelBuilderManager::Instance().ops_kernel_builders_.clear();
+    OpsKernelBuilderManager::Instance().builder_mutexes_.clear();
+  }
+};
+
+TEST_F(UtestTaskGenerator, parallel_generated_tasks_same_as_serial) {
+  // builder_a is registered with two lib names, and is called by one thread only
+  auto builder_a = std::make_shared<FakeTaskBuilder>(1, false);
+  auto builder_b = std::make_shared<FakeTaskBuilder>(2, false);
+  auto builder_rts = std::make_shared<FakeTaskBuilder>(3, true);
+  auto &manager = OpsKernelBuilderManager::Instance();
+  manager.ops_kernel_builders_[kLibAiCore] = builder_a;
+  manager.ops_kernel_builders_[kLibGeLocal] = builder_a;
+  manager.ops_kernel_builders_[kLibAiCpu] = builder_b;
+  manager.ops_kernel_builders_[kLibRts] = builder_rts;
+
+  ut::GraphBuilder graph_builder("graph");
+  const std::vector<std::pair<std::string, std::string>> node_libs = {
+      {"n0", kLibAiCore}, {"two1", kLibAiCpu}, {"fp2", kLibGeLocal}, {"two3", kLibAiCore}, {"n4", kLibRts},
+      {"n5", kLibAiCpu},  {"fp6", kLibGeLocal}, {"two7", kLibAiCpu}, {"two8", kLibRts}, {"n9", kLibAiCore}};
+  std::vector<NodePtr> nodes;
+  for (const auto &node_lib : node_libs) {
+    auto node = graph_builder.AddNode(node_lib.first, node_lib.first, 0, 1);
+    node->GetOpDesc()->SetOpKernelLibName(node_lib.second);
+    nodes.emplace_back(node);
+  }
+  std::vector<domi::TaskDef> initial_tasks(1);
+  initial_tasks[0].set_type(0);
+
+  std::vector<domi::TaskDef> serial_tasks = initial_tasks;
+  std::unordered_map<Node *, std::vector<domi::TaskDef>> no_tasks;
+  ASSERT_EQ(MergeTasks(nodes, no_tasks, serial_tasks), SUCCESS);
+  builder_a->thread_ids_.clear();
+  builder_b->thread_ids_.clear();
+
+  RunContext run_context;
+  std::unordered_map<Node *, std::vector<domi::TaskDef>> node_tasks;
+  ASSERT_EQ(TaskGenerator::GenerateTasksInParallel(run_context, nodes, true, 4, node_tasks), SUCCESS);
+  // engine not in the allow list is left to the merge loop
+  EXPECT_EQ(node_tasks.size(), 8);
+  EXPECT_EQ(node_tasks.count(nodes[4].get()), 0);
+  EXPECT_EQ(node_tasks.count(nodes[8].get()), 0);
+  std::vector<domi::TaskDef> parallel_tasks = initial_tasks;
+  ASSERT_EQ(MergeTasks(nodes, node_tasks, parallel_tasks), SUCCESS);
+
+  EXPECT_EQ(SerializeTasks(parallel_tasks), SerializeTasks(serial_tasks));
+  EXPECT_EQ(builder_a->thread_ids_.size(), 1);
+  EXPECT_EQ(builder_b->thread_ids_.size(), 1);
+  // tasks of the rts engine refer to profiling tasks and tasks of other engines generated before
+  EXPECT_EQ(serial_tasks.size(), 17);
+  EXPECT_EQ(serial_tasks[8].kernel().kernel_name(), "n4_0");
+  EXPECT_EQ(serial_tasks[8].id(), 8);
+}
+
+TEST_F(UtestTaskGenerator, parallel_generate_unknown_lib_skipped) {
+  auto builder = std::make_shared<FakeTaskBuilder>(1, false);
+  OpsKernelBuilderManager::Instance().ops_kernel_builders_[kLibAiCore] = builder;
+  ut::GraphBuilder graph_builder("graph");
+  auto node_a = graph_builder.AddNode("a", "a", 0, 1);
+  auto node_b = graph_builder.AddNode("b", "b", 0, 1);
+  auto node_c = graph_builder.AddNode("c", "c", 0, 1);
+  node_a->GetOpDesc()->SetOpKernelLibName(kLibAiCore);
+  node_b->GetOpDesc()->SetOpKernelLibName("lib_unknown");
+  // allowed, but no builder registered
+  node_c->GetOpDesc()->SetOpKernelLibName(kLibAiCpu);
+
+  RunContext run_context;
+  std::unordered_map<Node *, std::vector<domi::TaskDef>> node_tasks;
+  ASSERT_EQ(TaskGenerator::GenerateTasksInParallel(run_context, {node_a, node_b, node_c}, true, 2, node_tasks),
+            SUCCESS);
+  EXPECT_EQ(node_tasks[node_a.get()].size(), 1);
+  // left to the merge loop, which reports the error
+  EXPECT_EQ(node_tasks.count(node_b.get()), 0);
+  EXPECT_EQ(node_tasks.count(node_c.get()), 0);
+}
+}  // namespace ge
@@ -0,0 +1,154 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#define private public
+#define protected public
+#include "graph/execute/graph_execute.h"
+#include "graph/load/model_manager/davinci_model.h"
+#include "graph/load/model_manager/model_manager.h"
+#include "graph/load/model_manager/zero_copy_offset.h"
+#include "graph/load/model_manager/zero_copy_task.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+const uint64_t kMB = 1024UL * 1024UL;
+const uint32_t kModelId = 1001;
+const int64_t kTensorSize = 512;
+
+// data of Data or NetOutput at virtual_addr, fed by zero copy
+ZeroCopyOffset MakeZeroCopyOffset(const std::string &op_name, void *virtual_addr) {
+  ZeroCopyOffset zero_copy_offset;
+  zero_copy_offset.op_name_ = op_name;
+  zero_copy_offset.basic_addr_ = virtual_addr;
+  zero_copy_offset.data_count_ = 1;
+  zero_copy_offset.data_info_.emplace_back(kTensorSize, virtual_addr);
+  zero_copy_offset.relative_offset_.emplace_back(0);
+  zero_copy_offset.data_size_ = kTensorSize;
+  return zero_copy_offset;
+}
+}  // namespace
+
+class UtestGraphExecute : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestGraphExecute, staging_buffer_reused_in_place) {
+  GraphExecutor executor;
+  std::vector<void *> data_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({100, 3 * kMB}, data_addr), SUCCESS);
+  ASSERT_EQ(data_addr.size(), 2);
+  EXPECT_EQ(executor.buffer_size_, std::vector<uint64_t>({512, 3 * kMB}));
+
+  // same size classes
+  std::vector<void *> reused_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({500, 3 * kMB - 1}, reused_addr), SUCCESS);
+  EXPECT_EQ(reused_addr, data_addr);
+  EXPECT_TRUE(executor.free_buffers_.empty());
+  EXPECT_EQ(executor.FreeInOutBuffer(), SUCCESS);
+}
+
+TEST_F(UtestGraphExecute, staging_buffer_pooled_when_size_changes) {
+  GraphExecutor executor;
+  std::vector<void *> data_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({1024, 2048}, data_addr), SUCCESS);
+
+  std::vector<void *> swapped_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({2048, 1024}, swapped_addr), SUCCESS);
+  EXPECT_EQ(swapped_addr, std::vector<void *>({data_addr[1], data_addr[0]}));
+  EXPECT_EQ(executor.free_buffers_size_, 0);
+
+  std::vector<void *> fewer_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({2048}, fewer_addr), SUCCESS);
+  EXPECT_EQ(fewer_addr[0], data_addr[1]);
+  EXPECT_EQ(executor.free_buffers_size_, 1024);
+  EXPECT_EQ(executor.free_buffers_[1024].size(), 1);
+  EXPECT_EQ(executor.FreeInOutBuffer(), SUCCESS);
+  EXPECT_EQ(executor.free_buffers_size_, 0);
+}
+
+TEST_F(UtestGraphExecute, idle_staging_buffers_bounded) {
+  GraphExecutor executor;
+  std::vector<void *> data_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({200 * kMB, 200 * kMB}, data_addr), SUCCESS);
+
+  // only one of the big buffers fits in the idle pool
+  std::vector<void *> small_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({1024}, small_addr), SUCCESS);
+  EXPECT_EQ(executor.free_buffers_size_, 200 * kMB);
+  EXPECT_EQ(executor.free_buffers_[200 * kMB].size(), 1);
+
+  std::vector<void *> big_addr;
+  ASSERT_EQ(executor.MallocInOutBuffer({200 * kMB}, big_addr), SUCCESS);
+  EXPECT_EQ(executor.free_buffers_size_, 1024);
+  EXPECT_EQ(executor.FreeInOutBuffer(), SUCCESS);
+}
+TEST_F(UtestGraphExecute, execute_with_device_buffers_by_zero_copy) {
+  // args of a task reading the input and writing the output of model
+  uint8_t input_virtual_addr[kTensorSize] = {0};
+  uint8_t output_virtual_addr[kTensorSize] = {0};
+  uintptr_t origin_args[] = {reinterpret_cast<uintptr_t>(input_virtual_addr),
+                             reinterpret_cast<uintptr_t>(output_virtual_addr)};
+  uintptr_t device_args[2] = {0};
+  ZeroCopyTask zero_copy_task("task", reinterpret_cast<uint8_t *>(device_args), sizeof(device_args));
+  ASSERT_EQ(zero_copy_task.SetTaskArgsOffset(origin_args[0], 0), SUCCESS);
+  ASSERT_EQ(zero_copy_task.SetTaskArgsOffset(origin_args[1], sizeof(uintptr_t)), SUCCESS);
+  zero_copy_task.SetOriginalArgs(origin_args, sizeof(origin_args));
+
+  auto davinci_model = MakeShared<DavinciModel>(0, nullptr);
+  ASSERT_NE(davinci_model, nullptr);
+  davinci_model->model_id_ = kModelId;
+  davinci_model->input_data_info_[0] = MakeZeroCopyOffset("data", input_virtual_addr);
+  davinci_model->output_data_info_[0] = MakeZeroCopyOffset("net_output", output_virtual_addr);
+  davinci_model->zero_copy_tasks_.emplace_back(zero_copy_task);
+  auto model_manager = ModelManager::GetInstance();
+  ASSERT_NE(model_manager, nullptr);
+  model_manager->model_map_[kModelId] = davinci_model;
+
+  auto ge_root_model = MakeShared<GeRootModel>(MakeShared<ComputeGraph>("graph"));
+  ASSERT_NE(ge_root_model, nullptr);
+  ge_root_model->SetModelId(kModelId);
+  GraphExecutor executor;
+  uint8_t input_device_buffer[kTensorSize] = {0};
+  uint8_t output_device_buffer[kTensorSize] = {0};
+  std::vector<DataBuffer> inputs = {DataBuffer(input_device_buffer, kTensorSize, false)};
+  std::vector<DataBuffer> outputs = {DataBuffer(output_device_buffer, kTensorSize, false)};
+  EXPECT_EQ(executor.ExecuteGraphWithDeviceBuffers(0, ge_root_model, nullptr, inputs, outputs),
+            GE_GRAPH_EXECUTE_NOT_INIT);
+  executor.init_flag_ = true;
+  EXPECT_EQ(executor.ExecuteGraphWithDeviceBuffers(0, ge_root_model, nullptr, inputs, outputs), SUCCESS);
+
+  // task args refer to buffers of caller, without copies through staging buffers
+  const auto &args_info = davinci_model->zero_copy_tasks_[0].args_info_;
+  ASSERT_EQ(args_info.size(), sizeof(origin_args));
+  const uintptr_t *args = reinterpret_cast<const uintptr_t *>(args_info.data());
+  EXPECT_EQ(args[0], reinterpret_cast<uintptr_t>(input_device_buffer));
+  EXPECT_EQ(args[1], reinterpret_cast<uintptr_t>(output_device_buffer));
+  EXPECT_TRUE(executor.buffer_addr_.empty());
+
+  // buffer smaller than the model data is rejected
+  std::vector<DataBuffer> small_inputs = {DataBuffer(input_device_buffer, kTensorSize / 2, false)};
+  EXPECT_NE(executor.ExecuteGraphWithDeviceBuffers(0, ge_root_model, nullptr, small_inputs, outputs), SUCCESS);
+  model_manager->model_map_.erase(kModelId);
+}
+}  // namespace ge
@@ -15,11 +15,16 @@
  */
 
 #include <gtest/gtest.h>
+#include <dirent.h>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 
 #define private public
 #define protected public
 #include "graph/load/model_manager/data_dumper.h"
 #include "graph/load/model_manager/davinci_model.h"
+#include "proto/dump_task.pb.h"
 #undef private
 #undef protected
 
@@ -63,4 +68,64 @@ TEST_F(UtestDataDumper, UnloadDumpInfo_success) {
   Status ret = data_dumper.UnloadDumpInfo();
   EXPECT_EQ(ret, SUCCESS);
 }
+
+TEST_F(UtestDataDumper, DumpExceptionInfo_file_layout) {
+  RuntimeParam rts_param;
+  DataDumper data_dumper(rts_param);
+  data_dumper.SetModelName("test");
+  uint8_t input_mem[16] = {0};
+  uint8_t output_mem[32] = {0};
+  OpDescInfo op_desc_info;
+  op_desc_info.op_name = "add1";
+  op_desc_info.op_type = "Add";
+  op_desc_info.task_id = 7;
+  op_desc_info.stream_id = 1;
+  op_desc_info.input_format = {FORMAT_ND};
+  op_desc_info.input_shape = {{4}};
+  op_desc_info.input_data_type = {DT_FLOAT};
+  op_desc_info.input_addrs = {input_mem};
+  op_desc_info.input_size = {sizeof(input_mem)};
+  op_desc_info.output_format = {FORMAT_ND};
+  op_desc_info.output_shape = {{8}};
+  op_desc_info.output_data_type = {DT_FLOAT};
+  op_desc_info.output_addrs = {output_mem};
+  op_desc_info.output_size = {sizeof(output_mem)};
+  data_dumper.op_desc_info_.emplace_back(op_desc_info);
+
+  rtExceptionInfo exception_info = {0};
+  exception_info.taskid = 7;
+  exception_info.streamid = 1;
+  EXPECT_EQ(data_dumper.DumpExceptionInfo({exception_info}), SUCCESS);
+  // file is written in background, complete after flush
+  ASSERT_EQ(DumpWriter::GetInstance().Flush(), SUCCESS);
+
+  std::string file_path;
+  DIR *dir = opendir(".");
+  ASSERT_NE(dir, nullptr);
+  for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+    std::string file_name = entry->d_name;
+    if (file_name.find("Add.add1.7.") == 0) {
+      file_path = "./" + file_name;
+    }
+  }
+  closedir(dir);
+  ASSERT_FALSE(file_path.empty());
+  std::ifstream ifs(file_path, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  ifs.close();
+  (void) remove(file_path.c_str());
+
+  // layout: proto size, proto msg, data of inputs, data of outputs
+  uint64_t proto_size = 0;
+  ASSERT_GE(content.size(), sizeof(proto_size));
+  memcpy(&proto_size, content.data(), sizeof(proto_size));
+  ASSERT_EQ(content.size(), sizeof(proto_size) + proto_size + sizeof(input_mem) + sizeof(output_mem));
+  toolkit::dumpdata::DumpData dump_data;
+  ASSERT_TRUE(dump_data.ParseFromArray(content.data() + sizeof(proto_size), static_cast<int>(proto_size)));
+  EXPECT_EQ(dump_data.op_name(), "add1");
+  ASSERT_EQ(dump_data.input_size(), 1);
+  EXPECT_EQ(dump_data.input(0).size(), sizeof(input_mem));
+  ASSERT_EQ(dump_data.output_size(), 1);
+  EXPECT_EQ(dump_data.output(0).size(), sizeof(output_mem));
+}
 }  // namespace ge
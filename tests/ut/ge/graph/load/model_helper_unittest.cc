@@ -22,11 +22,53 @@
 #undef private
 #undef protected
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "common/auth/file_saver.h"
+#include "graph/utils/graph_utils.h"
 #include "proto/task.pb.h"
 
 using namespace std;
 
 namespace ge {
+namespace {
+// peak resident size of the process in KB
+int64_t GetPeakRssKb() {
+  std::ifstream fs("/proc/self/status");
+  std::string line;
+  while (std::getline(fs, line)) {
+    if (line.compare(0, strlen("VmHWM:"), "VmHWM:") == 0) {
+      return std::strtoll(line.c_str() + strlen("VmHWM:"), nullptr, 10);
+    }
+  }
+  return -1;
+}
+
+// peak resident size is reset to current resident size
+bool ResetPeakRss() {
+  std::ofstream fs("/proc/self/clear_refs");
+  fs << "5";
+  fs.flush();
+  return fs.good();
+}
+
+GeModelPtr CreateLargeModel(size_t weight_size, size_t task_args_size) {
+  GeModelPtr ge_model = ge::MakeShared<ge::GeModel>();
+  ge_model->SetName("large_model");
+  ge_model->SetGraph(GraphUtils::CreateGraphFromComputeGraph(ge::MakeShared<ComputeGraph>("large_graph")));
+  ge_model->SetWeight(Buffer(weight_size, 1));
+  std::shared_ptr<domi::ModelTaskDef> model_task_def = ge::MakeShared<domi::ModelTaskDef>();
+  model_task_def->add_task()->mutable_kernel()->set_args(std::string(task_args_size, 'a'));
+  ge_model->SetModelTaskDef(model_task_def);
+  return ge_model;
+}
+}  // namespace
+
 class UtestModelHelper : public testing::Test {
  protected:
   void SetUp() override {}
@@ -49,4 +91,91 @@ TEST_F(UtestModelHelper, save_size_to_modeldef)
   ModelHelper model_helper;
   EXPECT_EQ(SUCCESS, model_helper.SaveSizeToModelDef(ge_model));
 }
+
+TEST_F(UtestModelHelper, stream_save_om_file)
+{
+  const std::string file_path = "./stream_save_ut.om";
+  std::vector<uint8_t> model_def(16, 1);
+  std::vector<uint8_t> task_def(32, 2);
+  OmFileStreamSaver stream_saver;
+  EXPECT_EQ(stream_saver.Open(file_path, 2), SUCCESS);
+  EXPECT_EQ(stream_saver.WritePartition(MODEL_DEF, model_def.data(), model_def.size()), SUCCESS);
+  ModelFileHeader incomplete_header;
+  EXPECT_EQ(stream_saver.Finish(incomplete_header), FAILED);  // one partition missing
+  EXPECT_EQ(stream_saver.WritePartition(TASK_INFO, task_def.data(), task_def.size()), SUCCESS);
+  EXPECT_EQ(stream_saver.WritePartition(TASK_INFO, task_def.data(), task_def.size()), FAILED);
+  ModelFileHeader file_header;
+  file_header.model_num = 1;
+  EXPECT_EQ(stream_saver.Finish(file_header), SUCCESS);
+
+  std::ifstream fs(file_path, std::ios::binary);
+  std::vector<char> content((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  size_t table_size = sizeof(ModelPartitionTable) + sizeof(ModelPartitionMemInfo) * 2;
+  ASSERT_EQ(content.size(), sizeof(ModelFileHeader) + table_size + model_def.size() + task_def.size());
+  auto saved_header = reinterpret_cast<const ModelFileHeader *>(content.data());
+  EXPECT_EQ(saved_header->length, table_size + model_def.size() + task_def.size());
+  EXPECT_EQ(saved_header->model_num, 1);
+  auto table = reinterpret_cast<const ModelPartitionTable *>(content.data() + sizeof(ModelFileHeader));
+  EXPECT_EQ(table->num, 2);
+  EXPECT_EQ(table->partition[1].type, TASK_INFO);
+  EXPECT_EQ(table->partition[1].mem_offset, model_def.size());
+  EXPECT_EQ(table->partition[1].mem_size, task_def.size());
+  EXPECT_EQ(content.back(), 2);
+  (void) remove(file_path.c_str());
+}
+
+TEST_F(UtestModelHelper, stream_save_incomplete_file_removed)
+{
+  const std::string file_path = "./stream_save_incomplete_ut.om";
+  std::vector<uint8_t> model_def(16, 1);
+  {
+    OmFileStreamSaver stream_saver;
+    EXPECT_EQ(stream_saver.Open(file_path, 2), SUCCESS);
+    EXPECT_EQ(stream_saver.WritePartition(MODEL_DEF, model_def.data(), model_def.size()), SUCCESS);
+    ModelFileHeader file_header;
+    EXPECT_EQ(stream_saver.Finish(file_header), FAILED);
+    EXPECT_TRUE(std::ifstream(file_path).good());
+  }
+  // saver destroyed before finished
+  EXPECT_FALSE(std::ifstream(file_path).good());
+}
+
+TEST_F(UtestModelHelper, stream_save_peak_rss)
+{
+  const size_t kWeightSize = 64UL * 1024UL * 1024UL;
+  const size_t kTaskArgsSize = 8UL * 1024UL * 1024UL;
+  const std::string file_path = "./stream_save_large_ut.om";
+  GeModelPtr ge_model = CreateLargeModel(kWeightSize, kTaskArgsSize);
+  SaveParam save_param;
+
+  // offline save writes partitions to file one by one
+  ModelHelper stream_helper;
+  ModelBufferData stream_model;
+  bool rss_reset = ResetPeakRss();
+  int64_t stream_before = GetPeakRssKb();
+  EXPECT_EQ(stream_helper.SaveToOmModel(ge_model, save_param, file_path, stream_model), SUCCESS);
+  int64_t stream_after = GetPeakRssKb();
+  (void) remove(file_path.c_str());
+
+  // in memory save builds the whole om in one buffer
+  ModelHelper buffer_helper;
+  buffer_helper.SetSaveMode(false);
+  ModelBufferData buffer_model;
+  rss_reset = ResetPeakRss() && rss_reset;
+  int64_t buffer_before = GetPeakRssKb();
+  EXPECT_EQ(buffer_helper.SaveToOmModel(ge_model, save_param, file_path, buffer_model), SUCCESS);
+  int64_t buffer_after = GetPeakRssKb();
+  EXPECT_GE(buffer_model.length, kWeightSize + kTaskArgsSize);
+
+  RecordProperty("weight_kb", static_cast<int>(kWeightSize / 1024));
+  RecordProperty("stream_save_peak_rss_before_kb", static_cast<int>(stream_before));
+  RecordProperty("stream_save_peak_rss_after_kb", static_cast<int>(stream_after));
+  RecordProperty("buffer_save_peak_rss_before_kb", static_cast<int>(buffer_before));
+  RecordProperty("buffer_save_peak_rss_after_kb", static_cast<int>(buffer_after));
+  if (rss_reset && (stream_before > 0) && (buffer_before > 0)) {
+    // weights are written from the model, not copied
+    EXPECT_LT(stream_after - stream_before, static_cast<int64_t>(kWeightSize / 1024));
+    EXPECT_LT(stream_after - stream_before, buffer_after - buffer_before);
+  }
+}
 }  // namespace ge
@@ -29,11 +29,15 @@ class UtestTBEHandleStore : public testing::Test {
   void SetUp() {
     TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
     kernel_store.kernels_.clear();
+    kernel_store.binaries_.clear();
+    kernel_store.name_hashes_.clear();
   }
 
   void TearDown() {
     TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
     kernel_store.kernels_.clear();
+    kernel_store.binaries_.clear();
+    kernel_store.name_hashes_.clear();
   }
 };
 
@@ -119,6 +123,124 @@ TEST_F(UtestTBEHandleStore, test_store_tbe_handle) {
   EXPECT_EQ(kernel_store.kernels_.size(), 0);
 }
 
+TEST_F(UtestTBEHandleStore, test_register_tbe_handle_shared_binary) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  std::vector<char> data0 = {'a', 'b', 'c', 'd'};
+  std::vector<char> data1 = {'a', 'b', 'c', 'd'};
+  std::vector<char> data2 = {'a', 'b', 'c', 'e'};
+  auto kernel0 = std::make_shared<OpKernelBin>("kernel0", std::move(data0));
+  auto kernel1 = std::make_shared<OpKernelBin>("kernel1", std::move(data1));
+  auto kernel2 = std::make_shared<OpKernelBin>("kernel2", std::move(data2));
+  std::shared_ptr<OpKernelBin> null_kernel;
+
+  void *handle = nullptr;
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model0_stub", RT_DEV_BINARY_MAGIC_ELF, "", null_kernel, handle),
+            PARAM_INVALID);
+
+  // same content of different models is registered once.
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model0_stub", RT_DEV_BINARY_MAGIC_ELF, "", kernel0, handle), SUCCESS);
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model1_stub", RT_DEV_BINARY_MAGIC_ELF, "", kernel1, handle), SUCCESS);
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model1_stub", RT_DEV_BINARY_MAGIC_ELF, "", kernel1, handle), SUCCESS);
+  EXPECT_EQ(kernel_store.kernels_.size(), 2);
+  EXPECT_EQ(kernel_store.kernels_.find("model1_stub")->second.kernel(), kernel0);
+
+  // different content or magic is not shared.
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model2_stub", RT_DEV_BINARY_MAGIC_ELF, "", kernel2, handle), SUCCESS);
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model3_stub", RT_DEV_BINARY_MAGIC_ELF_AIVEC, "", kernel1, handle),
+            SUCCESS);
+
+  TbeHandleStatistic statistic = kernel_store.GetStatistic();
+  EXPECT_EQ(statistic.name_num, 4);
+  EXPECT_EQ(statistic.binary_num, 3);
+  EXPECT_EQ(statistic.reference_num, 5);
+  EXPECT_EQ(statistic.binary_size, 12);
+  EXPECT_EQ(statistic.shared_size, 4);
+
+  // names are erased with their last reference, binaries are unregistered when no name refers to them.
+  std::map<std::string, uint32_t> names0 = {{"model0_stub", 1}, {"model2_stub", 1}, {"model3_stub", 1}};
+  kernel_store.EraseTBEHandle(names0);
+  statistic = kernel_store.GetStatistic();
+  EXPECT_EQ(statistic.name_num, 1);
+  EXPECT_EQ(statistic.binary_num, 1);
+  EXPECT_EQ(statistic.reference_num, 2);
+  EXPECT_EQ(statistic.binary_size, 4);
+  EXPECT_EQ(statistic.shared_size, 0);
+  EXPECT_EQ(kernel_store.name_hashes_.size(), 1);
+  EXPECT_FALSE(kernel_store.FindTBEHandle("model0_stub", handle));
+
+  std::map<std::string, uint32_t> names1 = {{"model1_stub", 2}};
+  kernel_store.EraseTBEHandle(names1);
+  statistic = kernel_store.GetStatistic();
+  EXPECT_EQ(statistic.name_num, 0);
+  EXPECT_EQ(statistic.binary_num, 0);
+  EXPECT_EQ(statistic.reference_num, 0);
+  EXPECT_EQ(statistic.binary_size, 0);
+  EXPECT_TRUE(kernel_store.kernels_.empty());
+  EXPECT_TRUE(kernel_store.name_hashes_.empty());
+  EXPECT_TRUE(kernel_store.binaries_.empty());
+}
+
+TEST_F(UtestTBEHandleStore, test_register_tbe_handle_unload_reload) {
+  TBEHandleStore &kernel_store = TBEHandleStore::GetInstance();
+  std::vector<char> data0 = {'a', 'b', 'c', 'd'};
+  std::vector<char> data1 = {'a', 'b', 'c', 'd'};
+  auto kernel0 = std::make_shared<OpKernelBin>("kernel0", std::move(data0));
+  auto kernel1 = std::make_shared<OpKernelBin>("kernel1", std::move(data1));
+  std::map<std::string, uint32_t> names = {{"model0_stub", 1}};
+  std::map<std::string, uint32_t> other_names = {{"model1_stub", 1}};
+
+  // load
+  void *handle0 = nullptr;
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model0_stub", RT_DEV_BINARY_MAGIC_ELF, "", kernel0, handle0), SUCCESS);
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model1_stub", RT_DEV_BINARY_MAGIC_ELF, "", kernel1, handle0), SUCCESS);
+
+  // unload, name is erased, binary is kept by the other name.
+  kernel_store.EraseTBEHandle(names);
+  void *handle = nullptr;
+  EXPECT_FALSE(kernel_store.FindTBEHandle("model0_stub", handle));
+  EXPECT_EQ(kernel_store.name_hashes_.count("model0_stub"), 0);
+  TbeHandleStatistic statistic = kernel_store.GetStatistic();
+  EXPECT_EQ(statistic.name_num, 1);
+  EXPECT_EQ(statistic.binary_num, 1);
+  EXPECT_EQ(statistic.reference_num, 1);
+  EXPECT_EQ(statistic.shared_size, 0);
+
+  // reload with function still registered, refer the binary again, no new binary registered.
+  EXPECT_TRUE(kernel_store.ReferTBEBinary("model0_stub", kernel0));
+  EXPECT_TRUE(kernel_store.FindTBEHandle("model0_stub", handle));
+  EXPECT_EQ(handle, handle0);
+  EXPECT_EQ(kernel_store.kernels_.find("model0_stub")->second.kernel(), kernel0);
+  statistic = kernel_store.GetStatistic();
+  EXPECT_EQ(statistic.name_num, 2);
+  EXPECT_EQ(statistic.binary_num, 1);
+  EXPECT_EQ(statistic.reference_num, 2);
+  EXPECT_EQ(statistic.shared_size, 4);
+
+  // unload all, binary is unregistered with its functions, and can not be referred any more.
+  kernel_store.EraseTBEHandle(names);
+  kernel_store.EraseTBEHandle(other_names);
+  statistic = kernel_store.GetStatistic();
+  EXPECT_EQ(statistic.name_num, 0);
+  EXPECT_EQ(statistic.binary_num, 0);
+  EXPECT_EQ(statistic.reference_num, 0);
+  EXPECT_TRUE(kernel_store.name_hashes_.empty());
+  EXPECT_FALSE(kernel_store.ReferTBEBinary("model0_stub", kernel0));
+
+  // reload, binary is registered again.
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model0_stub", RT_DEV_BINARY_MAGIC_ELF, "", kernel0, handle), SUCCESS);
+  statistic = kernel_store.GetStatistic();
+  EXPECT_EQ(statistic.name_num, 1);
+  EXPECT_EQ(statistic.binary_num, 1);
+  EXPECT_EQ(statistic.reference_num, 1);
+
+  // binaries of same content but different magic, the one a function belongs to is unknown.
+  EXPECT_EQ(kernel_store.RegisterTBEHandle("model2_stub", RT_DEV_BINARY_MAGIC_ELF_AIVEC, "", kernel1, handle),
+            SUCCESS);
+  EXPECT_FALSE(kernel_store.ReferTBEBinary("model3_stub", kernel0));
+  kernel_store.EraseTBEHandle({{"model0_stub", 1}, {"model2_stub", 1}});
+  EXPECT_TRUE(kernel_store.binaries_.empty());
+}
+
 TEST_F(UtestTBEHandleStore, test_tbe_handle_info) {
   void *tbe_handle = (void *)0x12345678;
   std::shared_ptr<OpKernelBin> tbe_kernel = std::shared_ptr<OpKernelBin>();
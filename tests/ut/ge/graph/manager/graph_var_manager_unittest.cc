@@ -0,0 +1,107 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "graph/ge_tensor.h"
+#include "graph/utils/tensor_utils.h"
+
+#define private public
+#define protected public
+#include "graph/manager/graph_var_manager.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+const uint64_t kSessionId = 20210;
+}  // namespace
+
+class UtestGraphVarManager : public testing::Test {
+ protected:
+  void SetUp() { VarManager::Instance(kSessionId)->Init(0, kSessionId, 0, 0); }
+  void TearDown() { VarManagerPool::Instance().RemoveVarManager(kSessionId); }
+};
+
+TEST_F(UtestGraphVarManager, read_snapshot_published_and_invalidated) {
+  auto var_manager = VarManager::Instance(kSessionId);
+  GeTensorDesc tensor_desc(GeShape({1, 16}), FORMAT_ND, DT_FLOAT);
+  TensorUtils::SetSize(tensor_desc, 64);
+  ASSERT_EQ(var_manager->AssignVarMem("var", tensor_desc, RT_MEMORY_HBM), SUCCESS);
+
+  // reads never publish the snapshot by themselves
+  uint8_t *locked_addr = nullptr;
+  for (size_t i = 0; i < 128; ++i) {
+    ASSERT_EQ(var_manager->GetVarAddr("var", tensor_desc, &locked_addr), SUCCESS);
+  }
+  EXPECT_EQ(var_manager->GetReadSnapshot(), nullptr);
+  var_manager->PublishSnapshot();
+  ASSERT_NE(var_manager->GetReadSnapshot(), nullptr);
+
+  uint8_t *snapshot_addr = nullptr;
+  EXPECT_EQ(var_manager->GetVarAddr("var", tensor_desc, &snapshot_addr), SUCCESS);
+  EXPECT_EQ(snapshot_addr, locked_addr);
+  EXPECT_TRUE(var_manager->IsVarAddr(reinterpret_cast<int64_t>(locked_addr)));
+  GeTensorDesc cur_desc;
+  EXPECT_EQ(var_manager->GetCurVarDesc("var", cur_desc), SUCCESS);
+  EXPECT_EQ(cur_desc.GetShape().GetDims(), tensor_desc.GetShape().GetDims());
+  EXPECT_NE(var_manager->GetCurVarDesc("not_exist", cur_desc), SUCCESS);
+
+  // a write drops the snapshot, new variable is visible at once
+  GeTensorDesc new_desc(GeShape({4}), FORMAT_ND, DT_INT32);
+  TensorUtils::SetSize(new_desc, 16);
+  ASSERT_EQ(var_manager->AssignVarMem("new_var", new_desc, RT_MEMORY_HBM), SUCCESS);
+  EXPECT_EQ(var_manager->GetReadSnapshot(), nullptr);
+  EXPECT_TRUE(var_manager->IsVarExist("new_var", new_desc));
+}
+
+TEST_F(UtestGraphVarManager, read_snapshot_holds_lookup_maps_only) {
+  auto var_manager = VarManager::Instance(kSessionId);
+  GeTensorDesc tensor_desc(GeShape({1, 16}), FORMAT_ND, DT_FLOAT);
+  TensorUtils::SetSize(tensor_desc, 64);
+  ASSERT_EQ(var_manager->AssignVarMem("var", tensor_desc, RT_MEMORY_HBM), SUCCESS);
+  ASSERT_EQ(var_manager->SetChangedGraphId("var", 1), SUCCESS);
+  VarTransRoad trans_road(1);
+  ASSERT_EQ(var_manager->SetTransRoad("var", trans_road), SUCCESS);
+  var_manager->PublishSnapshot();
+
+  auto snapshot = var_manager->GetReadSnapshot();
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->var_addr_mgr_map_.size(), var_manager->var_resource_->var_addr_mgr_map_.size());
+  EXPECT_EQ(snapshot->var_offset_map_.size(), var_manager->var_resource_->var_offset_map_.size());
+  EXPECT_EQ(snapshot->cur_var_tensor_desc_map_.size(), var_manager->var_resource_->cur_var_tensor_desc_map_.size());
+  EXPECT_TRUE(snapshot->var_names_to_changed_graph_id_.empty());
+  EXPECT_TRUE(snapshot->var_to_trans_road_.empty());
+  // lookups not served by the snapshot still see the full resource
+  uint32_t graph_id = 0;
+  EXPECT_EQ(var_manager->GetChangedGraphId("var", graph_id), SUCCESS);
+  EXPECT_EQ(graph_id, 1);
+  EXPECT_NE(var_manager->GetTransRoad("var"), nullptr);
+}
+
+TEST_F(UtestGraphVarManager, instance_cached_until_removed) {
+  auto var_manager = VarManager::Instance(kSessionId);
+  EXPECT_EQ(VarManager::Instance(kSessionId), var_manager);
+  auto generation = VarManagerPool::Instance().generation_.load();
+  VarManagerPool::Instance().RemoveVarManager(kSessionId);
+  EXPECT_EQ(VarManagerPool::Instance().generation_.load(), generation + 1);
+  EXPECT_EQ(VarManagerPool::Instance().var_manager_map_.count(kSessionId), 0);
+  (void) VarManager::Instance(kSessionId);
+  EXPECT_EQ(VarManagerPool::Instance().var_manager_map_.count(kSessionId), 1);
+}
+}  // namespace ge
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "graph/compute_graph.h"
+#include "graph/op_desc.h"
+
+#define private public
+#define protected public
+#include "graph/manager/subgraph_optimize_scheduler.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+SubGraphInfoPtr CreateSubGraph(const std::string &name, const std::string &engine_name, size_t node_num) {
+  auto graph = std::make_shared<ComputeGraph>(name);
+  for (size_t i = 0; i < node_num; ++i) {
+    graph->AddNode(std::make_shared<OpDesc>(name + "_node_" + std::to_string(i), "Relu"));
+  }
+  auto subgraph = std::make_shared<SubGraphInfo>();
+  subgraph->SetSubGraph(graph);
+  subgraph->SetEngineName(engine_name);
+  return subgraph;
+}
+}  // namespace
+
+class UtestSubGraphOptimizeScheduler : public testing::Test {
+ protected:
+  void SetUp() { SubGraphOptimizeScheduler::Instance().Clear(); }
+  void TearDown() { SubGraphOptimizeScheduler::Instance().Clear(); }
+};
+
+TEST_F(UtestSubGraphOptimizeScheduler, sort_by_node_num_without_history) {
+  std::vector<SubGraphInfoPtr> subgraphs = {CreateSubGraph("small", "AIcoreEngine", 2),
+                                            CreateSubGraph("large", "AIcoreEngine", 8),
+                                            CreateSubGraph("middle", "AIcoreEngine", 4)};
+  SubGraphOptimizeScheduler::Instance().SortByEstimatedCost(subgraphs);
+  EXPECT_EQ(subgraphs[0]->GetSubGraph()->GetName(), "large");
+  EXPECT_EQ(subgraphs[1]->GetSubGraph()->GetName(), "middle");
+  EXPECT_EQ(subgraphs[2]->GetSubGraph()->GetName(), "small");
+}
+
+TEST_F(UtestSubGraphOptimizeScheduler, sort_by_recorded_engine_cost) {
+  auto &scheduler = SubGraphOptimizeScheduler::Instance();
+  scheduler.RecordCost("AIcoreEngine", 10, 10000);  // 1000 us per node
+  scheduler.RecordCost("DNN_VM_GE_LOCAL", 10, 100);  // 10 us per node
+  std::vector<SubGraphInfoPtr> subgraphs = {CreateSubGraph("ge_local", "DNN_VM_GE_LOCAL", 8),
+                                            CreateSubGraph("aicore", "AIcoreEngine", 2)};
+  scheduler.SortByEstimatedCost(subgraphs);
+  EXPECT_EQ(subgraphs[0]->GetSubGraph()->GetName(), "aicore");
+  EXPECT_EQ(scheduler.EstimateCost(subgraphs[0]), 2000);
+  EXPECT_EQ(scheduler.EstimateCost(subgraphs[1]), 80);
+
+  // unknown engine takes the average of known engines
+  EXPECT_EQ(scheduler.EstimateCost(CreateSubGraph("aicpu", "aicpu_kernel", 2)), 1010);
+}
+
+TEST_F(UtestSubGraphOptimizeScheduler, record_cost_moving_average) {
+  auto &scheduler = SubGraphOptimizeScheduler::Instance();
+  scheduler.RecordCost("AIcoreEngine", 1, 100);
+  scheduler.RecordCost("AIcoreEngine", 1, 300);
+  EXPECT_EQ(scheduler.EstimateCost(CreateSubGraph("aicore", "AIcoreEngine", 1)), 200);
+  scheduler.RecordCost("AIcoreEngine", 0, 1000);
+  EXPECT_EQ(scheduler.EstimateCost(CreateSubGraph("aicore", "AIcoreEngine", 1)), 200);
+}
+
+TEST_F(UtestSubGraphOptimizeScheduler, thread_pool_is_shared) {
+  auto &scheduler = SubGraphOptimizeScheduler::Instance();
+  EXPECT_EQ(&scheduler.GetThreadPool(), &scheduler.GetThreadPool());
+  auto f = scheduler.GetThreadPool().commit([]() -> Status { return SUCCESS; });
+  ASSERT_TRUE(f.valid());
+  EXPECT_EQ(f.get(), SUCCESS);
+}
+}  // namespace ge
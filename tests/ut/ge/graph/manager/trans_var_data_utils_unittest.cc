@@ -0,0 +1,79 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "graph/ge_tensor.h"
+#include "graph/utils/tensor_utils.h"
+
+#define private public
+#define protected public
+#include "graph/manager/graph_var_manager.h"
+#include "graph/manager/trans_var_data_utils.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+const uint64_t kSessionId = 20211;
+
+GeTensorDesc CreateTensorDesc(int64_t size) {
+  GeTensorDesc tensor_desc(GeShape({size / 4}), FORMAT_ND, DT_FLOAT);
+  TensorUtils::SetSize(tensor_desc, size);
+  return tensor_desc;
+}
+}  // namespace
+
+class UtestTransVarDataUtils : public testing::Test {
+ protected:
+  void SetUp() { VarManager::Instance(kSessionId)->Init(0, kSessionId, 0, 0); }
+  void TearDown() { VarManagerPool::Instance().RemoveVarManager(kSessionId); }
+};
+
+TEST_F(UtestTransVarDataUtils, reserved_size_of_var) {
+  EXPECT_EQ(TransVarDataUtils::CalcVarReservedSize(CreateTensorDesc(0)), 1024);
+  EXPECT_EQ(TransVarDataUtils::CalcVarReservedSize(CreateTensorDesc(4)), 512 + 1024);
+  EXPECT_EQ(TransVarDataUtils::CalcVarReservedSize(CreateTensorDesc(512)), 512 + 1024);
+  EXPECT_EQ(TransVarDataUtils::CalcVarReservedSize(CreateTensorDesc(516)), 1024 + 1024);
+}
+
+TEST_F(UtestTransVarDataUtils, merge_vars_assigned_in_turn) {
+  auto var_manager = VarManager::Instance(kSessionId);
+  auto desc1 = CreateTensorDesc(100);
+  auto desc2 = CreateTensorDesc(2048);
+  auto desc3 = CreateTensorDesc(64);
+  ASSERT_EQ(var_manager->AssignVarMem("var1", desc1, RT_MEMORY_HBM), SUCCESS);
+  ASSERT_EQ(var_manager->AssignVarMem("var2", desc2, RT_MEMORY_HBM), SUCCESS);
+  ASSERT_EQ(var_manager->AssignVarMem("var3", desc3, RT_MEMORY_HBM), SUCCESS);
+
+  uint8_t *addr1 = nullptr;
+  uint8_t *addr2 = nullptr;
+  uint8_t *addr3 = nullptr;
+  ASSERT_EQ(var_manager->GetVarAddr("var1", desc1, &addr1), SUCCESS);
+  ASSERT_EQ(var_manager->GetVarAddr("var2", desc2, &addr2), SUCCESS);
+  ASSERT_EQ(var_manager->GetVarAddr("var3", desc3, &addr3), SUCCESS);
+
+  // gap after data of var1 is far larger than one padding unit, still no var lies in it
+  EXPECT_GT(addr2 - (addr1 + 100), 1024);
+  EXPECT_TRUE(TransVarDataUtils::IsAdjacentVarMem(addr1, TransVarDataUtils::CalcVarReservedSize(desc1), addr2));
+  EXPECT_TRUE(TransVarDataUtils::IsAdjacentVarMem(addr2, TransVarDataUtils::CalcVarReservedSize(desc2), addr3));
+  // var2 lies between var1 and var3
+  EXPECT_FALSE(TransVarDataUtils::IsAdjacentVarMem(addr1, TransVarDataUtils::CalcVarReservedSize(desc1), addr3));
+  EXPECT_FALSE(TransVarDataUtils::IsAdjacentVarMem(addr2, TransVarDataUtils::CalcVarReservedSize(desc2), addr1));
+  EXPECT_FALSE(TransVarDataUtils::IsAdjacentVarMem(addr1, -1, addr2));
+}
+}  // namespace ge
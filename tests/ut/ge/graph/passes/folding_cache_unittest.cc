@@ -0,0 +1,150 @@
+/**
+ * Copyright 2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/common/folding_cache.h"
+
+#include "common/types.h"
+#include "graph_builder_utils.h"
+
+namespace ge {
+class UtestFoldingCache : public testing::Test {
+ protected:
+  void SetUp() {
+    FoldingCache::Instance().Clear();
+    FoldingCache::Instance().SetMemoryBudget(kBudget);
+  }
+  void TearDown() { FoldingCache::Instance().Clear(); }
+
+  // keys hold the op text and input data, leave room for them
+  const uint64_t kBudget = 4096;
+};
+
+namespace {
+ConstGeTensorPtr MakeTensor(const std::vector<uint8_t> &data) {
+  GeTensorDesc tensor_desc(GeShape({static_cast<int64_t>(data.size())}), FORMAT_ND, DT_UINT8);
+  return std::make_shared<GeTensor>(tensor_desc, data.data(), data.size());
+}
+
+NodePtr MakeAddNode(ut::GraphBuilder &builder, const std::string &name) {
+  return builder.AddNode(name, ADD, 2, 1);
+}
+}  // namespace
+
+TEST_F(UtestFoldingCache, same_fold_in_different_graphs_hit) {
+  ut::GraphBuilder builder1("g1");
+  ut::GraphBuilder builder2("g2");
+  auto add1 = MakeAddNode(builder1, "add1");
+  auto add2 = MakeAddNode(builder2, "add2");
+  std::vector<ConstGeTensorPtr> inputs = {MakeTensor({1, 2}), MakeTensor({3, 4})};
+
+  std::string key1;
+  std::string key2;
+  EXPECT_EQ(FoldingCache::Instance().GenerateKey(add1, inputs, key1), SUCCESS);
+  EXPECT_EQ(FoldingCache::Instance().GenerateKey(add2, inputs, key2), SUCCESS);
+  EXPECT_EQ(key1, key2);
+
+  std::vector<GeTensorPtr> outputs;
+  EXPECT_FALSE(FoldingCache::Instance().Lookup(key1, outputs));
+  GeTensorDesc out_desc(GeShape({2}), FORMAT_ND, DT_UINT8);
+  std::vector<uint8_t> result = {4, 6};
+  outputs.emplace_back(std::make_shared<GeTensor>(out_desc, result.data(), result.size()));
+  FoldingCache::Instance().Insert(key1, outputs);
+
+  std::vector<GeTensorPtr> cached;
+  EXPECT_TRUE(FoldingCache::Instance().Lookup(key2, cached));
+  ASSERT_EQ(cached.size(), 1);
+  EXPECT_NE(cached[0], outputs[0]);
+  EXPECT_EQ(cached[0]->GetData().size(), result.size());
+  EXPECT_EQ(cached[0]->GetData().data()[1], 6);
+
+  auto statistic = FoldingCache::Instance().GetStatistic();
+  EXPECT_EQ(statistic.hit_count, 1);
+  EXPECT_EQ(statistic.miss_count, 1);
+  EXPECT_EQ(statistic.entry_count, 1);
+}
+
+TEST_F(UtestFoldingCache, different_input_data_miss) {
+  ut::GraphBuilder builder("g");
+  auto add = MakeAddNode(builder, "add");
+  std::string key1;
+  std::string key2;
+  EXPECT_EQ(FoldingCache::Instance().GenerateKey(add, {MakeTensor({1, 2}), MakeTensor({3, 4})}, key1), SUCCESS);
+  EXPECT_EQ(FoldingCache::Instance().GenerateKey(add, {MakeTensor({1, 2}), MakeTensor({3, 5})}, key2), SUCCESS);
+  EXPECT_NE(key1, key2);
+}
+
+TEST_F(UtestFoldingCache, evict_when_exceed_budget) {
+  // two entries of 32 bytes data and 4 bytes key fit
+  const uint64_t budget = 80;
+  FoldingCache::Instance().SetMemoryBudget(budget);
+  GeTensorDesc out_desc(GeShape({32}), FORMAT_ND, DT_UINT8);
+  std::vector<uint8_t> result(32, 1);
+  std::vector<GeTensorPtr> outputs = {std::make_shared<GeTensor>(out_desc, result.data(), result.size())};
+  FoldingCache::Instance().Insert("key1", outputs);
+  FoldingCache::Instance().Insert("key2", outputs);
+  FoldingCache::Instance().Insert("key3", outputs);
+
+  auto statistic = FoldingCache::Instance().GetStatistic();
+  EXPECT_EQ(statistic.entry_count, 2);
+  EXPECT_EQ(statistic.evict_count, 1);
+  EXPECT_LE(statistic.cached_size, budget);
+  std::vector<GeTensorPtr> cached;
+  EXPECT_FALSE(FoldingCache::Instance().Lookup("key1", cached));
+  EXPECT_TRUE(FoldingCache::Instance().Lookup("key3", cached));
+}
+
+TEST_F(UtestFoldingCache, key_holds_input_data) {
+  ut::GraphBuilder builder("g");
+  auto add = MakeAddNode(builder, "add");
+  std::vector<uint8_t> data(256, 1);
+  std::string key1;
+  std::string key2;
+  EXPECT_EQ(FoldingCache::Instance().GenerateKey(add, {MakeTensor(data)}, key1), SUCCESS);
+  data[255] = 2;
+  EXPECT_EQ(FoldingCache::Instance().GenerateKey(add, {MakeTensor(data)}, key2), SUCCESS);
+  EXPECT_GT(key1.size(), data.size());
+  EXPECT_EQ(key1.size(), key2.size());
+  EXPECT_NE(key1, key2);
+
+  GeTensorDesc out_desc(GeShape({1}), FORMAT_ND, DT_UINT8);
+  std::vector<uint8_t> result = {1};
+  std::vector<GeTensorPtr> outputs = {std::make_shared<GeTensor>(out_desc, result.data(), result.size())};
+  FoldingCache::Instance().Insert(key1, outputs);
+  std::vector<GeTensorPtr> cached;
+  EXPECT_FALSE(FoldingCache::Instance().Lookup(key2, cached));
+  EXPECT_TRUE(FoldingCache::Instance().Lookup(key1, cached));
+}
+
+TEST_F(UtestFoldingCache, skip_when_key_exceeds_budget) {
+  ut::GraphBuilder builder("g");
+  auto add = MakeAddNode(builder, "add");
+  std::string key;
+  EXPECT_NE(FoldingCache::Instance().GenerateKey(add, {MakeTensor(std::vector<uint8_t>(kBudget, 1))}, key),
+            SUCCESS);
+  EXPECT_TRUE(key.empty());
+}
+
+TEST_F(UtestFoldingCache, disabled_when_budget_is_zero) {
+  FoldingCache::Instance().SetMemoryBudget(0);
+  ut::GraphBuilder builder("g");
+  auto add = MakeAddNode(builder, "add");
+  std::string key;
+  EXPECT_NE(FoldingCache::Instance().GenerateKey(add, {MakeTensor({1})}, key), SUCCESS);
+  EXPECT_TRUE(key.empty());
+}
+}  // namespace ge
@@ -0,0 +1,265 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <map>
+#include <set>
+
+#include "common/types.h"
+#include "graph/debug/ge_attr_define.h"
+#include "graph/passes/graph_builder_utils.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+
+#define private public
+#define protected public
+#include "graph/preprocess/multi_batch_branch_cloner.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace multibatch {
+class UtestMultiBatchBranchCloner : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+namespace {
+const char *const kPostfix = "_ascend_mbatch_batch_";
+const size_t kBatchNum = 3;
+
+struct BranchGraph {
+  ComputeGraphPtr graph;
+  NodePtr data;
+  NodePtr switchn;
+  std::vector<NodePtr> branch_nodes;
+};
+
+///      data    const
+///       |  \     :
+///  switchn  \   conv <--- const(data edge)
+///             \  |
+///              relu
+/// conv and relu are in batch branch, data edges from data are fed by switchn after copy.
+BranchGraph BuildBranchGraph() {
+  ut::GraphBuilder builder("g");
+  auto data = builder.AddNode("data", DATA, 1, 1);
+  auto weight = builder.AddNode("weight", CONSTANT, 0, 1);
+  auto switchn = builder.AddNode("switchn", SWITCHN, 2, kBatchNum);
+  auto conv = builder.AddNode("conv", CONV2D, 2, 1);
+  auto relu = builder.AddNode("relu", RELU, 2, 1);
+  builder.AddDataEdge(data, 0, switchn, 0);
+  builder.AddDataEdge(data, 0, conv, 0);
+  builder.AddDataEdge(weight, 0, conv, 1);
+  builder.AddDataEdge(conv, 0, relu, 0);
+  builder.AddDataEdge(data, 0, relu, 1);
+  builder.AddControlEdge(weight, conv);
+  builder.AddControlEdge(data, relu);
+  builder.AddControlEdge(conv, relu);
+
+  BranchGraph branch_graph;
+  branch_graph.graph = builder.GetGraph();
+  branch_graph.data = data;
+  branch_graph.switchn = switchn;
+  branch_graph.branch_nodes = {conv, relu};
+  return branch_graph;
+}
+
+// name -> type, batch label and in edges, comparable between graphs built in different ways
+std::map<std::string, std::string> DescribeGraph(const ComputeGraphPtr &graph) {
+  std::map<std::string, std::string> description;
+  for (const auto &node : graph->GetDirectNode()) {
+    std::string text = node->GetType() + ";";
+    std::string batch_label;
+    (void)AttrUtils::GetStr(node->GetOpDesc(), ATTR_NAME_BATCH_LABEL, batch_label);
+    text += batch_label + ";";
+    for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+      auto src_anchor = in_anchor->GetPeerOutAnchor();
+      if (src_anchor != nullptr) {
+        text += std::to_string(in_anchor->GetIdx()) + "<-" + src_anchor->GetOwnerNode()->GetName() + ":" +
+                std::to_string(src_anchor->GetIdx()) + ",";
+      }
+    }
+    std::set<std::string> ctrl_srcs;
+    for (const auto &src_node : node->GetInControlNodes()) {
+      ctrl_srcs.insert(src_node->GetName());
+    }
+    for (const auto &src_name : ctrl_srcs) {
+      text += "^" + src_name + ",";
+    }
+    description[node->GetName()] = text;
+  }
+  return description;
+}
+
+// Copy of branch as done by MultiBatchGraphCopyer before BranchCloner: InsertCopyNode for every gear,
+// then CopyInDataEdges and CopyInControlEdges for every gear.
+void LegacyCopyBranch(const BranchGraph &branch_graph) {
+  std::map<const Node *, std::vector<NodePtr>> nodes_to_batch_nodes;
+  for (const auto &node : branch_graph.branch_nodes) {
+    for (size_t i = 0; i < kBatchNum; ++i) {
+      auto desc = AttrUtils::CopyOpDesc(node->GetOpDesc());
+      desc->SetName(node->GetName() + kPostfix + std::to_string(i));
+      desc->CopyAttrsFrom(*node->GetOpDesc());
+      (void)AttrUtils::SetStr(desc, ATTR_NAME_BATCH_LABEL, "Batch_" + std::to_string(i));
+      nodes_to_batch_nodes[node.get()].emplace_back(branch_graph.graph->AddNode(desc));
+    }
+  }
+  for (const auto &node : branch_graph.branch_nodes) {
+    for (size_t i = 0; i < kBatchNum; ++i) {
+      const auto &copyed_node = nodes_to_batch_nodes[node.get()][i];
+      for (const auto &in_anchor : node->GetAllInDataAnchors()) {
+        auto src_anchor = in_anchor->GetPeerOutAnchor();
+        auto src_node = src_anchor->GetOwnerNode();
+        auto dst_anchor = copyed_node->GetInDataAnchor(in_anchor->GetIdx());
+        if (src_node == branch_graph.data) {
+          (void)GraphUtils::AddEdge(branch_graph.switchn->GetOutDataAnchor(i), dst_anchor);
+        } else if (nodes_to_batch_nodes.count(src_node.get()) > 0) {
+          (void)GraphUtils::AddEdge(nodes_to_batch_nodes[src_node.get()][i]->GetOutDataAnchor(src_anchor->GetIdx()),
+                                    dst_anchor);
+        } else {
+          (void)GraphUtils::AddEdge(src_anchor, dst_anchor);
+        }
+      }
+      for (const auto &src_node : node->GetInControlNodes()) {
+        NodePtr copy_src = src_node;
+        if (src_node == branch_graph.data) {
+          copy_src = branch_graph.switchn;
+        } else if (nodes_to_batch_nodes.count(src_node.get()) > 0) {
+          copy_src = nodes_to_batch_nodes[src_node.get()][i];
+        }
+        (void)GraphUtils::AddEdge(copy_src->GetOutControlAnchor(), copyed_node->GetInControlAnchor());
+      }
+    }
+  }
+}
+
+Status ClonerCopyBranch(const BranchGraph &branch_graph) {
+  BranchCloner cloner(kBatchNum, kPostfix);
+  cloner.SetCopyDecorator([](const NodePtr &origin, const OpDescPtr &copy_desc, size_t batch_index) {
+    (void)AttrUtils::SetStr(copy_desc, ATTR_NAME_BATCH_LABEL, "Batch_" + std::to_string(batch_index));
+    return SUCCESS;
+  });
+  GE_CHK_STATUS_RET(cloner.Init(branch_graph.branch_nodes));
+  for (const auto &node : branch_graph.branch_nodes) {
+    std::vector<NodePtr> copies;
+    GE_CHK_STATUS_RET(cloner.CloneNodeForAllBatches(node, copies));
+    if (copies.size() != kBatchNum) {
+      return FAILED;
+    }
+  }
+  size_t resolve_times = 0;
+  auto data_resolver = [&](const OutDataAnchorPtr &origin_src, const NodePtr &origin_dst,
+                           std::vector<OutDataAnchorPtr> &batch_srcs) -> Status {
+    ++resolve_times;
+    if (origin_src->GetOwnerNode() != branch_graph.data) {
+      batch_srcs.emplace_back(origin_src);
+      return SUCCESS;
+    }
+    for (size_t i = 0; i < kBatchNum; ++i) {
+      batch_srcs.emplace_back(branch_graph.switchn->GetOutDataAnchor(static_cast<int>(i)));
+    }
+    return SUCCESS;
+  };
+  auto ctrl_resolver = [&](const NodePtr &origin_src) -> NodePtr {
+    return (origin_src == branch_graph.data) ? branch_graph.switchn : origin_src;
+  };
+  for (const auto &node : branch_graph.branch_nodes) {
+    GE_CHK_STATUS_RET(cloner.LinkNodeForAllBatches(node, data_resolver, ctrl_resolver));
+  }
+  // external edges data->conv, weight->conv and data->relu are resolved once, not once per gear
+  return (resolve_times == 3) ? SUCCESS : FAILED;
+}
+}  // namespace
+
+TEST_F(UtestMultiBatchBranchCloner, copy_in_graph_same_as_legacy_copy) {
+  auto legacy = BuildBranchGraph();
+  LegacyCopyBranch(legacy);
+  auto cloned = BuildBranchGraph();
+  EXPECT_EQ(ClonerCopyBranch(cloned), SUCCESS);
+
+  auto legacy_description = DescribeGraph(legacy.graph);
+  auto cloned_description = DescribeGraph(cloned.graph);
+  EXPECT_EQ(legacy_description.size(), 5 + 2 * kBatchNum);
+  EXPECT_EQ(cloned_description, legacy_description);
+  EXPECT_EQ(cloned_description["relu_ascend_mbatch_batch_2"], legacy_description["relu_ascend_mbatch_batch_2"]);
+}
+
+TEST_F(UtestMultiBatchBranchCloner, clone_graph_same_as_graph_utils) {
+  auto branch_graph = BuildBranchGraph();
+  const auto &graph = branch_graph.graph;
+  (void)AttrUtils::SetStr(*graph, ATTR_NAME_SESSION_GRAPH_ID, "0_1");
+  std::vector<NodePtr> all_nodes;
+  for (const auto &node : graph->GetDirectNode()) {
+    all_nodes.emplace_back(node);
+  }
+  BranchCloner cloner(kBatchNum, kPostfix);
+  EXPECT_EQ(cloner.Init(all_nodes), SUCCESS);
+
+  for (size_t i = 1; i < kBatchNum; ++i) {
+    std::vector<NodePtr> legacy_inputs;
+    std::vector<NodePtr> legacy_outputs;
+    auto legacy = GraphUtils::CloneGraph(graph, kPostfix + std::to_string(i), legacy_inputs, legacy_outputs);
+    ASSERT_NE(legacy, nullptr);
+
+    std::vector<NodePtr> inputs;
+    std::vector<NodePtr> outputs;
+    auto cloned = cloner.CloneGraph(graph, i, inputs, outputs);
+    ASSERT_NE(cloned, nullptr);
+    EXPECT_EQ(DescribeGraph(cloned), DescribeGraph(legacy));
+    ASSERT_EQ(inputs.size(), legacy_inputs.size());
+    EXPECT_EQ(inputs[0]->GetName(), legacy_inputs[0]->GetName());
+    EXPECT_EQ(outputs.size(), legacy_outputs.size());
+
+    std::string session_graph_id;
+    EXPECT_TRUE(AttrUtils::GetStr(*cloned, ATTR_NAME_SESSION_GRAPH_ID, session_graph_id));
+    EXPECT_EQ(session_graph_id, "0_1");
+  }
+
+  std::vector<NodePtr> inputs;
+  std::vector<NodePtr> outputs;
+  EXPECT_EQ(cloner.CloneGraph(graph, kBatchNum, inputs, outputs), nullptr);
+}
+
+TEST_F(UtestMultiBatchBranchCloner, node_out_of_branch_failed) {
+  auto branch_graph = BuildBranchGraph();
+  BranchCloner cloner(kBatchNum, kPostfix);
+  EXPECT_EQ(cloner.Init(branch_graph.branch_nodes), SUCCESS);
+  EXPECT_TRUE(cloner.IsInBranch(branch_graph.branch_nodes[0]));
+  EXPECT_FALSE(cloner.IsInBranch(branch_graph.data));
+
+  std::vector<NodePtr> copies;
+  EXPECT_NE(cloner.CloneNodeForAllBatches(branch_graph.data, copies), SUCCESS);
+  EXPECT_NE(cloner.LinkNodeForAllBatches(branch_graph.data, nullptr, nullptr), SUCCESS);
+}
+
+TEST_F(UtestMultiBatchBranchCloner, resolved_sources_mismatch_batch_num_failed) {
+  auto branch_graph = BuildBranchGraph();
+  BranchCloner cloner(kBatchNum, kPostfix);
+  EXPECT_EQ(cloner.Init(branch_graph.branch_nodes), SUCCESS);
+  std::vector<NodePtr> copies;
+  EXPECT_EQ(cloner.CloneNodeForAllBatches(branch_graph.branch_nodes[0], copies), SUCCESS);
+  auto data_resolver = [&](const OutDataAnchorPtr &origin_src, const NodePtr &origin_dst,
+                           std::vector<OutDataAnchorPtr> &batch_srcs) -> Status {
+    batch_srcs = {origin_src, origin_src};
+    return SUCCESS;
+  };
+  EXPECT_NE(cloner.LinkNodeForAllBatches(branch_graph.branch_nodes[0], data_resolver, nullptr), SUCCESS);
+}
+}  // namespace multibatch
+}  // namespace ge
@@ -0,0 +1,178 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "graph/manager/graph_mem_allocator.h"
+#include "runtime/mem.h"
+
+#define private public
+#define protected public
+#include "hybrid/common/memory_arena.h"
+#include "hybrid/common/npu_memory_allocator.h"
+#include "hybrid/common/tensor_value.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestMemoryArena : public testing::Test {
+ protected:
+  void SetUp() {
+    MemManager::Instance().Initialize(std::vector<rtMemType_t>({RT_MEMORY_HBM}));
+    allocator_ = NpuMemoryAllocator::GetAllocator(0);
+  }
+  void TearDown() {
+    NpuMemoryAllocator::DestroyAllocator();
+    MemManager::Instance().Finalize();
+  }
+
+  NpuMemoryAllocator *allocator_ = nullptr;
+};
+
+namespace {
+const size_t kChunkSize = 4096;
+}  // namespace
+
+TEST_F(UtestMemoryArena, release_padded_size_of_allocation) {
+  MemoryArena arena(allocator_, kChunkSize);
+  auto addr1 = arena.Allocate(100);
+  auto addr2 = arena.Allocate(1);
+  ASSERT_NE(addr1, nullptr);
+  ASSERT_NE(addr2, nullptr);
+  EXPECT_TRUE(arena.Contains(addr1));
+  EXPECT_TRUE(arena.Contains(addr2));
+  // padded to 32 with an extra padding unit
+  EXPECT_EQ(static_cast<uint8_t *>(addr2) - static_cast<uint8_t *>(addr1), 160);
+  EXPECT_EQ(arena.live_size_, 160 + 64);
+
+  arena.Release(addr2);
+  EXPECT_EQ(arena.live_size_, 160);
+  // double release or unknown address is ignored
+  arena.Release(addr2);
+  arena.Release(nullptr);
+  EXPECT_EQ(arena.live_size_, 160);
+  arena.Release(addr1);
+  EXPECT_EQ(arena.live_size_, 0);
+
+  auto statistic = arena.GetStatistic();
+  EXPECT_EQ(statistic.used_size, 160 + 64);
+  EXPECT_EQ(statistic.peak_live_size, 160 + 64);
+  EXPECT_EQ(statistic.alloc_count, 2);
+  EXPECT_EQ(statistic.reserved_size, kChunkSize);
+}
+
+TEST_F(UtestMemoryArena, reset_after_all_released) {
+  MemoryArena arena(allocator_, kChunkSize);
+  auto addr1 = arena.Allocate(kChunkSize / 2);
+  auto addr2 = arena.Allocate(kChunkSize);
+  ASSERT_NE(addr1, nullptr);
+  ASSERT_NE(addr2, nullptr);
+  EXPECT_EQ(arena.chunks_.size(), 2);
+
+  // chunk of addr2 is still referenced and retired, the other one is reclaimed
+  arena.Release(addr1);
+  arena.Reset();
+  EXPECT_EQ(arena.chunks_.size(), 1);
+  EXPECT_EQ(arena.retired_chunks_.size(), 1);
+  EXPECT_TRUE(arena.Contains(addr2));
+  EXPECT_EQ(arena.GetStatistic().alloc_count, 0);
+  EXPECT_EQ(arena.GetStatistic().peak_live_size, arena.live_size_);
+
+  // retired chunk is freed with its last allocation
+  arena.Release(addr2);
+  EXPECT_TRUE(arena.retired_chunks_.empty());
+  EXPECT_FALSE(arena.Contains(addr2));
+  arena.Reset();
+  // chunks merged into one
+  EXPECT_EQ(arena.chunks_.size(), 1);
+  auto statistic = arena.GetStatistic();
+  EXPECT_EQ(statistic.used_size, 0);
+  EXPECT_EQ(statistic.peak_live_size, 0);
+  EXPECT_EQ(statistic.alloc_count, 0);
+  EXPECT_GE(statistic.reserved_size, kChunkSize / 2 + kChunkSize);
+
+  // steady iteration served by the merged chunk
+  addr1 = arena.Allocate(kChunkSize / 2);
+  addr2 = arena.Allocate(kChunkSize);
+  EXPECT_EQ(arena.chunks_.size(), 1);
+  EXPECT_EQ(addr1, arena.chunks_[0].base);
+  arena.Release(addr1);
+  arena.Release(addr2);
+  EXPECT_EQ(arena.live_size_, 0);
+}
+
+TEST_F(UtestMemoryArena, footprint_bounded_with_live_tensor) {
+  MemoryArena arena(allocator_, kChunkSize);
+  // allocated in the first iteration and kept through all of them
+  auto persistent = arena.Allocate(100);
+  ASSERT_NE(persistent, nullptr);
+  arena.Reset();
+  size_t reserved_size = 0;
+  const int kIterations = 1000;
+  for (int i = 0; i < kIterations; ++i) {
+    std::vector<void *> addrs;
+    for (int j = 0; j < 8; ++j) {
+      addrs.emplace_back(arena.Allocate(kChunkSize / 4));
+      ASSERT_NE(addrs.back(), nullptr);
+    }
+    for (auto addr : addrs) {
+      arena.Release(addr);
+    }
+    arena.Reset();
+    auto statistic = arena.GetStatistic();
+    if (i == 0) {
+      reserved_size = statistic.reserved_size;
+    }
+    EXPECT_EQ(statistic.reserved_size, reserved_size);
+    EXPECT_EQ(arena.chunks_.size(), 1);
+    EXPECT_EQ(arena.retired_chunks_.size(), 1);
+  }
+  EXPECT_EQ(arena.GetStatistic().retired_size, kChunkSize);
+  EXPECT_LE(reserved_size, kChunkSize * 5);
+  EXPECT_TRUE(arena.Contains(persistent));
+
+  arena.Release(persistent);
+  EXPECT_TRUE(arena.retired_chunks_.empty());
+  EXPECT_EQ(arena.live_size_, 0);
+}
+
+TEST_F(UtestMemoryArena, tensor_buffer_from_arena) {
+  MemoryArena arena(allocator_, kChunkSize);
+  {
+    auto buffer = TensorBuffer::Create(&arena, 100);
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_TRUE(arena.Contains(buffer->GetData()));
+    EXPECT_EQ(buffer->GetSize(), 100);
+    EXPECT_EQ(arena.live_size_, 160);
+  }
+  EXPECT_EQ(arena.live_size_, 0);
+  arena.Reset();
+  EXPECT_EQ(arena.GetStatistic().used_size, 0);
+}
+
+TEST_F(UtestMemoryArena, allocate_failed) {
+  MemoryArena arena(allocator_, kChunkSize);
+  EXPECT_EQ(arena.Allocate(0), nullptr);
+  // exceeds max HBM size, caller falls back to allocator
+  EXPECT_EQ(arena.Allocate(1024UL * 1024UL * 1024UL * 1024UL + 1), nullptr);
+  EXPECT_TRUE(arena.chunks_.empty());
+  EXPECT_EQ(arena.live_size_, 0);
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,196 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+#include "runtime/mem.h"
+#include "runtime/rt.h"
+
+#define private public
+#define protected public
+#include "hybrid/common/pinned_host_memory_pool.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestPinnedHostMemoryPool : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+namespace {
+const size_t kMaxIdleSize = 1024 * 1024;
+const size_t kOutputNum = 8;
+const int kWarmUpRequestNum = 10;
+const int kRequestNum = 2000;
+
+// sizes of outputs of one request, varying within the same size classes across requests
+std::vector<size_t> GetOutputSizes(int request_index) {
+  std::vector<size_t> output_sizes;
+  for (size_t i = 0; i < kOutputNum; ++i) {
+    output_sizes.emplace_back(((i + 1) * 8192) - static_cast<size_t>(request_index % 64));
+  }
+  return output_sizes;
+}
+
+// acquire, async D2H copy, one sync and release, same as outputs staged by HybridModelAsyncExecutor
+void StageRequest(PinnedHostMemoryPool &pool, rtStream_t stream, uint8_t *device_data, int request_index) {
+  std::vector<uint8_t *> buffers;
+  for (auto size : GetOutputSizes(request_index)) {
+    auto buffer = pool.Acquire(size);
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ(rtMemcpyAsync(buffer, size, device_data, size, RT_MEMCPY_DEVICE_TO_HOST, stream), RT_ERROR_NONE);
+    buffers.emplace_back(buffer);
+  }
+  ASSERT_EQ(rtStreamSynchronize(stream), RT_ERROR_NONE);
+  for (auto buffer : buffers) {
+    pool.Release(buffer);
+  }
+}
+
+// pinned buffers allocated and freed per request, without pooling
+void StageRequestUnpooled(rtStream_t stream, uint8_t *device_data, int request_index) {
+  std::vector<void *> buffers;
+  for (auto size : GetOutputSizes(request_index)) {
+    void *buffer = nullptr;
+    ASSERT_EQ(rtMallocHost(&buffer, size), RT_ERROR_NONE);
+    ASSERT_EQ(rtMemcpyAsync(buffer, size, device_data, size, RT_MEMCPY_DEVICE_TO_HOST, stream), RT_ERROR_NONE);
+    buffers.emplace_back(buffer);
+  }
+  ASSERT_EQ(rtStreamSynchronize(stream), RT_ERROR_NONE);
+  for (auto buffer : buffers) {
+    ASSERT_EQ(rtFreeHost(buffer), RT_ERROR_NONE);
+  }
+}
+}  // namespace
+
+TEST_F(UtestPinnedHostMemoryPool, reuse_buffer_of_same_size_class) {
+  PinnedHostMemoryPool pool(kMaxIdleSize);
+  auto buffer1 = pool.Acquire(100);
+  ASSERT_NE(buffer1, nullptr);
+  pool.Release(buffer1);
+  EXPECT_EQ(pool.GetStatistic().idle_size, 4096);
+
+  // 4096 falls in the same size class as 100
+  auto buffer2 = pool.Acquire(4096);
+  EXPECT_EQ(buffer2, buffer1);
+  // 4097 needs the next size class
+  auto buffer3 = pool.Acquire(4097);
+  ASSERT_NE(buffer3, nullptr);
+  EXPECT_NE(buffer3, buffer1);
+  EXPECT_EQ(pool.in_use_buffers_[buffer3], 8192);
+
+  auto statistic = pool.GetStatistic();
+  EXPECT_EQ(statistic.acquire_count, 3);
+  EXPECT_EQ(statistic.alloc_count, 2);
+  EXPECT_EQ(statistic.in_use_count, 2);
+  EXPECT_EQ(statistic.idle_size, 0);
+
+  pool.Release(buffer2);
+  pool.Release(buffer3);
+  statistic = pool.GetStatistic();
+  EXPECT_EQ(statistic.in_use_count, 0);
+  EXPECT_EQ(statistic.idle_size, 4096 + 8192);
+}
+
+TEST_F(UtestPinnedHostMemoryPool, free_buffer_above_max_idle_size) {
+  PinnedHostMemoryPool pool(8192);
+  auto buffer1 = pool.Acquire(8192);
+  auto buffer2 = pool.Acquire(4096);
+  auto buffer3 = pool.Acquire(4096);
+  ASSERT_NE(buffer1, nullptr);
+  ASSERT_NE(buffer2, nullptr);
+  ASSERT_NE(buffer3, nullptr);
+
+  pool.Release(buffer1);
+  EXPECT_EQ(pool.GetStatistic().idle_size, 8192);
+  // freed instead of kept, as the idle bound is reached
+  pool.Release(buffer2);
+  pool.Release(buffer3);
+  auto statistic = pool.GetStatistic();
+  EXPECT_EQ(statistic.idle_size, 8192);
+  EXPECT_EQ(statistic.in_use_count, 0);
+  EXPECT_TRUE(pool.idle_buffers_[4096].empty());
+
+  // freed buffers are allocated again
+  auto buffer4 = pool.Acquire(4096);
+  ASSERT_NE(buffer4, nullptr);
+  EXPECT_EQ(pool.GetStatistic().alloc_count, 4);
+  pool.Release(buffer4);
+}
+
+TEST_F(UtestPinnedHostMemoryPool, ignore_release_of_unknown_buffer) {
+  PinnedHostMemoryPool pool(kMaxIdleSize);
+  uint8_t unknown_buffer[16] = {0};
+  pool.Release(unknown_buffer);
+  pool.Release(nullptr);
+
+  auto buffer = pool.Acquire(16);
+  ASSERT_NE(buffer, nullptr);
+  pool.Release(buffer);
+  // double release is ignored as well
+  pool.Release(buffer);
+  auto statistic = pool.GetStatistic();
+  EXPECT_EQ(statistic.idle_size, 4096);
+  EXPECT_EQ(statistic.in_use_count, 0);
+  EXPECT_EQ(pool.idle_buffers_[4096].size(), 1);
+}
+
+TEST_F(UtestPinnedHostMemoryPool, staging_throughput_on_stub_runtime) {
+  rtStream_t stream = nullptr;
+  ASSERT_EQ(rtStreamCreate(&stream, 0), RT_ERROR_NONE);
+  std::vector<uint8_t> device_data(kOutputNum * 8192);
+
+  PinnedHostMemoryPool pool(kMaxIdleSize);
+  for (int i = 0; i < kWarmUpRequestNum; ++i) {
+    StageRequest(pool, stream, device_data.data(), i);
+  }
+  auto alloc_count_after_warm_up = pool.GetStatistic().alloc_count;
+  EXPECT_EQ(alloc_count_after_warm_up, kOutputNum);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRequestNum; ++i) {
+    StageRequest(pool, stream, device_data.data(), i);
+  }
+  auto pooled_cost = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRequestNum; ++i) {
+    StageRequestUnpooled(stream, device_data.data(), i);
+  }
+  auto unpooled_cost = std::chrono::steady_clock::now() - start;
+
+  // no more pinned allocation once warmed up, every buffer is returned to the pool
+  auto statistic = pool.GetStatistic();
+  EXPECT_EQ(statistic.alloc_count, alloc_count_after_warm_up);
+  EXPECT_EQ(statistic.acquire_count, (kWarmUpRequestNum + kRequestNum) * kOutputNum);
+  EXPECT_EQ(statistic.in_use_count, 0);
+  EXPECT_LE(statistic.idle_size, kMaxIdleSize);
+
+  auto pooled_us = std::chrono::duration_cast<std::chrono::microseconds>(pooled_cost).count();
+  auto unpooled_us = std::chrono::duration_cast<std::chrono::microseconds>(unpooled_cost).count();
+  RecordProperty("request_num", kRequestNum);
+  RecordProperty("pooled_requests_per_ms", static_cast<int>(kRequestNum * 1000 / (pooled_us + 1)));
+  RecordProperty("unpooled_requests_per_ms", static_cast<int>(kRequestNum * 1000 / (unpooled_us + 1)));
+  ASSERT_EQ(rtStreamDestroy(stream), RT_ERROR_NONE);
+}
+}  // namespace hybrid
+}  // namespace ge
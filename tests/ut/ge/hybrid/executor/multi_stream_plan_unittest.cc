@@ -0,0 +1,212 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "common/types.h"
+#include "graph/passes/graph_builder_utils.h"
+
+#define private public
+#define protected public
+#include "hybrid/executor/multi_stream_plan.h"
+#include "hybrid/model/graph_item.h"
+#include "hybrid/model/node_item.h"
+#include "hybrid/node_executor/node_executor.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+namespace {
+const char *const kEngineNameAiCore = "AIcoreEngine";
+const char *const kEngineNameHccl = "ops_kernel_info_hccl";
+}  // namespace
+
+class UtestMultiStreamPlan : public testing::Test {
+ protected:
+  void SetUp() {
+    auto &engine_mapping = NodeExecutorManager::GetInstance().engine_mapping_;
+    engine_mapping.emplace(kEngineNameAiCore, NodeExecutorManager::ExecutorType::AICORE);
+    engine_mapping.emplace(kEngineNameHccl, NodeExecutorManager::ExecutorType::HCCL);
+    graph_item_.SetName("graph");
+  }
+  void TearDown() {}
+
+  NodePtr AddNode(const std::string &name, const std::string &engine, int in_cnt) {
+    auto node = builder_.AddNode(name, name, in_cnt, 1);
+    node->GetOpDesc()->SetOpKernelLibName(engine);
+    return node;
+  }
+
+  // node items follow the order of nodes
+  void BuildGraphItem(const std::vector<NodePtr> &nodes) {
+    graph_ = builder_.GetGraph();
+    for (const auto &node : nodes) {
+      std::unique_ptr<NodeItem> node_item;
+      ASSERT_EQ(NodeItem::Create(node, node_item), SUCCESS);
+      node_item->graph_index = static_cast<int>(graph_item_.node_items_.size());
+      graph_item_.node_items_.emplace_back(node_item.get());
+      node_items_.emplace_back(std::move(node_item));
+    }
+  }
+
+  const MultiStreamPlan::NodeStreamInfo &GetInfo(const MultiStreamPlan &plan, size_t index) {
+    return plan.GetNodeStreamInfo(*node_items_[index]);
+  }
+
+  ut::GraphBuilder builder_{"graph"};
+  ComputeGraphPtr graph_;
+  GraphItem graph_item_;
+  std::vector<std::unique_ptr<NodeItem>> node_items_;
+};
+
+TEST_F(UtestMultiStreamPlan, no_plan_for_single_stream) {
+  auto a = AddNode("a", kEngineNameAiCore, 0);
+  auto b = AddNode("b", kEngineNameAiCore, 1);
+  auto c = AddNode("c", kEngineNameAiCore, 1);
+  builder_.AddDataEdge(a, 0, b, 0);
+  builder_.AddDataEdge(a, 0, c, 0);
+  BuildGraphItem({a, b, c});
+
+  EXPECT_EQ(MultiStreamPlan::Build(graph_item_, 1), nullptr);
+  graph_item_.is_dynamic_ = false;
+  EXPECT_EQ(MultiStreamPlan::Build(graph_item_, 2), nullptr);
+}
+
+TEST_F(UtestMultiStreamPlan, no_plan_for_chain) {
+  auto a = AddNode("a", kEngineNameAiCore, 0);
+  auto b = AddNode("b", kEngineNameAiCore, 1);
+  auto c = AddNode("c", kEngineNameAiCore, 1);
+  builder_.AddDataEdge(a, 0, b, 0);
+  builder_.AddDataEdge(b, 0, c, 0);
+  BuildGraphItem({a, b, c});
+  // every node continues the stream of its producer
+  EXPECT_EQ(MultiStreamPlan::Build(graph_item_, 2), nullptr);
+}
+
+TEST_F(UtestMultiStreamPlan, wait_elided_if_already_synced) {
+  //   a
+  //  / \
+  // b   c
+  // |   |
+  // |   e <- a
+  //  \ /
+  //   d
+  auto a = AddNode("a", kEngineNameAiCore, 0);
+  auto b = AddNode("b", kEngineNameAiCore, 1);
+  auto c = AddNode("c", kEngineNameAiCore, 1);
+  auto e = AddNode("e", kEngineNameAiCore, 2);
+  auto d = AddNode("d", kEngineNameAiCore, 2);
+  builder_.AddDataEdge(a, 0, b, 0);
+  builder_.AddDataEdge(a, 0, c, 0);
+  builder_.AddDataEdge(a, 0, e, 0);
+  builder_.AddDataEdge(c, 0, e, 1);
+  builder_.AddDataEdge(b, 0, d, 0);
+  builder_.AddDataEdge(e, 0, d, 1);
+  BuildGraphItem({a, b, c, e, d});
+
+  auto plan = MultiStreamPlan::Build(graph_item_, 2);
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(plan->GetStreamNum(), 2);
+  EXPECT_EQ(plan->GetEventNum(), 2);
+
+  EXPECT_EQ(GetInfo(*plan, 0).stream_id, 0);
+  EXPECT_EQ(GetInfo(*plan, 0).event_index, 0);
+  EXPECT_TRUE(GetInfo(*plan, 0).wait_events.empty());
+  // b continues stream of a
+  EXPECT_EQ(GetInfo(*plan, 1).stream_id, 0);
+  EXPECT_EQ(GetInfo(*plan, 1).event_index, -1);
+  EXPECT_TRUE(GetInfo(*plan, 1).wait_events.empty());
+  // c goes to the side stream
+  EXPECT_EQ(GetInfo(*plan, 2).stream_id, 1);
+  EXPECT_EQ(GetInfo(*plan, 2).event_index, -1);
+  EXPECT_EQ(GetInfo(*plan, 2).wait_events, std::vector<int>({0}));
+  // stream 1 has waited a before c, no wait again
+  EXPECT_EQ(GetInfo(*plan, 3).stream_id, 1);
+  EXPECT_EQ(GetInfo(*plan, 3).event_index, 1);
+  EXPECT_TRUE(GetInfo(*plan, 3).wait_events.empty());
+  EXPECT_EQ(GetInfo(*plan, 4).stream_id, 0);
+  EXPECT_EQ(GetInfo(*plan, 4).wait_events, std::vector<int>({1}));
+}
+
+TEST_F(UtestMultiStreamPlan, wait_elided_if_synced_transitively) {
+  // a(s0) -> b(s0) ------------> p(s0) -> q(s0) <- c
+  //       -> c(s1) -> n(s2) -> p
+  //       -> m(s2) -> n
+  // p waits n, which has waited c, so q needs not wait c again
+  auto a = AddNode("a", kEngineNameAiCore, 0);
+  auto b = AddNode("b", kEngineNameAiCore, 1);
+  auto c = AddNode("c", kEngineNameAiCore, 1);
+  auto m = AddNode("m", kEngineNameAiCore, 1);
+  auto n = AddNode("n", kEngineNameAiCore, 2);
+  auto p = AddNode("p", kEngineNameAiCore, 2);
+  auto q = AddNode("q", kEngineNameAiCore, 2);
+  builder_.AddDataEdge(a, 0, b, 0);
+  builder_.AddDataEdge(a, 0, c, 0);
+  builder_.AddDataEdge(a, 0, m, 0);
+  builder_.AddDataEdge(m, 0, n, 0);
+  builder_.AddDataEdge(c, 0, n, 1);
+  builder_.AddDataEdge(b, 0, p, 0);
+  builder_.AddDataEdge(n, 0, p, 1);
+  builder_.AddDataEdge(p, 0, q, 0);
+  builder_.AddDataEdge(c, 0, q, 1);
+  BuildGraphItem({a, b, c, m, n, p, q});
+
+  auto plan = MultiStreamPlan::Build(graph_item_, 3);
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(GetInfo(*plan, 2).stream_id, 1);
+  EXPECT_EQ(GetInfo(*plan, 3).stream_id, 2);
+  // a is recorded once for both side streams
+  EXPECT_EQ(GetInfo(*plan, 2).wait_events, std::vector<int>({0}));
+  EXPECT_EQ(GetInfo(*plan, 3).wait_events, std::vector<int>({0}));
+  EXPECT_EQ(GetInfo(*plan, 4).stream_id, 2);
+  EXPECT_EQ(GetInfo(*plan, 4).wait_events, std::vector<int>({GetInfo(*plan, 2).event_index}));
+  EXPECT_EQ(GetInfo(*plan, 5).stream_id, 0);
+  EXPECT_EQ(GetInfo(*plan, 5).wait_events, std::vector<int>({GetInfo(*plan, 4).event_index}));
+  EXPECT_EQ(GetInfo(*plan, 6).stream_id, 0);
+  EXPECT_TRUE(GetInfo(*plan, 6).wait_events.empty());
+  EXPECT_EQ(plan->GetEventNum(), 3);
+}
+
+TEST_F(UtestMultiStreamPlan, barrier_joins_all_streams) {
+  auto a = AddNode("a", kEngineNameAiCore, 0);
+  auto b = AddNode("b", kEngineNameAiCore, 1);
+  auto c = AddNode("c", kEngineNameAiCore, 1);
+  auto h = AddNode("h", kEngineNameHccl, 1);
+  auto x = AddNode("x", kEngineNameAiCore, 1);
+  builder_.AddDataEdge(a, 0, b, 0);
+  builder_.AddDataEdge(a, 0, c, 0);
+  builder_.AddDataEdge(b, 0, h, 0);
+  builder_.AddDataEdge(a, 0, x, 0);
+  BuildGraphItem({a, b, c, h, x});
+
+  auto plan = MultiStreamPlan::Build(graph_item_, 2);
+  ASSERT_NE(plan, nullptr);
+  EXPECT_EQ(GetInfo(*plan, 2).stream_id, 1);
+  // barrier stays on stream 0 and waits the tail of stream 1
+  const auto &barrier_info = GetInfo(*plan, 3);
+  EXPECT_EQ(barrier_info.stream_id, 0);
+  EXPECT_EQ(barrier_info.wait_events, std::vector<int>({GetInfo(*plan, 2).event_index}));
+  // nodes after the barrier wait for it, not for their producer a it has joined
+  const auto &x_info = GetInfo(*plan, 4);
+  EXPECT_EQ(x_info.stream_id, 1);
+  EXPECT_EQ(x_info.wait_events, std::vector<int>({barrier_info.event_index}));
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,159 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+
+#define private public
+#define protected public
+#include "hybrid/executor/rt_callback_manager.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+namespace {
+int stream_a = 0;
+int stream_b = 0;
+
+// fails to wait the event of the fail_index-th entry
+class FailingCallbackManager : public CallbackManager {
+ public:
+  explicit FailingCallbackManager(int fail_index) : fail_index_(fail_index) {}
+
+  Status WaitEvent(rtEvent_t event) override {
+    return (wait_count_++ == fail_index_) ? FAILED : CallbackManager::WaitEvent(event);
+  }
+
+  int fail_index_;
+  int wait_count_ = 0;
+};
+}  // namespace
+
+class UtestRtCallbackManager : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestRtCallbackManager, event_reused_across_rounds) {
+  CallbackManager callback_manager;
+  int num_invoked = 0;
+  ASSERT_EQ(callback_manager.Init(), SUCCESS);
+  ASSERT_EQ(callback_manager.RegisterCallback(&stream_a, [&num_invoked]() { ++num_invoked; }), SUCCESS);
+  ASSERT_EQ(callback_manager.Destroy(), SUCCESS);
+  EXPECT_EQ(num_invoked, 1);
+  ASSERT_EQ(callback_manager.free_events_.size(), 1);
+  auto event = callback_manager.free_events_[0];
+
+  ASSERT_EQ(callback_manager.Init(), SUCCESS);
+  ASSERT_EQ(callback_manager.RegisterCallback(&stream_a, [&num_invoked]() { ++num_invoked; }), SUCCESS);
+  ASSERT_EQ(callback_manager.Destroy(), SUCCESS);
+  EXPECT_EQ(num_invoked, 2);
+  ASSERT_EQ(callback_manager.free_events_.size(), 1);
+  EXPECT_EQ(callback_manager.free_events_[0], event);
+}
+
+TEST_F(UtestRtCallbackManager, coalesce_callbacks_of_same_stream) {
+  CallbackManager callback_manager;
+  int num_invoked = 0;
+  // callback thread is not started, so no entry is taken
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_EQ(callback_manager.RegisterCallback(&stream_a, [&num_invoked]() { ++num_invoked; }), SUCCESS);
+  }
+  ASSERT_EQ(callback_manager.RegisterCallback(&stream_b, [&num_invoked]() { ++num_invoked; }), SUCCESS);
+  ASSERT_EQ(callback_manager.pending_entries_.size(), 3);
+  EXPECT_EQ(callback_manager.pending_entries_[0].callbacks.size(), 16);
+  EXPECT_EQ(callback_manager.pending_entries_[1].callbacks.size(), 4);
+  EXPECT_EQ(callback_manager.pending_entries_[2].callbacks.size(), 1);
+  EXPECT_EQ(callback_manager.pending_entries_[2].stream, &stream_b);
+
+  ASSERT_EQ(callback_manager.Init(), SUCCESS);
+  ASSERT_EQ(callback_manager.Destroy(), SUCCESS);
+  EXPECT_EQ(num_invoked, 21);
+  EXPECT_EQ(callback_manager.free_events_.size(), 3);
+}
+
+TEST_F(UtestRtCallbackManager, requeue_entries_after_eof) {
+  CallbackManager callback_manager;
+  int num_invoked_a = 0;
+  int num_invoked_b = 0;
+  ASSERT_EQ(callback_manager.RegisterCallback(&stream_a, [&num_invoked_a]() { ++num_invoked_a; }), SUCCESS);
+  callback_manager.PushEntry(CallbackManager::CallbackEntry());
+  // not coalesced into eof
+  ASSERT_EQ(callback_manager.RegisterCallback(&stream_a, [&num_invoked_b]() { ++num_invoked_b; }), SUCCESS);
+  ASSERT_EQ(callback_manager.pending_entries_.size(), 3);
+
+  ASSERT_EQ(callback_manager.Init(), SUCCESS);
+  ASSERT_EQ(callback_manager.ret_future_.get(), SUCCESS);
+  EXPECT_EQ(num_invoked_a, 1);
+  EXPECT_EQ(num_invoked_b, 0);
+  ASSERT_EQ(callback_manager.pending_entries_.size(), 1);
+
+  // belongs to next round
+  ASSERT_EQ(callback_manager.Init(), SUCCESS);
+  ASSERT_EQ(callback_manager.Destroy(), SUCCESS);
+  EXPECT_EQ(num_invoked_b, 1);
+}
+
+// Callback throughput on the stub runtime, with coalescing and with every callback on its own event.
+TEST_F(UtestRtCallbackManager, callback_throughput) {
+  const int kCallbackNum = 100000;
+  std::atomic<int> num_invoked(0);
+  auto run = [&num_invoked, kCallbackNum](bool alternate_streams) -> int64_t {
+    CallbackManager callback_manager;
+    EXPECT_EQ(callback_manager.Init(), SUCCESS);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCallbackNum; ++i) {
+      auto stream = (alternate_streams && (i % 2 == 1)) ? &stream_b : &stream_a;
+      EXPECT_EQ(callback_manager.RegisterCallback(stream, [&num_invoked]() { ++num_invoked; }), SUCCESS);
+    }
+    EXPECT_EQ(callback_manager.Destroy(), SUCCESS);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  auto coalesced_cost = run(false);
+  EXPECT_EQ(num_invoked.load(), kCallbackNum);
+  auto uncoalesced_cost = run(true);
+  EXPECT_EQ(num_invoked.load(), kCallbackNum * 2);
+  RecordProperty("coalesced_ns_per_callback", static_cast<int>(coalesced_cost / kCallbackNum));
+  RecordProperty("one_event_each_ns_per_callback", static_cast<int>(uncoalesced_cost / kCallbackNum));
+}
+
+TEST_F(UtestRtCallbackManager, callbacks_invoked_after_failed_wait) {
+  FailingCallbackManager callback_manager(1);
+  int num_invoked = 0;
+  // one entry per callback, as streams alternate
+  for (int i = 0; i < 4; ++i) {
+    auto stream = (i % 2 == 0) ? &stream_a : &stream_b;
+    ASSERT_EQ(callback_manager.RegisterCallback(stream, [&num_invoked]() { ++num_invoked; }), SUCCESS);
+  }
+  ASSERT_EQ(callback_manager.pending_entries_.size(), 4);
+  ASSERT_EQ(callback_manager.Init(), SUCCESS);
+  ASSERT_EQ(callback_manager.RegisterCallback(&stream_a, [&num_invoked]() { ++num_invoked; }), SUCCESS);
+  EXPECT_EQ(callback_manager.Destroy(), FAILED);
+
+  // entries after the failed one are not waited, but their callbacks are invoked
+  EXPECT_EQ(num_invoked, 5);
+  EXPECT_EQ(callback_manager.wait_count_, 2);
+  // only the event waited successfully is reused, events of others are destroyed
+  EXPECT_EQ(callback_manager.free_events_.size(), 1);
+  EXPECT_TRUE(callback_manager.pending_entries_.empty());
+}
+}  // namespace hybrid
+}  // namespace ge
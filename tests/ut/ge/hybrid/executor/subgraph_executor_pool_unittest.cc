@@ -0,0 +1,143 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+
+#define private public
+#define protected public
+#include "hybrid/executor/hybrid_execution_context.h"
+#include "hybrid/executor/subgraph_executor.h"
+#include "hybrid/executor/subgraph_executor_pool.h"
+#include "hybrid/model/graph_item.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestSubgraphExecutorPool : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestSubgraphExecutorPool, reuse_released_executor) {
+  GraphExecutionContext context;
+  auto pool = std::make_shared<SubgraphExecutorPool>();
+  GraphItem body;
+  body.SetName("body");
+  GraphItem cond;
+  cond.SetName("cond");
+
+  auto executor = pool->Acquire(&body, &context);
+  ASSERT_NE(executor, nullptr);
+  auto *raw_executor = executor.get();
+  executor.reset();
+  EXPECT_EQ(pool->NumIdleExecutors(&body), 1);
+  EXPECT_EQ(pool->NumIdleExecutors(&cond), 0);
+
+  executor = pool->Acquire(&body, &context, true);
+  EXPECT_EQ(executor.get(), raw_executor);
+  EXPECT_TRUE(executor->force_infer_shape_);
+  EXPECT_EQ(pool->NumIdleExecutors(&body), 0);
+
+  // executors of other subgraph are never shared
+  auto cond_executor = pool->Acquire(&cond, &context);
+  EXPECT_NE(cond_executor.get(), raw_executor);
+  EXPECT_EQ(cond_executor->GetGraphItem(), &cond);
+}
+
+TEST_F(UtestSubgraphExecutorPool, failed_executor_not_reused) {
+  GraphExecutionContext context;
+  auto pool = std::make_shared<SubgraphExecutorPool>();
+  GraphItem body;
+  body.SetName("body");
+
+  auto executor = pool->Acquire(&body, &context);
+  ASSERT_NE(executor, nullptr);
+  executor->reusable_ = false;
+  executor.reset();
+  EXPECT_EQ(pool->NumIdleExecutors(&body), 0);
+}
+
+TEST_F(UtestSubgraphExecutorPool, discarded_executor_destroyed) {
+  GraphExecutionContext context;
+  auto pool = std::make_shared<SubgraphExecutorPool>();
+  GraphItem cond;
+  cond.SetName("cond");
+
+  auto executor = pool->Acquire(&cond, &context);
+  ASSERT_NE(executor, nullptr);
+  executor->Discard();
+  executor.reset();
+  EXPECT_EQ(pool->NumIdleExecutors(&cond), 0);
+  executor = pool->Acquire(&cond, &context);
+  EXPECT_TRUE(executor->IsReusable());
+}
+
+TEST_F(UtestSubgraphExecutorPool, idle_executors_bounded) {
+  GraphExecutionContext context;
+  auto pool = std::make_shared<SubgraphExecutorPool>();
+  GraphItem body;
+  body.SetName("body");
+
+  std::vector<std::shared_ptr<SubgraphExecutor>> executors;
+  for (int i = 0; i < 8; ++i) {
+    executors.emplace_back(pool->Acquire(&body, &context));
+  }
+  executors.clear();
+  EXPECT_EQ(pool->NumIdleExecutors(&body), 4);
+
+  // released after the pool is gone
+  auto executor = pool->Acquire(&body, &context);
+  pool.reset();
+  executor.reset();
+}
+
+// Per-iteration overhead of a loop of cond/body subgraphs, executor creation is what the pool saves.
+TEST_F(UtestSubgraphExecutorPool, loop_iteration_overhead) {
+  GraphExecutionContext context;
+  GraphItem body;
+  body.SetName("body");
+  GraphItem cond;
+  cond.SetName("cond");
+  const int kIterations = 1000;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    auto cond_executor = std::make_shared<SubgraphExecutor>(&cond, &context);
+    auto body_executor = std::make_shared<SubgraphExecutor>(&body, &context);
+  }
+  auto create_cost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+
+  auto pool = std::make_shared<SubgraphExecutorPool>();
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    auto cond_executor = pool->Acquire(&cond, &context);
+    auto body_executor = pool->Acquire(&body, &context);
+  }
+  auto pooled_cost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(pool->NumIdleExecutors(&cond), 1);
+  EXPECT_EQ(pool->NumIdleExecutors(&body), 1);
+  EXPECT_LT(pooled_cost, create_cost);
+}
+}  // namespace hybrid
+}  // namespace ge
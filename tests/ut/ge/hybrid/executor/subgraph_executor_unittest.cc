@@ -0,0 +1,95 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "graph/passes/graph_builder_utils.h"
+
+#define private public
+#define protected public
+#include "hybrid/executor/hybrid_execution_context.h"
+#include "hybrid/executor/subgraph_executor.h"
+#include "hybrid/model/graph_item.h"
+#include "hybrid/model/node_item.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestSubgraphExecutor : public testing::Test {
+ protected:
+  void SetUp() {
+    graph_item_.SetName("graph");
+  }
+  void TearDown() {}
+
+  std::unique_ptr<NodeItem> CreateNodeItem(const std::string &name) {
+    auto node = builder_.AddNode(name, name, 1, 1);
+    std::unique_ptr<NodeItem> node_item;
+    EXPECT_EQ(NodeItem::Create(node, node_item), SUCCESS);
+    return node_item;
+  }
+
+  ut::GraphBuilder builder_{"graph"};
+  GraphItem graph_item_;
+  GraphExecutionContext context_;
+};
+
+TEST_F(UtestSubgraphExecutor, defer_callback_of_kernel_launch_only) {
+  SubgraphExecutor executor(&graph_item_, &context_);
+  auto node_item = CreateNodeItem("a");
+  ASSERT_NE(node_item, nullptr);
+  node_item->is_kernel_launch = true;
+  EXPECT_FALSE(executor.CanDeferCallback(*node_item));
+
+  executor.defer_callbacks_ = true;
+  EXPECT_TRUE(executor.CanDeferCallback(*node_item));
+
+  node_item->has_observer = true;
+  EXPECT_FALSE(executor.CanDeferCallback(*node_item));
+  node_item->has_observer = false;
+
+  node_item->shape_inference_type = DEPEND_COMPUTE;
+  EXPECT_FALSE(executor.CanDeferCallback(*node_item));
+  node_item->shape_inference_type = DEPEND_IN_SHAPE;
+
+  node_item->is_kernel_launch = false;
+  EXPECT_FALSE(executor.CanDeferCallback(*node_item));
+}
+
+TEST_F(UtestSubgraphExecutor, run_deferred_callbacks_on_error) {
+  SubgraphExecutor executor(&graph_item_, &context_);
+  int num_invoked = 0;
+  executor.deferred_callbacks_.resize(3);
+  executor.deferred_callbacks_[0].emplace_back([&num_invoked]() { ++num_invoked; });
+  executor.deferred_callbacks_[0].emplace_back([&num_invoked]() { ++num_invoked; });
+  executor.deferred_callbacks_[2].emplace_back([&num_invoked]() { ++num_invoked; });
+
+  // callbacks not flushed before the failure are neither registered nor dropped
+  executor.RunDeferredCallbacks();
+  EXPECT_EQ(num_invoked, 3);
+  for (const auto &deferred_callbacks : executor.deferred_callbacks_) {
+    EXPECT_TRUE(deferred_callbacks.empty());
+  }
+
+  executor.RunDeferredCallbacks();
+  EXPECT_EQ(num_invoked, 3);
+}
+}  // namespace hybrid
+}  // namespace ge
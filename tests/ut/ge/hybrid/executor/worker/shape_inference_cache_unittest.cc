@@ -0,0 +1,250 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "common/types.h"
+#include "graph/passes/graph_builder_utils.h"
+#include "graph/utils/attr_utils.h"
+#include "graph/utils/graph_utils.h"
+#include "graph/utils/tensor_utils.h"
+
+#define private public
+#define protected public
+#include "hybrid/executor/worker/shape_inference_cache.h"
+#include "hybrid/model/node_item.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestShapeInferenceCache : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+namespace {
+NodePtr AddNode(ut::GraphBuilder &builder, const std::string &name, const std::string &type, int in_cnt,
+                int out_cnt, const std::vector<int64_t> &shape = {2, 3}) {
+  auto node = builder.AddNode(name, type, in_cnt, out_cnt, FORMAT_ND, DT_FLOAT, shape);
+  for (size_t i = 0; i < node->GetOpDesc()->GetAllInputsSize(); ++i) {
+    node->GetOpDesc()->MutableInputDesc(i)->SetOriginFormat(FORMAT_ND);
+  }
+  for (size_t i = 0; i < node->GetOpDesc()->GetOutputsSize(); ++i) {
+    node->GetOpDesc()->MutableOutputDesc(i)->SetOriginFormat(FORMAT_ND);
+  }
+  return node;
+}
+
+std::unique_ptr<NodeItem> CreateNodeItem(const NodePtr &node) {
+  std::unique_ptr<NodeItem> node_item;
+  EXPECT_EQ(NodeItem::Create(node, node_item), SUCCESS);
+  return node_item;
+}
+
+void SetInputDims(const NodeItem &node_item, int index, const std::vector<int64_t> &dims) {
+  node_item.MutableInputDesc(index)->SetShape(GeShape(dims));
+  node_item.MutableInputDesc(index)->SetOriginShape(GeShape(dims));
+}
+
+std::vector<int64_t> GetOutputDims(const NodeItem &node_item) {
+  return node_item.MutableOutputDesc(0)->GetShape().GetDims();
+}
+
+NodePtr AddReshapeWithConst(ut::GraphBuilder &builder, const std::vector<int32_t> &shape_value) {
+  auto reshape = AddNode(builder, "reshape", RESHAPE, 2, 1);
+  auto shape = AddNode(builder, "shape", CONSTANT, 0, 1, {static_cast<int64_t>(shape_value.size())});
+  GeTensorDesc shape_desc(GeShape({static_cast<int64_t>(shape_value.size())}), FORMAT_ND, DT_INT32);
+  GeTensorPtr weight = std::make_shared<GeTensor>(shape_desc, reinterpret_cast<const uint8_t *>(shape_value.data()),
+                                                  shape_value.size() * sizeof(int32_t));
+  EXPECT_TRUE(AttrUtils::SetTensor(shape->GetOpDesc(), ATTR_NAME_WEIGHTS, weight));
+  builder.AddDataEdge(shape, 0, reshape, 1);
+  return reshape;
+}
+}  // namespace
+
+TEST_F(UtestShapeInferenceCache, infer_broadcast) {
+  std::vector<int64_t> dims;
+  EXPECT_TRUE(ShapeInferenceCache::InferBroadcast({2, 1, 3}, {4, 1}, dims));
+  EXPECT_EQ(dims, std::vector<int64_t>({2, 4, 3}));
+  EXPECT_TRUE(ShapeInferenceCache::InferBroadcast({4, 1}, {2, 1, 3}, dims));
+  EXPECT_EQ(dims, std::vector<int64_t>({2, 4, 3}));
+  EXPECT_TRUE(ShapeInferenceCache::InferBroadcast({}, {3}, dims));
+  EXPECT_EQ(dims, std::vector<int64_t>({3}));
+  EXPECT_TRUE(ShapeInferenceCache::InferBroadcast({5, 0}, {1}, dims));
+  EXPECT_EQ(dims, std::vector<int64_t>({5, 0}));
+
+  // not broadcastable or unknown dims are left to infer func
+  EXPECT_FALSE(ShapeInferenceCache::InferBroadcast({2, 3}, {4}, dims));
+  EXPECT_FALSE(ShapeInferenceCache::InferBroadcast({-1, 3}, {3}, dims));
+}
+
+TEST_F(UtestShapeInferenceCache, compile_rules) {
+  ut::GraphBuilder builder("g");
+  auto relu = CreateNodeItem(AddNode(builder, "relu", RELU, 1, 1));
+  auto add = CreateNodeItem(AddNode(builder, "add", ADD, 2, 1));
+  auto split = CreateNodeItem(AddNode(builder, "split", "Split", 1, 2));
+  auto cache = ShapeInferenceCache::Create(*relu);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetRule(), ShapeInferenceCache::ShapeRule::kSameAsInput);
+  cache = ShapeInferenceCache::Create(*add);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetRule(), ShapeInferenceCache::ShapeRule::kBroadcast);
+  cache = ShapeInferenceCache::Create(*split);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetRule(), ShapeInferenceCache::ShapeRule::kNone);
+
+  // format transformed, shape differs from origin shape
+  relu->MutableOutputDesc(0)->SetFormat(FORMAT_NC1HWC0);
+  cache = ShapeInferenceCache::Create(*relu);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetRule(), ShapeInferenceCache::ShapeRule::kNone);
+
+  // shapes depend on values of inputs
+  add->shape_inference_type = DEPEND_COMPUTE;
+  EXPECT_EQ(ShapeInferenceCache::Create(*add), nullptr);
+}
+
+TEST_F(UtestShapeInferenceCache, apply_rule) {
+  ut::GraphBuilder builder("g");
+  auto relu = CreateNodeItem(AddNode(builder, "relu", RELU, 1, 1));
+  auto relu_cache = ShapeInferenceCache::Create(*relu);
+  ASSERT_NE(relu_cache, nullptr);
+  SetInputDims(*relu, 0, {7, 8});
+  EXPECT_TRUE(relu_cache->ApplyRule(*relu));
+  EXPECT_EQ(GetOutputDims(*relu), std::vector<int64_t>({7, 8}));
+  EXPECT_EQ(relu->MutableOutputDesc(0)->GetOriginShape().GetDims(), std::vector<int64_t>({7, 8}));
+
+  auto add = CreateNodeItem(AddNode(builder, "add", ADD, 2, 1));
+  auto add_cache = ShapeInferenceCache::Create(*add);
+  ASSERT_NE(add_cache, nullptr);
+  SetInputDims(*add, 0, {4, 1});
+  SetInputDims(*add, 1, {3});
+  EXPECT_TRUE(add_cache->ApplyRule(*add));
+  EXPECT_EQ(GetOutputDims(*add), std::vector<int64_t>({4, 3}));
+  SetInputDims(*add, 1, {2});
+  SetInputDims(*add, 0, {4, 3});
+  EXPECT_FALSE(add_cache->ApplyRule(*add));
+}
+
+TEST_F(UtestShapeInferenceCache, infer_reshape) {
+  ut::GraphBuilder builder("g");
+  auto reshape_node = AddReshapeWithConst(builder, {-1, 6});
+  auto reshape = CreateNodeItem(reshape_node);
+  auto cache = ShapeInferenceCache::Create(*reshape);
+  ASSERT_NE(cache, nullptr);
+  ASSERT_EQ(cache->GetRule(), ShapeInferenceCache::ShapeRule::kReshapeConst);
+  EXPECT_EQ(cache->reshape_dims_, std::vector<int64_t>({-1, 6}));
+
+  SetInputDims(*reshape, 0, {2, 3, 4});
+  EXPECT_TRUE(cache->InferReshape(*reshape));
+  EXPECT_EQ(GetOutputDims(*reshape), std::vector<int64_t>({4, 6}));
+
+  // element count not divisible or unknown
+  SetInputDims(*reshape, 0, {5});
+  EXPECT_FALSE(cache->InferReshape(*reshape));
+  SetInputDims(*reshape, 0, {-1, 6});
+  EXPECT_FALSE(cache->InferReshape(*reshape));
+
+  cache->reshape_dims_ = {3, 4};
+  SetInputDims(*reshape, 0, {2, 6});
+  EXPECT_TRUE(cache->InferReshape(*reshape));
+  EXPECT_EQ(GetOutputDims(*reshape), std::vector<int64_t>({3, 4}));
+  SetInputDims(*reshape, 0, {2, 7});
+  EXPECT_FALSE(cache->InferReshape(*reshape));
+}
+
+TEST_F(UtestShapeInferenceCache, reshape_rule_not_compiled) {
+  ut::GraphBuilder builder("g");
+  // 0 copies dim from input for some frameworks, more than one -1 is invalid
+  auto copy_dim = CreateNodeItem(AddReshapeWithConst(builder, {0, -1}));
+  auto cache = ShapeInferenceCache::Create(*copy_dim);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetRule(), ShapeInferenceCache::ShapeRule::kNone);
+
+  ut::GraphBuilder builder2("g2");
+  auto two_inferred = CreateNodeItem(AddReshapeWithConst(builder2, {-1, -1}));
+  cache = ShapeInferenceCache::Create(*two_inferred);
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetRule(), ShapeInferenceCache::ShapeRule::kNone);
+}
+
+TEST_F(UtestShapeInferenceCache, lookup_hit_and_miss) {
+  ut::GraphBuilder builder("g");
+  auto split = CreateNodeItem(AddNode(builder, "split", "Split", 1, 2));
+  auto cache = ShapeInferenceCache::Create(*split);
+  ASSERT_NE(cache, nullptr);
+
+  SetInputDims(*split, 0, {4, 6});
+  EXPECT_FALSE(cache->Lookup(*split));
+  split->MutableOutputDesc(0)->SetShape(GeShape({2, 6}));
+  split->MutableOutputDesc(1)->SetShape(GeShape({2, 6}));
+  TensorUtils::SetSize(*split->MutableOutputDesc(0), 48);
+  cache->Save(*split);
+
+  // other input shape misses and does not touch outputs
+  SetInputDims(*split, 0, {8, 6});
+  EXPECT_FALSE(cache->Lookup(*split));
+  split->MutableOutputDesc(0)->SetShape(GeShape({4, 6}));
+  split->MutableOutputDesc(1)->SetShape(GeShape({4, 6}));
+  cache->Save(*split);
+
+  SetInputDims(*split, 0, {4, 6});
+  EXPECT_TRUE(cache->Lookup(*split));
+  EXPECT_EQ(GetOutputDims(*split), std::vector<int64_t>({2, 6}));
+  EXPECT_EQ(split->MutableOutputDesc(1)->GetShape().GetDims(), std::vector<int64_t>({2, 6}));
+  int64_t size = 0;
+  EXPECT_EQ(TensorUtils::GetSize(*split->MutableOutputDesc(0), size), GRAPH_SUCCESS);
+  EXPECT_EQ(size, 48);
+
+  SetInputDims(*split, 0, {8, 6});
+  EXPECT_TRUE(cache->Lookup(*split));
+  EXPECT_EQ(GetOutputDims(*split), std::vector<int64_t>({4, 6}));
+
+  // origin shape is part of the key
+  split->MutableInputDesc(0)->SetOriginShape(GeShape({8, 3, 2}));
+  EXPECT_FALSE(cache->Lookup(*split));
+}
+
+TEST_F(UtestShapeInferenceCache, entries_replaced_in_turn) {
+  ut::GraphBuilder builder("g");
+  auto relu = CreateNodeItem(AddNode(builder, "relu", RELU, 1, 1));
+  auto cache = ShapeInferenceCache::Create(*relu);
+  ASSERT_NE(cache, nullptr);
+  const int64_t kEntryNum = 10;
+  for (int64_t i = 1; i <= kEntryNum; ++i) {
+    SetInputDims(*relu, 0, {i});
+    EXPECT_TRUE(cache->ApplyRule(*relu));
+    cache->Save(*relu);
+  }
+  EXPECT_EQ(cache->entries_.size(), 8);
+
+  // the two oldest are replaced
+  SetInputDims(*relu, 0, {1});
+  EXPECT_FALSE(cache->Lookup(*relu));
+  SetInputDims(*relu, 0, {2});
+  EXPECT_FALSE(cache->Lookup(*relu));
+  SetInputDims(*relu, 0, {3});
+  EXPECT_TRUE(cache->Lookup(*relu));
+  SetInputDims(*relu, 0, {kEntryNum});
+  EXPECT_TRUE(cache->Lookup(*relu));
+  EXPECT_EQ(GetOutputDims(*relu), std::vector<int64_t>({kEntryNum}));
+}
+}  // namespace hybrid
+}  // namespace ge
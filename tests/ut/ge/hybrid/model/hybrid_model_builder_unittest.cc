@@ -0,0 +1,141 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "common/types.h"
+#include "graph/passes/graph_builder_utils.h"
+
+#define private public
+#define protected public
+#include "hybrid/executor/hybrid_execution_context.h"
+#include "hybrid/executor/subgraph_context.h"
+#include "hybrid/model/graph_item.h"
+#include "hybrid/model/hybrid_model.h"
+#include "hybrid/model/hybrid_model_builder.h"
+#include "hybrid/model/node_item.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestHybridModelBuilder : public testing::Test {
+ protected:
+  void SetUp() {
+    ut::GraphBuilder builder("graph");
+    auto data = builder.AddNode("data", DATA, 0, 1);
+    auto add = builder.AddNode("add", ADD, 2, 1);
+    auto relu = builder.AddNode("relu", RELU, 1, 1);
+    builder.AddDataEdge(data, 0, add, 0);
+    builder.AddDataEdge(data, 0, add, 1);
+    builder.AddDataEdge(add, 0, relu, 0);
+    graph_ = builder.GetGraph();
+
+    ut::GraphBuilder other_builder("other_graph");
+    other_ = other_builder.AddNode("other", RELU, 1, 1);
+    other_graph_ = other_builder.GetGraph();
+
+    for (const auto &node : {data, add, relu, other_}) {
+      std::unique_ptr<NodeItem> node_item;
+      ASSERT_EQ(NodeItem::Create(node, node_item), SUCCESS);
+      if (node != other_) {
+        graph_item_.node_items_.emplace_back(node_item.get());
+      }
+      model_.node_items_[node] = std::move(node_item);
+    }
+    graph_item_.SetName("graph");
+    data_item_ = model_.node_items_[data].get();
+    add_item_ = model_.node_items_[add].get();
+    relu_item_ = model_.node_items_[relu].get();
+    add_item_->dependents_for_execution.emplace_back(data);
+    relu_item_->dependents_for_execution.emplace_back(add);
+    relu_item_->dependents_for_shape_inference.emplace_back(data);
+  }
+
+  ComputeGraphPtr graph_;
+  ComputeGraphPtr other_graph_;
+  NodePtr other_;
+  HybridModel model_{nullptr};
+  GraphItem graph_item_;
+  NodeItem *data_item_ = nullptr;
+  NodeItem *add_item_ = nullptr;
+  NodeItem *relu_item_ = nullptr;
+};
+
+TEST_F(UtestHybridModelBuilder, index_node_items) {
+  HybridModelBuilder builder(model_);
+  ASSERT_EQ(builder.IndexNodeItems(graph_item_), SUCCESS);
+  const auto &node_items = graph_item_.GetAllNodes();
+  for (size_t i = 0; i < node_items.size(); ++i) {
+    EXPECT_EQ(node_items[i]->graph_index, static_cast<int>(i));
+  }
+  EXPECT_TRUE(data_item_->execution_dependencies.empty());
+  EXPECT_EQ(add_item_->execution_dependencies, std::vector<const NodeItem *>({data_item_}));
+  EXPECT_EQ(relu_item_->execution_dependencies, std::vector<const NodeItem *>({add_item_}));
+  EXPECT_EQ(relu_item_->shape_inference_dependencies, std::vector<const NodeItem *>({data_item_}));
+}
+
+TEST_F(UtestHybridModelBuilder, reject_dependent_out_of_graph) {
+  relu_item_->dependents_for_execution.emplace_back(other_);
+  HybridModelBuilder builder(model_);
+  EXPECT_EQ(builder.IndexNodeItems(graph_item_), INTERNAL_ERROR);
+}
+
+TEST_F(UtestHybridModelBuilder, node_state_looked_up_by_index) {
+  HybridModelBuilder builder(model_);
+  ASSERT_EQ(builder.IndexNodeItems(graph_item_), SUCCESS);
+  GraphExecutionContext execution_context;
+  SubgraphContext subgraph_context(&graph_item_, &execution_context);
+  ASSERT_EQ(subgraph_context.Init(), SUCCESS);
+  EXPECT_EQ(subgraph_context.node_states_.size(), 3);
+
+  auto add_state = subgraph_context.GetOrCreateNodeState(add_item_);
+  ASSERT_NE(add_state, nullptr);
+  EXPECT_EQ(add_state->GetNodeItem(), add_item_);
+  EXPECT_EQ(subgraph_context.GetOrCreateNodeState(add_item_), add_state);
+  EXPECT_NE(subgraph_context.GetOrCreateNodeState(relu_item_), add_state);
+
+  // node of another graph, even if its index is in range
+  auto other_item = model_.node_items_[other_].get();
+  EXPECT_EQ(subgraph_context.GetOrCreateNodeState(other_item), nullptr);
+  other_item->graph_index = 1;
+  EXPECT_EQ(subgraph_context.GetOrCreateNodeState(other_item), nullptr);
+}
+
+TEST_F(UtestHybridModelBuilder, node_done_by_index) {
+  HybridModelBuilder builder(model_);
+  ASSERT_EQ(builder.IndexNodeItems(graph_item_), SUCCESS);
+  GraphExecutionContext execution_context;
+  SubgraphContext subgraph_context(&graph_item_, &execution_context);
+  ASSERT_EQ(subgraph_context.Init(), SUCCESS);
+
+  subgraph_context.NodeDone(*data_item_);
+  EXPECT_EQ(subgraph_context.Await(*data_item_), SUCCESS);
+  EXPECT_TRUE(subgraph_context.node_done_manager_.subjects_[data_item_->graph_index]->IsRelease());
+  EXPECT_EQ(subgraph_context.node_done_manager_.subjects_[add_item_->graph_index], nullptr);
+
+  auto other_item = model_.node_items_[other_].get();
+  other_item->graph_index = 3;
+  EXPECT_EQ(subgraph_context.Await(*other_item), FAILED);
+
+  // awaiting nodes are woken up on error
+  subgraph_context.OnError(FAILED);
+  EXPECT_EQ(subgraph_context.Await(*add_item_), FAILED);
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "common/types.h"
+#include "graph/op_desc.h"
+#include "graph/utils/attr_utils.h"
+
+#define private public
+#define protected public
+#include "hybrid/node_executor/aicore/aicore_op_task.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestAiCoreOpTask : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+namespace {
+OpDescPtr CreateOpDesc(const std::vector<int64_t> &input_dims, const std::vector<int64_t> &output_dims) {
+  auto op_desc = std::make_shared<OpDesc>("add", ADD);
+  op_desc->AddInputDesc(GeTensorDesc(GeShape(input_dims)));
+  op_desc->AddInputDesc(GeTensorDesc(GeShape(input_dims)));
+  op_desc->AddOutputDesc(GeTensorDesc(GeShape(output_dims)));
+  return op_desc;
+}
+}  // namespace
+
+TEST_F(UtestAiCoreOpTask, tiling_cache_only_for_declared_ops) {
+  // not dynamic, no tiling buffer is needed
+  AiCoreOpTask task;
+  auto op_desc = CreateOpDesc({2, 3}, {2, 3});
+  EXPECT_EQ(task.InitTilingInfo(*op_desc), SUCCESS);
+  EXPECT_FALSE(task.tiling_cacheable_);
+
+  AiCoreOpTask declared_task;
+  AttrUtils::SetBool(op_desc, "tiling_depend_shape_only", true);
+  EXPECT_EQ(declared_task.InitTilingInfo(*op_desc), SUCCESS);
+  EXPECT_TRUE(declared_task.tiling_cacheable_);
+
+  AiCoreOpTask value_depend_task;
+  AttrUtils::SetBool(op_desc, "tiling_depend_shape_only", false);
+  EXPECT_EQ(value_depend_task.InitTilingInfo(*op_desc), SUCCESS);
+  EXPECT_FALSE(value_depend_task.tiling_cacheable_);
+}
+
+TEST_F(UtestAiCoreOpTask, tiling_key_of_shapes) {
+  auto key1 = AiCoreOpTask::GenerateTilingKey(*CreateOpDesc({2, 3}, {2, 3}));
+  auto key2 = AiCoreOpTask::GenerateTilingKey(*CreateOpDesc({2, 3}, {2, 3}));
+  auto key3 = AiCoreOpTask::GenerateTilingKey(*CreateOpDesc({2, 3}, {6}));
+  auto key4 = AiCoreOpTask::GenerateTilingKey(*CreateOpDesc({6}, {2, 3}));
+  EXPECT_EQ(key1, key2);
+  EXPECT_NE(key1, key3);
+  EXPECT_NE(key1, key4);
+}
+
+TEST_F(UtestAiCoreOpTask, tiling_cache_hit_restores_tiling_info) {
+  AiCoreOpTask task;
+  auto op_desc = CreateOpDesc({2, 3}, {2, 3});
+  auto key = AiCoreOpTask::GenerateTilingKey(*op_desc);
+  EXPECT_FALSE(task.LookupTilingCache(key, *op_desc));
+
+  task.block_dim_ = 8;
+  task.clear_atomic_ = false;
+  task.tiling_data_ = "tiling_1";
+  task.tiling_data_copied_ = true;
+  task.SaveTilingCache(key, {32, 64});
+
+  // tiling of other shapes
+  task.block_dim_ = 2;
+  task.clear_atomic_ = true;
+  task.tiling_data_ = "tiling_2";
+  auto other_key = AiCoreOpTask::GenerateTilingKey(*CreateOpDesc({4, 3}, {4, 3}));
+  task.SaveTilingCache(other_key, {16});
+
+  EXPECT_TRUE(task.LookupTilingCache(key, *op_desc));
+  EXPECT_EQ(task.block_dim_, 8U);
+  EXPECT_FALSE(task.clear_atomic_);
+  EXPECT_EQ(task.tiling_data_, "tiling_1");
+  EXPECT_EQ(op_desc->GetWorkspaceBytes(), std::vector<int64_t>({32, 64}));
+  // tiling data changed, must be copied to device again
+  EXPECT_FALSE(task.tiling_data_copied_);
+
+  task.tiling_data_copied_ = true;
+  EXPECT_TRUE(task.LookupTilingCache(key, *op_desc));
+  EXPECT_TRUE(task.tiling_data_copied_);
+}
+
+TEST_F(UtestAiCoreOpTask, tiling_cache_replaced_in_turn) {
+  AiCoreOpTask task;
+  std::vector<std::string> keys;
+  const int64_t kEntryNum = 5;
+  for (int64_t i = 1; i <= kEntryNum; ++i) {
+    keys.emplace_back(AiCoreOpTask::GenerateTilingKey(*CreateOpDesc({i}, {i})));
+    task.block_dim_ = static_cast<uint32_t>(i);
+    task.SaveTilingCache(keys.back(), {});
+  }
+  EXPECT_EQ(task.tiling_cache_.size(), 4U);
+
+  auto op_desc = CreateOpDesc({1}, {1});
+  EXPECT_FALSE(task.LookupTilingCache(keys[0], *op_desc));
+  EXPECT_TRUE(task.LookupTilingCache(keys[kEntryNum - 1], *op_desc));
+  EXPECT_EQ(task.block_dim_, static_cast<uint32_t>(kEntryNum));
+}
+}  // namespace hybrid
+}  // namespace ge
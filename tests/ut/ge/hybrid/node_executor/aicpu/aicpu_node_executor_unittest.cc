@@ -0,0 +1,77 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "graph/passes/graph_builder_utils.h"
+
+#define private public
+#define protected public
+#include "hybrid/executor/hybrid_execution_context.h"
+#include "hybrid/executor/subgraph_context.h"
+#include "hybrid/model/node_item.h"
+#include "hybrid/node_executor/aicpu/aicpu_node_executor.h"
+#include "hybrid/node_executor/task_context.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace hybrid {
+class UtestAicpuNodeExecutor : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+TEST_F(UtestAicpuNodeExecutor, copy_io_addr_only_if_changed) {
+  ut::GraphBuilder builder("graph");
+  auto node = builder.AddNode("a", "a", 2, 0);
+  std::unique_ptr<NodeItem> node_item;
+  ASSERT_EQ(NodeItem::Create(node, node_item), SUCCESS);
+  node_item->input_start = 0;
+  node_item->output_start = 0;
+
+  GraphExecutionContext execution_context;
+  NodeState node_state(*node_item, nullptr);
+  TaskContext task_context(&execution_context, &node_state, nullptr);
+  uint8_t data[4] = {0};
+  std::vector<TensorValue> inputs = {TensorValue(&data[0], 1), TensorValue(&data[1], 1)};
+  task_context.node_item_ = node_item.get();
+  task_context.inputs_start_ = inputs.data();
+
+  domi::TaskDef task_def;
+  AicpuTfNodeTask task(node_item.get(), task_def);
+  uint64_t io_addr_dev[2] = {0};
+  task.input_output_addr_ = TensorBuffer::Create(io_addr_dev, sizeof(io_addr_dev));
+  ASSERT_NE(task.input_output_addr_, nullptr);
+
+  std::vector<uint64_t> expected_io_addrs = {reinterpret_cast<uintptr_t>(&data[0]),
+                                             reinterpret_cast<uintptr_t>(&data[1])};
+  ASSERT_EQ(task.UpdateIoAddr(task_context), SUCCESS);
+  EXPECT_EQ(task.copied_io_addrs_, expected_io_addrs);
+  ASSERT_EQ(task.UpdateIoAddr(task_context), SUCCESS);
+  EXPECT_EQ(task.copied_io_addrs_, expected_io_addrs);
+
+  inputs[1] = TensorValue(&data[2], 1);
+  expected_io_addrs[1] = reinterpret_cast<uintptr_t>(&data[2]);
+  ASSERT_EQ(task.UpdateIoAddr(task_context), SUCCESS);
+  EXPECT_EQ(task.copied_io_addrs_, expected_io_addrs);
+}
+}  // namespace hybrid
+}  // namespace ge
@@ -0,0 +1,175 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#define private public
+#define protected public
+#include "offline/single_op_build_scheduler.h"
+#undef private
+#undef protected
+
+using namespace std;
+
+namespace ge {
+class UtestSingleOpBuildScheduler : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+namespace {
+int64_t BuildWithSleep(size_t op_num, size_t worker_num, int64_t build_ms) {
+  vector<string> signatures;
+  for (size_t i = 0; i < op_num; ++i) {
+    signatures.emplace_back("op_" + to_string(i));
+  }
+  SingleOpBuildScheduler scheduler(signatures);
+  auto start = chrono::steady_clock::now();
+  auto ret = scheduler.Run(worker_num, [build_ms](size_t worker_index, size_t op_index) -> Status {
+    this_thread::sleep_for(chrono::milliseconds(build_ms));
+    return SUCCESS;
+  });
+  EXPECT_EQ(ret, SUCCESS);
+  return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+TEST_F(UtestSingleOpBuildScheduler, identical_ops_built_once) {
+  vector<string> signatures = {"a", "b", "a", "c", "b", "a"};
+  SingleOpBuildScheduler scheduler(signatures);
+  EXPECT_EQ(scheduler.GetTasks(), vector<size_t>({0, 1, 3}));
+  EXPECT_EQ(scheduler.GetOriginIndex(2), 0);
+  EXPECT_EQ(scheduler.GetOriginIndex(3), 3);
+  EXPECT_EQ(scheduler.GetOriginIndex(4), 1);
+  EXPECT_EQ(scheduler.GetOriginIndex(5), 0);
+
+  mutex mu;
+  vector<size_t> build_count(signatures.size(), 0);
+  auto ret = scheduler.Run(4, [&](size_t worker_index, size_t op_index) -> Status {
+    lock_guard<mutex> lk(mu);
+    build_count[op_index]++;
+    return SUCCESS;
+  });
+  EXPECT_EQ(ret, SUCCESS);
+  EXPECT_EQ(build_count, vector<size_t>({1, 1, 0, 1, 0, 0}));
+
+  vector<pair<size_t, size_t>> copies;
+  ret = scheduler.CopyDuplicates([&copies](size_t src_index, size_t dst_index) -> Status {
+    copies.emplace_back(src_index, dst_index);
+    return SUCCESS;
+  });
+  EXPECT_EQ(ret, SUCCESS);
+  EXPECT_EQ(copies, (vector<pair<size_t, size_t>>{{0, 2}, {1, 4}, {0, 5}}));
+}
+
+TEST_F(UtestSingleOpBuildScheduler, outputs_follow_op_index) {
+  vector<string> signatures = {"a", "b", "c", "b", "d", "e", "a", "f"};
+  SingleOpBuildScheduler scheduler(signatures);
+  vector<string> outputs(signatures.size());
+  // later ops finish first, outputs must not depend on the finishing order
+  auto ret = scheduler.Run(4, [&](size_t worker_index, size_t op_index) -> Status {
+    this_thread::sleep_for(chrono::milliseconds(5 * (signatures.size() - op_index)));
+    outputs[op_index] = "model_" + signatures[op_index];
+    return SUCCESS;
+  });
+  EXPECT_EQ(ret, SUCCESS);
+  ret = scheduler.CopyDuplicates([&outputs](size_t src_index, size_t dst_index) -> Status {
+    outputs[dst_index] = outputs[src_index];
+    return SUCCESS;
+  });
+  EXPECT_EQ(ret, SUCCESS);
+  for (size_t i = 0; i < signatures.size(); ++i) {
+    EXPECT_EQ(outputs[i], "model_" + signatures[i]);
+  }
+}
+
+TEST_F(UtestSingleOpBuildScheduler, worker_num_limited_by_unique_ops) {
+  SingleOpBuildScheduler scheduler({"a", "a", "b"});
+  mutex mu;
+  size_t max_worker_index = 0;
+  auto ret = scheduler.Run(8, [&](size_t worker_index, size_t op_index) -> Status {
+    lock_guard<mutex> lk(mu);
+    max_worker_index = std::max(max_worker_index, worker_index);
+    return SUCCESS;
+  });
+  EXPECT_EQ(ret, SUCCESS);
+  EXPECT_LT(max_worker_index, 2);
+}
+
+TEST_F(UtestSingleOpBuildScheduler, serial_build_stops_at_first_failure) {
+  SingleOpBuildScheduler scheduler({"a", "b", "c", "d", "e"});
+  vector<size_t> built;
+  auto ret = scheduler.Run(1, [&built](size_t worker_index, size_t op_index) -> Status {
+    built.emplace_back(op_index);
+    return (op_index == 2 || op_index == 4) ? PARAM_INVALID : SUCCESS;
+  });
+  EXPECT_EQ(ret, PARAM_INVALID);
+  EXPECT_EQ(scheduler.GetFailedIndex(), 2);
+  EXPECT_EQ(scheduler.GetFailedRet(), PARAM_INVALID);
+  EXPECT_EQ(built, vector<size_t>({0, 1, 2}));
+}
+
+TEST_F(UtestSingleOpBuildScheduler, parallel_build_reports_smallest_failed_index) {
+  SingleOpBuildScheduler scheduler({"a", "b", "c", "d"});
+  mutex mu;
+  vector<size_t> built;
+  // op 0 is taken first and fails after op 1 did, the smallest index is reported
+  auto ret = scheduler.Run(2, [&](size_t worker_index, size_t op_index) -> Status {
+    {
+      lock_guard<mutex> lk(mu);
+      built.emplace_back(op_index);
+    }
+    if (op_index == 0) {
+      this_thread::sleep_for(chrono::milliseconds(50));
+      return FAILED;
+    }
+    return (op_index == 1) ? PARAM_INVALID : SUCCESS;
+  });
+  EXPECT_EQ(ret, FAILED);
+  EXPECT_EQ(scheduler.GetFailedIndex(), 0);
+  EXPECT_EQ(scheduler.GetFailedRet(), FAILED);
+  // no op is taken after the failures
+  for (auto op_index : built) {
+    EXPECT_LT(op_index, 2);
+  }
+}
+
+TEST_F(UtestSingleOpBuildScheduler, failed_copy_is_reported) {
+  SingleOpBuildScheduler scheduler({"a", "a", "a"});
+  size_t copy_num = 0;
+  auto ret = scheduler.CopyDuplicates([&copy_num](size_t src_index, size_t dst_index) -> Status {
+    ++copy_num;
+    return FAILED;
+  });
+  EXPECT_EQ(ret, FAILED);
+  EXPECT_EQ(copy_num, 1);
+}
+
+TEST_F(UtestSingleOpBuildScheduler, wall_time_scales_with_workers) {
+  const size_t kOpNum = 32;
+  const int64_t kBuildMs = 10;
+  int64_t serial_ms = BuildWithSleep(kOpNum, 1, kBuildMs);
+  int64_t parallel_ms = BuildWithSleep(kOpNum, 4, kBuildMs);
+  EXPECT_GE(serial_ms, static_cast<int64_t>(kOpNum) * kBuildMs);
+  EXPECT_LT(parallel_ms * 2, serial_ms);
+}
+}  // namespace ge
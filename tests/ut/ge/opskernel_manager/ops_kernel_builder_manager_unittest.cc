@@ -0,0 +1,129 @@
+/**
+ * Copyright 2019-2020 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "graph/passes/graph_builder_utils.h"
+
+#define private public
+#define protected public
+#include "opskernel_manager/ops_kernel_builder_manager.h"
+#undef private
+#undef protected
+
+namespace ge {
+namespace {
+class FakeOpsKernelBuilder : public OpsKernelBuilder {
+ public:
+  Status Initialize(const map<std::string, std::string> &options) override {
+    return SUCCESS;
+  }
+
+  Status Finalize() override {
+    return SUCCESS;
+  }
+
+  Status CalcOpRunningParam(Node &node) override {
+    Enter();
+    return SUCCESS;
+  }
+
+  Status GenerateTask(const Node &node, RunContext &context, std::vector<domi::TaskDef> &tasks) override {
+    Enter();
+    tasks.emplace_back(domi::TaskDef());
+    return SUCCESS;
+  }
+
+  std::atomic<int> max_active_{0};
+
+ private:
+  void Enter() {
+    int active = ++active_;
+    int max_active = max_active_.load();
+    while ((active > max_active) && !max_active_.compare_exchange_weak(max_active, active)) {
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    --active_;
+  }
+
+  std::atomic<int> active_{0};
+};
+}  // namespace
+
+class UtestOpsKernelBuilderManager : public testing::Test {
+ protected:
+  void SetUp() {}
+  void TearDown() {
+    OpsKernelBuilderManager::Instance().ops_kernel_builders_.clear();
+    OpsKernelBuilderManager::Instance().builder_mutexes_.clear();
+  }
+};
+
+TEST_F(UtestOpsKernelBuilderManager, calls_to_same_builder_serialized) {
+  // one builder registered with two lib names, as an engine lib may do
+  auto builder = std::make_shared<FakeOpsKernelBuilder>();
+  auto &manager = OpsKernelBuilderManager::Instance();
+  manager.ops_kernel_builders_["lib_a"] = builder;
+  manager.ops_kernel_builders_["lib_b"] = builder;
+
+  ut::GraphBuilder graph_builder("graph");
+  auto node_a = graph_builder.AddNode("a", "a", 0, 1);
+  auto node_b = graph_builder.AddNode("b", "b", 0, 1);
+  node_a->GetOpDesc()->SetOpKernelLibName("lib_a");
+  node_b->GetOpDesc()->SetOpKernelLibName("lib_b");
+
+  const int kThreadNum = 4;
+  const int kCallNum = 20;
+  std::atomic<int> failed_num(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadNum; ++i) {
+    auto node = (i % 2 == 0) ? node_a : node_b;
+    threads.emplace_back([&manager, &failed_num, node]() {
+      for (int j = 0; j < kCallNum; ++j) {
+        RunContext run_context;
+        std::vector<domi::TaskDef> tasks;
+        if ((manager.CalcOpRunningParam(*node) != SUCCESS) ||
+            (manager.GenerateTask(*node, run_context, tasks) != SUCCESS) || (tasks.size() != 1)) {
+          ++failed_num;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failed_num.load(), 0);
+  EXPECT_EQ(builder->max_active_.load(), 1);
+  EXPECT_EQ(manager.builder_mutexes_.size(), 1);
+}
+
+TEST_F(UtestOpsKernelBuilderManager, unknown_lib_name) {
+  ut::GraphBuilder graph_builder("graph");
+  auto node = graph_builder.AddNode("a", "a", 0, 1);
+  node->GetOpDesc()->SetOpKernelLibName("lib_unknown");
+  RunContext run_context;
+  std::vector<domi::TaskDef> tasks;
+  EXPECT_EQ(OpsKernelBuilderManager::Instance().CalcOpRunningParam(*node), INTERNAL_ERROR);
+  EXPECT_EQ(OpsKernelBuilderManager::Instance().GenerateTask(*node, run_context, tasks), INTERNAL_ERROR);
+  EXPECT_TRUE(OpsKernelBuilderManager::Instance().builder_mutexes_.empty());
+}
+}  // namespace ge
@@ -66,3 +66,38 @@ struct MsprofGeOptions prof_conf = {{ 0 }};
 Status ret = ProfilingManager::Instance().ParseOptions(options.profiling_options);
 EXPECT_EQ(ret, ge::SUCCESS);
 }
+
+namespace {
+size_t g_report_count = 0;
+std::string g_reported_data;
+
+int32_t ReporterCallbackStub(uint32_t module_id, uint32_t type, void *data, uint32_t len) {
+  auto reporter_data = static_cast<ReporterData *>(data);
+  g_reported_data.append(reinterpret_cast<char *>(reporter_data->data), reporter_data->dataLen);
+  g_report_count++;
+  return 0;
+}
+}  // namespace
+
+TEST_F(UtestGeProfilinganager, report_data_async) {
+  auto &profiling_manager = ProfilingManager::Instance();
+  auto origin_callback = profiling_manager.prof_cb_.msprofReporterCallback;
+  profiling_manager.SetMsprofReporterCallback(ReporterCallbackStub);
+  g_report_count = 0;
+  g_reported_data.clear();
+
+  std::string data(5000, 'a');
+  std::string line = "line\n";
+  std::string batch;
+  profiling_manager.AppendReportLine(0, "task_desc_info", line, batch);
+  profiling_manager.AppendReportLine(0, "task_desc_info", line, batch);
+  EXPECT_EQ(batch, "line\nline\n");
+  profiling_manager.ReportData(0, "task_desc_info", std::move(batch));
+  profiling_manager.ReportData(0, "task_desc_info", std::string(data));
+  profiling_manager.FlushReports();
+
+  // 1 report of packed lines, 3 pieces of 2KB at most for the long one
+  EXPECT_EQ(g_report_count, 4);
+  EXPECT_EQ(g_reported_data, "line\nline\n" + data);
+  profiling_manager.SetMsprofReporterCallback(origin_callback);
+}